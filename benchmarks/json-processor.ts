@@ -0,0 +1,427 @@
+/**
+ * NexureJS JSON Processor Benchmark
+ *
+ * Compares the native JsonProcessor against V8's JSON.parse/JSON.stringify on
+ * the profiling/test-data fixtures, per payload class, so it is clear where
+ * the native path actually wins.
+ *
+ * Run with: npm run bench:json
+ * Options:
+ *   --sizes=small,medium,large  Fixtures to run (default: small,medium)
+ *   --samples=N                 Timed samples per case (default: 5)
+ *   --min-time=MS               Minimum duration of one sample (default: 250)
+ *   --only=parse|stringify      Restrict to one group
+ *
+ * Every case runs in its own child process, so its peak RSS is not inflated
+ * by earlier cases. Reported per case:
+ * - ops/sec with the 95% error margin, and MB/s of JSON text
+ * - heap and external (Buffer/native-backed) bytes allocated per op
+ * - peak RSS, and RSS right after the fixture was loaded
+ */
+
+import { fork } from 'node:child_process';
+import { readFileSync, existsSync } from 'node:fs';
+import { mkdir, writeFile } from 'node:fs/promises';
+import { join } from 'node:path';
+import { gunzipSync } from 'node:zlib';
+import { performance } from 'node:perf_hooks';
+
+// =============================================
+// FIXTURES
+// =============================================
+
+const FIXTURE_DIR = join(process.cwd(), 'profiling', 'test-data');
+
+interface Payload {
+  size: string;
+  text: string;
+  buffer: Buffer;
+  value: any;
+  bytes: number;
+}
+
+/**
+ * Load a fixture, falling back to the gzipped copy when the plain file is absent
+ */
+function loadPayload(size: string): Payload {
+  const plain = join(FIXTURE_DIR, `${size}.json`);
+  const buffer = existsSync(plain) ? readFileSync(plain) : gunzipSync(readFileSync(`${plain}.gz`));
+  const text = buffer.toString('utf8');
+  return { size, text, buffer, value: JSON.parse(text), bytes: buffer.length };
+}
+
+/**
+ * Derive a serializer schema from a sample value (arrays take their first item's shape)
+ */
+function inferSchema(value: any): any {
+  if (value === null) return { type: 'null' };
+  if (Array.isArray(value)) {
+    return value.length > 0 ? { type: 'array', items: inferSchema(value[0]) } : { type: 'array' };
+  }
+  switch (typeof value) {
+    case 'string':
+      return { type: 'string' };
+    case 'number':
+      return { type: 'number' };
+    case 'boolean':
+      return { type: 'boolean' };
+    case 'object': {
+      const properties: Record<string, any> = {};
+      for (const [key, item] of Object.entries(value)) {
+        properties[key] = inferSchema(item);
+      }
+      return { type: 'object', properties };
+    }
+    default:
+      return {};
+  }
+}
+
+// =============================================
+// CASES
+// =============================================
+
+type Operation = () => unknown;
+
+interface BenchCase {
+  id: string;
+  group: 'parse' | 'stringify';
+  name: string;
+  baseline?: boolean;
+  async?: boolean;
+  native?: boolean;
+  setup(payload: Payload, binding: any): Operation;
+}
+
+// Native parser modes, as accepted by the JsonProcessor constructor
+const PARSER_MODE = { AUTO: 0, DOM: 1, ONDEMAND: 2 };
+
+const CASES: BenchCase[] = [
+  {
+    id: 'json-parse',
+    group: 'parse',
+    name: 'V8 JSON.parse',
+    baseline: true,
+    setup: payload => () => JSON.parse(payload.text)
+  },
+  {
+    id: 'native-parse-auto',
+    group: 'parse',
+    name: 'native parse (auto)',
+    native: true,
+    setup: (payload, binding) => {
+      const processor = new binding.JsonProcessor({ parserMode: PARSER_MODE.AUTO });
+      return () => processor.parse(payload.text);
+    }
+  },
+  {
+    id: 'native-parse-dom',
+    group: 'parse',
+    name: 'native parse (DOM)',
+    native: true,
+    setup: (payload, binding) => {
+      const processor = new binding.JsonProcessor({ parserMode: PARSER_MODE.DOM });
+      return () => processor.parse(payload.text);
+    }
+  },
+  {
+    id: 'native-parse-ondemand',
+    group: 'parse',
+    name: 'native parse (On-Demand)',
+    native: true,
+    setup: (payload, binding) => {
+      const processor = new binding.JsonProcessor({ parserMode: PARSER_MODE.ONDEMAND });
+      return () => processor.parse(payload.text);
+    }
+  },
+  {
+    id: 'native-parse-buffer',
+    group: 'parse',
+    name: 'native parseBuffer (DOM)',
+    native: true,
+    setup: (payload, binding) => {
+      const processor = new binding.JsonProcessor({ parserMode: PARSER_MODE.DOM });
+      return () => processor.parseBuffer(payload.buffer);
+    }
+  },
+  {
+    id: 'native-parse-async',
+    group: 'parse',
+    name: 'native parseAsync (off-thread)',
+    native: true,
+    async: true,
+    setup: (payload, binding) => {
+      const processor = new binding.JsonProcessor();
+      return () => processor.parseAsync(payload.buffer);
+    }
+  },
+  {
+    id: 'json-stringify',
+    group: 'stringify',
+    name: 'V8 JSON.stringify',
+    baseline: true,
+    setup: payload => () => JSON.stringify(payload.value)
+  },
+  {
+    id: 'native-stringify',
+    group: 'stringify',
+    name: 'native stringify (generic)',
+    native: true,
+    setup: (payload, binding) => {
+      const processor = new binding.JsonProcessor();
+      return () => processor.stringify(payload.value);
+    }
+  },
+  {
+    id: 'native-stringify-compiled',
+    group: 'stringify',
+    name: 'native stringify (schema-compiled)',
+    native: true,
+    setup: (payload, binding) => {
+      const processor = new binding.JsonProcessor();
+      const serializer = processor.compileSerializer(inferSchema(payload.value));
+      return () => serializer.stringify(payload.value);
+    }
+  },
+  {
+    id: 'native-stringify-compiled-buffer',
+    group: 'stringify',
+    name: 'native stringifyToBuffer (schema-compiled)',
+    native: true,
+    setup: (payload, binding) => {
+      const processor = new binding.JsonProcessor();
+      const serializer = processor.compileSerializer(inferSchema(payload.value));
+      return () => serializer.stringifyToBuffer(payload.value);
+    }
+  }
+];
+
+// =============================================
+// MEASUREMENT (child process)
+// =============================================
+
+interface CaseResult {
+  id: string;
+  group: string;
+  name: string;
+  size: string;
+  bytes: number;
+  opsPerSecond: number;
+  relativeMargin: number;
+  mbPerSecond: number;
+  heapBytesPerOp: number;
+  externalBytesPerOp: number;
+  peakRss: number;
+  baselineRss: number;
+  skipped?: string;
+}
+
+function collectGarbage(): void {
+  (globalThis as any).gc?.();
+}
+
+/**
+ * Run one case in this process and report it to the parent
+ */
+async function measureCase(caseId: string, size: string, samples: number, minTime: number): Promise<CaseResult> {
+  const benchCase = CASES.find(c => c.id === caseId)!;
+  const payload = loadPayload(size);
+  const result: CaseResult = {
+    id: benchCase.id,
+    group: benchCase.group,
+    name: benchCase.name,
+    size,
+    bytes: payload.bytes,
+    opsPerSecond: 0,
+    relativeMargin: 0,
+    mbPerSecond: 0,
+    heapBytesPerOp: 0,
+    externalBytesPerOp: 0,
+    peakRss: 0,
+    baselineRss: 0
+  };
+
+  let binding: any = null;
+  if (benchCase.native) {
+    const nativeModule: any = await import('../dist/native/index.js').catch(() => null);
+    binding = nativeModule?.loadNativeBinding?.();
+    if (!binding?.JsonProcessor) {
+      result.skipped = 'native module not available';
+      return result;
+    }
+  }
+
+  collectGarbage();
+  result.baselineRss = process.memoryUsage().rss;
+
+  const operation = benchCase.setup(payload, binding);
+  const run = benchCase.async
+    ? async (count: number) => { for (let i = 0; i < count; i++) await operation(); }
+    : async (count: number) => { for (let i = 0; i < count; i++) operation(); };
+
+  // Warm up and size the batch so one sample lasts about minTime
+  const warmupStart = performance.now();
+  let warmupOps = 0;
+  while (warmupOps < 3 || performance.now() - warmupStart < minTime / 2) {
+    await run(1);
+    warmupOps++;
+  }
+  const perOp = (performance.now() - warmupStart) / warmupOps;
+  const batch = Math.max(1, Math.ceil(minTime / Math.max(perOp, 0.001)));
+
+  // Allocations: heap growth over a short batch straight after a full GC.
+  // Young-generation collections inside the batch make this a lower bound.
+  const allocationOps = Math.min(batch, 50);
+  collectGarbage();
+  const before = process.memoryUsage();
+  await run(allocationOps);
+  const after = process.memoryUsage();
+  result.heapBytesPerOp = Math.max(0, (after.heapUsed - before.heapUsed) / allocationOps);
+  result.externalBytesPerOp = Math.max(0, (after.external - before.external) / allocationOps);
+
+  // Timed samples
+  const rates: number[] = [];
+  for (let sample = 0; sample < samples; sample++) {
+    collectGarbage();
+    const start = performance.now();
+    await run(batch);
+    rates.push(batch / ((performance.now() - start) / 1000));
+  }
+
+  const mean = rates.reduce((sum, rate) => sum + rate, 0) / rates.length;
+  const stdDev = Math.sqrt(rates.reduce((sum, rate) => sum + (rate - mean) ** 2, 0) / rates.length);
+  result.opsPerSecond = mean;
+  result.relativeMargin = mean > 0 ? (1.96 * stdDev / Math.sqrt(rates.length)) / mean * 100 : 0;
+  result.mbPerSecond = mean * payload.bytes / (1024 * 1024);
+  result.peakRss = process.resourceUsage().maxRSS * 1024;
+  return result;
+}
+
+/**
+ * Run one case in a fresh child process
+ */
+function runCaseInChild(caseId: string, size: string, samples: number, minTime: number): Promise<CaseResult> {
+  return new Promise((resolve, reject) => {
+    const child = fork(process.argv[1], [`--case=${caseId}`, `--size=${size}`, `--samples=${samples}`, `--min-time=${minTime}`], {
+      execArgv: [...process.execArgv, '--expose-gc']
+    });
+    let result: CaseResult | undefined;
+    child.on('message', message => { result = message as CaseResult; });
+    child.on('error', reject);
+    child.on('exit', code => {
+      if (result) {
+        resolve(result);
+      } else {
+        reject(new Error(`${caseId} (${size}) exited with code ${code}`));
+      }
+    });
+  });
+}
+
+// =============================================
+// REPORTING (parent process)
+// =============================================
+
+function formatBytes(bytes: number): string {
+  const absBytes = Math.abs(bytes);
+  if (absBytes < 1024) return `${Math.round(bytes)} B`;
+  else if (absBytes < 1024 * 1024) return `${(bytes / 1024).toFixed(1)} KB`;
+  else return `${(bytes / (1024 * 1024)).toFixed(1)} MB`;
+}
+
+function printGroup(size: string, group: string, results: CaseResult[]): void {
+  const baseline = results.find(r => CASES.find(c => c.id === r.id)?.baseline && !r.skipped);
+  console.log(`\n--- ${group} | ${size} (${formatBytes(results[0]?.bytes ?? 0)}) ---`);
+  console.log(
+    'case'.padEnd(44) + 'ops/sec'.padStart(14) + 'MB/s'.padStart(10) + 'heap/op'.padStart(11) +
+    'ext/op'.padStart(11) + 'peak RSS'.padStart(11) + 'vs V8'.padStart(10)
+  );
+
+  for (const r of results) {
+    if (r.skipped) {
+      console.log(`${r.name.padEnd(44)}skipped: ${r.skipped}`);
+      continue;
+    }
+    const ratio = baseline && r !== baseline ? `${(r.opsPerSecond / baseline.opsPerSecond).toFixed(2)}x` : '';
+    console.log(
+      r.name.padEnd(44) +
+      `${Math.round(r.opsPerSecond).toLocaleString()} ±${r.relativeMargin.toFixed(1)}%`.padStart(14) +
+      r.mbPerSecond.toFixed(1).padStart(10) +
+      formatBytes(r.heapBytesPerOp).padStart(11) +
+      formatBytes(r.externalBytesPerOp).padStart(11) +
+      formatBytes(r.peakRss).padStart(11) +
+      ratio.padStart(10)
+    );
+  }
+}
+
+async function saveResults(results: CaseResult[]): Promise<void> {
+  const resultsDir = join(process.cwd(), 'benchmark-results');
+  await mkdir(resultsDir, { recursive: true });
+  const timestamp = new Date().toISOString().replace(/:/g, '-');
+  const filepath = join(resultsDir, `json-processor-${timestamp}.json`);
+  await writeFile(filepath, JSON.stringify({
+    timestamp: new Date().toISOString(),
+    node: process.version,
+    platform: `${process.platform}-${process.arch}`,
+    results
+  }, null, 2));
+  console.log(`\nResults saved to ${filepath}`);
+}
+
+// =============================================
+// ENTRY POINT
+// =============================================
+
+function parseArgs(): Record<string, string> {
+  const args: Record<string, string> = {};
+  for (const arg of process.argv.slice(2)) {
+    const match = /^--([^=]+)(?:=(.*))?$/.exec(arg);
+    if (match) {
+      args[match[1]] = match[2] ?? 'true';
+    }
+  }
+  return args;
+}
+
+async function main(): Promise<void> {
+  const args = parseArgs();
+  const samples = Math.max(1, Number(args.samples ?? 5));
+  const minTime = Math.max(10, Number(args['min-time'] ?? 250));
+
+  // Child: measure a single case and hand the result back
+  if (args.case) {
+    const result = await measureCase(args.case, args.size, samples, minTime);
+    process.send!(result);
+    return;
+  }
+
+  const sizes = (args.sizes ?? 'small,medium').split(',').map(s => s.trim()).filter(Boolean);
+  const groups = args.only ? [args.only] : ['parse', 'stringify'];
+
+  console.log('=== NexureJS JSON Processor Benchmark ===');
+  console.log(`Node ${process.version} | ${samples} samples of >=${minTime}ms | fixtures: ${sizes.join(', ')}`);
+
+  const allResults: CaseResult[] = [];
+  for (const size of sizes) {
+    for (const group of groups) {
+      const groupResults: CaseResult[] = [];
+      for (const benchCase of CASES.filter(c => c.group === group)) {
+        try {
+          groupResults.push(await runCaseInChild(benchCase.id, size, samples, minTime));
+        } catch (error) {
+          console.error(`Error running ${benchCase.name}:`, error instanceof Error ? error.message : String(error));
+        }
+      }
+      printGroup(size, group, groupResults);
+      allResults.push(...groupResults);
+    }
+  }
+
+  await saveResults(allResults);
+}
+
+main().catch(error => {
+  console.error('Error running JSON processor benchmark:', error);
+  process.exit(1);
+});
@@ -6,10 +6,24 @@
         "src/native/main.cc",
         "src/native/http/http_parser.cc",
         "src/native/http/object_pool.cc",
+        "src/native/http/negotiator.cc",
         "src/native/routing/radix_router.cc",
         "src/native/json/json_processor.cc",
+        "src/native/json/json_serializer.cc",
+        "src/native/json/json_stringify_cursor.cc",
+        "src/native/json/json_parse_worker.cc",
+        "src/native/json/binary_codec.cc",
+        "src/native/json/json_patch.cc",
         "src/native/url/url_parser.cc",
+        "src/native/url/whatwg_url.cc",
+        "src/native/url/url_batch.cc",
+        "src/native/url/url_builder.cc",
         "src/native/schema/schema_validator.cc",
+        "src/native/schema/schema_program.cc",
+        "src/native/schema/schema_pattern.cc",
+        "src/native/schema/compiled_schema.cc",
+        "src/native/schema/schema_json.cc",
+        "src/native/schema/schema_parse.cc",
         "src/native/compression/compression.cc",
         "src/native/websocket/websocket.cc",
         "src/native/json/simdjson_wrapper.cpp"
@@ -0,0 +1,321 @@
+#ifndef HTTP_COOKIE_H
+#define HTTP_COOKIE_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include "url/url_scan.h"
+
+/**
+ * RFC 6265 cookie parsing and Set-Cookie serialization
+ *
+ * Parsing works directly on the raw Cookie header: pairs are split on ';',
+ * names and values are trimmed of spaces and tabs and a value wrapped in
+ * double quotes loses them. The first pair with a given name wins, and only
+ * values that are actually read get percent-decoded, so looking up one cookie
+ * costs a scan of the header and nothing else.
+ */
+namespace HttpCookie {
+
+  inline bool IsCookieSpace(char c) {
+    return c == ' ' || c == '\t';
+  }
+
+  inline std::string_view TrimCookieSpace(std::string_view text) {
+    size_t start = 0;
+    size_t end = text.size();
+    while (start < end && IsCookieSpace(text[start])) {
+      start++;
+    }
+    while (end > start && IsCookieSpace(text[end - 1])) {
+      end--;
+    }
+    return text.substr(start, end - start);
+  }
+
+  // ASCII case-insensitive comparison against a lowercase literal
+  inline bool EqualsIgnoreCase(std::string_view text, std::string_view lower) {
+    if (text.size() != lower.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < text.size(); i++) {
+      char c = text[i];
+      if ((c >= 'A' && c <= 'Z' ? static_cast<char>(c + 32) : c) != lower[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Call fn(name, rawValue) for each name=value pair in a Cookie header, until fn returns false.
+  // Segments without '=' are skipped; the value keeps its escapes but loses surrounding quotes.
+  template <typename Fn>
+  inline void ForEachCookie(std::string_view header, Fn&& fn) {
+    size_t pos = 0;
+    while (pos < header.size()) {
+      size_t end = header.find(';', pos);
+      if (end == std::string_view::npos) {
+        end = header.size();
+      }
+      std::string_view pair = header.substr(pos, end - pos);
+      pos = end + 1;
+
+      size_t eq = pair.find('=');
+      if (eq == std::string_view::npos) {
+        continue;
+      }
+      std::string_view name = TrimCookieSpace(pair.substr(0, eq));
+      std::string_view value = TrimCookieSpace(pair.substr(eq + 1));
+      if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
+        value = value.substr(1, value.size() - 2);
+      }
+      if (!fn(name, value)) {
+        return;
+      }
+    }
+  }
+
+  // Raw value of the first cookie called `name`; false if there is none
+  inline bool FindCookie(std::string_view header, std::string_view name, std::string_view& value) {
+    bool found = false;
+    ForEachCookie(header, [&](std::string_view cookieName, std::string_view cookieValue) {
+      if (cookieName == name) {
+        value = cookieValue;
+        found = true;
+      }
+      return !found;
+    });
+    return found;
+  }
+
+  // Append a cookie value, decoded like decodeURIComponent; values it would reject are kept as is
+  inline void AppendCookieValue(std::string_view value, std::string& out) {
+    if (value.find('%') == std::string_view::npos) {
+      out.append(value.data(), value.size());
+      return;
+    }
+    size_t mark = out.size();
+    if (!UrlScan::AppendComponentDecoded(value.data(), value.size(), out)) {
+      out.resize(mark);
+      out.append(value.data(), value.size());
+    }
+  }
+
+  // RFC 7230 token characters, the only ones allowed in a cookie name
+  inline bool IsTokenChar(unsigned char c) {
+    if ((c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z')) {
+      return true;
+    }
+    switch (c) {
+      case '!': case '#': case '$': case '%': case '&': case '\'': case '*':
+      case '+': case '-': case '.': case '^': case '_': case '`': case '|': case '~':
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  // RFC 6265 cookie-octet: printable ASCII except space, DQUOTE, ',', ';' and '\'
+  inline bool IsCookieOctet(unsigned char c) {
+    return c >= 0x21 && c <= 0x7e && c != '"' && c != ',' && c != ';' && c != '\\';
+  }
+
+  inline bool IsValidCookieName(std::string_view name) {
+    if (name.empty()) {
+      return false;
+    }
+    for (char c : name) {
+      if (!IsTokenChar(static_cast<unsigned char>(c))) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // cookie-value: *cookie-octet, optionally wrapped in one pair of double quotes
+  inline bool IsValidCookieValue(std::string_view value) {
+    if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
+      value = value.substr(1, value.size() - 2);
+    }
+    for (char c : value) {
+      if (!IsCookieOctet(static_cast<unsigned char>(c))) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Domain attribute: dot-separated LDH labels of 1-63 characters, with an optional leading dot
+  inline bool IsValidCookieDomain(std::string_view domain) {
+    if (!domain.empty() && domain.front() == '.') {
+      domain.remove_prefix(1);
+    }
+    if (domain.empty()) {
+      return false;
+    }
+    size_t labelStart = 0;
+    for (size_t i = 0; i <= domain.size(); i++) {
+      if (i < domain.size() && domain[i] != '.') {
+        unsigned char c = static_cast<unsigned char>(domain[i]);
+        bool alnum = (c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+        if (!alnum && c != '-') {
+          return false;
+        }
+        continue;
+      }
+      size_t labelLength = i - labelStart;
+      if (labelLength == 0 || labelLength > 63 ||
+          domain[labelStart] == '-' || domain[i - 1] == '-') {
+        return false;
+      }
+      labelStart = i + 1;
+    }
+    return true;
+  }
+
+  // Path attribute: printable ASCII except ';'
+  inline bool IsValidCookiePath(std::string_view path) {
+    for (char c : path) {
+      unsigned char u = static_cast<unsigned char>(c);
+      if (u < 0x20 || u > 0x7e || u == ';') {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  enum class SameSite { UNSET, STRICT, LAX, NONE };
+  enum class Priority { UNSET, LOW, MEDIUM, HIGH };
+
+  struct CookieOptions {
+    bool encode = true;          // Percent-encode the value like encodeURIComponent
+    bool hasMaxAge = false;
+    double maxAge = 0;           // Seconds; fractions are floored
+    bool hasExpires = false;
+    double expires = 0;          // Milliseconds since the epoch
+    std::string_view domain;
+    std::string_view path;
+    bool httpOnly = false;
+    bool secure = false;
+    bool partitioned = false;
+    SameSite sameSite = SameSite::UNSET;
+    Priority priority = Priority::UNSET;
+  };
+
+  // Append an IMF-fixdate ("Sun, 06 Nov 1994 08:49:37 GMT"), as Date.prototype.toUTCString
+  // writes it. Returns false for times outside years 0-9999, which have no such form.
+  inline bool AppendHttpDate(double milliseconds, std::string& out) {
+    static const char kDays[7][4] = {"Thu", "Fri", "Sat", "Sun", "Mon", "Tue", "Wed"};
+    static const char kMonths[12][4] = {
+      "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"
+    };
+    // Day range of years 0000-9999 relative to 1970-01-01
+    if (!std::isfinite(milliseconds) || milliseconds < -62167219200000.0 ||
+        milliseconds >= 253402300800000.0) {
+      return false;
+    }
+
+    int64_t seconds = static_cast<int64_t>(std::floor(milliseconds / 1000));
+    int64_t days = seconds >= 0 ? seconds / 86400 : -((-seconds + 86399) / 86400);
+    int64_t secondOfDay = seconds - days * 86400;
+
+    // Civil date from a day count (proleptic Gregorian, eras of 400 years)
+    int64_t z = days + 719468;
+    int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    int64_t dayOfEra = z - era * 146097;
+    int64_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    int64_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    int64_t shiftedMonth = (5 * dayOfYear + 2) / 153;
+    int day = static_cast<int>(dayOfYear - (153 * shiftedMonth + 2) / 5 + 1);
+    int month = static_cast<int>(shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9);
+    int year = static_cast<int>(yearOfEra + era * 400 + (month <= 2 ? 1 : 0));
+    int weekday = static_cast<int>(((days % 7) + 7) % 7);
+
+    char buffer[32];
+    int written = std::snprintf(buffer, sizeof(buffer), "%s, %02d %s %04d %02d:%02d:%02d GMT",
+      kDays[weekday], day, kMonths[month - 1], year,
+      static_cast<int>(secondOfDay / 3600), static_cast<int>(secondOfDay / 60 % 60),
+      static_cast<int>(secondOfDay % 60));
+    out.append(buffer, static_cast<size_t>(written));
+    return true;
+  }
+
+  // Serialize a Set-Cookie header value. Returns nullptr on success, or the reason the
+  // name, value or an attribute cannot be sent (out is left partially written).
+  inline const char* SerializeCookie(std::string_view name, std::string_view value,
+                                     const CookieOptions& options, std::string& out) {
+    if (!IsValidCookieName(name)) {
+      return "argument name is invalid";
+    }
+    out.append(name.data(), name.size());
+    out += '=';
+
+    size_t valueStart = out.size();
+    if (options.encode) {
+      UrlScan::AppendComponentEncoded(value.data(), value.size(), out);
+    } else {
+      out.append(value.data(), value.size());
+    }
+    if (!IsValidCookieValue(std::string_view(out).substr(valueStart))) {
+      return "argument val is invalid";
+    }
+
+    if (options.hasMaxAge) {
+      if (!std::isfinite(options.maxAge)) {
+        return "option maxAge is invalid";
+      }
+      char buffer[32];
+      int written = std::snprintf(buffer, sizeof(buffer), "%.0f", std::floor(options.maxAge));
+      out += "; Max-Age=";
+      out.append(buffer, static_cast<size_t>(written));
+    }
+    if (!options.domain.empty()) {
+      if (!IsValidCookieDomain(options.domain)) {
+        return "option domain is invalid";
+      }
+      out += "; Domain=";
+      out.append(options.domain.data(), options.domain.size());
+    }
+    if (!options.path.empty()) {
+      if (!IsValidCookiePath(options.path)) {
+        return "option path is invalid";
+      }
+      out += "; Path=";
+      out.append(options.path.data(), options.path.size());
+    }
+    if (options.hasExpires) {
+      out += "; Expires=";
+      if (!AppendHttpDate(options.expires, out)) {
+        return "option expires is invalid";
+      }
+    }
+    if (options.httpOnly) {
+      out += "; HttpOnly";
+    }
+    if (options.secure) {
+      out += "; Secure";
+    }
+    if (options.partitioned) {
+      out += "; Partitioned";
+    }
+    switch (options.priority) {
+      case Priority::LOW: out += "; Priority=Low"; break;
+      case Priority::MEDIUM: out += "; Priority=Medium"; break;
+      case Priority::HIGH: out += "; Priority=High"; break;
+      case Priority::UNSET: break;
+    }
+    switch (options.sameSite) {
+      case SameSite::STRICT: out += "; SameSite=Strict"; break;
+      case SameSite::LAX: out += "; SameSite=Lax"; break;
+      case SameSite::NONE: out += "; SameSite=None"; break;
+      case SameSite::UNSET: break;
+    }
+    return nullptr;
+  }
+
+} // namespace HttpCookie
+
+#endif // HTTP_COOKIE_H
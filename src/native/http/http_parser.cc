@@ -1,4 +1,7 @@
 #include "http_parser.h"
+#include "cookie.h"
+#include "negotiator.h"
+#include "url/url_scan.h"
 #include <algorithm>
 #include <cctype>
 #include <sstream>
@@ -13,7 +16,11 @@ Napi::Object HttpParser::Init(Napi::Env env, Napi::Object exports) {
     InstanceMethod("parseRequest", &HttpParser::ParseRequest),
     InstanceMethod("parseHeaders", &HttpParser::ParseHeaders),
     InstanceMethod("parseBody", &HttpParser::ParseBody),
-    InstanceMethod("reset", &HttpParser::Reset)
+    InstanceMethod("reset", &HttpParser::Reset),
+    InstanceMethod("getCookie", &HttpParser::GetCookie),
+    InstanceMethod("getCookies", &HttpParser::GetCookies),
+    InstanceMethod("negotiate", &HttpParser::Negotiate),
+    StaticMethod("serializeCookie", &HttpParser::SerializeCookie)
   });
 
   Napi::FunctionReference* constructor = new Napi::FunctionReference();
@@ -302,6 +309,160 @@ Napi::Value HttpParser::Reset(const Napi::CallbackInfo& info) {
   return env.Undefined();
 }
 
+// Decoded value of one cookie from the last request, or undefined
+Napi::Value HttpParser::GetCookie(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "Cookie name must be a string").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  auto header = headers_.find(std::string(HEADER_COOKIE));
+  if (header == headers_.end()) {
+    return env.Undefined();
+  }
+
+  std::string name = info[0].As<Napi::String>().Utf8Value();
+  std::string_view raw;
+  if (!HttpCookie::FindCookie(header->second, name, raw)) {
+    return env.Undefined();
+  }
+
+  std::string value;
+  HttpCookie::AppendCookieValue(raw, value);
+  return Napi::String::New(env, value);
+}
+
+// All cookies of the last request as an object; the first of repeated names wins
+Napi::Value HttpParser::GetCookies(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  Napi::Object cookies = Napi::Object::New(env);
+
+  auto header = headers_.find(std::string(HEADER_COOKIE));
+  if (header == headers_.end()) {
+    return cookies;
+  }
+
+  std::string value;
+  HttpCookie::ForEachCookie(header->second, [&](std::string_view name, std::string_view raw) {
+    std::string key(name);
+    if (key == "__proto__" || cookies.HasOwnProperty(key)) {
+      return true;
+    }
+    value.clear();
+    HttpCookie::AppendCookieValue(raw, value);
+    cookies.Set(key, Napi::String::New(env, value));
+    return true;
+  });
+
+  return cookies;
+}
+
+// negotiate(negotiator) -> offer index for the stored header, -1 if nothing is acceptable
+Napi::Value HttpParser::Negotiate(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  Negotiator* negotiator = info.Length() > 0 ? Negotiator::FromValue(info[0]) : nullptr;
+  if (!negotiator) {
+    Napi::TypeError::New(env, "Negotiator expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  auto header = headers_.find(negotiator->HeaderName());
+  bool present = header != headers_.end();
+  return Napi::Number::New(env, negotiator->Select(present ? std::string_view(header->second) : std::string_view(), present));
+}
+
+// serializeCookie(name, value, options?) -> Set-Cookie header value
+Napi::Value HttpParser::SerializeCookie(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2 || !info[0].IsString() || !info[1].IsString()) {
+    Napi::TypeError::New(env, "Cookie name and value must be strings").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  std::string name = info[0].As<Napi::String>().Utf8Value();
+  std::string value = info[1].As<Napi::String>().Utf8Value();
+  std::string domain;
+  std::string path;
+  HttpCookie::CookieOptions options;
+
+  if (info.Length() > 2 && info[2].IsObject()) {
+    Napi::Object opts = info[2].As<Napi::Object>();
+
+    if (opts.Has("encode") && opts.Get("encode").IsBoolean()) {
+      options.encode = opts.Get("encode").As<Napi::Boolean>().Value();
+    }
+    if (opts.Has("maxAge") && !opts.Get("maxAge").IsUndefined()) {
+      Napi::Value maxAge = opts.Get("maxAge");
+      options.hasMaxAge = true;
+      options.maxAge = maxAge.IsNumber() ? maxAge.As<Napi::Number>().DoubleValue() : NAN;
+    }
+    if (opts.Has("domain") && opts.Get("domain").IsString()) {
+      domain = opts.Get("domain").As<Napi::String>().Utf8Value();
+      options.domain = domain;
+    }
+    if (opts.Has("path") && opts.Get("path").IsString()) {
+      path = opts.Get("path").As<Napi::String>().Utf8Value();
+      options.path = path;
+    }
+    if (opts.Has("expires") && !opts.Get("expires").IsUndefined()) {
+      Napi::Value expires = opts.Get("expires");
+      options.hasExpires = true;
+      options.expires = expires.IsDate() ? expires.As<Napi::Date>().ValueOf()
+        : expires.IsNumber() ? expires.As<Napi::Number>().DoubleValue() : NAN;
+    }
+    options.httpOnly = opts.Has("httpOnly") && opts.Get("httpOnly").ToBoolean().Value();
+    options.secure = opts.Has("secure") && opts.Get("secure").ToBoolean().Value();
+    options.partitioned = opts.Has("partitioned") && opts.Get("partitioned").ToBoolean().Value();
+
+    if (opts.Has("priority") && opts.Get("priority").IsString()) {
+      std::string priority = opts.Get("priority").As<Napi::String>().Utf8Value();
+      if (HttpCookie::EqualsIgnoreCase(priority, "low")) {
+        options.priority = HttpCookie::Priority::LOW;
+      } else if (HttpCookie::EqualsIgnoreCase(priority, "medium")) {
+        options.priority = HttpCookie::Priority::MEDIUM;
+      } else if (HttpCookie::EqualsIgnoreCase(priority, "high")) {
+        options.priority = HttpCookie::Priority::HIGH;
+      } else {
+        Napi::TypeError::New(env, "option priority is invalid").ThrowAsJavaScriptException();
+        return env.Null();
+      }
+    }
+
+    if (opts.Has("sameSite")) {
+      Napi::Value sameSite = opts.Get("sameSite");
+      std::string policy = sameSite.IsString() ? sameSite.As<Napi::String>().Utf8Value() : "";
+      if (sameSite.IsBoolean()) {
+        options.sameSite = sameSite.As<Napi::Boolean>().Value() ? HttpCookie::SameSite::STRICT
+                                                                 : HttpCookie::SameSite::UNSET;
+      } else if (sameSite.IsUndefined()) {
+        options.sameSite = HttpCookie::SameSite::UNSET;
+      } else if (HttpCookie::EqualsIgnoreCase(policy, "strict")) {
+        options.sameSite = HttpCookie::SameSite::STRICT;
+      } else if (HttpCookie::EqualsIgnoreCase(policy, "lax")) {
+        options.sameSite = HttpCookie::SameSite::LAX;
+      } else if (HttpCookie::EqualsIgnoreCase(policy, "none")) {
+        options.sameSite = HttpCookie::SameSite::NONE;
+      } else {
+        Napi::TypeError::New(env, "option sameSite is invalid").ThrowAsJavaScriptException();
+        return env.Null();
+      }
+    }
+  }
+
+  std::string out;
+  out.reserve(name.size() + value.size() + 96);
+  const char* error = HttpCookie::SerializeCookie(name, value, options, out);
+  if (error) {
+    Napi::TypeError::New(env, error).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  return Napi::String::New(env, out);
+}
+
 // Parse the request line with zero-copy approach
 bool HttpParser::ParseRequestLine(Napi::Env env, Napi::Object result) {
   // Find the end of the request line
@@ -377,6 +538,9 @@ bool HttpParser::ParseHeaders(Napi::Env env, Napi::Object headers) {
     return false;
   }
 
+  // Drop the previous request's headers so their cookies are not served for this one
+  headers_.clear();
+
   // Calculate the length of the headers section
   size_t headersLength = endOfHeaders - (currentBuffer_ + bufferOffset_);
   headerEndOffset_ = bufferOffset_ + headersLength + 4; // +4 for the \r\n\r\n
@@ -515,28 +679,11 @@ const char* HttpParser::FindSubstring(
   return nullptr;
 }
 
-// URL decode helper
+// URL decode helper ('+' decodes to a space; malformed escapes are kept)
 std::string HttpParser::UrlDecode(const std::string_view& input) {
   std::string result;
   result.reserve(input.length());
-
-  for (size_t i = 0; i < input.length(); i++) {
-    if (input[i] == '%' && i + 2 < input.length()) {
-      // Get the hex value
-      unsigned int value;
-      if (sscanf(input.data() + i + 1, "%2x", &value) == 1) {
-        result += static_cast<char>(value);
-        i += 2;
-      } else {
-        result += input[i];
-      }
-    } else if (input[i] == '+') {
-      result += ' ';
-    } else {
-      result += input[i];
-    }
-  }
-
+  UrlScan::AppendDecoded(input.data(), input.length(), true, result);
   return result;
 }
 
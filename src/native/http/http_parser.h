@@ -63,6 +63,14 @@ public:
   Napi::Value ParseBody(const Napi::CallbackInfo& info);
   Napi::Value Reset(const Napi::CallbackInfo& info);
 
+  // Cookies of the last parsed request, read from the raw Cookie header on demand
+  Napi::Value GetCookie(const Napi::CallbackInfo& info);
+  Napi::Value GetCookies(const Napi::CallbackInfo& info);
+  static Napi::Value SerializeCookie(const Napi::CallbackInfo& info);
+
+  // Offer index a Negotiator picks for the last request's Accept* header
+  Napi::Value Negotiate(const Napi::CallbackInfo& info);
+
 private:
   // Internal parsing methods
   bool ParseRequestLine(Napi::Env env, Napi::Object result);
@@ -0,0 +1,359 @@
+#ifndef HTTP_NEGOTIATION_H
+#define HTTP_NEGOTIATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "cookie.h"
+
+/**
+ * Proactive content negotiation (RFC 9110 section 12.5)
+ *
+ * Accept, Accept-Encoding, Accept-Language and Accept-Charset headers are
+ * parsed into ranges with q-values, then every server offer is scored by the
+ * most specific range that matches it. The best offer has the highest q,
+ * then the most specific match, then the earliest matching range, then the
+ * earliest position in the offer list. Offers whose q is 0 are never chosen.
+ * The ordering follows the `negotiator` package used by Express.
+ */
+namespace HttpNegotiation {
+
+  enum class Kind { MEDIA_TYPE, ENCODING, LANGUAGE, CHARSET };
+
+  struct Param {
+    std::string_view name;
+    std::string_view value;
+  };
+
+  // One media range, coding, language range or charset from a header (or an offer).
+  // For media types `primary`/`secondary` are type and subtype; for languages they are
+  // the full tag and its primary subtag; otherwise `primary` is the token.
+  struct Range {
+    std::string_view primary;
+    std::string_view secondary;
+    size_t paramsBegin = 0;
+    size_t paramsEnd = 0;
+    double q = 1;
+  };
+
+  struct ParsedHeader {
+    std::vector<Range> ranges;
+    std::vector<Param> params;
+
+    void Clear() {
+      ranges.clear();
+      params.clear();
+    }
+  };
+
+  // Split on `separator` outside double-quoted strings
+  template <typename Fn>
+  inline void ForEachElement(std::string_view text, char separator, Fn&& fn) {
+    size_t start = 0;
+    bool quoted = false;
+    for (size_t i = 0; i < text.size(); i++) {
+      char c = text[i];
+      if (quoted) {
+        if (c == '\\') {
+          i++;
+        } else if (c == '"') {
+          quoted = false;
+        }
+      } else if (c == '"') {
+        quoted = true;
+      } else if (c == separator) {
+        fn(text.substr(start, i - start));
+        start = i + 1;
+      }
+    }
+    fn(text.substr(start));
+  }
+
+  // qvalue = ( "0" [ "." 0*3DIGIT ] ) / ( "1" [ "." 0*3("0") ] ), read leniently
+  inline bool ParseQuality(std::string_view text, double& q) {
+    if (text.empty() || text[0] < '0' || text[0] > '9') {
+      return false;
+    }
+    double value = 0;
+    size_t i = 0;
+    for (; i < text.size() && text[i] >= '0' && text[i] <= '9'; i++) {
+      value = value * 10 + (text[i] - '0');
+    }
+    if (i < text.size() && text[i] == '.') {
+      double scale = 0.1;
+      for (i++; i < text.size() && text[i] >= '0' && text[i] <= '9'; i++) {
+        value += (text[i] - '0') * scale;
+        scale /= 10;
+      }
+    }
+    if (i != text.size() || value > 1) {
+      return false;
+    }
+    q = value;
+    return true;
+  }
+
+  // Parse one element ("text/html;level=1;q=0.5"). For headers a q parameter ends the media
+  // type parameters; offers keep every parameter. Returns false for elements to ignore.
+  inline bool ParseRange(Kind kind, std::string_view element, bool isOffer,
+                         std::vector<Param>& params, Range& range) {
+    size_t paramMark = params.size();
+    bool first = true;
+    bool valid = true;
+    bool afterQuality = false;
+    ForEachElement(element, ';', [&](std::string_view part) {
+      part = HttpCookie::TrimCookieSpace(part);
+      if (first) {
+        first = false;
+        range.primary = part;
+        return;
+      }
+      if (!valid || afterQuality || part.empty()) {
+        return;
+      }
+      size_t eq = part.find('=');
+      if (eq == std::string_view::npos) {
+        return;
+      }
+      Param param{HttpCookie::TrimCookieSpace(part.substr(0, eq)), HttpCookie::TrimCookieSpace(part.substr(eq + 1))};
+      if (param.value.size() >= 2 && param.value.front() == '"' && param.value.back() == '"') {
+        param.value = param.value.substr(1, param.value.size() - 2);
+      }
+      if (!isOffer && HttpCookie::EqualsIgnoreCase(param.name, "q")) {
+        valid = ParseQuality(param.value, range.q);
+        afterQuality = true;
+        return;
+      }
+      if (kind == Kind::MEDIA_TYPE) {
+        params.push_back(param);
+      }
+    });
+
+    range.paramsBegin = paramMark;
+    range.paramsEnd = params.size();
+    if (!valid || range.primary.empty()) {
+      params.resize(paramMark);
+      return false;
+    }
+
+    if (kind == Kind::MEDIA_TYPE) {
+      size_t slash = range.primary.find('/');
+      if (slash == std::string_view::npos || slash == 0 || slash + 1 == range.primary.size()) {
+        params.resize(paramMark);
+        return false;
+      }
+      range.secondary = range.primary.substr(slash + 1);
+      range.primary = range.primary.substr(0, slash);
+    } else if (kind == Kind::LANGUAGE) {
+      size_t dash = range.primary.find('-');
+      range.secondary = dash == std::string_view::npos ? range.primary : range.primary.substr(0, dash);
+    }
+    return true;
+  }
+
+  // Parse a whole header (or offer list joined by commas) into `out`
+  inline void ParseHeader(Kind kind, std::string_view header, bool isOffer, ParsedHeader& out) {
+    out.Clear();
+    ForEachElement(header, ',', [&](std::string_view element) {
+      Range range;
+      if (ParseRange(kind, HttpCookie::TrimCookieSpace(element), isOffer, out.params, range)) {
+        out.ranges.push_back(range);
+      }
+    });
+  }
+
+  inline bool EqualsIgnoreCaseBoth(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < a.size(); i++) {
+      char x = a[i];
+      char y = b[i];
+      if ((x >= 'A' && x <= 'Z' ? x + 32 : x) != (y >= 'A' && y <= 'Z' ? y + 32 : y)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Specificity of `accept` for `offer`, or -1 if it does not match
+  inline int Specificity(Kind kind, const Range& accept, const std::vector<Param>& acceptParams,
+                         const Range& offer, const std::vector<Param>& offerParams) {
+    switch (kind) {
+      case Kind::MEDIA_TYPE: {
+        int s = 0;
+        if (EqualsIgnoreCaseBoth(accept.primary, offer.primary)) {
+          s |= 4;
+        } else if (accept.primary != "*") {
+          return -1;
+        }
+        if (EqualsIgnoreCaseBoth(accept.secondary, offer.secondary)) {
+          s |= 2;
+        } else if (accept.secondary != "*") {
+          return -1;
+        }
+        if (accept.paramsEnd > accept.paramsBegin) {
+          for (size_t i = accept.paramsBegin; i < accept.paramsEnd; i++) {
+            const Param& wanted = acceptParams[i];
+            if (wanted.value == "*") {
+              continue;
+            }
+            bool matched = false;
+            for (size_t j = offer.paramsBegin; j < offer.paramsEnd && !matched; j++) {
+              matched = EqualsIgnoreCaseBoth(offerParams[j].name, wanted.name) &&
+                        EqualsIgnoreCaseBoth(offerParams[j].value, wanted.value);
+            }
+            if (!matched) {
+              return -1;
+            }
+          }
+          s |= 1;
+        }
+        return s;
+      }
+      case Kind::LANGUAGE:
+        if (EqualsIgnoreCaseBoth(accept.primary, offer.primary)) {
+          return 4;
+        }
+        if (EqualsIgnoreCaseBoth(accept.secondary, offer.primary)) {
+          return 2;
+        }
+        if (EqualsIgnoreCaseBoth(accept.primary, offer.secondary)) {
+          return 1;
+        }
+        return accept.primary == "*" ? 0 : -1;
+      case Kind::ENCODING:
+      case Kind::CHARSET:
+        if (EqualsIgnoreCaseBoth(accept.primary, offer.primary)) {
+          return 1;
+        }
+        return accept.primary == "*" ? 0 : -1;
+    }
+    return -1;
+  }
+
+  // Index of the best offer for a parsed header, or -1 if none is acceptable
+  inline int SelectOffer(Kind kind, const ParsedHeader& accepted, const ParsedHeader& offers) {
+    int best = -1;
+    double bestQ = 0;
+    int bestS = -1;
+    size_t bestOrder = 0;
+
+    for (size_t i = 0; i < offers.ranges.size(); i++) {
+      const Range& offer = offers.ranges[i];
+      int s = -1;
+      double q = 0;
+      size_t order = 0;
+      for (size_t o = 0; o < accepted.ranges.size(); o++) {
+        int spec = Specificity(kind, accepted.ranges[o], accepted.params, offer, offers.params);
+        if (spec > s || (spec == s && spec >= 0 && accepted.ranges[o].q > q)) {
+          s = spec;
+          q = accepted.ranges[o].q;
+          order = o;
+        }
+      }
+      if (s < 0 || q <= 0) {
+        continue;
+      }
+      if (best < 0 || q > bestQ || (q == bestQ && (s > bestS || (s == bestS && order < bestOrder)))) {
+        best = static_cast<int>(i);
+        bestQ = q;
+        bestS = s;
+        bestOrder = order;
+      }
+    }
+    return best;
+  }
+
+  // Header used when the request did not send one
+  inline std::string_view DefaultHeader(Kind kind) {
+    // No Accept-Encoding means identity only, as compression middleware expects
+    return kind == Kind::ENCODING ? std::string_view() : kind == Kind::MEDIA_TYPE ? "*/*" : "*";
+  }
+
+  // Parse a request header for `kind`, adding the implicit "identity" coding when neither
+  // "identity" nor "*" covers it, at the lowest nonzero q listed (as negotiator does):
+  // only "identity;q=0" or "*;q=0" refuse it
+  inline void ParseAccept(Kind kind, std::string_view header, ParsedHeader& out) {
+    ParseHeader(kind, header, false, out);
+    if (kind != Kind::ENCODING) {
+      return;
+    }
+    double minQ = 1;
+    for (const Range& range : out.ranges) {
+      if (range.primary == "*" || EqualsIgnoreCaseBoth(range.primary, "identity")) {
+        return;
+      }
+      if (range.q > 0 && range.q < minQ) {
+        minQ = range.q;
+      }
+    }
+    Range identity;
+    identity.primary = "identity";
+    identity.q = minQ;
+    out.ranges.push_back(identity);
+  }
+
+  /**
+   * Least-recently-used map from raw header values to the offer chosen for them.
+   * Keys point into the list nodes, so lookups take a string_view without copying.
+   */
+  class DecisionCache {
+  public:
+    explicit DecisionCache(size_t capacity = 0) : capacity_(capacity) {}
+
+    void SetCapacity(size_t capacity) {
+      capacity_ = capacity;
+      while (entries_.size() > capacity_) {
+        index_.erase(entries_.back().first);
+        entries_.pop_back();
+      }
+    }
+
+    size_t Capacity() const { return capacity_; }
+    size_t Size() const { return entries_.size(); }
+    uint64_t Hits() const { return hits_; }
+    uint64_t Misses() const { return misses_; }
+
+    bool Find(std::string_view header, int& decision) {
+      auto it = index_.find(header);
+      if (it == index_.end()) {
+        misses_++;
+        return false;
+      }
+      entries_.splice(entries_.begin(), entries_, it->second);
+      decision = it->second->second;
+      hits_++;
+      return true;
+    }
+
+    void Insert(std::string_view header, int decision) {
+      if (capacity_ == 0) {
+        return;
+      }
+      if (entries_.size() >= capacity_) {
+        index_.erase(entries_.back().first);
+        entries_.pop_back();
+      }
+      entries_.emplace_front(std::string(header), decision);
+      index_.emplace(entries_.front().first, entries_.begin());
+    }
+
+  private:
+    using Entry = std::pair<std::string, int>;
+
+    size_t capacity_;
+    std::list<Entry> entries_;
+    std::unordered_map<std::string_view, std::list<Entry>::iterator> index_;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+  };
+
+} // namespace HttpNegotiation
+
+#endif // HTTP_NEGOTIATION_H
@@ -0,0 +1,157 @@
+#include "negotiator.h"
+
+namespace {
+
+  constexpr size_t kDefaultCacheSize = 64;
+
+  // Header values longer than this are negotiated without caching
+  constexpr size_t kMaxCachedHeaderLength = 1024;
+
+  // Tag on every constructed Negotiator, so FromValue never unwraps a foreign object
+  const napi_type_tag kNegotiatorTag = {0x6e6578757265736aULL, 0x6e65676f74696174ULL};
+
+} // namespace
+
+Napi::Object Negotiator::Init(Napi::Env env, Napi::Object exports) {
+  Napi::HandleScope scope(env);
+
+  Napi::Function func = DefineClass(env, "Negotiator", {
+    InstanceMethod("select", &Negotiator::Select),
+    InstanceMethod("getStats", &Negotiator::GetStats)
+  });
+
+  Napi::FunctionReference* constructor = new Napi::FunctionReference();
+  *constructor = Napi::Persistent(func);
+  exports.Set("Negotiator", func);
+
+  nexurejs::AddCleanupReference(constructor);
+
+  return exports;
+}
+
+// new Negotiator(kind, offers, { cacheSize }) where kind is 'type', 'encoding', 'language' or 'charset'
+Negotiator::Negotiator(const Napi::CallbackInfo& info)
+  : Napi::ObjectWrap<Negotiator>(info), cache_(kDefaultCacheSize) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2 || !info[0].IsString() || !info[1].IsArray()) {
+    Napi::TypeError::New(env, "Expected a negotiation kind and an array of offers").ThrowAsJavaScriptException();
+    return;
+  }
+
+  std::string kind = info[0].As<Napi::String>().Utf8Value();
+  if (kind == "type") {
+    kind_ = HttpNegotiation::Kind::MEDIA_TYPE;
+    headerName_ = "accept";
+  } else if (kind == "encoding") {
+    kind_ = HttpNegotiation::Kind::ENCODING;
+    headerName_ = "accept-encoding";
+  } else if (kind == "language") {
+    kind_ = HttpNegotiation::Kind::LANGUAGE;
+    headerName_ = "accept-language";
+  } else if (kind == "charset") {
+    kind_ = HttpNegotiation::Kind::CHARSET;
+    headerName_ = "accept-charset";
+  } else {
+    Napi::RangeError::New(env, "Negotiation kind must be 'type', 'encoding', 'language' or 'charset'")
+      .ThrowAsJavaScriptException();
+    return;
+  }
+
+  Napi::Array offers = info[1].As<Napi::Array>();
+  uint32_t count = offers.Length();
+  offerValues_.reserve(count);
+  for (uint32_t i = 0; i < count; i++) {
+    Napi::Value offer = offers.Get(i);
+    if (!offer.IsString()) {
+      Napi::TypeError::New(env, "Offers must be strings").ThrowAsJavaScriptException();
+      return;
+    }
+    offerValues_.push_back(offer.As<Napi::String>().Utf8Value());
+  }
+
+  // Ranges point into offerValues_, which no longer changes
+  for (size_t i = 0; i < offerValues_.size(); i++) {
+    HttpNegotiation::Range range;
+    if (HttpNegotiation::ParseRange(kind_, HttpCookie::TrimCookieSpace(offerValues_[i]), true,
+                                    offers_.params, range)) {
+      offers_.ranges.push_back(range);
+      offerIndex_.push_back(static_cast<int>(i));
+    }
+  }
+
+  if (info.Length() > 2 && info[2].IsObject()) {
+    Napi::Object opts = info[2].As<Napi::Object>();
+    if (opts.Has("cacheSize") && opts.Get("cacheSize").IsNumber()) {
+      cache_.SetCapacity(opts.Get("cacheSize").As<Napi::Number>().Uint32Value());
+    }
+  }
+
+  HttpNegotiation::ParseAccept(kind_, HttpNegotiation::DefaultHeader(kind_), scratch_);
+  int selected = HttpNegotiation::SelectOffer(kind_, scratch_, offers_);
+  missingDecision_ = selected < 0 ? -1 : offerIndex_[selected];
+
+  napi_type_tag_object(env, info.This(), &kNegotiatorTag);
+}
+
+Negotiator* Negotiator::FromValue(const Napi::Value& value) {
+  if (!value.IsObject()) {
+    return nullptr;
+  }
+  bool tagged = false;
+  if (napi_check_object_type_tag(value.Env(), value, &kNegotiatorTag, &tagged) != napi_ok || !tagged) {
+    return nullptr;
+  }
+  return Unwrap(value.As<Napi::Object>());
+}
+
+int Negotiator::Select(std::string_view header, bool present) {
+  if (!present) {
+    return missingDecision_;
+  }
+
+  int decision;
+  bool cacheable = header.size() <= kMaxCachedHeaderLength;
+  if (cacheable && cache_.Find(header, decision)) {
+    return decision;
+  }
+
+  HttpNegotiation::ParseAccept(kind_, header, scratch_);
+  int selected = HttpNegotiation::SelectOffer(kind_, scratch_, offers_);
+  decision = selected < 0 ? -1 : offerIndex_[selected];
+
+  if (cacheable) {
+    cache_.Insert(header, decision);
+  }
+  return decision;
+}
+
+// select(header: string | Buffer | undefined) -> offer index, or -1 if nothing is acceptable
+Napi::Value Negotiator::Select(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || info[0].IsUndefined() || info[0].IsNull()) {
+    return Napi::Number::New(env, Select(std::string_view(), false));
+  }
+  if (info[0].IsBuffer()) {
+    Napi::Buffer<char> buffer = info[0].As<Napi::Buffer<char>>();
+    return Napi::Number::New(env, Select(std::string_view(buffer.Data(), buffer.Length()), true));
+  }
+  if (!info[0].IsString()) {
+    Napi::TypeError::New(env, "Header value must be a string or Buffer").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  std::string header = info[0].As<Napi::String>().Utf8Value();
+  return Napi::Number::New(env, Select(header, true));
+}
+
+Napi::Value Negotiator::GetStats(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  Napi::Object stats = Napi::Object::New(env);
+  stats.Set("capacity", Napi::Number::New(env, static_cast<double>(cache_.Capacity())));
+  stats.Set("size", Napi::Number::New(env, static_cast<double>(cache_.Size())));
+  stats.Set("hits", Napi::Number::New(env, static_cast<double>(cache_.Hits())));
+  stats.Set("misses", Napi::Number::New(env, static_cast<double>(cache_.Misses())));
+  return stats;
+}
@@ -0,0 +1,50 @@
+#ifndef HTTP_NEGOTIATOR_H
+#define HTTP_NEGOTIATOR_H
+
+#include <napi.h>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "negotiation.h"
+
+namespace nexurejs {
+  // Forward declaration
+  void AddCleanupReference(Napi::FunctionReference* ref);
+}
+
+/**
+ * Content negotiator for one kind of Accept header and a fixed list of offers
+ *
+ * Offers are parsed once at construction. Each distinct header value is
+ * negotiated once and the chosen offer index kept in an LRU, since clients
+ * send the same few Accept strings over and over.
+ */
+class Negotiator : public Napi::ObjectWrap<Negotiator> {
+public:
+  static Napi::Object Init(Napi::Env env, Napi::Object exports);
+  Negotiator(const Napi::CallbackInfo& info);
+
+  // The Negotiator behind a JS value, or nullptr if it is not one
+  static Negotiator* FromValue(const Napi::Value& value);
+
+  // Offer index chosen for a header value, or -1; `present` is false when the request has none
+  int Select(std::string_view header, bool present);
+
+  // Lowercase name of the request header this negotiator reads
+  const std::string& HeaderName() const { return headerName_; }
+
+private:
+  Napi::Value Select(const Napi::CallbackInfo& info);
+  Napi::Value GetStats(const Napi::CallbackInfo& info);
+
+  HttpNegotiation::Kind kind_ = HttpNegotiation::Kind::MEDIA_TYPE;
+  std::string headerName_;
+  std::vector<std::string> offerValues_;
+  HttpNegotiation::ParsedHeader offers_;
+  std::vector<int> offerIndex_;          // Parsed range -> position in offerValues_
+  HttpNegotiation::ParsedHeader scratch_;
+  HttpNegotiation::DecisionCache cache_;
+  int missingDecision_ = -1;
+};
+
+#endif // HTTP_NEGOTIATOR_H
@@ -10,10 +10,13 @@ import { fileURLToPath, URL, URLSearchParams } from 'node:url';
 import { performance } from 'node:perf_hooks';
 import { Server as HttpServer } from 'node:http';
 import { EventEmitter } from 'node:events';
+import { Readable } from 'node:stream';
 import { createRequire } from 'node:module';
 import { loadNativeBinding as safeLoadNativeBinding } from './loader.js';
 import { JsHttpParser } from '../http/index.js';
 import { JsRadixRouter } from '../routing/js-router.js';
+import { encodeBinary, decodeBinary, type BinaryFormat } from '../serialization/binary-codec.js';
+import { applyPatch as applyPatchJs, type PatchType } from '../serialization/json-patch.js';
 import type {
   HttpParseResult,
   NativeHttpParser,
@@ -355,6 +358,123 @@ function initializeNativeModuleStatus(): void {
   }
 }
 
+/**
+ * Set-Cookie attributes accepted by HttpParser.serializeCookie
+ */
+export interface CookieSerializeOptions {
+  /** Percent-encode the value like encodeURIComponent (default true) */
+  encode?: boolean;
+  maxAge?: number;
+  domain?: string;
+  path?: string;
+  expires?: Date | number;
+  httpOnly?: boolean;
+  secure?: boolean;
+  partitioned?: boolean;
+  priority?: 'low' | 'medium' | 'high' | 'Low' | 'Medium' | 'High';
+  sameSite?: boolean | 'strict' | 'lax' | 'none' | 'Strict' | 'Lax' | 'None';
+}
+
+const COOKIE_NAME = /^[!#$%&'*+\-.^_`|~0-9A-Za-z]+$/;
+const COOKIE_VALUE = /^("?)[\u0021\u0023-\u002B\u002D-\u003A\u003C-\u005B\u005D-\u007E]*\1$/;
+const COOKIE_DOMAIN = /^\.?[a-z0-9]([a-z0-9-]{0,61}[a-z0-9])?(\.[a-z0-9]([a-z0-9-]{0,61}[a-z0-9])?)*$/i;
+const COOKIE_PATH = /^[\u0020-\u003A\u003D-\u007E]*$/;
+
+/**
+ * Visit the name=value pairs of a Cookie header until the visitor returns false
+ */
+function forEachCookie(header: string, visit: (name: string, raw: string) => boolean): void {
+  for (const pair of header.split(';')) {
+    const eq = pair.indexOf('=');
+    if (eq === -1) {
+      continue;
+    }
+    let raw = pair.slice(eq + 1).replace(/^[ \t]+|[ \t]+$/g, '');
+    if (raw.length >= 2 && raw[0] === '"' && raw[raw.length - 1] === '"') {
+      raw = raw.slice(1, -1);
+    }
+    if (!visit(pair.slice(0, eq).replace(/^[ \t]+|[ \t]+$/g, ''), raw)) {
+      return;
+    }
+  }
+}
+
+function decodeCookieValue(raw: string): string {
+  if (!raw.includes('%')) {
+    return raw;
+  }
+  try {
+    return decodeURIComponent(raw);
+  } catch {
+    return raw;
+  }
+}
+
+/**
+ * JavaScript fallback for HttpParser.serializeCookie, with the same validation
+ */
+function serializeCookieFallback(name: string, value: string, options: CookieSerializeOptions): string {
+  if (!COOKIE_NAME.test(name)) {
+    throw new TypeError('argument name is invalid');
+  }
+  const encoded = options.encode === false ? value : encodeURIComponent(value);
+  if (!COOKIE_VALUE.test(encoded)) {
+    throw new TypeError('argument val is invalid');
+  }
+  let cookie = `${name}=${encoded}`;
+
+  if (options.maxAge !== undefined) {
+    if (typeof options.maxAge !== 'number' || !Number.isFinite(options.maxAge)) {
+      throw new TypeError('option maxAge is invalid');
+    }
+    cookie += `; Max-Age=${Math.floor(options.maxAge)}`;
+  }
+  if (options.domain) {
+    if (!COOKIE_DOMAIN.test(options.domain)) {
+      throw new TypeError('option domain is invalid');
+    }
+    cookie += `; Domain=${options.domain}`;
+  }
+  if (options.path) {
+    if (!COOKIE_PATH.test(options.path)) {
+      throw new TypeError('option path is invalid');
+    }
+    cookie += `; Path=${options.path}`;
+  }
+  if (options.expires !== undefined) {
+    const expires = new Date(options.expires as number);
+    const year = expires.getUTCFullYear();
+    if (!(year >= 0 && year <= 9999)) {
+      throw new TypeError('option expires is invalid');
+    }
+    cookie += `; Expires=${expires.toUTCString()}`;
+  }
+  if (options.httpOnly) {
+    cookie += '; HttpOnly';
+  }
+  if (options.secure) {
+    cookie += '; Secure';
+  }
+  if (options.partitioned) {
+    cookie += '; Partitioned';
+  }
+  if (options.priority !== undefined) {
+    const priority = String(options.priority).toLowerCase();
+    if (priority !== 'low' && priority !== 'medium' && priority !== 'high') {
+      throw new TypeError('option priority is invalid');
+    }
+    cookie += `; Priority=${priority[0].toUpperCase()}${priority.slice(1)}`;
+  }
+  if (options.sameSite !== undefined && options.sameSite !== false) {
+    const sameSite = options.sameSite === true ? 'strict' : String(options.sameSite).toLowerCase();
+    if (sameSite !== 'strict' && sameSite !== 'lax' && sameSite !== 'none') {
+      throw new TypeError('option sameSite is invalid');
+    }
+    cookie += `; SameSite=${sameSite[0].toUpperCase()}${sameSite.slice(1)}`;
+  }
+  return cookie;
+}
+
 /**
  * HTTP Parser class that automatically chooses between native and JS implementations
  */
@@ -362,6 +482,8 @@ export class HttpParser implements NativeHttpParser {
   private parser: any;
   private useNative: boolean;
   private jsParser: JsHttpParser | null = null;
+  // Headers of the last request parsed by the JS fallback, for cookie and Accept* lookups
+  private jsHeaders: Record<string, string> = {};
 
   // Performance metrics
   private static jsParseTime = 0;
@@ -405,6 +527,7 @@ export class HttpParser implements NativeHttpParser {
       HttpParser.nativeParseCount++;
     } else if (this.jsParser) {
       result = this.jsParser.parse(buffer);
+      this.jsHeaders = result.headers;
       HttpParser.jsParseTime += performance.now() - start;
       HttpParser.jsParseCount++;
     } else {
@@ -423,7 +546,8 @@ export class HttpParser implements NativeHttpParser {
     if (this.useNative && this.parser) {
       return this.parser.parseHeaders(buffer);
     } else if (this.jsParser) {
-      return this.jsParser.parseHeaders(buffer);
+      this.jsHeaders = this.jsParser.parseHeaders(buffer);
+      return this.jsHeaders;
     }
     throw new Error('No HTTP parser implementation available');
   }
@@ -443,10 +567,74 @@ export class HttpParser implements NativeHttpParser {
     throw new Error('No HTTP parser implementation available');
   }
 
+  /**
+   * Decoded value of one cookie from the last parsed request.
+   * The native parser scans the raw Cookie header for the name and decodes only that value.
+   * @param name Cookie name
+   * @returns The cookie value, or undefined if the request did not send it
+   */
+  getCookie(name: string): string | undefined {
+    if (this.useNative && this.parser) {
+      return this.parser.getCookie(name);
+    }
+    let value: string | undefined;
+    forEachCookie(this.jsHeaders.cookie ?? '', (cookieName, raw) => {
+      if (cookieName === name) {
+        value = decodeCookieValue(raw);
+      }
+      return value === undefined;
+    });
+    return value;
+  }
+
+  /**
+   * All cookies of the last parsed request; the first of repeated names wins
+   */
+  getCookies(): Record<string, string> {
+    if (this.useNative && this.parser) {
+      return this.parser.getCookies();
+    }
+    const cookies: Record<string, string> = {};
+    forEachCookie(this.jsHeaders.cookie ?? '', (name, raw) => {
+      if (name !== '__proto__' && !Object.prototype.hasOwnProperty.call(cookies, name)) {
+        cookies[name] = decodeCookieValue(raw);
+      }
+      return true;
+    });
+    return cookies;
+  }
+
+  /**
+   * Pick the best offer of a negotiator for the matching Accept* header of the last parsed request
+   * @param negotiator Negotiator for Accept, Accept-Encoding, Accept-Language or Accept-Charset
+   * @returns The chosen offer, or undefined if none is acceptable
+   */
+  negotiate(negotiator: ContentNegotiator): string | undefined {
+    if (this.useNative && this.parser && negotiator.nativeHandle) {
+      return negotiator.offers[this.parser.negotiate(negotiator.nativeHandle)];
+    }
+    return negotiator.select(this.jsHeaders[negotiator.headerName]);
+  }
+
+  /**
+   * Serialize a Set-Cookie header value.
+   * @param name Cookie name (an RFC 7230 token)
+   * @param value Cookie value, percent-encoded unless options.encode is false
+   * @param options Cookie attributes
+   * @throws TypeError if the name, value or an attribute cannot be sent
+   */
+  static serializeCookie(name: string, value: string, options: CookieSerializeOptions = {}): string {
+    if (nativeBinding && nativeBinding.HttpParser?.serializeCookie) {
+      return nativeBinding.HttpParser.serializeCookie(name, value, options);
+    }
+    return serializeCookieFallback(name, value, options);
+  }
+
   /**
    * Reset the parser state
    */
   reset(): void {
+    this.jsHeaders = {};
     if (this.useNative && this.parser) {
       this.parser.reset();
     } else if (this.jsParser) {
@@ -483,6 +671,206 @@ export class HttpParser implements NativeHttpParser {
   }
 }
 
+/**
+ * What a ContentNegotiator chooses: media type, content coding, language or charset
+ */
+export type NegotiationKind = 'type' | 'encoding' | 'language' | 'charset';
+
+const NEGOTIATION_HEADERS: Record<NegotiationKind, string> = {
+  type: 'accept',
+  encoding: 'accept-encoding',
+  language: 'accept-language',
+  charset: 'accept-charset'
+};
+
+interface NegotiationRange {
+  primary: string;
+  secondary: string;
+  params: Array<[string, string]>;
+  q: number;
+}
+
+/**
+ * Parse one Accept* element (or offer) for the JS fallback; null for elements to ignore
+ */
+function parseNegotiationRange(kind: NegotiationKind, element: string, isOffer: boolean): NegotiationRange | null {
+  const parts = element.split(';').map(part => part.trim());
+  const range: NegotiationRange = { primary: parts[0], secondary: '', params: [], q: 1 };
+  for (let i = 1; i < parts.length; i++) {
+    const eq = parts[i].indexOf('=');
+    if (eq === -1) {
+      continue;
+    }
+    const name = parts[i].slice(0, eq).trim().toLowerCase();
+    const value = parts[i].slice(eq + 1).trim().replace(/^"(.*)"$/, '$1');
+    if (!isOffer && name === 'q') {
+      if (!/^\d+(\.\d*)?$/.test(value) || Number(value) > 1) {
+        return null;
+      }
+      range.q = Number(value);
+      break;
+    }
+    range.params.push([name, value.toLowerCase()]);
+  }
+  range.primary = range.primary.toLowerCase();
+  if (!range.primary) {
+    return null;
+  }
+  if (kind === 'type') {
+    const slash = range.primary.indexOf('/');
+    if (slash <= 0 || slash === range.primary.length - 1) {
+      return null;
+    }
+    range.secondary = range.primary.slice(slash + 1);
+    range.primary = range.primary.slice(0, slash);
+  } else if (kind === 'language') {
+    range.secondary = range.primary.split('-')[0];
+  }
+  return range;
+}
+
+function negotiationSpecificity(kind: NegotiationKind, accept: NegotiationRange, offer: NegotiationRange): number {
+  if (kind === 'type') {
+    let s = 0;
+    if (accept.primary === offer.primary) {
+      s |= 4;
+    } else if (accept.primary !== '*') {
+      return -1;
+    }
+    if (accept.secondary === offer.secondary) {
+      s |= 2;
+    } else if (accept.secondary !== '*') {
+      return -1;
+    }
+    if (accept.params.length > 0) {
+      const matches = accept.params.every(([name, value]) =>
+        value === '*' || offer.params.some(([offerName, offerValue]) => offerName === name && offerValue === value));
+      if (!matches) {
+        return -1;
+      }
+      s |= 1;
+    }
+    return s;
+  }
+  if (kind === 'language') {
+    if (accept.primary === offer.primary) return 4;
+    if (accept.secondary === offer.primary) return 2;
+    if (accept.primary === offer.secondary) return 1;
+    return accept.primary === '*' ? 0 : -1;
+  }
+  if (accept.primary === offer.primary) {
+    return 1;
+  }
+  return accept.primary === '*' ? 0 : -1;
+}
+
+/**
+ * JavaScript fallback for Negotiator.select: index of the best offer, or -1
+ */
+function selectOfferFallback(kind: NegotiationKind, header: string | undefined, offers: Array<NegotiationRange | null>): number {
+  const source = header ?? (kind === 'encoding' ? '' : kind === 'type' ? '*/*' : '*');
+  const accepted: NegotiationRange[] = [];
+  for (const element of source.split(',')) {
+    const range = parseNegotiationRange(kind, element.trim(), false);
+    if (range) {
+      accepted.push(range);
+    }
+  }
+  if (kind === 'encoding' && !accepted.some(range => range.primary === 'identity' || range.primary === '*')) {
+    const minQ = accepted.reduce((min, range) => Math.min(min, range.q || 1), 1);
+    accepted.push({ primary: 'identity', secondary: '', params: [], q: minQ });
+  }
+
+  let best = -1;
+  let bestQ = 0;
+  let bestS = -1;
+  let bestOrder = 0;
+  offers.forEach((offer, i) => {
+    if (!offer) {
+      return;
+    }
+    let s = -1;
+    let q = 0;
+    let order = 0;
+    accepted.forEach((accept, o) => {
+      const spec = negotiationSpecificity(kind, accept, offer);
+      if (spec > s || (spec === s && spec >= 0 && accept.q > q)) {
+        s = spec;
+        q = accept.q;
+        order = o;
+      }
+    });
+    if (s < 0 || q <= 0) {
+      return;
+    }
+    if (best < 0 || q > bestQ || (q === bestQ && (s > bestS || (s === bestS && order < bestOrder)))) {
+      best = i;
+      bestQ = q;
+      bestS = s;
+      bestOrder = order;
+    }
+  });
+  return best;
+}
+
+/**
+ * Content negotiation over Accept, Accept-Encoding, Accept-Language or Accept-Charset.
+ * Picks the offer a client prefers by q-value and specificity, like the `negotiator`
+ * package. The native implementation remembers the decision for recently seen header values.
+ */
+export class ContentNegotiator {
+  readonly kind: NegotiationKind;
+  readonly offers: readonly string[];
+  readonly headerName: string;
+  /** @internal Native negotiator, passed to HttpParser.negotiate */
+  readonly nativeHandle: any = null;
+  private jsOffers: Array<NegotiationRange | null> = [];
+
+  /**
+   * @param kind Header to negotiate on
+   * @param offers Values the server can produce, in order of server preference
+   * @param options.cacheSize Header values whose decision is remembered (native only, default 64)
+   */
+  constructor(kind: NegotiationKind, offers: string[], options: { cacheSize?: number } = {}) {
+    if (!(kind in NEGOTIATION_HEADERS)) {
+      throw new RangeError("Negotiation kind must be 'type', 'encoding', 'language' or 'charset'");
+    }
+    this.kind = kind;
+    this.offers = [...offers];
+    this.headerName = NEGOTIATION_HEADERS[kind];
+
+    const nativeModule = loadNativeBinding();
+    if (nativeModule?.Negotiator && nativeOptions.enabled) {
+      this.nativeHandle = new nativeModule.Negotiator(kind, this.offers, options);
+    } else {
+      this.jsOffers = this.offers.map(offer => parseNegotiationRange(kind, offer.trim(), true));
+    }
+  }
+
+  /**
+   * Choose the best offer for a request header value
+   * @param header Raw header value, or undefined when the request did not send the header
+   * @returns The chosen offer, or undefined if none is acceptable (a 406 for Accept)
+   */
+  select(header: string | Buffer | undefined): string | undefined {
+    if (this.nativeHandle) {
+      return this.offers[this.nativeHandle.select(header)];
+    }
+    const text = Buffer.isBuffer(header) ? header.toString('latin1') : header;
+    return this.offers[selectOfferFallback(this.kind, text, this.jsOffers)];
+  }
+
+  /**
+   * Decision cache statistics; all zero without the native implementation
+   */
+  getStats(): { capacity: number; size: number; hits: number; misses: number } {
+    if (this.nativeHandle) {
+      return this.nativeHandle.getStats();
+    }
+    return { capacity: 0, size: 0, hits: 0, misses: 0 };
+  }
+}
+
 /**
  * Radix Router Interface
  */
@@ -638,12 +1026,164 @@ export class RadixRouter {
   }
 }
 
+/**
+ * Schema accepted by JsonProcessor.compileSerializer (JSON Schema subset)
+ */
+export interface SerializerSchema {
+  type?: string | string[];
+  nullable?: boolean;
+  properties?: Record<string, SerializerSchema>;
+  required?: string[];
+  items?: SerializerSchema;
+}
+
+/**
+ * Serializer compiled from a schema
+ */
+export interface CompiledSerializer {
+  stringify(value: any): string;
+  stringifyToBuffer(value: any): Buffer;
+}
+
+/**
+ * Project a value onto a serializer schema (JS fallback for compiled serializers)
+ */
+function projectBySchema(schema: SerializerSchema, value: any): any {
+  const types = Array.isArray(schema.type) ? schema.type.filter(t => t !== 'null') : [schema.type];
+  const type = types.length === 1 ? types[0] : undefined;
+
+  if (value === null || value === undefined) {
+    // Scalars that cannot be null get their type's empty value, as in the native writer
+    const nullable = schema.nullable === true || (Array.isArray(schema.type) && schema.type.includes('null'));
+    if (nullable) {
+      return null;
+    }
+    switch (type) {
+      case 'string':
+        return '';
+      case 'number':
+      case 'integer':
+        return 0;
+      case 'boolean':
+        return false;
+      default:
+        return null;
+    }
+  }
+
+  switch (type) {
+    case 'string':
+      return typeof value === 'string' ? value : String(value);
+    case 'number':
+      return Number(value);
+    case 'integer':
+      return Math.trunc(Number(value));
+    case 'boolean':
+      return Boolean(value);
+    case 'null':
+      return null;
+    case 'array':
+      return Array.isArray(value) && schema.items
+        ? value.map(item => projectBySchema(schema.items!, item))
+        : value;
+  }
+
+  if (schema.properties && typeof value === 'object' && !Array.isArray(value)) {
+    const result: Record<string, any> = {};
+    for (const [key, propSchema] of Object.entries(schema.properties)) {
+      const propValue = value[key];
+      if (propValue === undefined || typeof propValue === 'function') {
+        if (schema.required?.includes(key)) {
+          throw new Error(`"${key}" is required!`);
+        }
+        continue;
+      }
+      result[key] = projectBySchema(propSchema, propValue);
+    }
+    return result;
+  }
+
+  return value;
+}
+
+/**
+ * How integers outside the JS safe range are returned by JsonProcessor.parse
+ * - number: lossy double, as JSON.parse (default)
+ * - bigint: exact BigInt
+ * - string: exact decimal string
+ */
+export type BigIntMode = 'number' | 'bigint' | 'string';
+
+/**
+ * JsonProcessor options
+ */
+export interface JsonProcessorOptions {
+  bigIntMode?: BigIntMode;
+  /** Documents of at least this many bytes are parsed off the JS thread by parseAsync (default 1MB) */
+  asyncThreshold?: number;
+  /** Output buffers grown past this many bytes are shrunk back after each call (default 1MB) */
+  maxBufferSize?: number;
+  /** Parsers grown past this many bytes are dropped after use (default 16MB) */
+  maxParserCapacity?: number;
+  /** Calls without a large document before idle large parsers are released (default 64) */
+  parserIdleCalls?: number;
+}
+
+/**
+ * JSON.parse that keeps large integers exact (JS fallback for bigIntMode)
+ * Relies on the reviver source-text context where the runtime provides it.
+ */
+function parseJsonText(text: string, bigIntMode: BigIntMode): any {
+  // Only documents containing 16+ digit runs can hold unsafe integers
+  if (bigIntMode === 'number' || !/\d{16}/.test(text)) {
+    return JSON.parse(text);
+  }
+
+  return JSON.parse(text, (_key: string, value: any, context?: { source?: string }) => {
+    if (
+      typeof value === 'number' &&
+      !Number.isSafeInteger(value) &&
+      context?.source !== undefined &&
+      /^-?\d+$/.test(context.source)
+    ) {
+      return bigIntMode === 'bigint' ? BigInt(context.source) : context.source;
+    }
+    return value;
+  });
+}
+
+/**
+ * JSON.stringify for decoded MessagePack/CBOR values, writing BigInts as exact
+ * decimals the way the native transcoder does
+ */
+function stringifyDecoded(value: any): string | undefined {
+  if (typeof value === 'bigint') {
+    return value.toString();
+  }
+  if (Array.isArray(value)) {
+    return `[${value.map(item => stringifyDecoded(item) ?? 'null').join(',')}]`;
+  }
+  if (value === null || typeof value !== 'object' || Buffer.isBuffer(value) || value instanceof Date) {
+    return JSON.stringify(value);
+  }
+
+  const fields: string[] = [];
+  for (const key of Object.keys(value)) {
+    const text = stringifyDecoded(value[key]);
+    if (text !== undefined) {
+      fields.push(`${JSON.stringify(key)}:${text}`);
+    }
+  }
+  return `{${fields.join(',')}}`;
+}
+
 /**
  * JSON Processor Interface
  */
 export class JsonProcessor {
   private processor: any;
   private useNative: boolean;
+  private bigIntMode: BigIntMode;
 
   // Performance metrics
   private static jsParseTime = 0;
@@ -655,13 +1195,20 @@ export class JsonProcessor {
   private static nativeStringifyTime = 0;
   private static nativeStringifyCount = 0;
 
-  constructor() {
+  constructor(options: JsonProcessorOptions = {}) {
     const nativeModule = loadNativeBinding();
     this.useNative = Boolean(nativeModule?.JsonProcessor && nativeOptions.enabled);
+    this.bigIntMode = options.bigIntMode ?? 'number';
 
     if (this.useNative) {
       try {
-        this.processor = new nativeModule.JsonProcessor();
+        this.processor = new nativeModule.JsonProcessor({
+          bigIntMode: this.bigIntMode,
+          asyncThreshold: options.asyncThreshold,
+          maxBufferSize: options.maxBufferSize,
+          maxParserCapacity: options.maxParserCapacity,
+          parserIdleCalls: options.parserIdleCalls
+        });
       } catch (err: any) {
         if (nativeOptions.verbose) {
           Logger.warn(`Failed to create native JSON processor: ${err.message}`);
@@ -690,7 +1237,40 @@ export class JsonProcessor {
       JsonProcessor.nativeParseCount++;
     } else {
       // JavaScript fallback implementation
-      result = JSON.parse(typeof json === 'string' ? json : json.toString());
+      result = parseJsonText(typeof json === 'string' ? json : json.toString(), this.bigIntMode);
+      JsonProcessor.jsParseTime += performance.now() - start;
+      JsonProcessor.jsParseCount++;
+    }
+
+    return result;
+  }
+
+  /**
+   * Parse JSON without blocking the event loop
+   * Documents at or above the native async threshold (default 1 MB, see asyncThreshold)
+   * are parsed on the libuv thread pool; NDJSON input is split across pool tasks on
+   * line boundaries, and each line must hold exactly one value.
+   * @param json JSON string or buffer
+   * @param options ndjson parses newline-delimited documents into an array; threads caps parallelism
+   * @returns Promise of the parsed JavaScript value
+   */
+  async parseAsync(
+    json: string | Buffer,
+    options: { ndjson?: boolean; threads?: number } = {}
+  ): Promise<any> {
+    const start = performance.now();
+    let result: any;
+
+    if (this.useNative && this.processor?.parseAsync) {
+      result = await this.processor.parseAsync(json, options);
+      JsonProcessor.nativeParseTime += performance.now() - start;
+      JsonProcessor.nativeParseCount++;
+    } else {
+      // JavaScript fallback implementation
+      const text = typeof json === 'string' ? json : json.toString();
+      result = options.ndjson
+        ? text.split('\n').filter(line => line.trim()).map(line => parseJsonText(line, this.bigIntMode))
+        : parseJsonText(text, this.bigIntMode);
       JsonProcessor.jsParseTime += performance.now() - start;
       JsonProcessor.jsParseCount++;
     }
@@ -722,65 +1302,340 @@ export class JsonProcessor {
   }
 
   /**
-   * Parse a JSON stream
-   * @param buffer Buffer containing JSON data
-   * @returns Array of parsed objects
+   * Set how integers beyond Number.MAX_SAFE_INTEGER are returned by parse
+   * @param mode 'number' (lossy), 'bigint' or 'string'
    */
-  parseStream(buffer: Buffer): any[] {
-    if (this.useNative && this.processor) {
-      return this.processor.parseStream(buffer);
-    } else {
-      // Simple JavaScript fallback implementation
-      const jsonStr = buffer.toString();
-      const jsonLines = jsonStr.split('\n').filter(line => line.trim());
-      return jsonLines.map(line => JSON.parse(line));
+  setBigIntMode(mode: BigIntMode): void {
+    this.bigIntMode = mode;
+    if (this.useNative && this.processor?.setBigIntMode) {
+      this.processor.setBigIntMode(mode);
     }
   }
 
   /**
-   * Stringify multiple values for streaming
-   * @param values Array of values to stringify
-   * @returns JSON string with newlines between values
+   * Get the large integer policy
    */
-  stringifyStream(values: any[]): string {
-    if (this.useNative && this.processor) {
-      return this.processor.stringifyStream(values);
-    } else {
-      // JavaScript fallback implementation
-      return values.map(v => JSON.stringify(v)).join('\n');
+  getBigIntMode(): BigIntMode {
+    return this.bigIntMode;
+  }
+
+  /**
+   * Set the document size above which parseAsync parses on the thread pool
+   * @param bytes Threshold in bytes; 0 sends every document off-thread
+   * @returns The threshold now in effect (0 without the native module)
+   */
+  setAsyncThreshold(bytes: number): number {
+    if (this.useNative && this.processor?.setAsyncThreshold) {
+      return this.processor.setAsyncThreshold(bytes);
     }
+    return 0;
   }
 
   /**
-   * Get performance metrics for JSON processing
-   * @returns Performance metrics
+   * Compile a schema into a serializer for fixed-shape values
+   * @param schema JSON schema describing the value
+   * @returns Serializer with precomputed field order and typed writers
    */
-  static getPerformanceMetrics(): {
-    jsParseTime: number;
-    jsParseCount: number;
-    jsStringifyTime: number;
-    jsStringifyCount: number;
-    nativeParseTime: number;
-    nativeParseCount: number;
-    nativeStringifyTime: number;
-    nativeStringifyCount: number;
-  } {
+  compileSerializer(schema: SerializerSchema): CompiledSerializer {
+    if (this.useNative && this.processor?.compileSerializer) {
+      const serializer = this.processor.compileSerializer(schema);
+      return {
+        stringify: (value: any): string => {
+          const start = performance.now();
+          const result = serializer.stringify(value);
+          JsonProcessor.nativeStringifyTime += performance.now() - start;
+          JsonProcessor.nativeStringifyCount++;
+          return result;
+        },
+        stringifyToBuffer: (value: any): Buffer => serializer.stringifyToBuffer(value)
+      };
+    }
+
+    // JavaScript fallback implementation
     return {
-      jsParseTime: JsonProcessor.jsParseTime,
-      jsParseCount: JsonProcessor.jsParseCount,
-      jsStringifyTime: JsonProcessor.jsStringifyTime,
-      jsStringifyCount: JsonProcessor.jsStringifyCount,
-      nativeParseTime: JsonProcessor.nativeParseTime,
-      nativeParseCount: JsonProcessor.nativeParseCount,
-      nativeStringifyTime: JsonProcessor.nativeStringifyTime,
-      nativeStringifyCount: JsonProcessor.nativeStringifyCount
+      stringify: (value: any): string => {
+        const start = performance.now();
+        const result = JSON.stringify(projectBySchema(schema, value));
+        JsonProcessor.jsStringifyTime += performance.now() - start;
+        JsonProcessor.jsStringifyCount++;
+        return result;
+      },
+      stringifyToBuffer: (value: any): Buffer =>
+        Buffer.from(JSON.stringify(projectBySchema(schema, value)))
     };
   }
 
   /**
-   * Reset performance metrics
+   * Stringify a value into fixed-size Buffer chunks, produced on demand
+   * @param value Value to stringify
+   * @param options chunkSize in bytes (default 64 KB, at least 1 KB); ndjson writes a top-level array as lines
+   * @returns Iterator over the output chunks
    */
-  static resetPerformanceMetrics(): void {
+  *stringifyChunks(
+    value: any,
+    options: { chunkSize?: number; ndjson?: boolean } = {}
+  ): Generator<Buffer, void, undefined> {
+    // Chunks are never smaller than 1 KB, as in the native cursor
+    const chunkSize = Math.max(Math.trunc(options.chunkSize ?? 64 * 1024) || 0, 1024);
+
+    if (this.useNative && this.processor?.createStringifyCursor) {
+      const cursor = this.processor.createStringifyCursor(value, { chunkSize, ndjson: options.ndjson });
+      let chunk: Buffer | null;
+      while ((chunk = cursor.next()) !== null) {
+        yield chunk;
+      }
+      return;
+    }
+
+    // JavaScript fallback implementation (output is built in one piece)
+    const output = Buffer.from(
+      options.ndjson && Array.isArray(value)
+        ? value.map(v => JSON.stringify(v)).join('\n')
+        : JSON.stringify(value)
+    );
+    for (let offset = 0; offset < output.length; offset += chunkSize) {
+      yield output.subarray(offset, offset + chunkSize);
+    }
+  }
+
+  /**
+   * Create a readable stream of JSON output that respects backpressure
+   * @param value Value to stringify
+   * @param options chunkSize in bytes (default 64 KB, at least 1 KB); ndjson writes a top-level array as lines
+   * @returns Readable stream, chunks are serialized only when the consumer pulls them
+   */
+  createStringifyStream(
+    value: any,
+    options: { chunkSize?: number; ndjson?: boolean } = {}
+  ): Readable {
+    const chunks = this.stringifyChunks(value, options);
+
+    return new Readable({
+      read(): void {
+        try {
+          const next = chunks.next();
+          this.push(next.done ? null : next.value);
+        } catch (err: any) {
+          this.destroy(err);
+        }
+      }
+    });
+  }
+
+  /**
+   * Encode a value as MessagePack or CBOR
+   * @param value Value to encode
+   * @param format Binary format (default msgpack)
+   * @returns Encoded bytes
+   */
+  encode(value: any, format: BinaryFormat = 'msgpack'): Buffer {
+    if (this.useNative && this.processor?.encode) {
+      return this.processor.encode(value, format);
+    }
+    return encodeBinary(value, format);
+  }
+
+  /**
+   * Decode a MessagePack or CBOR buffer
+   * @param buffer Encoded bytes
+   * @param format Binary format (default msgpack)
+   * @returns Decoded value
+   */
+  decode(buffer: Buffer, format: BinaryFormat = 'msgpack'): any {
+    if (this.useNative && this.processor?.decode) {
+      return this.processor.decode(buffer, format);
+    }
+    return decodeBinary(buffer, format);
+  }
+
+  /**
+   * Transcode JSON text to MessagePack or CBOR without building JS objects
+   * @param input JSON text
+   * @param format Binary format (default msgpack)
+   * @returns Encoded bytes
+   */
+  jsonToBinary(input: string | Buffer, format: BinaryFormat = 'msgpack'): Buffer {
+    const method = format === 'cbor' ? 'jsonToCbor' : 'jsonToMsgpack';
+    if (this.useNative && this.processor?.[method]) {
+      return this.processor[method](input);
+    }
+    // Integers beyond 2^53 that fit in 64 bits are encoded exactly, as natively
+    const value = JSON.parse(input.toString(), (_key: string, item: any, context?: { source?: string }) => {
+      if (
+        typeof item === 'number' &&
+        !Number.isSafeInteger(item) &&
+        context?.source !== undefined &&
+        /^-?\d+$/.test(context.source)
+      ) {
+        const exact = BigInt(context.source);
+        if (exact >= -(2n ** 63n) && exact < 2n ** 64n) {
+          return exact;
+        }
+      }
+      return item;
+    });
+    return encodeBinary(value, format);
+  }
+
+  /**
+   * Transcode MessagePack or CBOR to JSON text without building JS objects
+   * @param buffer Encoded bytes
+   * @param format Binary format (default msgpack)
+   * @returns JSON text as UTF-8 bytes
+   */
+  binaryToJson(buffer: Buffer, format: BinaryFormat = 'msgpack'): Buffer {
+    const method = format === 'cbor' ? 'cborToJson' : 'msgpackToJson';
+    if (this.useNative && this.processor?.[method]) {
+      return this.processor[method](buffer);
+    }
+    const text = stringifyDecoded(decodeBinary(buffer, format));
+    if (text === undefined) {
+      throw new Error('undefined is not representable as JSON');
+    }
+    return Buffer.from(text);
+  }
+
+  /**
+   * Transcode JSON text to MessagePack
+   */
+  jsonToMsgpack(input: string | Buffer): Buffer {
+    return this.jsonToBinary(input, 'msgpack');
+  }
+
+  /**
+   * Transcode MessagePack to JSON text
+   */
+  msgpackToJson(buffer: Buffer): Buffer {
+    return this.binaryToJson(buffer, 'msgpack');
+  }
+
+  /**
+   * Apply a JSON Patch (RFC 6902) or Merge Patch (RFC 7396) to a JSON document
+   * Only the parts of the document the patch touches are materialized natively;
+   * the result is serialized once.
+   * @param document JSON text of the target document
+   * @param patch JSON text of the patch
+   * @param options type: 'auto' (default; arrays are JSON Patch), 'json-patch' or 'merge-patch'
+   * @returns Patched document as JSON bytes
+   */
+  applyPatch(
+    document: string | Buffer,
+    patch: string | Buffer,
+    options: { type?: PatchType } = {}
+  ): Buffer {
+    if (this.useNative && this.processor?.applyPatch) {
+      return this.processor.applyPatch(document, patch, options);
+    }
+
+    // JavaScript fallback implementation
+    const result = applyPatchJs(
+      JSON.parse(document.toString()),
+      JSON.parse(patch.toString()),
+      options.type
+    );
+    return Buffer.from(JSON.stringify(result));
+  }
+
+  /**
+   * Parse a JSON stream
+   * @param buffer Buffer containing JSON data
+   * @returns Array of parsed objects
+   */
+  parseStream(buffer: Buffer): any[] {
+    if (this.useNative && this.processor) {
+      return this.processor.parseStream(buffer);
+    } else {
+      // Simple JavaScript fallback implementation
+      const jsonStr = buffer.toString();
+      const jsonLines = jsonStr.split('\n').filter(line => line.trim());
+      return jsonLines.map(line => JSON.parse(line));
+    }
+  }
+
+  /**
+   * Stringify multiple values for streaming
+   * @param values Array of values to stringify
+   * @returns JSON string with newlines between values
+   */
+  stringifyStream(values: any[]): string {
+    if (this.useNative && this.processor) {
+      return this.processor.stringifyStream(values);
+    } else {
+      // JavaScript fallback implementation
+      return values.map(v => JSON.stringify(v)).join('\n');
+    }
+  }
+
+  /**
+   * Get output buffer and parser pool statistics
+   * @returns Buffer and idle parser capacity, retention caps and number of shrinks (zeros for the JS fallback)
+   */
+  getBufferStats(): {
+    outputCapacity: number;
+    maxRetainedSize: number;
+    shrinkCount: number;
+    paddedCapacity: number;
+    parserCount: number;
+    parserCapacity: number;
+    parserInUse: number;
+    maxParserCapacity: number;
+    parserTrimCount: number;
+  } {
+    if (this.useNative && this.processor?.getBufferStats) {
+      return this.processor.getBufferStats();
+    }
+    return {
+      outputCapacity: 0,
+      maxRetainedSize: 0,
+      shrinkCount: 0,
+      paddedCapacity: 0,
+      parserCount: 0,
+      parserCapacity: 0,
+      parserInUse: 0,
+      maxParserCapacity: 0,
+      parserTrimCount: 0
+    };
+  }
+
+  /**
+   * Release native buffers back to their initial size
+   */
+  releaseBuffers(): void {
+    if (this.useNative && this.processor) {
+      this.processor.releaseBuffers();
+    }
+  }
+
+  /**
+   * Get performance metrics for JSON processing
+   * @returns Performance metrics
+   */
+  static getPerformanceMetrics(): {
+    jsParseTime: number;
+    jsParseCount: number;
+    jsStringifyTime: number;
+    jsStringifyCount: number;
+    nativeParseTime: number;
+    nativeParseCount: number;
+    nativeStringifyTime: number;
+    nativeStringifyCount: number;
+  } {
+    return {
+      jsParseTime: JsonProcessor.jsParseTime,
+      jsParseCount: JsonProcessor.jsParseCount,
+      jsStringifyTime: JsonProcessor.jsStringifyTime,
+      jsStringifyCount: JsonProcessor.jsStringifyCount,
+      nativeParseTime: JsonProcessor.nativeParseTime,
+      nativeParseCount: JsonProcessor.nativeParseCount,
+      nativeStringifyTime: JsonProcessor.nativeStringifyTime,
+      nativeStringifyCount: JsonProcessor.nativeStringifyCount
+    };
+  }
+
+  /**
+   * Reset performance metrics
+   */
+  static resetPerformanceMetrics(): void {
     JsonProcessor.jsParseTime = 0;
     JsonProcessor.jsParseCount = 0;
     JsonProcessor.jsStringifyTime = 0;
@@ -792,6 +1647,391 @@ export class JsonProcessor {
   }
 }
 
+/**
+ * URL components in packed span order: span i is (spans[2i], spans[2i + 1]) = (offset, length)
+ */
+export const URL_COMPONENTS = ['protocol', 'auth', 'hostname', 'port', 'pathname', 'search', 'hash'] as const;
+
+export type UrlComponent = typeof URL_COMPONENTS[number];
+
+/**
+ * Locate URL components as (offset, length) spans (JS fallback for UrlParser.parseSpans)
+ */
+function scanUrlSpans(url: string, out: Uint32Array): Uint32Array {
+  out.fill(0);
+  const length = url.length;
+  const set = (component: number, begin: number, end: number): void => {
+    out[component * 2] = begin;
+    out[component * 2 + 1] = end - begin;
+  };
+
+  let pos = 0;
+  let hasProtocol = false;
+  for (let i = 0; i + 2 < length; i++) {
+    const c = url.charCodeAt(i);
+    if (c === 0x3a && url.startsWith('//', i + 1)) {
+      set(0, 0, i);
+      hasProtocol = true;
+      pos = i + 3;
+      break;
+    }
+    if (c === 0x2f || c === 0x3f || c === 0x23) break;
+  }
+
+  if (hasProtocol || url.startsWith('//')) {
+    if (!hasProtocol) pos = 2;
+    let authorityEnd = length;
+    for (let i = pos; i < length; i++) {
+      const c = url.charCodeAt(i);
+      if (c === 0x2f || c === 0x3f || c === 0x23) {
+        authorityEnd = i;
+        break;
+      }
+    }
+
+    let hostStart = pos;
+    const at = url.indexOf('@', pos);
+    if (at !== -1 && at < authorityEnd) {
+      set(1, pos, at);
+      hostStart = at + 1;
+    }
+
+    const colon = url.indexOf(':', hostStart);
+    if (colon !== -1 && colon < authorityEnd) {
+      set(2, hostStart, colon);
+      set(3, colon + 1, authorityEnd);
+    } else {
+      set(2, hostStart, authorityEnd);
+    }
+    pos = authorityEnd;
+  }
+
+  let pathnameEnd = length;
+  for (let i = pos; i < length; i++) {
+    const c = url.charCodeAt(i);
+    if (c === 0x3f || c === 0x23) {
+      pathnameEnd = i;
+      break;
+    }
+  }
+  set(4, pos, pathnameEnd);
+  pos = pathnameEnd;
+
+  if (url.charCodeAt(pos) === 0x3f) {
+    const hash = url.indexOf('#', pos + 1);
+    const searchEnd = hash === -1 ? length : hash;
+    set(5, pos + 1, searchEnd);
+    pos = searchEnd;
+  }
+  if (url.charCodeAt(pos) === 0x23) {
+    set(6, pos + 1, length);
+  }
+  return out;
+}
+
+/**
+ * Lazy view over a parsed URL: components are sliced from the input only when read
+ */
+export class UrlView {
+  constructor(readonly href: string, readonly spans: Uint32Array) {}
+
+  private component(index: number): string {
+    const length = this.spans[index * 2 + 1];
+    if (length === 0) return '';
+    const offset = this.spans[index * 2];
+    return this.href.slice(offset, offset + length);
+  }
+
+  get protocol(): string { return this.component(0); }
+  get auth(): string { return this.component(1); }
+  get hostname(): string { return this.component(2); }
+  get port(): string { return this.component(3); }
+  get pathname(): string { return this.component(4); }
+  get search(): string { return this.component(5); }
+  get hash(): string { return this.component(6); }
+
+  toJSON(): Record<UrlComponent, string> {
+    const result = {} as Record<UrlComponent, string>;
+    URL_COMPONENTS.forEach((name, index) => {
+      result[name] = this.component(index);
+    });
+    return result;
+  }
+}
+
+/**
+ * Build a UrlView over a WHATWG URL's href (JS fallback for UrlParser.parseWhatwg)
+ */
+function urlToView(url: URL): UrlView {
+  const href = url.href;
+  const spans = new Uint32Array(14);
+  const set = (index: number, offset: number, length: number) => {
+    spans[index * 2] = offset;
+    spans[index * 2 + 1] = length;
+  };
+
+  set(0, 0, url.protocol.length - 1);
+  let pos = url.protocol.length;
+  if (href.startsWith('//', pos)) {
+    pos += 2;
+    const auth = url.password ? `${url.username}:${url.password}` : url.username;
+    if (auth) {
+      set(1, pos, auth.length);
+      pos += auth.length + 1;
+    }
+    set(2, pos, url.hostname.length);
+    pos += url.hostname.length;
+    if (url.port) {
+      set(3, pos + 1, url.port.length);
+      pos += url.port.length + 1;
+    }
+  } else if (href.startsWith('/.//', pos)) {
+    pos += 2;
+  }
+
+  set(4, pos, url.pathname.length);
+  pos += url.pathname.length;
+  const hash = href.indexOf('#', pos);
+  if (href.charCodeAt(pos) === 0x3f) {
+    set(5, pos + 1, (hash === -1 ? href.length : hash) - pos - 1);
+  }
+  if (hash !== -1) {
+    set(6, hash + 1, href.length - hash - 1);
+  }
+  return new UrlView(href, spans);
+}
+
+/**
+ * Options for UrlParser.parseBatch
+ */
+export interface UrlBatchOptions {
+  /** Deduplicate hostnames (ASCII case-insensitive) into hostIds/hostnames */
+  hostnames?: boolean;
+  /** Locate raw query parameters into paramIndex/params */
+  params?: boolean;
+  /** Upper bound on threads for large batches (default: CPU count) */
+  threads?: number;
+}
+
+/**
+ * Columnar result of UrlParser.parseBatch. Each component column holds (offset, length)
+ * pairs per URL, with offsets into the batch buffer.
+ */
+export type UrlBatch = { count: number } & Record<UrlComponent, Uint32Array> & {
+  /** Per-URL index into hostnames */
+  hostIds?: Uint32Array;
+  /** Distinct lowercased hostnames */
+  hostnames?: string[];
+  /** URL i owns parameters paramIndex[i] .. paramIndex[i + 1] - 1 */
+  paramIndex?: Uint32Array;
+  /** (keyOffset, keyLength, valueOffset, valueLength) per parameter, undecoded */
+  params?: Uint32Array;
+};
+
+/**
+ * Batch parsing (JS fallback for UrlParser.parseBatch)
+ */
+function parseBatchFallback(buffer: Buffer, offsets: Uint32Array, options: UrlBatchOptions): UrlBatch {
+  const count = offsets.length - 1;
+  const text = buffer.toString('latin1');
+  const storage = new Uint32Array(count * 2 * URL_COMPONENTS.length);
+  const spans = new Uint32Array(14);
+  const hostIds = options.hostnames ? new Uint32Array(count) : undefined;
+  const hostnames: string[] = [];
+  const hostIndex = new Map<string, number>();
+  const paramIndex = options.params ? new Uint32Array(count + 1) : undefined;
+  const params: number[] = [];
+
+  for (let i = 0; i < count; i++) {
+    const start = offsets[i];
+    if (start > offsets[i + 1] || offsets[i + 1] > buffer.length) {
+      throw new RangeError('Offsets must be non-decreasing and within the buffer');
+    }
+    scanUrlSpans(text.slice(start, offsets[i + 1]), spans.fill(0));
+    for (let c = 0; c < URL_COMPONENTS.length; c++) {
+      storage[c * count * 2 + i * 2] = start + spans[c * 2];
+      storage[c * count * 2 + i * 2 + 1] = spans[c * 2 + 1];
+    }
+
+    if (hostIds) {
+      const hostStart = start + spans[4];
+      const host = text.slice(hostStart, hostStart + spans[5]).replace(/[A-Z]+/g, (m) => m.toLowerCase());
+      let id = hostIndex.get(host);
+      if (id === undefined) {
+        id = hostnames.length;
+        hostIndex.set(host, id);
+        hostnames.push(host);
+      }
+      hostIds[i] = id;
+    }
+
+    if (paramIndex) {
+      paramIndex[i] = params.length / 4;
+      const searchStart = start + spans[10];
+      const searchEnd = searchStart + spans[11];
+      let pos = text.charCodeAt(searchStart) === 0x3f && spans[11] > 0 ? searchStart + 1 : searchStart;
+      while (pos < searchEnd) {
+        let end = text.indexOf('&', pos);
+        if (end === -1 || end > searchEnd) end = searchEnd;
+        if (end > pos) {
+          let eq = text.indexOf('=', pos);
+          if (eq === -1 || eq > end) eq = end;
+          const valueStart = eq < end ? eq + 1 : end;
+          params.push(pos, eq - pos, valueStart, end - valueStart);
+        }
+        pos = end + 1;
+      }
+    }
+  }
+
+  const result = { count } as UrlBatch;
+  URL_COMPONENTS.forEach((name, c) => {
+    result[name] = storage.subarray(c * count * 2, (c + 1) * count * 2);
+  });
+  if (hostIds) {
+    result.hostIds = hostIds;
+    result.hostnames = hostnames;
+  }
+  if (paramIndex) {
+    paramIndex[count] = params.length / 4;
+    result.paramIndex = paramIndex;
+    result.params = Uint32Array.from(params);
+  }
+  return result;
+}
+
+export type UrlParamOverrides = Record<string, string | number | boolean | null | undefined>;
+
+/**
+ * Apply query overrides to a URL (JS fallback for UrlParser.buildUrl)
+ */
+function buildUrlFallback(base: string, overrides: UrlParamOverrides): string {
+  const hash = base.indexOf('#');
+  const hashPos = hash === -1 ? base.length : hash;
+  const question = base.indexOf('?');
+  const queryPos = question === -1 || question > hashPos ? hashPos : question;
+  const keys = Object.keys(overrides);
+  const written = new Set<string>();
+  const parts: string[] = [];
+  const encoded = (key: string) => `${encodeURIComponent(key)}=${encodeURIComponent(String(overrides[key]))}`;
+
+  if (queryPos < hashPos) {
+    let query = base.slice(queryPos + 1, hashPos);
+    if (query.startsWith('?')) query = query.slice(1);
+    for (const param of query.split('&')) {
+      if (!param) continue;
+      const eq = param.indexOf('=');
+      const rawKey = eq === -1 ? param : param.slice(0, eq);
+      let key: string;
+      try {
+        key = decodeURIComponent(rawKey.replace(/\+/g, ' '));
+      } catch {
+        key = rawKey;
+      }
+      if (keys.includes(key)) {
+        if (!written.has(key) && overrides[key] != null) parts.push(encoded(key));
+        written.add(key);
+      } else {
+        parts.push(param);
+      }
+    }
+  }
+  for (const key of keys) {
+    if (!written.has(key) && overrides[key] != null) parts.push(encoded(key));
+  }
+
+  return base.slice(0, queryPos) + (parts.length ? `?${parts.join('&')}` : '') + base.slice(hashPos);
+}
+
+/**
+ * Options for UrlParser.parseQuery
+ */
+export interface QueryParseOptions {
+  /** Bracket segments honoured per key, e.g. a[b][c] (default: 5) */
+  depth?: number;
+  /** Parameters past this count are ignored (default: 1000) */
+  parameterLimit?: number;
+  /** Largest explicit index treated as an array slot, e.g. a[20] (default: 20) */
+  arrayLimit?: number;
+}
+
+export type QueryValue = string | QueryValue[] | { [key: string]: QueryValue };
+
+function parseArrayIndex(segment: string, arrayLimit: number): number {
+  if (!/^(0|[1-9]\d{0,9})$/.test(segment)) return -1;
+  const index = Number(segment);
+  return index <= arrayLimit ? index : -1;
+}
+
+/**
+ * Store value under container[segments[i]]...; mirrors the native nested query parser
+ */
+function assignQueryValue(container: any, segments: string[], i: number, value: string, arrayLimit: number): any {
+  const segment = segments[i];
+  const index = segment === '' ? 0 : parseArrayIndex(segment, arrayLimit);
+
+  let key: string | number;
+  if (Array.isArray(container) && index !== -1) {
+    key = segment === '' || index > container.length ? container.length : index;
+  } else {
+    if (Array.isArray(container)) container = Object.assign({}, container);
+    key = segment === '' && i > 0 ? Object.keys(container).length : segment;
+  }
+
+  const exists = Object.prototype.hasOwnProperty.call(container, key);
+  if (i + 1 === segments.length) {
+    const existing = container[key];
+    container[key] = !exists ? value : Array.isArray(existing) ? (existing.push(value), existing) : [existing, value];
+    return container;
+  }
+
+  let child = exists ? container[key] : undefined;
+  if (exists && (typeof child !== 'object' || child === null)) {
+    child = [child];
+  } else if (!exists) {
+    const next = segments[i + 1];
+    child = next === '' || parseArrayIndex(next, arrayLimit) !== -1 ? [] : {};
+  }
+  container[key] = assignQueryValue(child, segments, i + 1, value, arrayLimit);
+  return container;
+}
+
+/**
+ * Nested query parsing (JS fallback for UrlParser.parseQuery)
+ */
+function parseNestedQuery(query: string, options: QueryParseOptions): Record<string, QueryValue> {
+  const depth = options.depth ?? 5;
+  const parameterLimit = options.parameterLimit ?? 1000;
+  const arrayLimit = options.arrayLimit ?? 20;
+  const result: Record<string, QueryValue> = {};
+
+  let count = 0;
+  for (const [key, value] of new URLSearchParams(query)) {
+    if (count++ >= parameterLimit) break;
+
+    const segments: string[] = [];
+    const open = key.indexOf('[');
+    if (depth === 0 || open <= 0) {
+      segments.push(key);
+    } else {
+      segments.push(key.slice(0, open));
+      let pos = open;
+      while (pos < key.length && key[pos] === '[' && segments.length <= depth) {
+        const close = key.indexOf(']', pos + 1);
+        if (close === -1) break;
+        segments.push(key.slice(pos + 1, close));
+        pos = close + 1;
+      }
+      if (pos < key.length) segments.push(key.slice(pos));
+    }
+
+    if (!segments.includes('__proto__')) {
+      assignQueryValue(result, segments, 0, value, arrayLimit);
+    }
+  }
+  return result;
+}
+
 /**
  * URL Parser implementation
  */
@@ -862,6 +2102,63 @@ export class UrlParser {
     }
   }
 
+  /**
+   * Locate URL components without creating strings
+   * @param url URL string (offsets are string indices) or Buffer (offsets are byte offsets)
+   * @param out Optional Uint32Array(14) to fill instead of allocating one
+   * @returns Packed (offset, length) pairs in URL_COMPONENTS order
+   */
+  parseSpans(url: string | Buffer, out?: Uint32Array): Uint32Array {
+    if (this.useNative && this.parser.parseSpans) {
+      const start = performance.now();
+      const result = this.parser.parseSpans(url, out);
+      UrlParser.nativeParseTime += performance.now() - start;
+      UrlParser.nativeParseCount++;
+      return result;
+    }
+
+    const start = performance.now();
+    const result = scanUrlSpans(typeof url === 'string' ? url : url.toString('latin1'), out ?? new Uint32Array(14));
+    UrlParser.jsParseTime += performance.now() - start;
+    UrlParser.jsParseCount++;
+    return result;
+  }
+
+  /**
+   * Parse a URL into a lazy view; only the components that are read become strings
+   */
+  parseLazy(url: string): UrlView {
+    return new UrlView(url, this.parseSpans(url));
+  }
+
+  /**
+   * Parse and normalize a URL per the WHATWG URL Standard, like `new URL(input, base)`
+   * @returns A view over the serialized href, or null if the URL is invalid
+   */
+  parseWhatwg(input: string, base?: string): UrlView | null {
+    if (this.useNative && this.parser.parseWhatwg) {
+      const start = performance.now();
+      const spans = new Uint32Array(14);
+      const href = this.parser.parseWhatwg(input, base, spans);
+      UrlParser.nativeParseTime += performance.now() - start;
+      UrlParser.nativeParseCount++;
+      // undefined: the host needs IDNA, which Node's URL handles below
+      if (href !== undefined) {
+        return href === null ? null : new UrlView(href, spans);
+      }
+    }
+
+    const start = performance.now();
+    try {
+      return urlToView(new URL(input, base));
+    } catch (_err) {
+      return null;
+    } finally {
+      UrlParser.jsParseTime += performance.now() - start;
+      UrlParser.jsParseCount++;
+    }
+  }
+
   parseQueryString(queryString: string): Record<string, string> {
     if (this.useNative) {
       const start = performance.now();
@@ -885,6 +2182,158 @@ export class UrlParser {
     }
   }
 
+  /**
+   * Parse a query string with repeated keys collected into arrays and bracket keys nested,
+   * e.g. "a[]=1&a[]=2&b[c]=3" gives { a: ['1', '2'], b: { c: '3' } }.
+   * Keys and values are percent- and '+'-decoded; key order is preserved.
+   */
+  parseQuery(queryString: string | Buffer, options: QueryParseOptions = {}): Record<string, QueryValue> {
+    if (this.useNative) {
+      const start = performance.now();
+      const result = this.parser.parseQueryString(queryString, { ...options, nested: true });
+      UrlParser.nativeParseTime += performance.now() - start;
+      UrlParser.nativeParseCount++;
+      return result;
+    }
+
+    const start = performance.now();
+    const query = typeof queryString === 'string' ? queryString : queryString.toString('utf8');
+    const result = parseNestedQuery(query, options);
+    UrlParser.jsParseTime += performance.now() - start;
+    UrlParser.jsParseCount++;
+    return result;
+  }
+
+  /**
+   * Parse many URLs packed into one Buffer in a single call, e.g. a column of access-log
+   * paths. Results are columnar typed arrays; large batches are split across threads.
+   * @param buffer URLs back to back (see UrlParser.packUrls)
+   * @param offsets count + 1 boundaries: URL i is buffer[offsets[i], offsets[i + 1])
+   */
+  parseBatch(buffer: Buffer, offsets: Uint32Array, options: UrlBatchOptions = {}): UrlBatch {
+    if (this.useNative && this.parser.parseBatch) {
+      const start = performance.now();
+      const result = this.parser.parseBatch(buffer, offsets, options);
+      UrlParser.nativeParseTime += performance.now() - start;
+      UrlParser.nativeParseCount += result.count;
+      return result;
+    }
+
+    const start = performance.now();
+    const result = parseBatchFallback(buffer, offsets, options);
+    UrlParser.jsParseTime += performance.now() - start;
+    UrlParser.jsParseCount += result.count;
+    return result;
+  }
+
+  /**
+   * Pack URLs into the Buffer and offsets layout taken by parseBatch
+   */
+  static packUrls(urls: string[]): { buffer: Buffer; offsets: Uint32Array } {
+    const offsets = new Uint32Array(urls.length + 1);
+    let total = 0;
+    for (let i = 0; i < urls.length; i++) {
+      total += Buffer.byteLength(urls[i]);
+      offsets[i + 1] = total;
+    }
+    const buffer = Buffer.allocUnsafe(total);
+    for (let i = 0; i < urls.length; i++) {
+      buffer.write(urls[i], offsets[i]);
+    }
+    return { buffer, offsets };
+  }
+
+  /**
+   * Build a URL from a base plus query parameter overrides, written into a pooled Buffer.
+   * An overridden parameter replaces every occurrence of its key (at the first one's
+   * position); null or undefined removes it; new keys are appended before the fragment.
+   * Keys and values are encoded like encodeURIComponent; the rest of the base is kept as is.
+   * The returned Buffer is a view into a shared slab, like Buffer.allocUnsafe: copy it if
+   * it needs to outlive the request.
+   * @param base URL string or Buffer; with a Buffer, span selects [start, end) within it
+   */
+  buildUrl(base: string | Buffer, overrides: UrlParamOverrides = {}, span?: [number, number]): Buffer {
+    if (this.useNative && this.parser.buildUrl) {
+      let written = this.parser.buildUrl(base, overrides, UrlParser.urlSlab, UrlParser.urlSlabOffset, span?.[0], span?.[1]);
+      if (written < 0) {
+        UrlParser.newUrlSlab(-written);
+        written = this.parser.buildUrl(base, overrides, UrlParser.urlSlab, 0, span?.[0], span?.[1]);
+      }
+      return UrlParser.claimUrlSlab(written);
+    }
+
+    const text = typeof base === 'string' ? base : base.toString('utf8', span?.[0] ?? 0, span?.[1] ?? base.length);
+    const url = buildUrlFallback(text, overrides);
+    const length = Buffer.byteLength(url);
+    if (length > UrlParser.urlSlab.length - UrlParser.urlSlabOffset) {
+      UrlParser.newUrlSlab(length);
+    }
+    UrlParser.urlSlab.write(url, UrlParser.urlSlabOffset);
+    return UrlParser.claimUrlSlab(length);
+  }
+
+  // Pooled output for buildUrl: URLs are carved out of shared slabs
+  private static readonly URL_SLAB_SIZE = 64 * 1024;
+  private static urlSlab: Buffer = Buffer.allocUnsafeSlow(UrlParser.URL_SLAB_SIZE);
+  private static urlSlabOffset = 0;
+
+  private static newUrlSlab(minimum: number): void {
+    UrlParser.urlSlab = Buffer.allocUnsafeSlow(Math.max(UrlParser.URL_SLAB_SIZE, minimum));
+    UrlParser.urlSlabOffset = 0;
+  }
+
+  private static claimUrlSlab(length: number): Buffer {
+    const start = UrlParser.urlSlabOffset;
+    // Keep views 8-byte aligned, as Node's own Buffer pool does
+    UrlParser.urlSlabOffset = Math.min(UrlParser.urlSlab.length, (start + length + 7) & ~7);
+    return UrlParser.urlSlab.subarray(start, start + length);
+  }
+
+  /**
+   * Size the URL parse cache used by parse, parseSpans, parseQueryString and parseQuery.
+   * Entries are keyed by the exact input, so they never need invalidating; a repeated
+   * URL or query string costs one hash lookup. The cache is per thread, 4-way set
+   * associative and bounded; size it at about twice the number of hot URLs. 0 disables it.
+   * @returns The effective capacity (rounded up to a power of two), 0 without native support
+   */
+  static configureCache(capacity: number): number {
+    if (nativeBinding && nativeBinding.configureParseCache) {
+      return nativeBinding.configureParseCache(capacity);
+    }
+    return 0;
+  }
+
+  static getCacheStats(): { capacity: number; size: number; hits: number; misses: number; evictions: number } {
+    if (nativeBinding && nativeBinding.getParseCacheStats) {
+      return nativeBinding.getParseCacheStats();
+    }
+    return { capacity: 0, size: 0, hits: 0, misses: 0, evictions: 0 };
+  }
+
+  /**
+   * Same result as the global decodeURIComponent (including URIError on malformed
+   * input); long inputs are scanned 16 bytes at a time natively.
+   */
+  decodeURIComponent(value: string): string {
+    if (this.useNative && this.parser.decodeURIComponent) {
+      const result = this.parser.decodeURIComponent(value);
+      // undefined: malformed or not representable in UTF-8; the builtin decides
+      if (result !== undefined) return result;
+    }
+    return decodeURIComponent(value);
+  }
+
+  /**
+   * Same result as the global encodeURIComponent (including URIError on lone surrogates)
+   */
+  encodeURIComponent(value: string): string {
+    if (this.useNative && this.parser.encodeURIComponent) {
+      const result = this.parser.encodeURIComponent(value);
+      if (result !== undefined) return result;
+    }
+    return encodeURIComponent(value);
+  }
+
   // Performance metrics
   private static jsParseTime = 0;
   private static jsParseCount = 0;
@@ -913,11 +2362,27 @@ export class UrlParser {
   }
 }
 
+/**
+ * Compiled schema returned by SchemaValidator.compileSchema()
+ */
+export interface CompiledSchema {
+  readonly id: string;
+  readonly hash: string;
+  readonly version: number;
+  validate(data: any): { valid: boolean; errors: { path: string; message: string }[] };
+  validatePartial(
+    data: object,
+    updates: object
+  ): { valid: boolean; errors: { path: string; message: string }[] };
+}
+
 // Schema Validator implementation
 export class SchemaValidator {
   private validator: any;
   private useNative: boolean;
   private compiledSchemas: Map<string, any> = new Map();
+  // Source schema of each handle, for the parseJson()/parseQuery() fallbacks
+  private handleSchemas: WeakMap<CompiledSchema, object> = new WeakMap();
 
   constructor() {
     if (nativeBinding && nativeBinding.validate) {
@@ -993,13 +2458,15 @@ export class SchemaValidator {
 
   /**
    * Compile a schema for faster validation
+   * The native validator does not support Unicode property escapes (\p{...}) in
+   * `pattern`; strings checked against one fail with an "Unsupported regex pattern" error.
    * @param schema The schema to compile
-   * @returns A reference to the compiled schema
+   * @returns A handle whose validate() skips the per-call schema lookup
    */
-  compileSchema(schema: object): { id: string; hash: string; version: number } {
+  compileSchema(schema: object): CompiledSchema {
     if (this.useNative && this.validator.compileSchema) {
       const start = performance.now();
-      const compiled = this.validator.compileSchema(schema);
+      const compiled: CompiledSchema = this.validator.compileSchema(schema);
       const end = performance.now();
       SchemaValidator.nativeCompileTime += end - start;
       SchemaValidator.nativeCompileCount++;
@@ -1007,16 +2474,289 @@ export class SchemaValidator {
       // Store in local cache
       const key = compiled.id ? `${compiled.id}:${compiled.hash}` : compiled.hash;
       this.compiledSchemas.set(key, compiled);
+      this.handleSchemas.set(compiled, schema);
 
       return compiled;
     } else {
-      // No compilation in JS fallback, return empty reference
-      return { id: '', hash: '', version: 0 };
+      // No compilation in JS fallback; the handle validates against the schema directly
+      const compiled: CompiledSchema = {
+        id: '',
+        hash: '',
+        version: 0,
+        validate: (data: any) => this.validate(schema, data),
+        validatePartial: (data: object, updates: object) => this.validatePartial(schema, data, updates)
+      };
+      this.handleSchemas.set(compiled, schema);
+      return compiled;
+    }
+  }
+
+  /**
+   * Validate JSON text against a compiled schema without parsing it into
+   * objects first
+   * @param compiled A schema returned by compileSchema()
+   * @param json The JSON document as a Buffer or string
+   * @returns Validation result; `value` holds the parsed document when it is valid
+   */
+  validateJson(
+    compiled: CompiledSchema,
+    json: Buffer | string
+  ): { valid: boolean; errors: { path: string; message: string }[]; value?: any } {
+    if (
+      this.useNative &&
+      this.validator.validateJson &&
+      compiled instanceof this.validator.CompiledSchema
+    ) {
+      const start = performance.now();
+      const result = this.validator.validateJson(compiled, json);
+      const end = performance.now();
+      SchemaValidator.nativeValidateTime += end - start;
+      SchemaValidator.nativeValidateCount++;
+      return result;
+    }
+
+    // Fallback: parse, then validate the parsed value
+    let value: any;
+    try {
+      value = JSON.parse(typeof json === 'string' ? json : json.toString('utf8'));
+    } catch (error) {
+      return {
+        valid: false,
+        errors: [{ path: '$', message: `Invalid JSON: ${(error as Error).message}` }]
+      };
+    }
+    const result = compiled.validate(value);
+    return result.valid ? { ...result, value } : result;
+  }
+
+  /**
+   * Parse a JSON request body into the value a compiled schema describes
+   *
+   * Validation, type coercion (e.g. "42" for an integer property), `default`
+   * values for missing properties and removal of properties rejected by
+   * `additionalProperties: false` all happen in one pass over the text.
+   * @param compiled A schema returned by compileSchema()
+   * @param json The JSON document as a Buffer or string
+   * @returns Validation result; `value` holds the coerced document when it is valid
+   */
+  parseJson(
+    compiled: CompiledSchema,
+    json: Buffer | string
+  ): { valid: boolean; errors: { path: string; message: string }[]; value?: any } {
+    if (this.useNative && this.validator.parseJson && compiled instanceof this.validator.CompiledSchema) {
+      const start = performance.now();
+      const result = this.validator.parseJson(compiled, json);
+      const end = performance.now();
+      SchemaValidator.nativeValidateTime += end - start;
+      SchemaValidator.nativeValidateCount++;
+      return result;
+    }
+
+    // Fallback: parse, coerce, then validate the coerced value
+    let value: any;
+    try {
+      value = JSON.parse(typeof json === 'string' ? json : json.toString('utf8'));
+    } catch (error) {
+      return {
+        valid: false,
+        errors: [{ path: '$', message: `Invalid JSON: ${(error as Error).message}` }]
+      };
+    }
+    const schema = this.handleSchemas.get(compiled);
+    if (!schema) {
+      const result = compiled.validate(value);
+      return result.valid ? { ...result, value } : result;
+    }
+    return this.coerceAndValidate(schema, this.coerceValue(schema, value));
+  }
+
+  /**
+   * Parse a query string against an object schema, as parseJson() does for JSON
+   *
+   * Every parameter arrives as a string and is coerced to its property's
+   * type. Repeated keys (or `key[]`) collect into an array for properties
+   * that accept arrays; otherwise the last value wins.
+   * @param compiled A schema returned by compileSchema()
+   * @param query The query string, with or without the leading '?'
+   * @returns Validation result; `value` holds the parsed parameters when they are valid
+   */
+  parseQuery(
+    compiled: CompiledSchema,
+    query: string
+  ): { valid: boolean; errors: { path: string; message: string }[]; value?: any } {
+    if (this.useNative && this.validator.parseQuery && compiled instanceof this.validator.CompiledSchema) {
+      const start = performance.now();
+      const result = this.validator.parseQuery(compiled, query);
+      const end = performance.now();
+      SchemaValidator.nativeValidateTime += end - start;
+      SchemaValidator.nativeValidateCount++;
+      return result;
+    }
+
+    const schema: any = this.handleSchemas.get(compiled) ?? {};
+    const types = SchemaValidator.typeList(schema);
+    if (types.length > 0 && !types.includes('object')) {
+      return {
+        valid: false,
+        errors: [{ path: '$', message: 'Schema must be an object schema for query input' }]
+      };
+    }
+
+    // Group values by key, in first-seen order
+    const params = new Map<string, string[]>();
+    for (const [rawKey, value] of new URLSearchParams(query)) {
+      const key = rawKey.length > 2 && rawKey.endsWith('[]') ? rawKey.slice(0, -2) : rawKey;
+      const values = params.get(key);
+      if (values) {
+        values.push(value);
+      } else {
+        params.set(key, [value]);
+      }
+    }
+
+    const input: Record<string, any> = {};
+    for (const [key, values] of params) {
+      const propSchema = schema.properties?.[key] ??
+        (typeof schema.additionalProperties === 'object' ? schema.additionalProperties : undefined);
+      const wantsArray = propSchema !== undefined && SchemaValidator.typeList(propSchema).includes('array');
+      SchemaValidator.setOwn(input, key, wantsArray ? values : values[values.length - 1]);
+    }
+    return this.coerceAndValidate(schema, this.coerceValue(schema, input));
+  }
+
+  /**
+   * Validate a coerced value, attaching it to the result when valid
+   * @private
+   */
+  private coerceAndValidate(
+    schema: object,
+    value: any
+  ): { valid: boolean; errors: { path: string; message: string }[]; value?: any } {
+    const start = performance.now();
+    const errors: { path: string; message: string }[] = [];
+    this.validateValue(schema, value, '$', errors);
+    const end = performance.now();
+    SchemaValidator.jsValidateTime += end - start;
+    SchemaValidator.jsValidateCount++;
+    return errors.length === 0 ? { valid: true, errors, value } : { valid: false, errors };
+  }
+
+  /**
+   * Coerce a parsed value towards a schema: scalar conversions, defaults and
+   * stripping of disallowed properties (JS fallback for parseJson/parseQuery)
+   * @private
+   */
+  private coerceValue(schema: any, value: any): any {
+    if (!schema || typeof schema !== 'object') {
+      return value;
+    }
+
+    if (Array.isArray(value)) {
+      return schema.items ? value.map(item => this.coerceValue(schema.items, item)) : value;
+    }
+
+    if (typeof value === 'object' && value !== null) {
+      const properties = schema.properties ?? {};
+      const result: Record<string, any> = {};
+      for (const [key, item] of Object.entries(value)) {
+        if (Object.prototype.hasOwnProperty.call(properties, key)) {
+          SchemaValidator.setOwn(result, key, this.coerceValue(properties[key], item));
+        } else if (schema.additionalProperties === false) {
+          // Unknown properties are stripped
+        } else if (typeof schema.additionalProperties === 'object') {
+          SchemaValidator.setOwn(result, key, this.coerceValue(schema.additionalProperties, item));
+        } else {
+          SchemaValidator.setOwn(result, key, item);
+        }
+      }
+      for (const [key, propSchema] of Object.entries<any>(properties)) {
+        if (!Object.hasOwn(result, key) && propSchema && propSchema.default !== undefined) {
+          SchemaValidator.setOwn(result, key, structuredClone(propSchema.default));
+        }
+      }
+      return result;
+    }
+
+    const types = SchemaValidator.typeList(schema);
+    if (value === null || types.length === 0 || types.some(type => SchemaValidator.matchesType(type, value))) {
+      return value;
+    }
+    return SchemaValidator.coerceScalar(types, value);
+  }
+
+  /**
+   * Assign an own data property, so a "__proto__" key from the input never
+   * reaches the prototype setter
+   * @private
+   */
+  private static setOwn(target: Record<string, any>, key: string, value: any): void {
+    Object.defineProperty(target, key, { value, writable: true, enumerable: true, configurable: true });
+  }
+
+  /**
+   * Convert a scalar to one of `types`, trying numbers, booleans, strings and
+   * null in that order; the value is returned unchanged when none applies
+   * @private
+   */
+  private static coerceScalar(types: string[], value: any): any {
+    const toNumber = types.includes('number') || types.includes('integer');
+    const integerOnly = !types.includes('number');
+
+    if (typeof value === 'string') {
+      // Only plain decimal spellings: no hex, Infinity or padding
+      if (toNumber && /^[-+.0-9eE]+$/.test(value)) {
+        const number = Number(value);
+        if (Number.isFinite(number) && (!integerOnly || Number.isInteger(number))) {
+          return number;
+        }
+      }
+      if (types.includes('boolean') && (value === 'true' || value === 'false')) {
+        return value === 'true';
+      }
+      if (types.includes('null') && value === '') {
+        return null;
+      }
+    } else if (typeof value === 'number') {
+      if (types.includes('boolean') && (value === 0 || value === 1)) {
+        return value === 1;
+      }
+      if (types.includes('string')) {
+        return String(value);
+      }
+      if (types.includes('null') && value === 0) {
+        return null;
+      }
+    } else if (typeof value === 'boolean') {
+      if (toNumber) {
+        return value ? 1 : 0;
+      }
+      if (types.includes('string')) {
+        return String(value);
+      }
+      if (types.includes('null') && !value) {
+        return null;
+      }
     }
+    return value;
+  }
+
+  /**
+   * The `type` keyword as a list of names (empty when absent)
+   * @private
+   */
+  private static typeList(schema: any): string[] {
+    if (!schema || !schema.type) {
+      return [];
+    }
+    return Array.isArray(schema.type) ? schema.type : [schema.type];
   }
 
   /**
    * Clear the schema cache
+   *
+   * Compiled schemas are cached by a hash of their structure. Schemas are
+   * rehashed on every call, so in-place mutations are always seen; deeply
+   * frozen schemas keep their hash on the object and skip the rehash.
    */
   clearCache(): void {
     if (this.useNative && this.validator.clearCache) {
@@ -1066,20 +2806,15 @@ export class SchemaValidator {
       return false;
     }
 
-    // Type-specific validations
-    if (schema.type === 'string' && typeof value === 'string') {
+    // Keyword validations apply to the value's own type, as in the native program
+    if (typeof value === 'string') {
       this.validateString(schema, value, path, errors);
-    } else if (schema.type === 'number' && typeof value === 'number') {
+    } else if (typeof value === 'number') {
       this.validateNumber(schema, value, path, errors);
-    } else if (
-      schema.type === 'object' &&
-      typeof value === 'object' &&
-      value !== null &&
-      !Array.isArray(value)
-    ) {
-      this.validateObject(schema, value, path, errors);
-    } else if (schema.type === 'array' && Array.isArray(value)) {
+    } else if (Array.isArray(value)) {
       this.validateArray(schema, value, path, errors);
+    } else if (typeof value === 'object' && value !== null) {
+      this.validateObject(schema, value, path, errors);
     }
 
     return errors.length === 0;
@@ -1099,33 +2834,41 @@ export class SchemaValidator {
       return true;
     }
 
-    const type = typeof value;
-    if (schema.type === 'array' && !Array.isArray(value)) {
-      errors.push({ path, message: 'Expected array' });
-      return false;
-    } else if (
-      schema.type === 'object' &&
-      (typeof value !== 'object' || Array.isArray(value) || value === null)
-    ) {
-      errors.push({ path, message: 'Expected object' });
-      return false;
-    } else if (schema.type === 'string' && type !== 'string') {
-      errors.push({ path, message: 'Expected string' });
-      return false;
-    } else if (schema.type === 'number' && type !== 'number') {
-      errors.push({ path, message: 'Expected number' });
-      return false;
-    } else if (schema.type === 'boolean' && type !== 'boolean') {
-      errors.push({ path, message: 'Expected boolean' });
-      return false;
-    } else if (schema.type === 'null' && value !== null) {
-      errors.push({ path, message: 'Expected null' });
+    // `type` may be a single name or a list of names
+    const types: string[] = Array.isArray(schema.type) ? schema.type : [schema.type];
+    if (!types.some(type => SchemaValidator.matchesType(type, value))) {
+      errors.push({ path, message: `Expected ${types.join(' or ')}` });
       return false;
     }
 
     return true;
   }
 
+  /**
+   * Check a value against one JSON schema type name
+   * @private
+   */
+  private static matchesType(type: string, value: any): boolean {
+    switch (type) {
+      case 'array':
+        return Array.isArray(value);
+      case 'object':
+        return typeof value === 'object' && value !== null && !Array.isArray(value);
+      case 'string':
+        return typeof value === 'string';
+      case 'number':
+        return typeof value === 'number';
+      case 'integer':
+        return Number.isInteger(value);
+      case 'boolean':
+        return typeof value === 'boolean';
+      case 'null':
+        return value === null;
+      default:
+        return false;
+    }
+  }
+
   /**
    * Validate string values
    * @private
@@ -1142,6 +2885,31 @@ export class SchemaValidator {
     if (schema.maxLength !== undefined && value.length > schema.maxLength) {
       errors.push({ path, message: 'String too long' });
     }
+    if (typeof schema.pattern === 'string') {
+      const regex = SchemaValidator.patternRegExp(schema.pattern);
+      if (!regex) {
+        errors.push({ path, message: `Invalid regex pattern in schema: ${schema.pattern}` });
+      } else if (!regex.test(value)) {
+        errors.push({ path, message: `String does not match pattern: ${schema.pattern}` });
+      }
+    }
+  }
+
+  /**
+   * RegExp for a `pattern` keyword, matching by code point like the native
+   * matcher; patterns only valid in non-Unicode syntax compile without the flag
+   * @private
+   */
+  private static patternRegExp(pattern: string): RegExp | null {
+    try {
+      return new RegExp(pattern, 'u');
+    } catch {
+      try {
+        return new RegExp(pattern);
+      } catch {
+        return null;
+      }
+    }
   }
 
   /**
@@ -1194,7 +2962,7 @@ export class SchemaValidator {
   ): void {
     if (schema.required && Array.isArray(schema.required)) {
       for (const prop of schema.required) {
-        if (!(prop in value)) {
+        if (!Object.hasOwn(value, prop)) {
           errors.push({ path: `${path}.${prop}`, message: 'Required property missing' });
         }
       }
@@ -1213,7 +2981,7 @@ export class SchemaValidator {
   ): void {
     if (schema.properties) {
       for (const [propName, propSchema] of Object.entries(schema.properties)) {
-        if (propName in value) {
+        if (Object.hasOwn(value, propName)) {
           this.validateValue(propSchema, value[propName], `${path}.${propName}`, errors);
         }
       }
@@ -0,0 +1,1221 @@
+#include "binary_codec.h"
+#include "json_escape.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace BinaryCodec {
+
+namespace {
+
+constexpr size_t kMaxDepth = 512;
+constexpr size_t kMaxCachedKeyLength = 64;
+constexpr size_t kMaxCachedKeys = 256;
+constexpr double kMaxSafeInteger = 9007199254740991.0;
+
+// MessagePack timestamp extension type
+constexpr int8_t kMsgpackTimestampExt = -1;
+
+// CBOR major types
+constexpr uint8_t kCborUint = 0;
+constexpr uint8_t kCborNegative = 1;
+constexpr uint8_t kCborBytes = 2;
+constexpr uint8_t kCborText = 3;
+constexpr uint8_t kCborArray = 4;
+constexpr uint8_t kCborMap = 5;
+constexpr uint8_t kCborTag = 6;
+constexpr uint8_t kCborSimple = 7;
+constexpr uint8_t kCborBreak = 0xff;
+
+// Decode an IEEE 754 half-precision float (CBOR major type 7, info 25)
+double DecodeHalf(uint16_t half) {
+  int exponent = (half >> 10) & 0x1f;
+  int mantissa = half & 0x3ff;
+  double value;
+
+  if (exponent == 0) {
+    value = std::ldexp(mantissa, -24);
+  } else if (exponent != 31) {
+    value = std::ldexp(mantissa + 1024, exponent - 25);
+  } else {
+    value = mantissa == 0 ? INFINITY : NAN;
+  }
+
+  return (half & 0x8000) ? -value : value;
+}
+
+// Low-level MessagePack / CBOR writer shared by the JS encoder and JSON transcoder
+class Writer {
+public:
+  enum HeaderKind { MSGPACK_STR, MSGPACK_BIN, MSGPACK_ARRAY, MSGPACK_MAP };
+
+  Writer(Format format, std::string& out) : format_(format), out_(out) {}
+
+  void Byte(uint8_t byte) {
+    out_.push_back(static_cast<char>(byte));
+  }
+
+  void BigEndian(uint64_t value, int bytes) {
+    for (int shift = (bytes - 1) * 8; shift >= 0; shift -= 8) {
+      Byte(static_cast<uint8_t>(value >> shift));
+    }
+  }
+
+  // CBOR initial byte plus the shortest argument encoding
+  void CborHead(uint8_t major, uint64_t argument) {
+    uint8_t prefix = static_cast<uint8_t>(major << 5);
+    if (argument < 24) {
+      Byte(prefix | static_cast<uint8_t>(argument));
+    } else if (argument <= 0xff) {
+      Byte(prefix | 24);
+      BigEndian(argument, 1);
+    } else if (argument <= 0xffff) {
+      Byte(prefix | 25);
+      BigEndian(argument, 2);
+    } else if (argument <= 0xffffffffULL) {
+      Byte(prefix | 26);
+      BigEndian(argument, 4);
+    } else {
+      Byte(prefix | 27);
+      BigEndian(argument, 8);
+    }
+  }
+
+  // Length header for strings, binaries, arrays and maps
+  void Header(HeaderKind kind, uint8_t cborMajor, size_t length) {
+    if (format_ == Format::CBOR) {
+      CborHead(cborMajor, length);
+      return;
+    }
+
+    switch (kind) {
+      case MSGPACK_STR:
+        if (length < 32) {
+          Byte(0xa0 | static_cast<uint8_t>(length));
+        } else if (length <= 0xff) {
+          Byte(0xd9);
+          BigEndian(length, 1);
+        } else if (length <= 0xffff) {
+          Byte(0xda);
+          BigEndian(length, 2);
+        } else {
+          Byte(0xdb);
+          BigEndian(length, 4);
+        }
+        break;
+      case MSGPACK_BIN:
+        if (length <= 0xff) {
+          Byte(0xc4);
+          BigEndian(length, 1);
+        } else if (length <= 0xffff) {
+          Byte(0xc5);
+          BigEndian(length, 2);
+        } else {
+          Byte(0xc6);
+          BigEndian(length, 4);
+        }
+        break;
+      case MSGPACK_ARRAY:
+        if (length < 16) {
+          Byte(0x90 | static_cast<uint8_t>(length));
+        } else if (length <= 0xffff) {
+          Byte(0xdc);
+          BigEndian(length, 2);
+        } else {
+          Byte(0xdd);
+          BigEndian(length, 4);
+        }
+        break;
+      case MSGPACK_MAP:
+        if (length < 16) {
+          Byte(0x80 | static_cast<uint8_t>(length));
+        } else if (length <= 0xffff) {
+          Byte(0xde);
+          BigEndian(length, 2);
+        } else {
+          Byte(0xdf);
+          BigEndian(length, 4);
+        }
+        break;
+    }
+  }
+
+  void Nil() {
+    Byte(format_ == Format::CBOR ? 0xf6 : 0xc0);
+  }
+
+  void Bool(bool value) {
+    if (format_ == Format::CBOR) {
+      Byte(value ? 0xf5 : 0xf4);
+    } else {
+      Byte(value ? 0xc3 : 0xc2);
+    }
+  }
+
+  void Uint(uint64_t value) {
+    if (format_ == Format::CBOR) {
+      CborHead(kCborUint, value);
+    } else if (value <= 0x7f) {
+      Byte(static_cast<uint8_t>(value));
+    } else if (value <= 0xff) {
+      Byte(0xcc);
+      BigEndian(value, 1);
+    } else if (value <= 0xffff) {
+      Byte(0xcd);
+      BigEndian(value, 2);
+    } else if (value <= 0xffffffffULL) {
+      Byte(0xce);
+      BigEndian(value, 4);
+    } else {
+      Byte(0xcf);
+      BigEndian(value, 8);
+    }
+  }
+
+  void Int(int64_t value) {
+    if (value >= 0) {
+      Uint(static_cast<uint64_t>(value));
+    } else if (format_ == Format::CBOR) {
+      CborHead(kCborNegative, static_cast<uint64_t>(-1 - value));
+    } else if (value >= -32) {
+      Byte(static_cast<uint8_t>(value));
+    } else if (value >= INT8_MIN) {
+      Byte(0xd0);
+      BigEndian(static_cast<uint64_t>(value), 1);
+    } else if (value >= INT16_MIN) {
+      Byte(0xd1);
+      BigEndian(static_cast<uint64_t>(value), 2);
+    } else if (value >= INT32_MIN) {
+      Byte(0xd2);
+      BigEndian(static_cast<uint64_t>(value), 4);
+    } else {
+      Byte(0xd3);
+      BigEndian(static_cast<uint64_t>(value), 8);
+    }
+  }
+
+  void Double(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    Byte(format_ == Format::CBOR ? 0xfb : 0xcb);
+    BigEndian(bits, 8);
+  }
+
+  // Integral doubles within the safe range use the compact integer encodings
+  void Number(double value) {
+    if (std::trunc(value) == value && std::fabs(value) <= kMaxSafeInteger) {
+      Int(static_cast<int64_t>(value));
+    } else {
+      Double(value);
+    }
+  }
+
+  void Text(const char* data, size_t length) {
+    Header(MSGPACK_STR, kCborText, length);
+    out_.append(data, length);
+  }
+
+  // MessagePack timestamp extension or CBOR epoch tag (1)
+  void Date(double ms) {
+    if (!std::isfinite(ms)) {
+      Nil();
+      return;
+    }
+
+    if (format_ == Format::CBOR) {
+      Byte(0xc1);
+      Number(ms / 1000.0);
+      return;
+    }
+
+    int64_t seconds = static_cast<int64_t>(std::floor(ms / 1000.0));
+    uint32_t nanoseconds = static_cast<uint32_t>((ms - static_cast<double>(seconds) * 1000.0) * 1000000.0);
+
+    if (seconds >= 0 && (seconds >> 34) == 0) {
+      // timestamp 64: 30-bit nanoseconds, 34-bit seconds
+      Byte(0xd7);
+      Byte(static_cast<uint8_t>(kMsgpackTimestampExt));
+      BigEndian((static_cast<uint64_t>(nanoseconds) << 34) | static_cast<uint64_t>(seconds), 8);
+    } else {
+      // timestamp 96: 32-bit nanoseconds, 64-bit signed seconds
+      Byte(0xc7);
+      Byte(12);
+      Byte(static_cast<uint8_t>(kMsgpackTimestampExt));
+      BigEndian(nanoseconds, 4);
+      BigEndian(static_cast<uint64_t>(seconds), 8);
+    }
+  }
+
+protected:
+  Format format_;
+  std::string& out_;
+};
+
+// Walks JS values and writes MessagePack or CBOR
+class Encoder : public Writer {
+public:
+  using Writer::Writer;
+
+  void Value(const Napi::Value& value, size_t depth) {
+    if (depth > kMaxDepth) {
+      throw std::runtime_error("Maximum nesting depth exceeded");
+    }
+
+    if (value.IsNull() || value.IsUndefined() || value.IsFunction()) {
+      Nil();
+    } else if (value.IsBoolean()) {
+      Bool(value.As<Napi::Boolean>().Value());
+    } else if (value.IsNumber()) {
+      Number(value.As<Napi::Number>().DoubleValue());
+    } else if (value.IsString()) {
+      String(value);
+    } else if (value.IsBigInt()) {
+      BigInt(value.As<Napi::BigInt>());
+    } else if (value.IsBuffer()) {
+      Napi::Buffer<char> buffer = value.As<Napi::Buffer<char>>();
+      Header(MSGPACK_BIN, kCborBytes, buffer.Length());
+      out_.append(buffer.Data(), buffer.Length());
+    } else if (value.IsDate()) {
+      Date(value.As<Napi::Date>().ValueOf());
+    } else if (value.IsArray()) {
+      Napi::Array array = value.As<Napi::Array>();
+      uint32_t length = array.Length();
+      Header(MSGPACK_ARRAY, kCborArray, length);
+      for (uint32_t i = 0; i < length; i++) {
+        Value(array.Get(i), depth + 1);
+      }
+    } else if (value.IsObject()) {
+      Object(value.As<Napi::Object>(), depth);
+    } else {
+      // Symbols and other non-serializable values
+      Nil();
+    }
+  }
+
+private:
+  void String(const Napi::Value& value) {
+    napi_env env = value.Env();
+    size_t length = 0;
+    napi_get_value_string_utf8(env, value, nullptr, 0, &length);
+    scratch_.resize(length + 1);
+    napi_get_value_string_utf8(env, value, &scratch_[0], scratch_.size(), &length);
+
+    Text(scratch_.data(), length);
+  }
+
+  void BigInt(const Napi::BigInt& value) {
+    bool lossless = false;
+    int64_t signedValue = value.Int64Value(&lossless);
+    if (lossless) {
+      Int(signedValue);
+      return;
+    }
+
+    uint64_t unsignedValue = value.Uint64Value(&lossless);
+    if (lossless) {
+      Uint(unsignedValue);
+      return;
+    }
+
+    throw std::runtime_error("BigInt value out of 64-bit range");
+  }
+
+  // Objects: undefined and function properties are skipped like JSON.stringify
+  void Object(const Napi::Object& object, size_t depth) {
+    Napi::Array keys = object.GetPropertyNames();
+    uint32_t length = keys.Length();
+
+    std::vector<std::pair<Napi::Value, Napi::Value>> entries;
+    entries.reserve(length);
+    for (uint32_t i = 0; i < length; i++) {
+      Napi::Value key = keys.Get(i);
+      Napi::Value value = object.Get(key);
+      if (value.IsUndefined() || value.IsFunction()) {
+        continue;
+      }
+      entries.emplace_back(key, value);
+    }
+
+    Header(MSGPACK_MAP, kCborMap, entries.size());
+    for (const auto& entry : entries) {
+      String(entry.first.IsString() ? entry.first : Napi::Value(entry.first.ToString()));
+      Value(entry.second, depth + 1);
+    }
+  }
+
+  std::string scratch_;
+};
+
+// Bounds-checked big-endian reader over MessagePack / CBOR input
+class Reader {
+public:
+  Reader(const uint8_t* data, size_t length) : data_(data), length_(length) {}
+
+  bool AtEnd() const {
+    return offset_ == length_;
+  }
+
+protected:
+  uint8_t Byte() {
+    if (offset_ >= length_) {
+      throw std::runtime_error("Unexpected end of input");
+    }
+    return data_[offset_++];
+  }
+
+  uint8_t Peek() const {
+    if (offset_ >= length_) {
+      throw std::runtime_error("Unexpected end of input");
+    }
+    return data_[offset_];
+  }
+
+  uint64_t BigEndian(int bytes) {
+    const uint8_t* p = Take(bytes);
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; i++) {
+      value = (value << 8) | p[i];
+    }
+    return value;
+  }
+
+  const uint8_t* Take(uint64_t count) {
+    if (count > length_ - offset_) {
+      throw std::runtime_error("Unexpected end of input");
+    }
+    const uint8_t* p = data_ + offset_;
+    offset_ += static_cast<size_t>(count);
+    return p;
+  }
+
+  double Float32() {
+    uint32_t bits = static_cast<uint32_t>(BigEndian(4));
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  double Float64() {
+    uint64_t bits = BigEndian(8);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  // Read the argument of an initial byte; returns false for indefinite length
+  bool CborArgument(uint8_t info, uint64_t& argument) {
+    if (info < 24) {
+      argument = info;
+    } else if (info <= 27) {
+      argument = BigEndian(1 << (info - 24));
+    } else if (info == 31) {
+      return false;
+    } else {
+      throw std::runtime_error("Invalid CBOR additional information");
+    }
+    return true;
+  }
+
+  // Definite or indefinite (chunked) byte and text strings
+  void CborChunks(uint8_t major, uint8_t info, std::string& out) {
+    uint64_t length;
+    if (CborArgument(info, length)) {
+      const uint8_t* p = Take(length);
+      out.assign(reinterpret_cast<const char*>(p), static_cast<size_t>(length));
+      return;
+    }
+
+    out.clear();
+    while (Peek() != kCborBreak) {
+      uint8_t chunk = Byte();
+      if ((chunk >> 5) != major || !CborArgument(chunk & 0x1f, length)) {
+        throw std::runtime_error("Invalid CBOR string chunk");
+      }
+      const uint8_t* p = Take(length);
+      out.append(reinterpret_cast<const char*>(p), static_cast<size_t>(length));
+    }
+    offset_++;
+  }
+
+  const uint8_t* data_;
+  size_t length_;
+  size_t offset_ = 0;
+};
+
+// Reads MessagePack or CBOR and builds JS values
+class Decoder : public Reader {
+public:
+  Decoder(Napi::Env env, Format format, const uint8_t* data, size_t length)
+      : Reader(data, length), env_(env), format_(format) {}
+
+  Napi::Value Value(size_t depth) {
+    if (depth > kMaxDepth) {
+      throw std::runtime_error("Maximum nesting depth exceeded");
+    }
+    return format_ == Format::CBOR ? CborValue(depth) : MsgpackValue(depth);
+  }
+
+private:
+  // Integers beyond the safe range become BigInt instead of losing precision
+  Napi::Value Unsigned(uint64_t value) {
+    if (value <= static_cast<uint64_t>(kMaxSafeInteger)) {
+      return Napi::Number::New(env_, static_cast<double>(value));
+    }
+    return Napi::BigInt::New(env_, value);
+  }
+
+  Napi::Value Signed(int64_t value) {
+    if (value >= -static_cast<int64_t>(kMaxSafeInteger)) {
+      return Napi::Number::New(env_, static_cast<double>(value));
+    }
+    return Napi::BigInt::New(env_, value);
+  }
+
+  Napi::Value Text(const uint8_t* p, size_t length) {
+    return Napi::String::New(env_, reinterpret_cast<const char*>(p), length);
+  }
+
+  // Map keys: reuse the JS string for keys already seen in this document
+  Napi::Value Key(const uint8_t* p, size_t length) {
+    if (length > kMaxCachedKeyLength) {
+      return Text(p, length);
+    }
+
+    std::string_view view(reinterpret_cast<const char*>(p), length);
+    auto it = keyCache_.find(view);
+    if (it != keyCache_.end()) {
+      return it->second;
+    }
+
+    Napi::Value key = Text(p, length);
+    if (keyCache_.size() < kMaxCachedKeys) {
+      keyCache_.emplace(view, key);
+    }
+    return key;
+  }
+
+  // Own-property set that never triggers the __proto__ setter
+  void SetProperty(Napi::Object& object, const Napi::Value& key, const Napi::Value& value) {
+    if (key.IsString() && key.As<Napi::String>().Utf8Value() == "__proto__") {
+      napi_property_descriptor descriptor = {
+        nullptr, key, nullptr, nullptr, nullptr, value, napi_default_jsproperty, nullptr
+      };
+      napi_define_properties(env_, object, 1, &descriptor);
+      return;
+    }
+    object.Set(key, value);
+  }
+
+  Napi::Value MakeDate(double ms) {
+    return Napi::Date::New(env_, ms);
+  }
+
+  // Shared by MessagePack and definite-length CBOR arrays
+  Napi::Value ReadArray(size_t count, size_t depth) {
+    // Every element takes at least one byte; reject bogus lengths before allocating
+    if (count > length_ - offset_) {
+      throw std::runtime_error("Unexpected end of input");
+    }
+
+    Napi::Array array = Napi::Array::New(env_, count);
+    for (size_t i = 0; i < count; i++) {
+      array.Set(static_cast<uint32_t>(i), Value(depth + 1));
+    }
+    return array;
+  }
+
+  // MessagePack ---------------------------------------------------------
+
+  Napi::Value MsgpackKey(size_t depth) {
+    uint8_t type = Peek();
+    size_t length;
+
+    if ((type & 0xe0) == 0xa0) {
+      offset_++;
+      length = type & 0x1f;
+    } else if (type == 0xd9) {
+      offset_++;
+      length = static_cast<size_t>(BigEndian(1));
+    } else if (type == 0xda) {
+      offset_++;
+      length = static_cast<size_t>(BigEndian(2));
+    } else if (type == 0xdb) {
+      offset_++;
+      length = static_cast<size_t>(BigEndian(4));
+    } else {
+      // Non-string keys are converted like JS property keys
+      return Value(depth + 1).ToString();
+    }
+
+    return Key(Take(length), length);
+  }
+
+  Napi::Value MsgpackMap(size_t count, size_t depth) {
+    Napi::Object object = Napi::Object::New(env_);
+    for (size_t i = 0; i < count; i++) {
+      Napi::Value key = MsgpackKey(depth);
+      SetProperty(object, key, Value(depth + 1));
+    }
+    return object;
+  }
+
+  Napi::Value MsgpackExt(size_t length) {
+    int8_t type = static_cast<int8_t>(Byte());
+    const uint8_t* p = Take(length);
+
+    if (type == kMsgpackTimestampExt) {
+      Decoder body(env_, format_, p, length);
+      if (length == 4) {
+        return MakeDate(static_cast<double>(body.BigEndian(4)) * 1000.0);
+      }
+      if (length == 8) {
+        uint64_t packed = body.BigEndian(8);
+        double seconds = static_cast<double>(packed & 0x3ffffffffULL);
+        double nanoseconds = static_cast<double>(packed >> 34);
+        return MakeDate(seconds * 1000.0 + nanoseconds / 1000000.0);
+      }
+      if (length == 12) {
+        double nanoseconds = static_cast<double>(body.BigEndian(4));
+        double seconds = static_cast<double>(static_cast<int64_t>(body.BigEndian(8)));
+        return MakeDate(seconds * 1000.0 + nanoseconds / 1000000.0);
+      }
+      throw std::runtime_error("Invalid MessagePack timestamp");
+    }
+
+    // Unknown extension types are returned as their raw payload
+    return Napi::Buffer<char>::Copy(env_, reinterpret_cast<const char*>(p), length);
+  }
+
+  Napi::Value MsgpackValue(size_t depth) {
+    uint8_t type = Byte();
+
+    if (type <= 0x7f) return Napi::Number::New(env_, type);
+    if (type >= 0xe0) return Napi::Number::New(env_, static_cast<int8_t>(type));
+    if ((type & 0xf0) == 0x80) return MsgpackMap(type & 0x0f, depth);
+    if ((type & 0xf0) == 0x90) return ReadArray(type & 0x0f, depth);
+    if ((type & 0xe0) == 0xa0) {
+      size_t length = type & 0x1f;
+      return Text(Take(length), length);
+    }
+
+    switch (type) {
+      case 0xc0: return env_.Null();
+      case 0xc2: return Napi::Boolean::New(env_, false);
+      case 0xc3: return Napi::Boolean::New(env_, true);
+      case 0xc4: case 0xc5: case 0xc6: {
+        size_t length = static_cast<size_t>(BigEndian(1 << (type - 0xc4)));
+        const uint8_t* p = Take(length);
+        return Napi::Buffer<char>::Copy(env_, reinterpret_cast<const char*>(p), length);
+      }
+      case 0xc7: case 0xc8: case 0xc9:
+        return MsgpackExt(static_cast<size_t>(BigEndian(1 << (type - 0xc7))));
+      case 0xca: return Napi::Number::New(env_, Float32());
+      case 0xcb: return Napi::Number::New(env_, Float64());
+      case 0xcc: case 0xcd: case 0xce: case 0xcf:
+        return Unsigned(BigEndian(1 << (type - 0xcc)));
+      case 0xd0: return Signed(static_cast<int8_t>(BigEndian(1)));
+      case 0xd1: return Signed(static_cast<int16_t>(BigEndian(2)));
+      case 0xd2: return Signed(static_cast<int32_t>(BigEndian(4)));
+      case 0xd3: return Signed(static_cast<int64_t>(BigEndian(8)));
+      case 0xd4: case 0xd5: case 0xd6: case 0xd7: case 0xd8:
+        return MsgpackExt(static_cast<size_t>(1) << (type - 0xd4));
+      case 0xd9: case 0xda: case 0xdb: {
+        size_t length = static_cast<size_t>(BigEndian(1 << (type - 0xd9)));
+        return Text(Take(length), length);
+      }
+      case 0xdc: return ReadArray(static_cast<size_t>(BigEndian(2)), depth);
+      case 0xdd: return ReadArray(static_cast<size_t>(BigEndian(4)), depth);
+      case 0xde: return MsgpackMap(static_cast<size_t>(BigEndian(2)), depth);
+      case 0xdf: return MsgpackMap(static_cast<size_t>(BigEndian(4)), depth);
+      default:
+        throw std::runtime_error("Invalid MessagePack type byte");
+    }
+  }
+
+  // CBOR ----------------------------------------------------------------
+
+  Napi::Value CborKey(size_t depth) {
+    uint8_t initial = Peek();
+    uint8_t info = initial & 0x1f;
+
+    // Definite-length text keys are read in place and cached
+    if ((initial >> 5) == kCborText && info != 31) {
+      offset_++;
+      uint64_t length;
+      CborArgument(info, length);
+      return Key(Take(length), static_cast<size_t>(length));
+    }
+
+    return Value(depth + 1).ToString();
+  }
+
+  Napi::Value CborValue(size_t depth) {
+    uint8_t initial = Byte();
+    uint8_t major = initial >> 5;
+    uint8_t info = initial & 0x1f;
+    uint64_t argument = 0;
+
+    switch (major) {
+      case kCborUint:
+        CborArgument(info, argument);
+        return Unsigned(argument);
+
+      case kCborNegative:
+        CborArgument(info, argument);
+        if (argument <= static_cast<uint64_t>(INT64_MAX)) {
+          return Signed(-1 - static_cast<int64_t>(argument));
+        }
+        return Napi::Number::New(env_, -1.0 - static_cast<double>(argument));
+
+      case kCborBytes: {
+        std::string bytes;
+        CborChunks(major, info, bytes);
+        return Napi::Buffer<char>::Copy(env_, bytes.data(), bytes.size());
+      }
+
+      case kCborText: {
+        if (info != 31) {
+          CborArgument(info, argument);
+          return Text(Take(argument), static_cast<size_t>(argument));
+        }
+        std::string text;
+        CborChunks(major, info, text);
+        return Napi::String::New(env_, text);
+      }
+
+      case kCborArray: {
+        if (CborArgument(info, argument)) {
+          return ReadArray(static_cast<size_t>(argument), depth);
+        }
+        Napi::Array array = Napi::Array::New(env_);
+        uint32_t index = 0;
+        while (Peek() != kCborBreak) {
+          array.Set(index++, Value(depth + 1));
+        }
+        offset_++;
+        return array;
+      }
+
+      case kCborMap: {
+        Napi::Object object = Napi::Object::New(env_);
+        bool definite = CborArgument(info, argument);
+        for (uint64_t i = 0; definite ? i < argument : Peek() != kCborBreak; i++) {
+          Napi::Value key = CborKey(depth);
+          SetProperty(object, key, Value(depth + 1));
+        }
+        if (!definite) {
+          offset_++;
+        }
+        return object;
+      }
+
+      case kCborTag: {
+        CborArgument(info, argument);
+        Napi::Value content = Value(depth + 1);
+
+        // Tag 1: epoch-based date/time
+        if (argument == 1 && content.IsNumber()) {
+          return MakeDate(content.As<Napi::Number>().DoubleValue() * 1000.0);
+        }
+
+        // Tags 2/3: bignums that fit in 64 bits
+        if ((argument == 2 || argument == 3) && content.IsBuffer()) {
+          Napi::Buffer<uint8_t> bytes = content.As<Napi::Buffer<uint8_t>>();
+          if (bytes.Length() <= 8) {
+            uint64_t magnitude = 0;
+            for (size_t i = 0; i < bytes.Length(); i++) {
+              magnitude = (magnitude << 8) | bytes.Data()[i];
+            }
+            if (argument == 2) {
+              return Napi::BigInt::New(env_, magnitude);
+            }
+            if (magnitude <= static_cast<uint64_t>(INT64_MAX)) {
+              return Napi::BigInt::New(env_, -1 - static_cast<int64_t>(magnitude));
+            }
+          }
+        }
+
+        // Other tags are transparent
+        return content;
+      }
+
+      case kCborSimple:
+      default:
+        switch (info) {
+          case 20: return Napi::Boolean::New(env_, false);
+          case 21: return Napi::Boolean::New(env_, true);
+          case 22: return env_.Null();
+          case 23: return env_.Undefined();
+          case 24: Byte(); return env_.Undefined();
+          case 25: return Napi::Number::New(env_, DecodeHalf(static_cast<uint16_t>(BigEndian(2))));
+          case 26: return Napi::Number::New(env_, Float32());
+          case 27: return Napi::Number::New(env_, Float64());
+          case 31: throw std::runtime_error("Unexpected CBOR break");
+          default: return env_.Undefined();
+        }
+    }
+  }
+
+  Napi::Env env_;
+  Format format_;
+  std::unordered_map<std::string_view, Napi::Value> keyCache_;
+};
+
+// Format a Date value the way Date.prototype.toJSON does (null when out of range)
+void AppendIsoDate(double ms, std::string& out) {
+  if (!std::isfinite(ms) || std::fabs(ms) > 8.64e15) {
+    out += "null";
+    return;
+  }
+
+  int64_t total = static_cast<int64_t>(std::trunc(ms));
+  int64_t days = total / 86400000;
+  int64_t rem = total % 86400000;
+  if (rem < 0) {
+    rem += 86400000;
+    days--;
+  }
+
+  // Civil date from days since the epoch (proleptic Gregorian calendar)
+  int64_t z = days + 719468;
+  int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+  int64_t doe = z - era * 146097;
+  int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  int64_t mp = (5 * doy + 2) / 153;
+  int64_t day = doy - (153 * mp + 2) / 5 + 1;
+  int64_t month = mp < 10 ? mp + 3 : mp - 9;
+  int64_t year = yoe + era * 400 + (month <= 2 ? 1 : 0);
+
+  char buf[40];
+  int len;
+  if (year >= 0 && year <= 9999) {
+    len = std::snprintf(buf, sizeof(buf), "\"%04" PRId64, year);
+  } else {
+    len = std::snprintf(buf, sizeof(buf), "\"%c%06" PRId64, year < 0 ? '-' : '+', year < 0 ? -year : year);
+  }
+  len += std::snprintf(buf + len, sizeof(buf) - len, "-%02" PRId64 "-%02" PRId64 "T%02" PRId64 ":%02" PRId64 ":%02" PRId64 ".%03" PRId64 "Z\"",
+                       month, day, rem / 3600000, (rem / 60000) % 60, (rem / 1000) % 60, rem % 1000);
+  out.append(buf, len);
+}
+
+// Writes a parsed simdjson document as MessagePack or CBOR without creating JS values
+class DocumentEncoder : public Writer {
+public:
+  using Writer::Writer;
+
+  void Element(simdjson::dom::element element) {
+    switch (element.type()) {
+      case simdjson::dom::element_type::ARRAY: {
+        simdjson::dom::array array = element.get_array().value();
+        Header(MSGPACK_ARRAY, kCborArray, array.size());
+        for (simdjson::dom::element item : array) {
+          Element(item);
+        }
+        break;
+      }
+      case simdjson::dom::element_type::OBJECT: {
+        simdjson::dom::object object = element.get_object().value();
+        Header(MSGPACK_MAP, kCborMap, object.size());
+        for (simdjson::dom::key_value_pair field : object) {
+          Text(field.key.data(), field.key.size());
+          Element(field.value);
+        }
+        break;
+      }
+      case simdjson::dom::element_type::INT64:
+        Int(element.get_int64().value());
+        break;
+      case simdjson::dom::element_type::UINT64:
+        Uint(element.get_uint64().value());
+        break;
+      case simdjson::dom::element_type::DOUBLE:
+        Number(element.get_double().value());
+        break;
+      case simdjson::dom::element_type::STRING: {
+        std::string_view text = element.get_string().value();
+        Text(text.data(), text.size());
+        break;
+      }
+      case simdjson::dom::element_type::BOOL:
+        Bool(element.get_bool().value());
+        break;
+      case simdjson::dom::element_type::NULL_VALUE:
+      default:
+        Nil();
+        break;
+    }
+  }
+};
+
+// Reads MessagePack or CBOR and writes JSON text, matching JSON.stringify(decode(input))
+// with integers of any size written as exact decimals. Map entries keep their input order.
+class JsonEmitter : public Reader {
+public:
+  JsonEmitter(Format format, const uint8_t* data, size_t length, std::string& out)
+      : Reader(data, length), format_(format), out_(out) {}
+
+  void Value(size_t depth) {
+    if (depth > kMaxDepth) {
+      throw std::runtime_error("Maximum nesting depth exceeded");
+    }
+    if (format_ == Format::CBOR) {
+      CborValue(depth);
+    } else {
+      MsgpackValue(depth);
+    }
+  }
+
+  // True when the value just read was CBOR undefined, for which nothing was written
+  bool WroteUndefined() const { return undefined_; }
+
+private:
+  void Unsigned(uint64_t value) {
+    char buf[24];
+    int len = std::snprintf(buf, sizeof(buf), "%" PRIu64, value);
+    out_.append(buf, len);
+  }
+
+  void Signed(int64_t value) {
+    char buf[24];
+    int len = std::snprintf(buf, sizeof(buf), "%" PRId64, value);
+    out_.append(buf, len);
+  }
+
+  // -1 - magnitude, for CBOR negative integers and bignums
+  void NegativeFromMagnitude(uint64_t magnitude) {
+    if (magnitude == UINT64_MAX) {
+      out_ += "-18446744073709551616";
+      return;
+    }
+    out_ += '-';
+    Unsigned(magnitude + 1);
+  }
+
+  // Shortest representation that reads back to the same double
+  void Double(double value) {
+    if (!std::isfinite(value)) {
+      out_ += "null";
+      return;
+    }
+    if (std::trunc(value) == value && std::fabs(value) <= kMaxSafeInteger) {
+      Signed(static_cast<int64_t>(value));
+      return;
+    }
+
+    JsonEscape::AppendShortestDouble(value, out_);
+  }
+
+  void String(const uint8_t* p, size_t length) {
+    JsonEscape::AppendEscapedString(reinterpret_cast<const char*>(p), length, out_);
+  }
+
+  // Buffers serialize as Buffer.prototype.toJSON does
+  void Binary(const uint8_t* p, size_t length) {
+    out_ += "{\"type\":\"Buffer\",\"data\":[";
+    for (size_t i = 0; i < length; i++) {
+      if (i > 0) {
+        out_ += ',';
+      }
+      Unsigned(p[i]);
+    }
+    out_ += "]}";
+  }
+
+  void Array(uint64_t count, bool definite, size_t depth) {
+    if (definite && count > length_ - offset_) {
+      throw std::runtime_error("Unexpected end of input");
+    }
+
+    out_ += '[';
+    for (uint64_t i = 0; definite ? i < count : Peek() != kCborBreak; i++) {
+      if (i > 0) {
+        out_ += ',';
+      }
+      Value(depth + 1);
+      if (undefined_) {
+        out_ += "null";
+        undefined_ = false;
+      }
+    }
+    if (!definite) {
+      offset_++;
+    }
+    out_ += ']';
+  }
+
+  void Map(uint64_t count, bool definite, size_t depth) {
+    out_ += '{';
+    bool wroteAny = false;
+    for (uint64_t i = 0; definite ? i < count : Peek() != kCborBreak; i++) {
+      size_t mark = out_.size();
+      if (wroteAny) {
+        out_ += ',';
+      }
+      Key(depth);
+      out_ += ':';
+      Value(depth + 1);
+      if (undefined_) {
+        out_.resize(mark);
+        undefined_ = false;
+        continue;
+      }
+      wroteAny = true;
+    }
+    if (!definite) {
+      offset_++;
+    }
+    out_ += '}';
+  }
+
+  // Keys are written as values; non-string scalars are then quoted like JS property keys
+  void Key(size_t depth) {
+    size_t mark = out_.size();
+    Value(depth + 1);
+
+    if (undefined_) {
+      out_ += "\"undefined\"";
+      undefined_ = false;
+      return;
+    }
+    if (out_[mark] == '"') {
+      return;
+    }
+    if (out_[mark] == '[' || out_[mark] == '{') {
+      throw std::runtime_error("Unsupported map key type");
+    }
+
+    std::string key = out_.substr(mark);
+    out_.resize(mark);
+    JsonEscape::AppendEscapedString(key.data(), key.size(), out_);
+  }
+
+  void MsgpackExt(size_t length) {
+    int8_t type = static_cast<int8_t>(Byte());
+    const uint8_t* p = Take(length);
+
+    if (type != kMsgpackTimestampExt) {
+      Binary(p, length);
+      return;
+    }
+
+    uint64_t first = 0;
+    for (size_t i = 0; i < std::min<size_t>(length, 8); i++) {
+      first = (first << 8) | p[i];
+    }
+
+    if (length == 4) {
+      AppendIsoDate(static_cast<double>(first) * 1000.0, out_);
+    } else if (length == 8) {
+      double seconds = static_cast<double>(first & 0x3ffffffffULL);
+      double nanoseconds = static_cast<double>(first >> 34);
+      AppendIsoDate(seconds * 1000.0 + nanoseconds / 1000000.0, out_);
+    } else if (length == 12) {
+      uint64_t seconds = 0;
+      for (size_t i = 4; i < 12; i++) {
+        seconds = (seconds << 8) | p[i];
+      }
+      double nanoseconds = static_cast<double>(first >> 32);
+      AppendIsoDate(static_cast<double>(static_cast<int64_t>(seconds)) * 1000.0 + nanoseconds / 1000000.0, out_);
+    } else {
+      throw std::runtime_error("Invalid MessagePack timestamp");
+    }
+  }
+
+  void MsgpackValue(size_t depth) {
+    uint8_t type = Byte();
+
+    if (type <= 0x7f) return Unsigned(type);
+    if (type >= 0xe0) return Signed(static_cast<int8_t>(type));
+    if ((type & 0xf0) == 0x80) return Map(type & 0x0f, true, depth);
+    if ((type & 0xf0) == 0x90) return Array(type & 0x0f, true, depth);
+    if ((type & 0xe0) == 0xa0) {
+      size_t length = type & 0x1f;
+      return String(Take(length), length);
+    }
+
+    switch (type) {
+      case 0xc0: out_ += "null"; return;
+      case 0xc2: out_ += "false"; return;
+      case 0xc3: out_ += "true"; return;
+      case 0xc4: case 0xc5: case 0xc6: {
+        size_t length = static_cast<size_t>(BigEndian(1 << (type - 0xc4)));
+        return Binary(Take(length), length);
+      }
+      case 0xc7: case 0xc8: case 0xc9:
+        return MsgpackExt(static_cast<size_t>(BigEndian(1 << (type - 0xc7))));
+      case 0xca: return Double(Float32());
+      case 0xcb: return Double(Float64());
+      case 0xcc: case 0xcd: case 0xce: case 0xcf:
+        return Unsigned(BigEndian(1 << (type - 0xcc)));
+      case 0xd0: return Signed(static_cast<int8_t>(BigEndian(1)));
+      case 0xd1: return Signed(static_cast<int16_t>(BigEndian(2)));
+      case 0xd2: return Signed(static_cast<int32_t>(BigEndian(4)));
+      case 0xd3: return Signed(static_cast<int64_t>(BigEndian(8)));
+      case 0xd4: case 0xd5: case 0xd6: case 0xd7: case 0xd8:
+        return MsgpackExt(static_cast<size_t>(1) << (type - 0xd4));
+      case 0xd9: case 0xda: case 0xdb: {
+        size_t length = static_cast<size_t>(BigEndian(1 << (type - 0xd9)));
+        return String(Take(length), length);
+      }
+      case 0xdc: return Array(BigEndian(2), true, depth);
+      case 0xdd: return Array(BigEndian(4), true, depth);
+      case 0xde: return Map(BigEndian(2), true, depth);
+      case 0xdf: return Map(BigEndian(4), true, depth);
+      default:
+        throw std::runtime_error("Invalid MessagePack type byte");
+    }
+  }
+
+  void CborValue(size_t depth) {
+    uint8_t initial = Byte();
+    uint8_t major = initial >> 5;
+    uint8_t info = initial & 0x1f;
+    uint64_t argument = 0;
+
+    switch (major) {
+      case kCborUint:
+        CborArgument(info, argument);
+        return Unsigned(argument);
+
+      case kCborNegative:
+        CborArgument(info, argument);
+        return NegativeFromMagnitude(argument);
+
+      case kCborBytes:
+      case kCborText: {
+        if (info != 31) {
+          CborArgument(info, argument);
+          const uint8_t* p = Take(argument);
+          return major == kCborText ? String(p, static_cast<size_t>(argument)) : Binary(p, static_cast<size_t>(argument));
+        }
+        std::string chunks;
+        CborChunks(major, info, chunks);
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(chunks.data());
+        return major == kCborText ? String(p, chunks.size()) : Binary(p, chunks.size());
+      }
+
+      case kCborArray: {
+        bool definite = CborArgument(info, argument);
+        return Array(argument, definite, depth);
+      }
+
+      case kCborMap: {
+        bool definite = CborArgument(info, argument);
+        return Map(argument, definite, depth);
+      }
+
+      case kCborTag: {
+        CborArgument(info, argument);
+        uint8_t content = Peek();
+
+        // Tag 1: epoch-based date/time with numeric content
+        if (argument == 1 && ((content >> 5) <= kCborNegative || (content >= 0xf9 && content <= 0xfb))) {
+          size_t mark = out_.size();
+          Value(depth + 1);
+          double seconds = std::strtod(out_.c_str() + mark, nullptr);
+          out_.resize(mark);
+          AppendIsoDate(seconds * 1000.0, out_);
+          return;
+        }
+
+        // Tags 2/3: bignums; those that fit in 64 bits are written as integers
+        if ((argument == 2 || argument == 3) && (content >> 5) == kCborBytes && (content & 0x1f) != 31) {
+          offset_++;
+          uint64_t size;
+          CborArgument(content & 0x1f, size);
+          const uint8_t* p = Take(size);
+          if (size > 8) {
+            return Binary(p, static_cast<size_t>(size));
+          }
+
+          uint64_t magnitude = 0;
+          for (uint64_t i = 0; i < size; i++) {
+            magnitude = (magnitude << 8) | p[i];
+          }
+          return argument == 2 ? Unsigned(magnitude) : NegativeFromMagnitude(magnitude);
+        }
+
+        // Other tags are transparent
+        return Value(depth + 1);
+      }
+
+      case kCborSimple:
+      default:
+        switch (info) {
+          case 20: out_ += "false"; return;
+          case 21: out_ += "true"; return;
+          case 22: out_ += "null"; return;
+          case 24: Byte(); undefined_ = true; return;
+          case 25: return Double(DecodeHalf(static_cast<uint16_t>(BigEndian(2))));
+          case 26: return Double(Float32());
+          case 27: return Double(Float64());
+          case 31: throw std::runtime_error("Unexpected CBOR break");
+          default: undefined_ = true; return;
+        }
+    }
+  }
+
+  Format format_;
+  std::string& out_;
+  // Set by CBOR undefined: the enclosing array writes null and the enclosing map drops the entry
+  bool undefined_ = false;
+};
+
+} // namespace
+
+bool ParseFormat(const std::string& name, Format& format) {
+  if (name == "msgpack" || name == "messagepack") {
+    format = Format::MSGPACK;
+    return true;
+  }
+  if (name == "cbor") {
+    format = Format::CBOR;
+    return true;
+  }
+  return false;
+}
+
+void Encode(Format format, const Napi::Value& value, std::string& out) {
+  Encoder encoder(format, out);
+  encoder.Value(value, 0);
+}
+
+Napi::Value Decode(Napi::Env env, Format format, const uint8_t* data, size_t length) {
+  Decoder decoder(env, format, data, length);
+  Napi::Value value = decoder.Value(0);
+
+  if (!decoder.AtEnd()) {
+    throw std::runtime_error("Unexpected trailing data");
+  }
+
+  return value;
+}
+
+
+void EncodeDocument(Format format, simdjson::dom::element element, std::string& out) {
+  DocumentEncoder encoder(format, out);
+  encoder.Element(element);
+}
+
+void DecodeToJson(Format format, const uint8_t* data, size_t length, std::string& out) {
+  JsonEmitter emitter(format, data, length, out);
+  emitter.Value(0);
+
+  if (emitter.WroteUndefined()) {
+    throw std::runtime_error("undefined is not representable as JSON");
+  }
+
+  if (!emitter.AtEnd()) {
+    throw std::runtime_error("Unexpected trailing data");
+  }
+}
+
+} // namespace BinaryCodec
@@ -0,0 +1,43 @@
+#ifndef BINARY_CODEC_H
+#define BINARY_CODEC_H
+
+#include <napi.h>
+#include <simdjson.h>
+#include <string>
+#include <cstdint>
+
+/**
+ * MessagePack and CBOR codecs
+ *
+ * Encoders walk JS values the same way the JSON stringify path does and write
+ * binary output into a caller-provided byte string. Decoders read a Buffer and
+ * build JS values directly, caching the JS strings of repeated map keys so
+ * arrays of same-shaped records do not re-create their property names.
+ * Transcoders convert between JSON text and either binary format without
+ * touching the JS heap.
+ */
+namespace BinaryCodec {
+
+  enum class Format {
+    MSGPACK = 0,
+    CBOR = 1
+  };
+
+  // Parse a format name ("msgpack" or "cbor"); returns false for unknown names
+  bool ParseFormat(const std::string& name, Format& format);
+
+  // Encode a JS value; throws std::runtime_error on unsupported input
+  void Encode(Format format, const Napi::Value& value, std::string& out);
+
+  // Decode one value from data; throws std::runtime_error on malformed input
+  Napi::Value Decode(Napi::Env env, Format format, const uint8_t* data, size_t length);
+
+  // Transcode a parsed JSON document straight from the simdjson tape; no JS values are created
+  void EncodeDocument(Format format, simdjson::dom::element element, std::string& out);
+
+  // Transcode binary input to JSON text; throws std::runtime_error on malformed input
+  void DecodeToJson(Format format, const uint8_t* data, size_t length, std::string& out);
+
+} // namespace BinaryCodec
+
+#endif // BINARY_CODEC_H
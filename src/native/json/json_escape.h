@@ -0,0 +1,124 @@
+#ifndef JSON_ESCAPE_H
+#define JSON_ESCAPE_H
+
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+/**
+ * JSON text helpers shared by the compiled serializer, binary transcoders
+ * and patch serializer
+ */
+namespace JsonEscape {
+
+  // Lookup table: 1 for bytes that must be escaped inside a JSON string
+  struct EscapeTable {
+    bool needsEscape[256];
+    constexpr EscapeTable() : needsEscape() {
+      for (int i = 0; i < 32; i++) needsEscape[i] = true;
+      needsEscape[static_cast<unsigned char>('"')] = true;
+      needsEscape[static_cast<unsigned char>('\\')] = true;
+    }
+  };
+  constexpr EscapeTable kEscapeTable;
+
+  // Append a quoted, escaped JSON string, bulk-copying runs that need no escaping
+  inline void AppendEscapedString(const char* data, size_t length, std::string& out) {
+    out += '"';
+
+    size_t runStart = 0;
+    for (size_t i = 0; i < length; i++) {
+      unsigned char c = static_cast<unsigned char>(data[i]);
+      if (!kEscapeTable.needsEscape[c]) {
+        continue;
+      }
+
+      out.append(data + runStart, i - runStart);
+      runStart = i + 1;
+
+      switch (c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\b': out += "\\b"; break;
+        case '\f': out += "\\f"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default: {
+          char buf[7];
+          std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+          out.append(buf, 6);
+          break;
+        }
+      }
+    }
+
+    out.append(data + runStart, length - runStart);
+    out += '"';
+  }
+
+  // Append a finite double as Number.prototype.toString (and JSON.stringify) writes it:
+  // the shortest digits that read back exactly, in fixed notation for exponents -7 to 20
+  inline void AppendShortestDouble(double value, std::string& out) {
+    if (value == 0) {
+      out += '0';
+      return;
+    }
+
+    // Up to 15 significant digits always read back uniquely, so rounding to 15 and
+    // dropping trailing zeros finds the shortest form; otherwise try 16 and 17.
+    // Subnormals carry less precision and are searched from one digit up.
+    char buf[40];
+    for (int precision = std::fabs(value) < DBL_MIN ? 0 : 14; precision <= 16; precision++) {
+      std::snprintf(buf, sizeof(buf), "%.*e", precision, value);
+      if (std::strtod(buf, nullptr) == value) {
+        break;
+      }
+    }
+
+    // buf is "[-]d.ddddde[+-]x": collect the digits and the decimal exponent
+    const char* p = buf;
+    if (*p == '-') {
+      out += '-';
+      p++;
+    }
+    char digits[20];
+    int count = 0;
+    for (; *p != 'e'; p++) {
+      if (*p != '.') {
+        digits[count++] = *p;
+      }
+    }
+    while (count > 1 && digits[count - 1] == '0') {
+      count--;
+    }
+    int point = std::atoi(p + 1) + 1;  // Digits before the decimal point
+
+    if (count <= point && point <= 21) {
+      out.append(digits, count);
+      out.append(point - count, '0');
+    } else if (0 < point && point <= 21) {
+      out.append(digits, point);
+      out += '.';
+      out.append(digits + point, count - point);
+    } else if (-6 < point && point <= 0) {
+      out += "0.";
+      out.append(-point, '0');
+      out.append(digits, count);
+    } else {
+      out += digits[0];
+      if (count > 1) {
+        out += '.';
+        out.append(digits + 1, count - 1);
+      }
+      out += 'e';
+      out += point - 1 < 0 ? '-' : '+';
+      out += std::to_string(std::abs(point - 1));
+    }
+  }
+
+} // namespace JsonEscape
+
+#endif // JSON_ESCAPE_H
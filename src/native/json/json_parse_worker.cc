@@ -0,0 +1,207 @@
+#include "json_parse_worker.h"
+#include "json_processor.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+// Slices smaller than this are not worth a pool task of their own
+constexpr size_t kMinSliceSize = 1024 * 1024;
+
+inline bool IsJsonWhitespace(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+} // namespace
+
+// One parseAsync call: the input, and per slice its parser and documents
+struct JsonParseWorker::Job {
+  struct Slice {
+    const char* begin = nullptr;
+    const char* end = nullptr;
+    std::unique_ptr<simdjson::dom::parser> parser;
+    simdjson::dom::element document;                // Whole-document parse
+    std::vector<simdjson::dom::document> lines;     // NDJSON: one document per line
+    std::string error;
+    const char* errorLine = nullptr;                // NDJSON: start of the failing line
+  };
+
+  // Owning JsonProcessor, used to materialize the parsed documents
+  JsonProcessor* owner = nullptr;
+  Napi::ObjectReference ownerRef;
+  Napi::Promise::Deferred deferred;
+
+  // Input: either a referenced Buffer (zero-copy until Execute) or an owned copy
+  Napi::Reference<Napi::Value> inputRef;
+  const char* data = nullptr;
+  size_t length = 0;
+  std::string ownedInput;
+
+  bool ndjson = false;
+  std::vector<Slice> slices;
+  size_t pending = 0;
+
+  explicit Job(Napi::Env env) : deferred(Napi::Promise::Deferred::New(env)) {}
+
+  void ParseDocument(Slice& slice);
+  void ParseLines(Slice& slice);
+  void Settle(Napi::Env env);
+};
+
+Napi::Promise JsonParseWorker::Start(Napi::Env env, JsonProcessor* owner, Napi::Object ownerObj,
+                                     Napi::Value input, bool ndjson, size_t threads) {
+  auto job = std::make_shared<Job>(env);
+  job->owner = owner;
+  job->ndjson = ndjson;
+
+  // Keep the owner alive until the result has been materialized
+  job->ownerRef = Napi::Persistent(ownerObj);
+
+  if (input.IsBuffer()) {
+    // Buffers do not move, so referencing the JS object is enough to read them off-thread
+    Napi::Buffer<char> buffer = input.As<Napi::Buffer<char>>();
+    job->data = buffer.Data();
+    job->length = buffer.Length();
+    job->inputRef = Napi::Persistent(input);
+  } else {
+    job->ownedInput = input.As<Napi::String>().Utf8Value();
+    job->data = job->ownedInput.data();
+    job->length = job->ownedInput.size();
+  }
+
+  // NDJSON slice boundaries always fall just after a newline
+  const char* end = job->data + job->length;
+  std::vector<const char*> bounds{job->data};
+  if (ndjson) {
+    size_t sliceCount = std::min(std::max<size_t>(threads, 1), std::max<size_t>(job->length / kMinSliceSize, 1));
+    for (size_t i = 1; i < sliceCount; i++) {
+      const char* target = job->data + (job->length * i) / sliceCount;
+      if (target <= bounds.back()) continue;
+
+      const char* newline = static_cast<const char*>(std::memchr(target, '\n', end - target));
+      if (newline == nullptr) break;
+      bounds.push_back(newline + 1);
+    }
+  }
+  bounds.push_back(end);
+
+  job->slices.resize(bounds.size() - 1);
+  for (size_t i = 0; i < job->slices.size(); i++) {
+    job->slices[i].begin = bounds[i];
+    job->slices[i].end = bounds[i + 1];
+  }
+  job->pending = job->slices.size();
+
+  Napi::Promise promise = job->deferred.Promise();
+  for (size_t i = 0; i < job->slices.size(); i++) {
+    (new JsonParseWorker(env, job, i))->Queue();
+  }
+  return promise;
+}
+
+JsonParseWorker::JsonParseWorker(Napi::Env env, std::shared_ptr<Job> job, size_t slice)
+    : Napi::AsyncWorker(env, "JsonParseWorker"), job_(std::move(job)), slice_(slice) {}
+
+// Runs on the thread pool: no N-API calls allowed here. Errors are kept on the
+// slice so that the last worker to finish can settle the promise.
+void JsonParseWorker::Execute() {
+  Job::Slice& slice = job_->slices[slice_];
+  try {
+    slice.parser = std::make_unique<simdjson::dom::parser>();
+    if (job_->ndjson) {
+      job_->ParseLines(slice);
+    } else {
+      job_->ParseDocument(slice);
+    }
+  } catch (const std::exception& e) {
+    slice.error = e.what();
+  }
+}
+
+// Parse a single document
+void JsonParseWorker::Job::ParseDocument(Slice& slice) {
+  auto error = slice.parser->parse(slice.begin, slice.end - slice.begin, true).get(slice.document);
+  if (error) {
+    slice.error = std::string("JSON parse error: ") + simdjson::error_message(error);
+  }
+}
+
+// Parse each non-blank line of the slice into a document of its own, so a line
+// holding anything but exactly one value is rejected
+void JsonParseWorker::Job::ParseLines(Slice& slice) {
+  const char* line = slice.begin;
+  while (line < slice.end) {
+    const char* lineEnd = static_cast<const char*>(std::memchr(line, '\n', slice.end - line));
+    if (lineEnd == nullptr) {
+      lineEnd = slice.end;
+    }
+
+    // Trim surrounding whitespace and skip blank lines
+    const char* start = line;
+    const char* stop = lineEnd;
+    while (start < stop && IsJsonWhitespace(*start)) start++;
+    while (stop > start && IsJsonWhitespace(*(stop - 1))) stop--;
+
+    if (start < stop) {
+      // The parser copies each line into its padded buffer, reused across lines
+      slice.lines.emplace_back();
+      simdjson::dom::element root;
+      auto error = slice.parser->parse_into_document(slice.lines.back(), start, stop - start, true).get(root);
+      if (error) {
+        slice.error = std::string("JSON parse error: ") + simdjson::error_message(error);
+        slice.errorLine = line;
+        slice.lines.clear();
+        return;
+      }
+    }
+
+    line = lineEnd + 1;
+  }
+}
+
+// Back on the JS thread: once every slice is parsed, materialize the documents
+void JsonParseWorker::OnOK() {
+  if (--job_->pending == 0) {
+    job_->Settle(Env());
+  }
+}
+
+void JsonParseWorker::Job::Settle(Napi::Env env) {
+  Napi::HandleScope scope(env);
+
+  // Report the first failure in input order
+  for (const Slice& slice : slices) {
+    if (slice.error.empty()) {
+      continue;
+    }
+    std::string message = slice.error;
+    if (slice.errorLine != nullptr) {
+      size_t lineNumber = 1 + std::count(data, slice.errorLine, '\n');
+      message.insert(std::strlen("JSON parse error"), " on line " + std::to_string(lineNumber));
+    }
+    deferred.Reject(Napi::Error::New(env, message).Value());
+    return;
+  }
+
+  Napi::Value result;
+  if (!ndjson) {
+    result = owner->ConvertDOMValueToNapi(env, slices.front().document);
+  } else {
+    Napi::Array values = Napi::Array::New(env);
+    uint32_t index = 0;
+    for (const Slice& slice : slices) {
+      for (const simdjson::dom::document& document : slice.lines) {
+        values.Set(index++, owner->ConvertDOMValueToNapi(env, document.root()));
+      }
+    }
+    result = values;
+  }
+
+  if (env.IsExceptionPending()) {
+    deferred.Reject(env.GetAndClearPendingException().Value());
+    return;
+  }
+
+  deferred.Resolve(result);
+}
@@ -0,0 +1,42 @@
+#ifndef JSON_PARSE_WORKER_H
+#define JSON_PARSE_WORKER_H
+
+#include <napi.h>
+#include <simdjson.h>
+#include <string>
+#include <vector>
+#include <memory>
+
+class JsonProcessor;
+
+/**
+ * Off-thread JSON parse
+ *
+ * Runs simdjson stage 1 (structural indexing) and stage 2 (tape building) on
+ * the libuv thread pool, then materializes JS values on the JS thread in
+ * OnOK(). NDJSON input is split on line boundaries into slices that are
+ * queued as separate pool tasks, each with its own parser, so large imports
+ * scale with cores instead of blocking the event loop. Every line is parsed
+ * as its own document and must hold exactly one value.
+ */
+class JsonParseWorker : public Napi::AsyncWorker {
+public:
+  // Queue the parse of `input` and return the promise settled with its result
+  static Napi::Promise Start(Napi::Env env, JsonProcessor* owner, Napi::Object ownerObj,
+                             Napi::Value input, bool ndjson, size_t threads);
+
+protected:
+  void Execute() override;
+  void OnOK() override;
+
+private:
+  struct Job;
+
+  JsonParseWorker(Napi::Env env, std::shared_ptr<Job> job, size_t slice);
+
+  // Shared by the workers of one call; the last to finish settles the promise
+  std::shared_ptr<Job> job_;
+  size_t slice_;
+};
+
+#endif // JSON_PARSE_WORKER_H
@@ -0,0 +1,527 @@
+#include "json_patch.h"
+#include "json_escape.h"
+#include <cinttypes>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace JsonPatch {
+
+namespace {
+
+using simdjson::dom::element;
+using simdjson::dom::element_type;
+
+// Write a DOM subtree as compact JSON
+void WriteElement(element value, std::string& out) {
+  switch (value.type()) {
+    case element_type::ARRAY: {
+      simdjson::dom::array array = value.get_array().value();
+      out += '[';
+      bool first = true;
+      for (element item : array) {
+        if (!first) {
+          out += ',';
+        }
+        first = false;
+        WriteElement(item, out);
+      }
+      out += ']';
+      break;
+    }
+    case element_type::OBJECT: {
+      simdjson::dom::object object = value.get_object().value();
+      out += '{';
+      bool first = true;
+      for (simdjson::dom::key_value_pair field : object) {
+        if (!first) {
+          out += ',';
+        }
+        first = false;
+        JsonEscape::AppendEscapedString(field.key.data(), field.key.size(), out);
+        out += ':';
+        WriteElement(field.value, out);
+      }
+      out += '}';
+      break;
+    }
+    case element_type::INT64: {
+      char buf[24];
+      int len = std::snprintf(buf, sizeof(buf), "%" PRId64, value.get_int64().value());
+      out.append(buf, len);
+      break;
+    }
+    case element_type::UINT64: {
+      char buf[24];
+      int len = std::snprintf(buf, sizeof(buf), "%" PRIu64, value.get_uint64().value());
+      out.append(buf, len);
+      break;
+    }
+    case element_type::DOUBLE:
+      JsonEscape::AppendShortestDouble(value.get_double().value(), out);
+      break;
+    case element_type::STRING: {
+      std::string_view text = value.get_string().value();
+      JsonEscape::AppendEscapedString(text.data(), text.size(), out);
+      break;
+    }
+    case element_type::BOOL:
+      out += value.get_bool().value() ? "true" : "false";
+      break;
+    case element_type::NULL_VALUE:
+    default:
+      out += "null";
+      break;
+  }
+}
+
+// Mutable value that stays a reference into the DOM until a patch descends into it
+class Node {
+public:
+  enum class Kind : uint8_t { SOURCE, NULL_VALUE, ARRAY, OBJECT };
+
+  Node() : kind_(Kind::NULL_VALUE) {}
+  explicit Node(element source) : kind_(Kind::SOURCE), source_(source) {}
+
+  static Node EmptyObject() {
+    Node node;
+    node.kind_ = Kind::OBJECT;
+    return node;
+  }
+
+  // Containers are expanded one level; scalars stay as DOM references
+  bool IsArray() const {
+    return kind_ == Kind::ARRAY || (kind_ == Kind::SOURCE && source_.type() == element_type::ARRAY);
+  }
+
+  bool IsObject() const {
+    return kind_ == Kind::OBJECT || (kind_ == Kind::SOURCE && source_.type() == element_type::OBJECT);
+  }
+
+  bool IsNull() const {
+    return kind_ == Kind::NULL_VALUE || (kind_ == Kind::SOURCE && source_.type() == element_type::NULL_VALUE);
+  }
+
+  void Materialize() {
+    if (kind_ != Kind::SOURCE) {
+      return;
+    }
+
+    if (source_.type() == element_type::ARRAY) {
+      simdjson::dom::array array = source_.get_array().value();
+      items_.reserve(array.size());
+      for (element item : array) {
+        items_.emplace_back(item);
+      }
+      kind_ = Kind::ARRAY;
+    } else if (source_.type() == element_type::OBJECT) {
+      simdjson::dom::object object = source_.get_object().value();
+      members_.reserve(object.size());
+      for (simdjson::dom::key_value_pair field : object) {
+        members_.emplace_back(std::string(field.key), Node(field.value));
+      }
+      kind_ = Kind::OBJECT;
+    }
+  }
+
+  std::vector<Node>& Items() {
+    Materialize();
+    return items_;
+  }
+
+  std::vector<std::pair<std::string, Node>>& Members() {
+    Materialize();
+    return members_;
+  }
+
+  Node* FindMember(const std::string& key) {
+    for (auto& member : Members()) {
+      if (member.first == key) {
+        return &member.second;
+      }
+    }
+    return nullptr;
+  }
+
+  void SetMember(const std::string& key, Node value) {
+    Node* existing = FindMember(key);
+    if (existing != nullptr) {
+      *existing = std::move(value);
+    } else {
+      members_.emplace_back(key, std::move(value));
+    }
+  }
+
+  bool RemoveMember(const std::string& key) {
+    auto& members = Members();
+    for (auto it = members.begin(); it != members.end(); ++it) {
+      if (it->first == key) {
+        members.erase(it);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void Write(std::string& out) const {
+    switch (kind_) {
+      case Kind::SOURCE:
+        WriteElement(source_, out);
+        break;
+      case Kind::NULL_VALUE:
+        out += "null";
+        break;
+      case Kind::ARRAY:
+        out += '[';
+        for (size_t i = 0; i < items_.size(); i++) {
+          if (i > 0) {
+            out += ',';
+          }
+          items_[i].Write(out);
+        }
+        out += ']';
+        break;
+      case Kind::OBJECT:
+        out += '{';
+        for (size_t i = 0; i < members_.size(); i++) {
+          if (i > 0) {
+            out += ',';
+          }
+          JsonEscape::AppendEscapedString(members_[i].first.data(), members_[i].first.size(), out);
+          out += ':';
+          members_[i].second.Write(out);
+        }
+        out += '}';
+        break;
+    }
+  }
+
+  // Structural equality; numbers compare by value (1 equals 1.0)
+  static bool Equal(Node& a, Node& b) {
+    if (a.kind_ == Kind::SOURCE && b.kind_ == Kind::SOURCE && !a.IsArray() && !a.IsObject()) {
+      return ScalarEqual(a.source_, b.source_);
+    }
+    if (a.IsNull() || b.IsNull()) {
+      return a.IsNull() && b.IsNull();
+    }
+    if (a.IsArray() != b.IsArray() || a.IsObject() != b.IsObject()) {
+      return false;
+    }
+
+    if (a.IsArray()) {
+      auto& left = a.Items();
+      auto& right = b.Items();
+      if (left.size() != right.size()) {
+        return false;
+      }
+      for (size_t i = 0; i < left.size(); i++) {
+        if (!Equal(left[i], right[i])) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    if (a.IsObject()) {
+      auto& left = a.Members();
+      if (left.size() != b.Members().size()) {
+        return false;
+      }
+      for (auto& member : left) {
+        Node* other = b.FindMember(member.first);
+        if (other == nullptr || !Equal(member.second, *other)) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    // Scalar against materialized container or null handled above
+    return a.kind_ == Kind::SOURCE && b.kind_ == Kind::SOURCE && ScalarEqual(a.source_, b.source_);
+  }
+
+private:
+  static bool IsNumber(element_type type) {
+    return type == element_type::INT64 || type == element_type::UINT64 || type == element_type::DOUBLE;
+  }
+
+  static bool ScalarEqual(element a, element b) {
+    element_type typeA = a.type();
+    element_type typeB = b.type();
+
+    if (IsNumber(typeA) && IsNumber(typeB)) {
+      if (typeA == typeB && typeA == element_type::INT64) {
+        return a.get_int64().value() == b.get_int64().value();
+      }
+      if (typeA == typeB && typeA == element_type::UINT64) {
+        return a.get_uint64().value() == b.get_uint64().value();
+      }
+      return a.get_double().value() == b.get_double().value();
+    }
+
+    if (typeA != typeB) {
+      return false;
+    }
+
+    switch (typeA) {
+      case element_type::STRING: return a.get_string().value() == b.get_string().value();
+      case element_type::BOOL: return a.get_bool().value() == b.get_bool().value();
+      case element_type::NULL_VALUE: return true;
+      default: return false;
+    }
+  }
+
+  Kind kind_;
+  element source_;
+  std::vector<Node> items_;
+  std::vector<std::pair<std::string, Node>> members_;
+};
+
+// Split a JSON Pointer (RFC 6901) into unescaped reference tokens
+std::vector<std::string> ParsePointer(std::string_view pointer) {
+  std::vector<std::string> tokens;
+  if (pointer.empty()) {
+    return tokens;
+  }
+  if (pointer[0] != '/') {
+    throw std::runtime_error("Invalid JSON Pointer: " + std::string(pointer));
+  }
+
+  std::string token;
+  for (size_t i = 1; i <= pointer.size(); i++) {
+    if (i == pointer.size() || pointer[i] == '/') {
+      tokens.push_back(std::move(token));
+      token.clear();
+    } else if (pointer[i] == '~') {
+      if (i + 1 >= pointer.size() || (pointer[i + 1] != '0' && pointer[i + 1] != '1')) {
+        throw std::runtime_error("Invalid JSON Pointer escape: " + std::string(pointer));
+      }
+      token += pointer[++i] == '0' ? '~' : '/';
+    } else {
+      token += pointer[i];
+    }
+  }
+  return tokens;
+}
+
+// Array index token: digits without leading zeros; "-" only when allowed (append)
+size_t ParseIndex(const std::string& token, size_t size, bool allowEnd) {
+  if (allowEnd && token == "-") {
+    return size;
+  }
+  if (token.empty() || token.size() > 10 || (token.size() > 1 && token[0] == '0')) {
+    throw std::runtime_error("Invalid array index: " + token);
+  }
+
+  size_t index = 0;
+  for (char c : token) {
+    if (c < '0' || c > '9') {
+      throw std::runtime_error("Invalid array index: " + token);
+    }
+    index = index * 10 + static_cast<size_t>(c - '0');
+  }
+
+  if (index > size || (!allowEnd && index == size)) {
+    throw std::runtime_error("Array index out of range: " + token);
+  }
+  return index;
+}
+
+// Applies RFC 6902 operations to a lazily materialized document
+class Patcher {
+public:
+  explicit Patcher(element document) : root_(document) {}
+
+  Node& Root() {
+    return root_;
+  }
+
+  void ApplyOperation(element operation) {
+    if (operation.type() != element_type::OBJECT) {
+      throw std::runtime_error("Patch operation must be an object");
+    }
+
+    std::string_view op = StringMember(operation, "op");
+    std::string_view path = StringMember(operation, "path");
+
+    if (op == "add") {
+      Add(ParsePointer(path), Node(ValueMember(operation)));
+    } else if (op == "remove") {
+      Remove(ParsePointer(path));
+    } else if (op == "replace") {
+      Resolve(ParsePointer(path)) = Node(ValueMember(operation));
+    } else if (op == "move") {
+      std::string_view from = StringMember(operation, "from");
+      if (path.size() > from.size() && path.compare(0, from.size(), from) == 0 && path[from.size()] == '/') {
+        throw std::runtime_error("Cannot move a value into one of its children");
+      }
+      if (from != path) {
+        Add(ParsePointer(path), Remove(ParsePointer(from)));
+      }
+    } else if (op == "copy") {
+      Add(ParsePointer(path), Node(Resolve(ParsePointer(StringMember(operation, "from")))));
+    } else if (op == "test") {
+      Node expected(ValueMember(operation));
+      if (!Node::Equal(Resolve(ParsePointer(path)), expected)) {
+        throw std::runtime_error("Test operation failed at " + std::string(path));
+      }
+    } else {
+      throw std::runtime_error("Unknown patch operation: " + std::string(op));
+    }
+  }
+
+private:
+  static std::string_view StringMember(element operation, const char* name) {
+    std::string_view value;
+    if (operation[name].get(value)) {
+      throw std::runtime_error(std::string("Patch operation is missing \"") + name + "\"");
+    }
+    return value;
+  }
+
+  static element ValueMember(element operation) {
+    element value;
+    if (operation["value"].get(value)) {
+      throw std::runtime_error("Patch operation is missing \"value\"");
+    }
+    return value;
+  }
+
+  Node& Resolve(const std::vector<std::string>& tokens, size_t count) {
+    Node* node = &root_;
+    for (size_t i = 0; i < count; i++) {
+      const std::string& token = tokens[i];
+      if (node->IsObject()) {
+        node = node->FindMember(token);
+        if (node == nullptr) {
+          throw std::runtime_error("Path not found: /" + token);
+        }
+      } else if (node->IsArray()) {
+        auto& items = node->Items();
+        node = &items[ParseIndex(token, items.size(), false)];
+      } else {
+        throw std::runtime_error("Path not found: /" + token);
+      }
+    }
+    return *node;
+  }
+
+  Node& Resolve(const std::vector<std::string>& tokens) {
+    return Resolve(tokens, tokens.size());
+  }
+
+  void Add(const std::vector<std::string>& tokens, Node value) {
+    if (tokens.empty()) {
+      root_ = std::move(value);
+      return;
+    }
+
+    Node& parent = Resolve(tokens, tokens.size() - 1);
+    const std::string& last = tokens.back();
+    if (parent.IsObject()) {
+      parent.SetMember(last, std::move(value));
+    } else if (parent.IsArray()) {
+      auto& items = parent.Items();
+      size_t index = ParseIndex(last, items.size(), true);
+      items.insert(items.begin() + index, std::move(value));
+    } else {
+      throw std::runtime_error("Cannot add to a scalar value");
+    }
+  }
+
+  Node Remove(const std::vector<std::string>& tokens) {
+    if (tokens.empty()) {
+      throw std::runtime_error("Cannot remove the document root");
+    }
+
+    Node& parent = Resolve(tokens, tokens.size() - 1);
+    const std::string& last = tokens.back();
+    if (parent.IsObject()) {
+      Node* member = parent.FindMember(last);
+      if (member == nullptr) {
+        throw std::runtime_error("Path not found: /" + last);
+      }
+      Node removed = std::move(*member);
+      parent.RemoveMember(last);
+      return removed;
+    }
+    if (parent.IsArray()) {
+      auto& items = parent.Items();
+      size_t index = ParseIndex(last, items.size(), false);
+      Node removed = std::move(items[index]);
+      items.erase(items.begin() + index);
+      return removed;
+    }
+    throw std::runtime_error("Path not found: /" + last);
+  }
+
+  Node root_;
+};
+
+// RFC 7396: objects merge recursively, null deletes, anything else replaces
+void MergePatch(Node& target, element patch) {
+  if (patch.type() != element_type::OBJECT) {
+    target = Node(patch);
+    return;
+  }
+
+  if (!target.IsObject()) {
+    target = Node::EmptyObject();
+  }
+
+  simdjson::dom::object fields = patch.get_object().value();
+  for (simdjson::dom::key_value_pair field : fields) {
+    std::string key(field.key);
+    if (field.value.type() == element_type::NULL_VALUE) {
+      target.RemoveMember(key);
+      continue;
+    }
+
+    Node* existing = target.FindMember(key);
+    if (existing == nullptr) {
+      target.SetMember(key, Node());
+      existing = target.FindMember(key);
+    }
+    MergePatch(*existing, field.value);
+  }
+}
+
+} // namespace
+
+bool ParseMode(const std::string& name, Mode& mode) {
+  if (name == "auto") {
+    mode = Mode::AUTO;
+  } else if (name == "json-patch") {
+    mode = Mode::JSON_PATCH;
+  } else if (name == "merge-patch") {
+    mode = Mode::MERGE_PATCH;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+void Apply(Mode mode, element document, element patch, std::string& out) {
+  if (mode == Mode::AUTO) {
+    mode = patch.type() == element_type::ARRAY ? Mode::JSON_PATCH : Mode::MERGE_PATCH;
+  }
+
+  Patcher patcher(document);
+
+  if (mode == Mode::JSON_PATCH) {
+    if (patch.type() != element_type::ARRAY) {
+      throw std::runtime_error("JSON Patch must be an array of operations");
+    }
+    simdjson::dom::array operations = patch.get_array().value();
+    for (element operation : operations) {
+      patcher.ApplyOperation(operation);
+    }
+  } else {
+    MergePatch(patcher.Root(), patch);
+  }
+
+  patcher.Root().Write(out);
+}
+
+} // namespace JsonPatch
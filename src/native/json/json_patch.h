@@ -0,0 +1,32 @@
+#ifndef JSON_PATCH_H
+#define JSON_PATCH_H
+
+#include <simdjson.h>
+#include <string>
+
+/**
+ * RFC 6902 JSON Patch and RFC 7396 Merge Patch
+ *
+ * The target document stays in the simdjson DOM; only the containers on the
+ * paths a patch touches are copied into mutable nodes. Untouched subtrees are
+ * serialized straight from the tape, so the cost of a small patch against a
+ * large document is one parse plus one write of the result.
+ */
+namespace JsonPatch {
+
+  enum class Mode {
+    AUTO = 0,        // Array patch: JSON Patch, anything else: Merge Patch
+    JSON_PATCH = 1,  // RFC 6902
+    MERGE_PATCH = 2  // RFC 7396
+  };
+
+  // Parse a mode name ("auto", "json-patch" or "merge-patch"); returns false for unknown names
+  bool ParseMode(const std::string& name, Mode& mode);
+
+  // Apply patch to document and append the result as compact JSON.
+  // Throws std::runtime_error when an operation fails; nothing is written then.
+  void Apply(Mode mode, simdjson::dom::element document, simdjson::dom::element patch, std::string& out);
+
+} // namespace JsonPatch
+
+#endif // JSON_PATCH_H
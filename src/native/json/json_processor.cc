@@ -1,4 +1,9 @@
 #include "json_processor.h"
+#include "json_serializer.h"
+#include "json_stringify_cursor.h"
+#include "json_parse_worker.h"
+#include "json_patch.h"
+#include <thread>
 #include <sstream>
 #include <iomanip>
 #include <cmath>
@@ -8,8 +13,16 @@
 #include <vector>
 #include <cinttypes>
 #include <limits>
+#include <algorithm>
 #include <simdjson.h>
 
+namespace {
+
+// Largest integer a JS number represents exactly (2^53 - 1)
+constexpr int64_t kMaxSafeInteger = 9007199254740991LL;
+
+} // namespace
+
 // Initialize the JSON processor class
 Napi::Object JsonProcessor::Init(Napi::Env env, Napi::Object exports) {
   // Define the JsonProcessor class
@@ -17,13 +30,27 @@ Napi::Object JsonProcessor::Init(Napi::Env env, Napi::Object exports) {
     InstanceMethod("parse", &JsonProcessor::Parse),
     InstanceMethod("parseBuffer", &JsonProcessor::ParseBuffer),
     InstanceMethod("parseStream", &JsonProcessor::ParseStream),
+    InstanceMethod("parseAsync", &JsonProcessor::ParseAsync),
     InstanceMethod("stringify", &JsonProcessor::Stringify),
     InstanceMethod("stringifyStream", &JsonProcessor::StringifyStream),
+    InstanceMethod("compileSerializer", &JsonProcessor::CompileSerializer),
+    InstanceMethod("createStringifyCursor", &JsonProcessor::CreateStringifyCursor),
+    InstanceMethod("encode", &JsonProcessor::Encode),
+    InstanceMethod("decode", &JsonProcessor::Decode),
+    InstanceMethod("jsonToMsgpack", &JsonProcessor::JsonToMsgpack),
+    InstanceMethod("msgpackToJson", &JsonProcessor::MsgpackToJson),
+    InstanceMethod("jsonToCbor", &JsonProcessor::JsonToCbor),
+    InstanceMethod("cborToJson", &JsonProcessor::CborToJson),
+    InstanceMethod("applyPatch", &JsonProcessor::ApplyPatch),
     InstanceMethod("setParserMode", &JsonProcessor::SetParserMode),
     InstanceMethod("getParserMode", &JsonProcessor::GetParserMode),
+    InstanceMethod("setBigIntMode", &JsonProcessor::SetBigIntMode),
+    InstanceMethod("getBigIntMode", &JsonProcessor::GetBigIntMode),
     InstanceMethod("setBufferSize", &JsonProcessor::SetBufferSize),
     InstanceMethod("getBufferSize", &JsonProcessor::GetBufferSize),
     InstanceMethod("releaseBuffers", &JsonProcessor::ReleaseBuffers),
+    InstanceMethod("setAsyncThreshold", &JsonProcessor::SetAsyncThreshold),
+    InstanceMethod("getBufferStats", &JsonProcessor::GetBufferStats),
   });
 
   // Create a constructor
@@ -34,6 +61,10 @@ Napi::Object JsonProcessor::Init(Napi::Env env, Napi::Object exports) {
   // Add to cleanup list
   nexurejs::AddCleanupReference(constructor);
 
+  // Register the schema-compiled serializer and chunked stringify classes
+  CompiledSerializer::Init(env);
+  StringifyCursor::Init(env);
+
   // Set export
   exports.Set("JsonProcessor", func);
   return exports;
@@ -42,8 +73,8 @@ Napi::Object JsonProcessor::Init(Napi::Env env, Napi::Object exports) {
 // Constructor
 JsonProcessor::JsonProcessor(const Napi::CallbackInfo& info)
     : Napi::ObjectWrap<JsonProcessor>(info) {
-  // Pre-allocate string buffer
-  stringBuffer_.reserve(initialStringBufferSize_);
+  // Pre-allocate output buffer
+  output_.Configure(initialStringBufferSize_, maxStringBufferSize_);
 
   // Pre-allocate padded buffer for simdjson
   paddedBuffer_.reserve(initialPaddedBufferSize_);
@@ -60,17 +91,51 @@ JsonProcessor::JsonProcessor(const Napi::CallbackInfo& info)
       }
     }
 
+    // Set large integer policy if provided
+    if (options.Has("bigIntMode") && options.Get("bigIntMode").IsString()) {
+      BigIntMode mode;
+      if (ParseBigIntMode(options.Get("bigIntMode").As<Napi::String>().Utf8Value(), mode)) {
+        bigIntMode_ = mode;
+      }
+    }
+
     // Set buffer size if provided
     if (options.Has("bufferSize") && options.Get("bufferSize").IsNumber()) {
       size_t sizeValue = options.Get("bufferSize").As<Napi::Number>().Uint32Value();
       if (sizeValue > 1024) {
         initialStringBufferSize_ = sizeValue;
         initialPaddedBufferSize_ = sizeValue;
+        maxStringBufferSize_ = std::max(maxStringBufferSize_, sizeValue);
         // Reallocate buffers
-        stringBuffer_.reserve(initialStringBufferSize_);
+        output_.Configure(initialStringBufferSize_, maxStringBufferSize_);
         paddedBuffer_.reserve(initialPaddedBufferSize_);
       }
     }
+
+    // Set off-thread parse threshold if provided
+    if (options.Has("asyncThreshold") && options.Get("asyncThreshold").IsNumber()) {
+      int64_t threshold = options.Get("asyncThreshold").As<Napi::Number>().Int64Value();
+      asyncThreshold_ = threshold > 0 ? static_cast<size_t>(threshold) : 0;
+    }
+
+    // Set retained output buffer cap if provided
+    if (options.Has("maxBufferSize") && options.Get("maxBufferSize").IsNumber()) {
+      size_t maxValue = options.Get("maxBufferSize").As<Napi::Number>().Uint32Value();
+      maxStringBufferSize_ = std::max(maxValue, initialStringBufferSize_);
+      output_.Configure(initialStringBufferSize_, maxStringBufferSize_);
+    }
+
+    // Set parser pool retention if provided
+    size_t maxParserCapacity = parsers_.MaxCapacity();
+    uint32_t parserIdleCalls = parsers_.IdleCalls();
+    if (options.Has("maxParserCapacity") && options.Get("maxParserCapacity").IsNumber()) {
+      int64_t capacity = options.Get("maxParserCapacity").As<Napi::Number>().Int64Value();
+      maxParserCapacity = capacity > 0 ? static_cast<size_t>(capacity) : 0;
+    }
+    if (options.Has("parserIdleCalls") && options.Get("parserIdleCalls").IsNumber()) {
+      parserIdleCalls = options.Get("parserIdleCalls").As<Napi::Number>().Uint32Value();
+    }
+    parsers_.Configure(maxParserCapacity, parserIdleCalls);
   }
 }
 
@@ -117,6 +182,50 @@ Napi::Value JsonProcessor::GetParserMode(const Napi::CallbackInfo& info) {
   return Napi::Number::New(env, static_cast<int>(parserMode_));
 }
 
+// Map a large integer policy name to its mode
+bool JsonProcessor::ParseBigIntMode(const std::string& name, BigIntMode& mode) {
+  if (name == "number") {
+    mode = BigIntMode::NUMBER;
+  } else if (name == "bigint") {
+    mode = BigIntMode::BIGINT;
+  } else if (name == "string") {
+    mode = BigIntMode::STRING;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// Set how integers beyond 2^53 are returned ("number", "bigint" or "string")
+Napi::Value JsonProcessor::SetBigIntMode(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "String expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  BigIntMode mode;
+  if (!ParseBigIntMode(info[0].As<Napi::String>().Utf8Value(), mode)) {
+    Napi::TypeError::New(env, "BigInt mode must be 'number', 'bigint' or 'string'").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  bigIntMode_ = mode;
+  return env.Undefined();
+}
+
+// Get current large integer policy
+Napi::Value JsonProcessor::GetBigIntMode(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  switch (bigIntMode_) {
+    case BigIntMode::NUMBER: return Napi::String::New(env, "number");
+    case BigIntMode::STRING: return Napi::String::New(env, "string");
+    case BigIntMode::BIGINT:
+    default: return Napi::String::New(env, "bigint");
+  }
+}
+
 // Set buffer size for various internal buffers
 Napi::Value JsonProcessor::SetBufferSize(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
@@ -139,9 +248,10 @@ Napi::Value JsonProcessor::SetBufferSize(const Napi::CallbackInfo& info) {
   // Update internal buffer sizes
   initialStringBufferSize_ = newSize;
   initialPaddedBufferSize_ = newSize;
+  maxStringBufferSize_ = std::max(maxStringBufferSize_, newSize);
 
   // Reserve string buffers
-  stringBuffer_.reserve(newSize);
+  output_.Configure(initialStringBufferSize_, maxStringBufferSize_);
   paddedBuffer_.reserve(newSize);
 
   return Napi::Number::New(env, newSize);
@@ -158,9 +268,10 @@ Napi::Value JsonProcessor::ReleaseBuffers(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
 
   // Clear string buffers and reallocate with initial size
-  stringBuffer_.clear();
-  stringBuffer_.shrink_to_fit();
-  stringBuffer_.reserve(initialStringBufferSize_);
+  output_.Release();
+
+  // Drop every idle parser; the next parse allocates to its document size
+  parsers_.Release();
 
   paddedBuffer_.clear();
   paddedBuffer_.shrink_to_fit();
@@ -176,6 +287,252 @@ Napi::Value JsonProcessor::ReleaseBuffers(const Napi::CallbackInfo& info) {
   return env.Undefined();
 }
 
+// Encode a JS value as MessagePack or CBOR into a Buffer
+Napi::Value JsonProcessor::Encode(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1) {
+    Napi::TypeError::New(env, "Value expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  BinaryCodec::Format format = BinaryCodec::Format::MSGPACK;
+  if (info.Length() > 1 && info[1].IsString() &&
+      !BinaryCodec::ParseFormat(info[1].As<Napi::String>().Utf8Value(), format)) {
+    Napi::TypeError::New(env, "Unknown binary format").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  try {
+    std::string& result = output_.Begin(1024);
+    BinaryCodec::Encode(format, info[0], result);
+    Napi::Buffer<char> buffer = Napi::Buffer<char>::Copy(env, result.data(), result.size());
+    output_.End();
+    return buffer;
+  } catch (const std::exception& e) {
+    output_.End();
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+// Decode a MessagePack or CBOR Buffer into a JS value
+Napi::Value JsonProcessor::Decode(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsBuffer()) {
+    Napi::TypeError::New(env, "Buffer expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  BinaryCodec::Format format = BinaryCodec::Format::MSGPACK;
+  if (info.Length() > 1 && info[1].IsString() &&
+      !BinaryCodec::ParseFormat(info[1].As<Napi::String>().Utf8Value(), format)) {
+    Napi::TypeError::New(env, "Unknown binary format").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  Napi::Buffer<uint8_t> buffer = info[0].As<Napi::Buffer<uint8_t>>();
+
+  try {
+    return BinaryCodec::Decode(env, format, buffer.Data(), buffer.Length());
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+// Transcoders: JSON text in, binary bytes out (and back) without building JS values
+Napi::Value JsonProcessor::JsonToMsgpack(const Napi::CallbackInfo& info) {
+  return TranscodeFromJson(info, BinaryCodec::Format::MSGPACK);
+}
+
+Napi::Value JsonProcessor::MsgpackToJson(const Napi::CallbackInfo& info) {
+  return TranscodeToJson(info, BinaryCodec::Format::MSGPACK);
+}
+
+Napi::Value JsonProcessor::JsonToCbor(const Napi::CallbackInfo& info) {
+  return TranscodeFromJson(info, BinaryCodec::Format::CBOR);
+}
+
+Napi::Value JsonProcessor::CborToJson(const Napi::CallbackInfo& info) {
+  return TranscodeToJson(info, BinaryCodec::Format::CBOR);
+}
+
+// Parse JSON into the DOM tape and write it out in a binary format
+Napi::Value JsonProcessor::TranscodeFromJson(const Napi::CallbackInfo& info, BinaryCodec::Format format) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || (!info[0].IsBuffer() && !info[0].IsString())) {
+    Napi::TypeError::New(env, "String or Buffer expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  std::string json;
+  const char* inputData;
+  size_t inputLength;
+  if (info[0].IsBuffer()) {
+    Napi::Buffer<char> buffer = info[0].As<Napi::Buffer<char>>();
+    inputData = buffer.Data();
+    inputLength = buffer.Length();
+  } else {
+    json = info[0].As<Napi::String>().Utf8Value();
+    inputData = json.data();
+    inputLength = json.size();
+  }
+
+  ParserPool::Lease parser = parsers_.Acquire(inputLength);
+  simdjson::dom::element document;
+  simdjson::error_code error = parser->parse(inputData, inputLength).get(document);
+
+  if (error) {
+    std::string errorMsg = std::string("JSON parse error: ") + simdjson::error_message(error);
+    Napi::Error::New(env, errorMsg).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  try {
+    // Binary output is usually smaller than the JSON text it came from
+    std::string& result = output_.Begin(inputLength + 16);
+    BinaryCodec::EncodeDocument(format, document, result);
+    Napi::Buffer<char> buffer = Napi::Buffer<char>::Copy(env, result.data(), result.size());
+    output_.End();
+    return buffer;
+  } catch (const std::exception& e) {
+    output_.End();
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+// Read binary input and write JSON text as a Buffer
+Napi::Value JsonProcessor::TranscodeToJson(const Napi::CallbackInfo& info, BinaryCodec::Format format) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsBuffer()) {
+    Napi::TypeError::New(env, "Buffer expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  Napi::Buffer<uint8_t> input = info[0].As<Napi::Buffer<uint8_t>>();
+
+  try {
+    std::string& result = output_.Begin(input.Length() * 2);
+    BinaryCodec::DecodeToJson(format, input.Data(), input.Length(), result);
+    Napi::Buffer<char> buffer = Napi::Buffer<char>::Copy(env, result.data(), result.size());
+    output_.End();
+    return buffer;
+  } catch (const std::exception& e) {
+    output_.End();
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+// Apply a JSON Patch or Merge Patch to a document and return the result as a Buffer
+Napi::Value JsonProcessor::ApplyPatch(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2 ||
+      (!info[0].IsBuffer() && !info[0].IsString()) ||
+      (!info[1].IsBuffer() && !info[1].IsString())) {
+    Napi::TypeError::New(env, "Document and patch must be strings or Buffers").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  JsonPatch::Mode mode = JsonPatch::Mode::AUTO;
+  if (info.Length() > 2 && info[2].IsObject()) {
+    Napi::Object options = info[2].As<Napi::Object>();
+    if (options.Has("type") && options.Get("type").IsString() &&
+        !JsonPatch::ParseMode(options.Get("type").As<Napi::String>().Utf8Value(), mode)) {
+      Napi::TypeError::New(env, "Patch type must be 'auto', 'json-patch' or 'merge-patch'").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+  }
+
+  // Strings are converted first so each document can lease a parser sized for it
+  auto inputBytes = [](const Napi::Value& input, std::string& text, const char*& data, size_t& length) {
+    if (input.IsBuffer()) {
+      Napi::Buffer<char> buffer = input.As<Napi::Buffer<char>>();
+      data = buffer.Data();
+      length = buffer.Length();
+      return;
+    }
+    text = input.As<Napi::String>().Utf8Value();
+    data = text.data();
+    length = text.size();
+  };
+
+  std::string documentText;
+  std::string patchText;
+  const char* documentData;
+  const char* patchData;
+  size_t documentLength;
+  size_t patchLength;
+  inputBytes(info[0], documentText, documentData, documentLength);
+  inputBytes(info[1], patchText, patchData, patchLength);
+
+  // Both documents stay alive together, so they need separate parsers
+  ParserPool::Lease documentParser = parsers_.Acquire(documentLength);
+  ParserPool::Lease patchParser = parsers_.Acquire(patchLength);
+  simdjson::dom::element document;
+  simdjson::dom::element patch;
+
+  auto error = documentParser->parse(documentData, documentLength).get(document);
+  if (!error) {
+    error = patchParser->parse(patchData, patchLength).get(patch);
+  }
+  if (error) {
+    std::string errorMsg = std::string("JSON parse error: ") + simdjson::error_message(error);
+    Napi::Error::New(env, errorMsg).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  try {
+    std::string& result = output_.Begin(documentLength + patchLength);
+    JsonPatch::Apply(mode, document, patch, result);
+    Napi::Buffer<char> buffer = Napi::Buffer<char>::Copy(env, result.data(), result.size());
+    output_.End();
+    return buffer;
+  } catch (const std::exception& e) {
+    output_.End();
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+}
+
+// Set the document size above which parseAsync parses off the JS thread
+Napi::Value JsonProcessor::SetAsyncThreshold(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsNumber()) {
+    Napi::TypeError::New(env, "Number expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  int64_t threshold = info[0].As<Napi::Number>().Int64Value();
+  asyncThreshold_ = threshold > 0 ? static_cast<size_t>(threshold) : 0;
+  return Napi::Number::New(env, static_cast<double>(asyncThreshold_));
+}
+
+// Report output buffer and parser pool capacity and retention policy
+Napi::Value JsonProcessor::GetBufferStats(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  Napi::Object stats = Napi::Object::New(env);
+
+  stats.Set("outputCapacity", Napi::Number::New(env, static_cast<double>(output_.Capacity())));
+  stats.Set("maxRetainedSize", Napi::Number::New(env, static_cast<double>(output_.MaxRetainedSize())));
+  stats.Set("shrinkCount", Napi::Number::New(env, static_cast<double>(output_.ShrinkCount())));
+  stats.Set("paddedCapacity", Napi::Number::New(env, static_cast<double>(paddedBuffer_.capacity())));
+  stats.Set("parserCount", Napi::Number::New(env, static_cast<double>(parsers_.RetainedCount())));
+  stats.Set("parserCapacity", Napi::Number::New(env, static_cast<double>(parsers_.RetainedCapacity())));
+  stats.Set("parserInUse", Napi::Number::New(env, static_cast<double>(parsers_.InUseCount())));
+  stats.Set("maxParserCapacity", Napi::Number::New(env, static_cast<double>(parsers_.MaxCapacity())));
+  stats.Set("parserTrimCount", Napi::Number::New(env, static_cast<double>(parsers_.TrimCount())));
+
+  return stats;
+}
+
 // Main Parse method - handles string input
 Napi::Value JsonProcessor::Parse(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
@@ -271,16 +628,215 @@ Napi::Value JsonProcessor::ParseBuffer(const Napi::CallbackInfo& info) {
   }
 }
 
-// Memory management helpers
-void JsonProcessor::GrowStringBuffer(size_t newSize) {
-  size_t currentSize = stringBuffer_.capacity();
-  if (newSize > currentSize) {
-    // Grow exponentially to reduce reallocations
-    size_t targetSize = std::max(newSize, currentSize * 2);
-    stringBuffer_.reserve(targetSize);
+// parseAsync(input: Buffer | string, options?: { ndjson, threads }): Promise
+// Small documents are parsed inline; larger ones (and all NDJSON) run on the thread pool
+Napi::Value JsonProcessor::ParseAsync(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || (!info[0].IsBuffer() && !info[0].IsString())) {
+    Napi::TypeError::New(env, "Buffer or string expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  bool ndjson = false;
+  size_t threads = std::max<unsigned int>(std::thread::hardware_concurrency(), 1);
+
+  if (info.Length() > 1 && info[1].IsObject()) {
+    Napi::Object options = info[1].As<Napi::Object>();
+    if (options.Has("ndjson") && options.Get("ndjson").IsBoolean()) {
+      ndjson = options.Get("ndjson").As<Napi::Boolean>().Value();
+    }
+    if (options.Has("threads") && options.Get("threads").IsNumber()) {
+      threads = std::max<uint32_t>(options.Get("threads").As<Napi::Number>().Uint32Value(), 1);
+    }
+  }
+
+  // UTF-8 size of the input; strings are measured without being copied
+  size_t inputLength = 0;
+  if (info[0].IsBuffer()) {
+    inputLength = info[0].As<Napi::Buffer<uint8_t>>().Length();
+  } else {
+    napi_get_value_string_utf8(env, info[0], nullptr, 0, &inputLength);
+  }
+
+  // Small documents: parse inline and settle the promise immediately
+  if (!ndjson && inputLength < asyncThreshold_) {
+    Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
+    Napi::Value result;
+
+    try {
+      if (info[0].IsBuffer()) {
+        Napi::Buffer<uint8_t> buffer = info[0].As<Napi::Buffer<uint8_t>>();
+        result = ParseWithDOM(env, buffer.Data(), buffer.Length());
+      } else {
+        result = ParseWithDOM(env, info[0].As<Napi::String>().Utf8Value());
+      }
+    } catch (const std::exception& e) {
+      Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    }
+
+    if (env.IsExceptionPending()) {
+      deferred.Reject(env.GetAndClearPendingException().Value());
+    } else {
+      deferred.Resolve(result);
+    }
+    return deferred.Promise();
+  }
+
+  return JsonParseWorker::Start(env, this, Value(), info[0], ndjson, threads);
+}
+
+// Output buffer: reset for a new call and reserve the estimated size
+std::string& OutputBuffer::Begin(size_t estimate) {
+  data_.clear();
+  if (estimate > data_.capacity()) {
+    // Never pre-reserve past the cap on a heuristic estimate alone
+    data_.reserve(std::min(estimate, std::max(maxRetainedSize_, data_.capacity())));
+  }
+  return data_;
+}
+
+// Output buffer: apply the cap and the shrink-after-spike policy
+void OutputBuffer::End() {
+  size_t used = data_.size();
+  data_.clear();
+
+  // Over the cap: give the memory back right away
+  if (data_.capacity() > maxRetainedSize_) {
+    ShrinkTo(initialSize_);
+    return;
+  }
+
+  // Track how much of the capacity recent calls actually needed
+  peakUsage_ = std::max(peakUsage_, used);
+  if (used * 4 < data_.capacity() && data_.capacity() > initialSize_) {
+    lowUsageCalls_++;
+  } else {
+    lowUsageCalls_ = 0;
+    peakUsage_ = used;
+  }
+
+  // A spike is over once enough consecutive calls used under a quarter of it
+  if (lowUsageCalls_ >= shrinkAfterCalls_) {
+    ShrinkTo(std::max(initialSize_, peakUsage_ * 2));
+  }
+}
+
+// Output buffer: drop all memory and reallocate the initial size
+void OutputBuffer::Release() {
+  ShrinkTo(initialSize_);
+}
+
+void OutputBuffer::Configure(size_t initialSize, size_t maxRetainedSize) {
+  initialSize_ = initialSize;
+  maxRetainedSize_ = std::max(maxRetainedSize, initialSize);
+  if (data_.capacity() > maxRetainedSize_) {
+    ShrinkTo(initialSize_);
+  } else {
+    data_.reserve(initialSize_);
+  }
+}
+
+void OutputBuffer::ShrinkTo(size_t size) {
+  std::string fresh;
+  fresh.reserve(size);
+  data_.swap(fresh);
+  peakUsage_ = 0;
+  lowUsageCalls_ = 0;
+  shrinkCount_++;
+}
+
+// Parser pool: lease a parser from the bucket for this document size
+ParserPool::Lease ParserPool::Acquire(size_t documentSize) {
+  calls_++;
+  TrimIdle();
+
+  size_t index = 0;
+  while (index + 1 < bucketCount_ && documentSize > (size_t(64 * 1024) << (4 * index))) {
+    index++;
+  }
+
+  Bucket& bucket = buckets_[index];
+  bucket.lastUsedCall = calls_;
+  inUse_++;
+  if (bucket.idle.empty()) {
+    return Lease(*this, index, std::make_unique<simdjson::dom::parser>());
+  }
+  std::unique_ptr<simdjson::dom::parser> parser = std::move(bucket.idle.back());
+  bucket.idle.pop_back();
+  return Lease(*this, index, std::move(parser));
+}
+
+// Parser pool: keep a returned parser unless it grew past the cap or the bucket is full
+void ParserPool::Return(size_t bucket, std::unique_ptr<simdjson::dom::parser> parser) {
+  inUse_--;
+  if (parser->capacity() > maxCapacity_) {
+    trimCount_++;
+    return;
+  }
+  if (buckets_[bucket].idle.size() < maxIdlePerBucket_) {
+    buckets_[bucket].idle.push_back(std::move(parser));
+  }
+}
+
+// Parser pool: release the larger buckets once they have sat unused for idleCalls_ calls
+void ParserPool::TrimIdle() {
+  for (size_t i = 1; i < bucketCount_; i++) {
+    Bucket& bucket = buckets_[i];
+    if (!bucket.idle.empty() && calls_ - bucket.lastUsedCall > idleCalls_) {
+      trimCount_ += bucket.idle.size();
+      bucket.idle.clear();
+    }
+  }
+}
+
+// Parser pool: drop all idle parsers
+void ParserPool::Release() {
+  for (Bucket& bucket : buckets_) {
+    bucket.idle.clear();
+  }
+}
+
+void ParserPool::Configure(size_t maxCapacity, uint32_t idleCalls) {
+  maxCapacity_ = maxCapacity;
+  idleCalls_ = idleCalls;
+  for (Bucket& bucket : buckets_) {
+    auto& idle = bucket.idle;
+    size_t before = idle.size();
+    idle.erase(std::remove_if(idle.begin(), idle.end(),
+                              [maxCapacity](const std::unique_ptr<simdjson::dom::parser>& parser) {
+                                return parser->capacity() > maxCapacity;
+                              }),
+               idle.end());
+    trimCount_ += before - idle.size();
   }
 }
 
+size_t ParserPool::RetainedCount() const {
+  size_t count = 0;
+  for (const Bucket& bucket : buckets_) {
+    count += bucket.idle.size();
+  }
+  return count;
+}
+
+size_t ParserPool::RetainedCapacity() const {
+  size_t capacity = 0;
+  for (const Bucket& bucket : buckets_) {
+    for (const auto& parser : bucket.idle) {
+      capacity += parser->capacity();
+    }
+  }
+  return capacity;
+}
+
+// Create the JS string for a finished call and reset the output buffer
+Napi::Value JsonProcessor::FinishOutput(const Napi::Env& env, std::string& output) {
+  Napi::String result = Napi::String::New(env, output);
+  output_.End();
+  return result;
+}
+
 // Get temporary buffer for number conversions
 char* JsonProcessor::GetTempBuffer(size_t size) {
   // Ensure the buffer is large enough
@@ -335,6 +891,12 @@ Napi::Value JsonProcessor::Stringify(const Napi::CallbackInfo& info) {
     return Napi::String::New(env, value.As<Napi::Boolean>().Value() ? "true" : "false");
   }
 
+  if (value.IsBigInt()) {
+    std::string result;
+    StringifyBigInt(value, result);
+    return Napi::String::New(env, result);
+  }
+
   // Fast path for common objects
   if (value.IsArray()) {
     Napi::Array array = value.As<Napi::Array>();
@@ -344,19 +906,10 @@ Napi::Value JsonProcessor::Stringify(const Napi::CallbackInfo& info) {
       return Napi::String::New(env, "[]");
     }
 
-    // For small arrays, use normal string buffer
-    if (array.Length() < 100) {
-      std::string result;
-      // Reserve some space based on array length (heuristic)
-      result.reserve(array.Length() * 20);
-      StringifyArrayFast(array, result);
-      return Napi::String::New(env, result);
-    }
-
-    // For large arrays, use our string buffer pool
-    GrowStringBuffer(array.Length() * 20); // Heuristic estimate
-    StringifyArrayFast(array, stringBuffer_);
-    return Napi::String::New(env, stringBuffer_);
+    // Reserve some space based on array length (heuristic)
+    std::string& result = output_.Begin(array.Length() * 20);
+    StringifyArrayFast(array, result);
+    return FinishOutput(env, result);
   }
 
   if (value.IsObject() && !value.IsFunction() && !value.IsBuffer()) {
@@ -368,19 +921,10 @@ Napi::Value JsonProcessor::Stringify(const Napi::CallbackInfo& info) {
       return Napi::String::New(env, "{}");
     }
 
-    // For small objects, use normal string buffer
-    if (properties.Length() < 100) {
-      std::string result;
-      // Reserve some space based on properties count (heuristic)
-      result.reserve(properties.Length() * 30);
-      StringifyObjectFast(object, result);
-      return Napi::String::New(env, result);
-    }
-
-    // For large objects, use our string buffer pool
-    GrowStringBuffer(properties.Length() * 30); // Heuristic estimate
-    StringifyObjectFast(object, stringBuffer_);
-    return Napi::String::New(env, stringBuffer_);
+    // Reserve some space based on properties count (heuristic)
+    std::string& result = output_.Begin(properties.Length() * 30);
+    StringifyObjectFast(object, result);
+    return FinishOutput(env, result);
   }
 
   if (value.IsBuffer()) {
@@ -407,31 +951,53 @@ Napi::Value JsonProcessor::Stringify(const Napi::CallbackInfo& info) {
       return Napi::String::New(env, result);
     }
 
-    // For large buffers, use string buffer
-    size_t estimatedSize = buffer.Length() * 5 + 2;
-    GrowStringBuffer(estimatedSize);
-
-    stringBuffer_ = '[';
+    // For large buffers, use the output buffer
+    std::string& result = output_.Begin(buffer.Length() * 5 + 2);
+    result += '[';
 
     for (size_t i = 0; i < buffer.Length(); i++) {
       if (i > 0) {
-        stringBuffer_ += ',';
+        result += ',';
       }
 
       char* numStr = GetTempBuffer(8);
       int len = snprintf(numStr, 8, "%u", buffer.Data()[i]);
-      stringBuffer_.append(numStr, len);
+      result.append(numStr, len);
     }
 
-    stringBuffer_ += ']';
-    return Napi::String::New(env, stringBuffer_);
+    result += ']';
+    return FinishOutput(env, result);
   }
 
   // Fallback to general stringification for other types
-  // Only use string buffer for potentially large objects
-  stringBuffer_.clear();
-  StringifyValue(value, stringBuffer_);
-  return Napi::String::New(env, stringBuffer_);
+  std::string& result = output_.Begin(0);
+  StringifyValue(value, result);
+  return FinishOutput(env, result);
+}
+
+// Compile a JSON schema into a reusable serializer
+Napi::Value JsonProcessor::CompileSerializer(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsObject() || info[0].IsArray()) {
+    Napi::TypeError::New(env, "Schema object expected").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  return CompiledSerializer::NewInstance(env, Value(), info[0].As<Napi::Object>());
+}
+
+// Create a cursor that stringifies a value into fixed-size Buffer chunks
+Napi::Value JsonProcessor::CreateStringifyCursor(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1) {
+    Napi::TypeError::New(env, "Wrong number of arguments").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  Napi::Value options = info.Length() > 1 ? info[1] : env.Undefined();
+  return StringifyCursor::NewInstance(env, Value(), info[0], options);
 }
 
 // Helper method to stringify a value to JSON - with optimizations
@@ -459,6 +1025,8 @@ void JsonProcessor::StringifyValue(const Napi::Value& value, std::string& result
       int len = snprintf(buffer, 32, "%.16g", numValue);
       result.append(buffer, len);
     }
+  } else if (value.IsBigInt()) {
+    StringifyBigInt(value, result);
   } else if (value.IsString()) {
     std::string strValue = value.As<Napi::String>().Utf8Value();
     result += '"';
@@ -557,8 +1125,7 @@ void JsonProcessor::StringifyValue(const Napi::Value& value, std::string& result
     // For very large buffers, estimate the size and pre-allocate
     if (length > 1000) {
       // Each byte takes approximately 4 chars (digit + comma)
-      size_t estimatedSize = result.size() + length * 4;
-      GrowStringBuffer(estimatedSize);
+      result.reserve(result.size() + length * 4);
     }
 
     // Process all bytes
@@ -615,7 +1182,10 @@ Napi::Value JsonProcessor::ConvertDOMValueToNapi(const Napi::Env& env, simdjson:
       if (intValue >= INT32_MIN && intValue <= INT32_MAX) {
         return Napi::Number::New(env, static_cast<int32_t>(intValue));
       }
-      return Napi::Number::New(env, static_cast<double>(intValue));
+      if (intValue >= -kMaxSafeInteger && intValue <= kMaxSafeInteger) {
+        return Napi::Number::New(env, static_cast<double>(intValue));
+      }
+      return ConvertLargeInteger(env, intValue);
     }
 
     case simdjson::dom::element_type::UINT64: {
@@ -624,7 +1194,10 @@ Napi::Value JsonProcessor::ConvertDOMValueToNapi(const Napi::Env& env, simdjson:
       if (uintValue <= INT32_MAX) {
         return Napi::Number::New(env, static_cast<int32_t>(uintValue));
       }
-      return Napi::Number::New(env, static_cast<double>(uintValue));
+      if (uintValue <= static_cast<uint64_t>(kMaxSafeInteger)) {
+        return Napi::Number::New(env, static_cast<double>(uintValue));
+      }
+      return ConvertLargeInteger(env, uintValue);
     }
 
     case simdjson::dom::element_type::DOUBLE: {
@@ -651,6 +1224,31 @@ Napi::Value JsonProcessor::ConvertDOMValueToNapi(const Napi::Env& env, simdjson:
   }
 }
 
+// Integers outside the safe range: converted per bigIntMode_ (lossy Number unless opted in)
+Napi::Value JsonProcessor::ConvertLargeInteger(const Napi::Env& env, int64_t value) {
+  switch (bigIntMode_) {
+    case BigIntMode::BIGINT:
+      return Napi::BigInt::New(env, value);
+    case BigIntMode::STRING:
+      return Napi::String::New(env, std::to_string(value));
+    case BigIntMode::NUMBER:
+    default:
+      return Napi::Number::New(env, static_cast<double>(value));
+  }
+}
+
+Napi::Value JsonProcessor::ConvertLargeInteger(const Napi::Env& env, uint64_t value) {
+  switch (bigIntMode_) {
+    case BigIntMode::BIGINT:
+      return Napi::BigInt::New(env, value);
+    case BigIntMode::STRING:
+      return Napi::String::New(env, std::to_string(value));
+    case BigIntMode::NUMBER:
+    default:
+      return Napi::Number::New(env, static_cast<double>(value));
+  }
+}
+
 // Parse stream of JSON objects (actually just parses a JSON array for now)
 Napi::Value JsonProcessor::ParseStream(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
@@ -690,7 +1288,8 @@ Napi::Value JsonProcessor::ParseStream(const Napi::CallbackInfo& info) {
     // Parse as a regular JSON array
     // Use DOM parser for all cases for now
     simdjson::padded_string padded(jsonData);
-    auto result = dom_parser_.parse(padded);
+    ParserPool::Lease parser = parsers_.Acquire(padded.size());
+    auto result = parser->parse(padded);
     if (result.error()) {
       Napi::Error::New(env, std::string("JSON parse error: ") +
                        simdjson::error_message(result.error())).ThrowAsJavaScriptException();
@@ -725,14 +1324,13 @@ Napi::Value JsonProcessor::StringifyStream(const Napi::CallbackInfo& info) {
   try {
     // Estimate the size of the output
     // Assume each item might take around 100 bytes (reasonable estimate)
-    size_t estimatedSize = length * 100;
-    GrowStringBuffer(estimatedSize);
+    std::string& result = output_.Begin(static_cast<size_t>(length) * 100);
 
     // Process each item
     for (uint32_t i = 0; i < length; i++) {
       // Add newline between items
       if (i > 0) {
-        stringBuffer_ += '\n';
+        result += '\n';
       }
 
       // Get value
@@ -740,46 +1338,47 @@ Napi::Value JsonProcessor::StringifyStream(const Napi::CallbackInfo& info) {
 
       // Convert to JSON and append
       if (value.IsString()) {
-        StringifyString(value.As<Napi::String>().Utf8Value(), stringBuffer_);
+        StringifyString(value.As<Napi::String>().Utf8Value(), result);
       } else if (value.IsNumber()) {
-        StringifyNumber(value.As<Napi::Number>().DoubleValue(), stringBuffer_);
+        StringifyNumber(value.As<Napi::Number>().DoubleValue(), result);
       } else if (value.IsBoolean()) {
-        StringifyBoolean(value.As<Napi::Boolean>().Value(), stringBuffer_);
+        StringifyBoolean(value.As<Napi::Boolean>().Value(), result);
       } else if (value.IsNull() || value.IsUndefined()) {
-        stringBuffer_ += "null";
+        result += "null";
       } else if (value.IsObject() && !value.IsFunction()) {
         if (value.IsArray()) {
-          StringifyArrayFast(value.As<Napi::Array>(), stringBuffer_);
+          StringifyArrayFast(value.As<Napi::Array>(), result);
         } else if (value.IsBuffer()) {
           // Handle buffer
           Napi::Buffer<uint8_t> buffer = value.As<Napi::Buffer<uint8_t>>();
 
-          stringBuffer_ += '[';
+          result += '[';
 
           for (size_t j = 0; j < buffer.Length(); j++) {
             if (j > 0) {
-              stringBuffer_ += ',';
+              result += ',';
             }
 
             char* numStr = GetTempBuffer(8);
             int len = snprintf(numStr, 8, "%u", buffer.Data()[j]);
-            stringBuffer_.append(numStr, len);
+            result.append(numStr, len);
           }
 
-          stringBuffer_ += ']';
+          result += ']';
         } else {
           // Regular object
-          StringifyObjectFast(value.As<Napi::Object>(), stringBuffer_);
+          StringifyObjectFast(value.As<Napi::Object>(), result);
         }
       } else {
         // Skip functions or other unsupported types
-        stringBuffer_ += "null";
+        result += "null";
       }
     }
 
     // Return the result
-    return Napi::String::New(env, stringBuffer_);
+    return FinishOutput(env, result);
   } catch (const std::exception& e) {
+    output_.End();
     Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
     return env.Null();
   }
@@ -787,8 +1386,9 @@ Napi::Value JsonProcessor::StringifyStream(const Napi::CallbackInfo& info) {
 
 // Parse with DOM API - string input
 Napi::Value JsonProcessor::ParseWithDOM(const Napi::Env& env, const std::string& json) {
-  // Use DOM parser
-  auto result = dom_parser_.parse(json);
+  // Use a DOM parser sized for the document; the lease outlives the conversion
+  ParserPool::Lease parser = parsers_.Acquire(json.size());
+  auto result = parser->parse(json);
   if (result.error()) {
     std::string errorMsg = std::string("JSON parse error: ") + simdjson::error_message(result.error());
     Napi::Error::New(env, errorMsg).ThrowAsJavaScriptException();
@@ -801,8 +1401,9 @@ Napi::Value JsonProcessor::ParseWithDOM(const Napi::Env& env, const std::string&
 
 // Parse with DOM API - buffer input
 Napi::Value JsonProcessor::ParseWithDOM(const Napi::Env& env, const uint8_t* data, size_t length) {
-  // Use DOM parser
-  auto result = dom_parser_.parse(data, length);
+  // Use a DOM parser sized for the document; the lease outlives the conversion
+  ParserPool::Lease parser = parsers_.Acquire(length);
+  auto result = parser->parse(data, length);
   if (result.error()) {
     std::string errorMsg = std::string("JSON parse error: ") + simdjson::error_message(result.error());
     Napi::Error::New(env, errorMsg).ThrowAsJavaScriptException();
@@ -819,16 +1420,23 @@ Napi::Value JsonProcessor::ParseWithOnDemand(const Napi::Env& env, const std::st
   simdjson::padded_string padded(json);
 
   // Parse with OnDemand parser
-  auto result = ondemand_parser_.iterate(padded);
-  if (result.error()) {
-    std::string errorMsg = std::string("JSON parse error: ") + simdjson::error_message(result.error());
+  simdjson::error_code error = ondemand_parser_.iterate(padded).error();
+
+  // The OnDemand parser grows like the DOM ones; do not keep it above the pool's cap
+  if (ondemand_parser_.capacity() > parsers_.MaxCapacity()) {
+    ondemand_parser_ = simdjson::ondemand::parser();
+  }
+
+  if (error) {
+    std::string errorMsg = std::string("JSON parse error: ") + simdjson::error_message(error);
     Napi::Error::New(env, errorMsg).ThrowAsJavaScriptException();
     return env.Null();
   }
 
   try {
     // Parse the document
-    auto result = dom_parser_.parse(padded);
+    ParserPool::Lease parser = parsers_.Acquire(padded.size());
+    auto result = parser->parse(padded);
     if (result.error()) {
       std::string errorMsg = std::string("JSON parse error: ") + simdjson::error_message(result.error());
       Napi::Error::New(env, errorMsg).ThrowAsJavaScriptException();
@@ -850,7 +1458,8 @@ Napi::Value JsonProcessor::ParseWithOnDemand(const Napi::Env& env, const uint8_t
 
   try {
     // Parse the document
-    auto result = dom_parser_.parse(padded);
+    ParserPool::Lease parser = parsers_.Acquire(length);
+    auto result = parser->parse(padded);
     if (result.error()) {
       std::string errorMsg = std::string("JSON parse error: ") + simdjson::error_message(result.error());
       Napi::Error::New(env, errorMsg).ThrowAsJavaScriptException();
@@ -953,6 +1562,11 @@ void JsonProcessor::StringifyNumber(double value, std::string& result) {
   result.append(buffer, len);
 }
 
+// BigInts (e.g. 64-bit ids from a lossless parse) are written as exact integers
+void JsonProcessor::StringifyBigInt(const Napi::Value& value, std::string& result) {
+  result += value.ToString().Utf8Value();
+}
+
 // Implementation for boolean type
 void JsonProcessor::StringifyBoolean(bool value, std::string& result) {
   result += value ? "true" : "false";
@@ -990,6 +1604,8 @@ void JsonProcessor::StringifyObjectFast(Napi::Object object, std::string& result
       StringifyString(value.As<Napi::String>().Utf8Value(), result);
     } else if (value.IsNumber()) {
       StringifyNumber(value.As<Napi::Number>().DoubleValue(), result);
+    } else if (value.IsBigInt()) {
+      StringifyBigInt(value, result);
     } else if (value.IsBoolean()) {
       StringifyBoolean(value.As<Napi::Boolean>().Value(), result);
     } else if (value.IsArray()) {
@@ -1036,6 +1652,8 @@ void JsonProcessor::StringifyArrayFast(Napi::Array array, std::string& result) {
       StringifyString(value.As<Napi::String>().Utf8Value(), result);
     } else if (value.IsNumber()) {
       StringifyNumber(value.As<Napi::Number>().DoubleValue(), result);
+    } else if (value.IsBigInt()) {
+      StringifyBigInt(value, result);
     } else if (value.IsBoolean()) {
       StringifyBoolean(value.As<Napi::Boolean>().Value(), result);
     } else if (value.IsArray()) {
@@ -3,24 +3,125 @@
 
 #include <napi.h>
 #include <simdjson.h>
+#include <memory>
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include "binary_codec.h"
 
 namespace nexurejs {
   // Forward declaration
   void AddCleanupReference(Napi::FunctionReference* ref);
 }
 
+/**
+ * Reusable per-call output buffer
+ *
+ * Every stringify call starts with Begin(), which resets the buffer, and ends
+ * with End(), which applies the retention policy: capacity above the cap is
+ * released immediately, and capacity left over from a one-off spike is given
+ * back after a run of calls that used only a fraction of it.
+ */
+class OutputBuffer {
+public:
+  std::string& Begin(size_t estimate);
+  void End();
+  void Release();
+  void Configure(size_t initialSize, size_t maxRetainedSize);
+
+  size_t Capacity() const { return data_.capacity(); }
+  size_t MaxRetainedSize() const { return maxRetainedSize_; }
+  uint64_t ShrinkCount() const { return shrinkCount_; }
+
+private:
+  void ShrinkTo(size_t size);
+
+  std::string data_;
+  size_t initialSize_ = 16 * 1024;           // 16KB initial output buffer
+  size_t maxRetainedSize_ = 1024 * 1024;     // 1MB retained across calls at most
+  size_t peakUsage_ = 0;                     // Largest output since the last shrink check
+  uint32_t lowUsageCalls_ = 0;
+  uint64_t shrinkCount_ = 0;
+
+  static constexpr uint32_t shrinkAfterCalls_ = 16; // Low-usage calls before shrinking
+};
+
+/**
+ * Reusable DOM parsers bucketed by document size
+ *
+ * A simdjson parser keeps the capacity of the largest document it has seen,
+ * so a single shared parser pins the memory of one big payload for the rest of
+ * the process. Parsers are instead leased from a bucket matching the document
+ * size (64KB, 1MB, 16MB, larger): small documents keep hitting a small warm
+ * parser, parsers grown past the cap are dropped when returned, and buckets
+ * above the smallest release their idle parsers once no document has needed
+ * them for a run of calls.
+ */
+class ParserPool {
+public:
+  // A parser borrowed for one parse; the DOM stays valid while the lease lives
+  class Lease {
+  public:
+    Lease(ParserPool& pool, size_t bucket, std::unique_ptr<simdjson::dom::parser> parser)
+        : pool_(pool), bucket_(bucket), parser_(std::move(parser)) {}
+    Lease(const Lease&) = delete;
+    Lease& operator=(const Lease&) = delete;
+    ~Lease() { pool_.Return(bucket_, std::move(parser_)); }
+
+    simdjson::dom::parser& operator*() const { return *parser_; }
+    simdjson::dom::parser* operator->() const { return parser_.get(); }
+
+  private:
+    ParserPool& pool_;
+    size_t bucket_;
+    std::unique_ptr<simdjson::dom::parser> parser_;
+  };
+
+  Lease Acquire(size_t documentSize);
+  void Release();
+  void Configure(size_t maxCapacity, uint32_t idleCalls);
+
+  size_t RetainedCount() const;
+  size_t RetainedCapacity() const;
+  size_t InUseCount() const { return inUse_; }
+  size_t MaxCapacity() const { return maxCapacity_; }
+  uint32_t IdleCalls() const { return idleCalls_; }
+  uint64_t TrimCount() const { return trimCount_; }
+
+private:
+  void Return(size_t bucket, std::unique_ptr<simdjson::dom::parser> parser);
+  void TrimIdle();
+
+  struct Bucket {
+    std::vector<std::unique_ptr<simdjson::dom::parser>> idle;
+    uint64_t lastUsedCall = 0;
+  };
+
+  static constexpr size_t bucketCount_ = 4;
+  static constexpr size_t maxIdlePerBucket_ = 2;  // Enough for a document and a patch at once
+
+  Bucket buckets_[bucketCount_];
+  size_t maxCapacity_ = 16 * 1024 * 1024;  // 16MB: larger parsers are not kept
+  uint32_t idleCalls_ = 64;                // Calls without use before a bucket is trimmed
+  uint64_t calls_ = 0;
+  size_t inUse_ = 0;
+  uint64_t trimCount_ = 0;
+};
+
 class JsonProcessor : public Napi::ObjectWrap<JsonProcessor> {
+  // Schema-compiled serializers and stringify cursors reuse the value writers
+  friend class CompiledSerializer;
+  friend class StringifyCursor;
+  // Off-thread parses materialize through ConvertDOMValueToNapi
+  friend class JsonParseWorker;
+
 public:
   static Napi::Object Init(Napi::Env env, Napi::Object exports);
   JsonProcessor(const Napi::CallbackInfo& info);
   ~JsonProcessor();
 
-  // Instead of using our own namespace, use simdjson::ondemand directly
-  // DOM API for compatibility
-  simdjson::dom::parser dom_parser_;
+  // DOM parsers, leased per call by document size
+  ParserPool parsers_;
 
   // OnDemand API for performance
   simdjson::ondemand::parser ondemand_parser_;
@@ -32,22 +133,47 @@ public:
     ONDEMAND = 2 // Use OnDemand API (faster but more restrictive)
   };
 
+  // How integers outside the JS safe range (|n| > 2^53 - 1) are returned
+  enum class BigIntMode {
+    NUMBER = 0,  // Lossy double, as JSON.parse (default)
+    BIGINT = 1,  // BigInt, exact
+    STRING = 2   // Decimal string, exact
+  };
+
 private:
   // Parse methods
   Napi::Value Parse(const Napi::CallbackInfo& info);
   Napi::Value ParseBuffer(const Napi::CallbackInfo& info);
   Napi::Value ParseStream(const Napi::CallbackInfo& info);
+  Napi::Value ParseAsync(const Napi::CallbackInfo& info);
 
   // Stringify methods
   Napi::Value Stringify(const Napi::CallbackInfo& info);
   Napi::Value StringifyStream(const Napi::CallbackInfo& info);
+  Napi::Value CompileSerializer(const Napi::CallbackInfo& info);
+  Napi::Value CreateStringifyCursor(const Napi::CallbackInfo& info);
+
+  // Binary formats (MessagePack, CBOR)
+  Napi::Value Encode(const Napi::CallbackInfo& info);
+  Napi::Value Decode(const Napi::CallbackInfo& info);
+  Napi::Value JsonToMsgpack(const Napi::CallbackInfo& info);
+  Napi::Value MsgpackToJson(const Napi::CallbackInfo& info);
+  Napi::Value JsonToCbor(const Napi::CallbackInfo& info);
+  Napi::Value CborToJson(const Napi::CallbackInfo& info);
+
+  // JSON Patch (RFC 6902) and Merge Patch (RFC 7396)
+  Napi::Value ApplyPatch(const Napi::CallbackInfo& info);
 
   // Configuration methods
   Napi::Value SetParserMode(const Napi::CallbackInfo& info);
   Napi::Value GetParserMode(const Napi::CallbackInfo& info);
+  Napi::Value SetBigIntMode(const Napi::CallbackInfo& info);
+  Napi::Value GetBigIntMode(const Napi::CallbackInfo& info);
   Napi::Value SetBufferSize(const Napi::CallbackInfo& info);
   Napi::Value GetBufferSize(const Napi::CallbackInfo& info);
   Napi::Value ReleaseBuffers(const Napi::CallbackInfo& info);
+  Napi::Value SetAsyncThreshold(const Napi::CallbackInfo& info);
+  Napi::Value GetBufferStats(const Napi::CallbackInfo& info);
 
   // Helper methods for parsing
   Napi::Value ParseWithDOM(const Napi::Env& env, const std::string& json);
@@ -57,6 +183,9 @@ private:
 
   // Convert simdjson DOM values to NAPI values
   Napi::Value ConvertDOMValueToNapi(const Napi::Env& env, simdjson::dom::element element);
+  Napi::Value ConvertLargeInteger(const Napi::Env& env, int64_t value);
+  Napi::Value ConvertLargeInteger(const Napi::Env& env, uint64_t value);
+  static bool ParseBigIntMode(const std::string& name, BigIntMode& mode);
 
   // Convert simdjson OnDemand values to NAPI values
   Napi::Value ConvertOnDemandValueToNapi(const Napi::Env& env, simdjson::ondemand::value value);
@@ -72,17 +201,22 @@ private:
   void StringifyString(const std::string& value, std::string& result);
   void StringifyNumber(double value, std::string& result);
   void StringifyBoolean(bool value, std::string& result);
+  void StringifyBigInt(const Napi::Value& value, std::string& result);
 
   // Object and array stringify methods
   void StringifyObjectFast(Napi::Object object, std::string& result);
   void StringifyArrayFast(Napi::Array array, std::string& result);
 
+  // Binary transcoding helpers (JSON text <-> MessagePack/CBOR bytes)
+  Napi::Value TranscodeFromJson(const Napi::CallbackInfo& info, BinaryCodec::Format format);
+  Napi::Value TranscodeToJson(const Napi::CallbackInfo& info, BinaryCodec::Format format);
+
   // Memory management helpers
-  void GrowStringBuffer(size_t newSize);
+  Napi::Value FinishOutput(const Napi::Env& env, std::string& output);
   char* GetTempBuffer(size_t size);
 
-  // String buffers for reuse
-  std::string stringBuffer_;
+  // Per-call stringify output and reusable parse buffer
+  OutputBuffer output_;
   std::string paddedBuffer_;
 
   // Temporary buffer for number formatting
@@ -91,8 +225,11 @@ private:
 
   // Parser configuration
   ParserMode parserMode_ = ParserMode::AUTO;
+  BigIntMode bigIntMode_ = BigIntMode::NUMBER;
   size_t initialStringBufferSize_ = 16 * 1024;      // 16KB initial string buffer
+  size_t maxStringBufferSize_ = 1024 * 1024;        // 1MB retained string buffer cap
   size_t initialPaddedBufferSize_ = 16 * 1024;      // 16KB initial padded buffer
+  size_t asyncThreshold_ = 1024 * 1024;             // 1MB: parseAsync goes off-thread above this
   static constexpr size_t maxInPlaceStringSize_ = 4 * 1024; // 4KB threshold for in-place strings
 
   // Miscellaneous helpers
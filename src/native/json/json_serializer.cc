@@ -0,0 +1,405 @@
+#include "json_serializer.h"
+#include "json_escape.h"
+#include <cmath>
+#include <cstring>
+#include <cinttypes>
+#include <stdexcept>
+
+Napi::FunctionReference* CompiledSerializer::constructor_ = nullptr;
+
+namespace {
+
+using JsonEscape::AppendEscapedString;
+
+CompiledSerializer::FieldType ParseFieldType(const std::string& type) {
+  using FieldType = CompiledSerializer::FieldType;
+  if (type == "string") return FieldType::STRING;
+  if (type == "number") return FieldType::NUMBER;
+  if (type == "integer") return FieldType::INTEGER;
+  if (type == "boolean") return FieldType::BOOLEAN;
+  if (type == "null") return FieldType::NULL_TYPE;
+  if (type == "object") return FieldType::OBJECT;
+  if (type == "array") return FieldType::ARRAY;
+  return FieldType::ANY;
+}
+
+} // namespace
+
+// Register the class (not exported, instances are created by JsonProcessor)
+void CompiledSerializer::Init(Napi::Env env) {
+  Napi::Function func = DefineClass(env, "CompiledSerializer", {
+    InstanceMethod("stringify", &CompiledSerializer::Stringify),
+    InstanceMethod("stringifyToBuffer", &CompiledSerializer::StringifyToBuffer),
+  });
+
+  constructor_ = new Napi::FunctionReference();
+  *constructor_ = Napi::Persistent(func);
+
+  // Add to cleanup list
+  nexurejs::AddCleanupReference(constructor_);
+}
+
+// Create a serializer bound to the given JsonProcessor instance
+Napi::Object CompiledSerializer::NewInstance(Napi::Env env, Napi::Object owner, Napi::Object schema) {
+  Napi::EscapableHandleScope scope(env);
+
+  Napi::Object obj = constructor_->New({owner, schema});
+  return scope.Escape(napi_value(obj)).ToObject();
+}
+
+// Constructor: (owner: JsonProcessor, schema: object)
+CompiledSerializer::CompiledSerializer(const Napi::CallbackInfo& info)
+    : Napi::ObjectWrap<CompiledSerializer>(info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2 || !info[0].IsObject() || !info[1].IsObject()) {
+    Napi::TypeError::New(env, "Schema object expected").ThrowAsJavaScriptException();
+    return;
+  }
+
+  owner_ = JsonProcessor::Unwrap(info[0].As<Napi::Object>());
+  if (owner_ == nullptr) {
+    Napi::TypeError::New(env, "JsonProcessor instance expected").ThrowAsJavaScriptException();
+    return;
+  }
+
+  // Keep the owning processor alive for as long as this serializer exists
+  ownerRef_ = Napi::Persistent(info[0].As<Napi::Object>());
+
+  try {
+    CompileNode(env, info[1].As<Napi::Object>(), root_, 0);
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+  }
+}
+
+// Walk the schema once and build the typed node tree
+void CompiledSerializer::CompileNode(Napi::Env env, Napi::Object schema, Node& node, size_t depth) {
+  if (depth > maxSchemaDepth_) {
+    throw std::runtime_error("Serializer schema nesting too deep");
+  }
+
+  // Resolve the declared type, "type": ["string", "null"] makes the node nullable
+  Napi::Value typeValue = schema.Get("type");
+  if (typeValue.IsString()) {
+    node.type = ParseFieldType(typeValue.As<Napi::String>().Utf8Value());
+  } else if (typeValue.IsArray()) {
+    Napi::Array types = typeValue.As<Napi::Array>();
+    size_t declared = 0;
+    for (uint32_t i = 0; i < types.Length(); i++) {
+      Napi::Value entry = types[i];
+      if (!entry.IsString()) continue;
+
+      FieldType type = ParseFieldType(entry.As<Napi::String>().Utf8Value());
+      if (type == FieldType::NULL_TYPE) {
+        node.nullable = true;
+      } else {
+        node.type = type;
+        declared++;
+      }
+    }
+    // Unions of several non-null types need runtime dispatch
+    if (declared > 1) {
+      node.type = FieldType::ANY;
+    } else if (declared == 0 && node.nullable) {
+      node.type = FieldType::NULL_TYPE;
+    }
+  } else if (schema.Has("properties")) {
+    node.type = FieldType::OBJECT;
+  } else if (schema.Has("items")) {
+    node.type = FieldType::ARRAY;
+  }
+
+  Napi::Value nullable = schema.Get("nullable");
+  if (nullable.IsBoolean() && nullable.As<Napi::Boolean>().Value()) {
+    node.nullable = true;
+  }
+
+  if (node.type == FieldType::OBJECT) {
+    Napi::Value properties = schema.Get("properties");
+    if (!properties.IsObject()) {
+      // No declared properties, serialize generically
+      node.type = FieldType::ANY;
+      return;
+    }
+
+    Napi::Object propsObj = properties.As<Napi::Object>();
+    Napi::Array names = propsObj.GetPropertyNames();
+    node.fields.reserve(names.Length());
+
+    for (uint32_t i = 0; i < names.Length(); i++) {
+      Napi::Value nameValue = names[i];
+      Napi::Value fieldSchema = propsObj.Get(nameValue);
+
+      Field field;
+      field.name = nameValue.As<Napi::String>().Utf8Value();
+      field.key = Napi::Persistent(Napi::Value(Napi::String::New(env, field.name)));
+
+      // Pre-escape the key fragment once: "name":
+      AppendEscapedString(field.name.data(), field.name.size(), field.fragment);
+      field.fragment += ':';
+
+      if (fieldSchema.IsObject()) {
+        CompileNode(env, fieldSchema.As<Napi::Object>(), field.node, depth + 1);
+      }
+
+      node.fields.push_back(std::move(field));
+    }
+
+    // Mark required fields
+    Napi::Value required = schema.Get("required");
+    if (required.IsArray()) {
+      Napi::Array requiredArr = required.As<Napi::Array>();
+      for (uint32_t i = 0; i < requiredArr.Length(); i++) {
+        Napi::Value entry = requiredArr[i];
+        if (!entry.IsString()) continue;
+
+        std::string name = entry.As<Napi::String>().Utf8Value();
+        for (auto& field : node.fields) {
+          if (field.name == name) {
+            field.required = true;
+            break;
+          }
+        }
+      }
+    }
+  } else if (node.type == FieldType::ARRAY) {
+    node.items = std::make_unique<Node>();
+    Napi::Value items = schema.Get("items");
+    if (items.IsObject() && !items.IsArray()) {
+      CompileNode(env, items.As<Napi::Object>(), *node.items, depth + 1);
+    }
+  }
+}
+
+// stringify(value): string
+Napi::Value CompiledSerializer::Stringify(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1) {
+    Napi::TypeError::New(env, "Wrong number of arguments").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  std::string& out = output_.Begin(0);
+
+  try {
+    WriteNode(root_, info[0], out);
+  } catch (const std::exception& e) {
+    output_.End();
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  Napi::Value result = Napi::String::New(env, out);
+  output_.End();
+  return result;
+}
+
+// stringifyToBuffer(value): Buffer, skips the UTF-16 string round trip for responses
+Napi::Value CompiledSerializer::StringifyToBuffer(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1) {
+    Napi::TypeError::New(env, "Wrong number of arguments").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  std::string& out = output_.Begin(0);
+
+  try {
+    WriteNode(root_, info[0], out);
+  } catch (const std::exception& e) {
+    output_.End();
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  Napi::Value result = Napi::Buffer<char>::Copy(env, out.data(), out.size());
+  output_.End();
+  return result;
+}
+
+// Write a value using the writer selected at compile time
+void CompiledSerializer::WriteNode(const Node& node, const Napi::Value& value, std::string& out) {
+  if (value.IsNull() || value.IsUndefined()) {
+    // Scalars that cannot be null get their type's empty value, like fast-json-stringify
+    if (node.nullable) {
+      out += "null";
+      return;
+    }
+    switch (node.type) {
+      case FieldType::STRING:
+        out += "\"\"";
+        break;
+      case FieldType::NUMBER:
+      case FieldType::INTEGER:
+        out += '0';
+        break;
+      case FieldType::BOOLEAN:
+        out += "false";
+        break;
+      default:
+        out += "null";
+        break;
+    }
+    return;
+  }
+
+  switch (node.type) {
+    case FieldType::STRING:
+      if (value.IsString()) {
+        WriteString(value, out);
+      } else {
+        // Coerce like fast-json-stringify does
+        WriteString(value.ToString(), out);
+      }
+      break;
+
+    case FieldType::NUMBER:
+      owner_->StringifyNumber(value.IsNumber()
+          ? value.As<Napi::Number>().DoubleValue()
+          : value.ToNumber().DoubleValue(), out);
+      break;
+
+    case FieldType::INTEGER:
+      WriteInteger(value.IsNumber()
+          ? value.As<Napi::Number>().DoubleValue()
+          : value.ToNumber().DoubleValue(), out);
+      break;
+
+    case FieldType::BOOLEAN:
+      owner_->StringifyBoolean(value.IsBoolean()
+          ? value.As<Napi::Boolean>().Value()
+          : value.ToBoolean().Value(), out);
+      break;
+
+    case FieldType::NULL_TYPE:
+      out += "null";
+      break;
+
+    case FieldType::OBJECT:
+      if (value.IsObject() && !value.IsArray() && !value.IsFunction()) {
+        WriteObject(node, value, out);
+      } else {
+        WriteAny(value, out);
+      }
+      break;
+
+    case FieldType::ARRAY:
+      if (value.IsArray()) {
+        WriteArray(node, value, out);
+      } else {
+        WriteAny(value, out);
+      }
+      break;
+
+    case FieldType::ANY:
+    default:
+      WriteAny(value, out);
+      break;
+  }
+}
+
+// Generic writer for values the schema does not describe
+void CompiledSerializer::WriteAny(const Napi::Value& value, std::string& out) {
+  if (value.IsNull() || value.IsUndefined()) {
+    out += "null";
+  } else if (value.IsString()) {
+    WriteString(value, out);
+  } else if (value.IsNumber()) {
+    owner_->StringifyNumber(value.As<Napi::Number>().DoubleValue(), out);
+  } else if (value.IsBigInt()) {
+    owner_->StringifyBigInt(value, out);
+  } else if (value.IsBoolean()) {
+    owner_->StringifyBoolean(value.As<Napi::Boolean>().Value(), out);
+  } else if (value.IsArray()) {
+    owner_->StringifyArrayFast(value.As<Napi::Array>(), out);
+  } else if (value.IsBuffer()) {
+    owner_->StringifyValue(value, out);
+  } else if (value.IsObject() && !value.IsFunction()) {
+    owner_->StringifyObjectFast(value.As<Napi::Object>(), out);
+  } else {
+    out += "null";
+  }
+}
+
+// Object writer: fixed field order, pre-escaped keys, no property enumeration
+void CompiledSerializer::WriteObject(const Node& node, const Napi::Value& value, std::string& out) {
+  Napi::Object object = value.As<Napi::Object>();
+  bool first = true;
+
+  out += '{';
+
+  for (const auto& field : node.fields) {
+    Napi::Value fieldValue = object.Get(field.key.Value());
+
+    if (fieldValue.IsUndefined() || fieldValue.IsFunction()) {
+      if (field.required) {
+        throw std::runtime_error("\"" + field.name + "\" is required!");
+      }
+      continue;
+    }
+
+    if (!first) {
+      out += ',';
+    }
+    first = false;
+
+    out += field.fragment;
+    WriteNode(field.node, fieldValue, out);
+  }
+
+  out += '}';
+}
+
+// Array writer: every item uses the compiled item node
+void CompiledSerializer::WriteArray(const Node& node, const Napi::Value& value, std::string& out) {
+  Napi::Array array = value.As<Napi::Array>();
+  const uint32_t length = array.Length();
+
+  out += '[';
+
+  for (uint32_t i = 0; i < length; i++) {
+    if (i > 0) {
+      out += ',';
+    }
+    WriteNode(*node.items, array[i], out);
+  }
+
+  out += ']';
+}
+
+// Copy the UTF-8 bytes into a reused scratch buffer instead of a fresh std::string
+void CompiledSerializer::WriteString(const Napi::Value& value, std::string& out) {
+  napi_env env = value.Env();
+  size_t length = 0;
+
+  if (napi_get_value_string_utf8(env, value, nullptr, 0, &length) != napi_ok) {
+    out += "null";
+    return;
+  }
+
+  scratch_.resize(length + 1);
+  napi_get_value_string_utf8(env, value, &scratch_[0], scratch_.size(), &length);
+
+  AppendEscapedString(scratch_.data(), length, out);
+}
+
+// Integer writer: truncates like Math.trunc, non-finite values become null
+void CompiledSerializer::WriteInteger(double value, std::string& out) {
+  if (!std::isfinite(value)) {
+    out += "null";
+    return;
+  }
+
+  double truncated = std::trunc(value);
+  if (std::fabs(truncated) >= 9223372036854775807.0) {
+    owner_->StringifyNumber(truncated, out);
+    return;
+  }
+
+  char buffer[32];
+  int len = std::snprintf(buffer, sizeof(buffer), "%" PRId64, static_cast<int64_t>(truncated));
+  out.append(buffer, len);
+}
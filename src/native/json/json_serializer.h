@@ -0,0 +1,86 @@
+#ifndef JSON_SERIALIZER_H
+#define JSON_SERIALIZER_H
+
+#include <napi.h>
+#include <string>
+#include <vector>
+#include <memory>
+#include "json_processor.h"
+
+namespace nexurejs {
+  // Forward declaration
+  void AddCleanupReference(Napi::FunctionReference* ref);
+}
+
+/**
+ * Schema-compiled serializer (fast-json-stringify style)
+ *
+ * The schema is walked once at compile time into a tree of typed nodes with
+ * precomputed field order and pre-escaped key fragments ("id":). At runtime
+ * only the values are read, so no GetPropertyNames() call and no type probing
+ * is needed for fields whose type is declared by the schema.
+ */
+class CompiledSerializer : public Napi::ObjectWrap<CompiledSerializer> {
+public:
+  static void Init(Napi::Env env);
+  static Napi::Object NewInstance(Napi::Env env, Napi::Object owner, Napi::Object schema);
+  CompiledSerializer(const Napi::CallbackInfo& info);
+
+  // Value types a schema node can declare
+  enum class FieldType {
+    ANY = 0,     // No type declared, falls back to the generic writer
+    STRING,
+    NUMBER,
+    INTEGER,
+    BOOLEAN,
+    NULL_TYPE,
+    OBJECT,
+    ARRAY
+  };
+
+  struct Field;
+
+  struct Node {
+    FieldType type = FieldType::ANY;
+    bool nullable = false;
+    std::vector<Field> fields;       // OBJECT: properties in schema order
+    std::unique_ptr<Node> items;     // ARRAY: item schema
+  };
+
+  struct Field {
+    Napi::Reference<Napi::Value> key; // Cached JS property name
+    std::string fragment;             // Pre-escaped "key": fragment
+    std::string name;                 // Raw property name (for errors)
+    bool required = false;
+    Node node;
+  };
+
+private:
+  Napi::Value Stringify(const Napi::CallbackInfo& info);
+  Napi::Value StringifyToBuffer(const Napi::CallbackInfo& info);
+
+  // Compile a JSON schema object into a node tree
+  void CompileNode(Napi::Env env, Napi::Object schema, Node& node, size_t depth);
+
+  // Typed writers
+  void WriteNode(const Node& node, const Napi::Value& value, std::string& out);
+  void WriteAny(const Napi::Value& value, std::string& out);
+  void WriteObject(const Node& node, const Napi::Value& value, std::string& out);
+  void WriteArray(const Node& node, const Napi::Value& value, std::string& out);
+  void WriteString(const Napi::Value& value, std::string& out);
+  void WriteInteger(double value, std::string& out);
+
+  static Napi::FunctionReference* constructor_;
+
+  // Owning JsonProcessor, used for the generic (untyped) writer
+  Napi::ObjectReference ownerRef_;
+  JsonProcessor* owner_ = nullptr;
+
+  Node root_;
+  OutputBuffer output_;
+  std::string scratch_;
+
+  static constexpr size_t maxSchemaDepth_ = 64;
+};
+
+#endif // JSON_SERIALIZER_H
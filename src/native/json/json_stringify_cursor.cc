@@ -0,0 +1,221 @@
+#include "json_stringify_cursor.h"
+#include "json_processor.h"
+#include <algorithm>
+#include <stdexcept>
+
+Napi::FunctionReference* StringifyCursor::constructor_ = nullptr;
+
+// Register the class (not exported, instances are created by JsonProcessor)
+void StringifyCursor::Init(Napi::Env env) {
+  Napi::Function func = DefineClass(env, "StringifyCursor", {
+    InstanceMethod("next", &StringifyCursor::Next),
+    InstanceMethod("isDone", &StringifyCursor::IsDone),
+  });
+
+  constructor_ = new Napi::FunctionReference();
+  *constructor_ = Napi::Persistent(func);
+
+  // Add to cleanup list
+  nexurejs::AddCleanupReference(constructor_);
+}
+
+// Create a cursor bound to the given JsonProcessor instance
+Napi::Object StringifyCursor::NewInstance(Napi::Env env, Napi::Object owner, Napi::Value value,
+                                          Napi::Value options) {
+  Napi::EscapableHandleScope scope(env);
+
+  Napi::Object obj = constructor_->New({owner, value, options});
+  return scope.Escape(napi_value(obj)).ToObject();
+}
+
+// Constructor: (owner: JsonProcessor, value: any, options?: { chunkSize, ndjson })
+StringifyCursor::StringifyCursor(const Napi::CallbackInfo& info)
+    : Napi::ObjectWrap<StringifyCursor>(info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2 || !info[0].IsObject()) {
+    Napi::TypeError::New(env, "JsonProcessor instance expected").ThrowAsJavaScriptException();
+    return;
+  }
+
+  owner_ = JsonProcessor::Unwrap(info[0].As<Napi::Object>());
+  if (owner_ == nullptr) {
+    Napi::TypeError::New(env, "JsonProcessor instance expected").ThrowAsJavaScriptException();
+    return;
+  }
+
+  // Keep the owner and the value graph alive until the cursor is collected
+  ownerRef_ = Napi::Persistent(info[0].As<Napi::Object>());
+  root_ = Napi::Persistent(info[1]);
+
+  if (info.Length() > 2 && info[2].IsObject()) {
+    Napi::Object options = info[2].As<Napi::Object>();
+
+    if (options.Has("chunkSize") && options.Get("chunkSize").IsNumber()) {
+      size_t chunkSize = options.Get("chunkSize").As<Napi::Number>().Uint32Value();
+      chunkSize_ = std::max(chunkSize, minChunkSize_);
+    }
+
+    if (options.Has("ndjson") && options.Get("ndjson").IsBoolean()) {
+      ndjson_ = options.Get("ndjson").As<Napi::Boolean>().Value();
+    }
+  }
+
+  pending_.reserve(chunkSize_ * 2);
+}
+
+// next(): Buffer | null - returns the next chunk, or null once the output is complete
+Napi::Value StringifyCursor::Next(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  try {
+    Fill(env);
+  } catch (const std::exception& e) {
+    // Abandon the walk so a failed cursor cannot be resumed half-way
+    stack_.clear();
+    pending_.clear();
+    pendingOffset_ = 0;
+    done_ = true;
+    Napi::TypeError::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  size_t available = pending_.size() - pendingOffset_;
+  if (available == 0) {
+    return env.Null();
+  }
+
+  size_t length = std::min(chunkSize_, available);
+  Napi::Buffer<char> chunk = Napi::Buffer<char>::Copy(env, pending_.data() + pendingOffset_, length);
+  pendingOffset_ += length;
+
+  // Drop the handed-out prefix only once it is at least half the buffer, so the
+  // remaining output is moved a bounded number of times
+  if (pendingOffset_ == pending_.size()) {
+    pending_.clear();
+    pendingOffset_ = 0;
+  } else if (pendingOffset_ * 2 >= pending_.size()) {
+    pending_.erase(0, pendingOffset_);
+    pendingOffset_ = 0;
+  }
+
+  return chunk;
+}
+
+// isDone(): boolean
+Napi::Value StringifyCursor::IsDone(const Napi::CallbackInfo& info) {
+  return Napi::Boolean::New(info.Env(), done_ && pendingOffset_ == pending_.size());
+}
+
+// Walk the value graph until a full chunk is pending or the walk is finished
+void StringifyCursor::Fill(Napi::Env env) {
+  while (pending_.size() - pendingOffset_ < chunkSize_ && !done_) {
+    Napi::HandleScope scope(env);
+
+    if (!started_) {
+      started_ = true;
+      WriteValue(root_.Value());
+      if (stack_.empty()) {
+        done_ = true;
+      }
+      continue;
+    }
+
+    Frame& frame = stack_.back();
+
+    // Close the container once all entries are written
+    if (frame.index >= frame.length) {
+      if (!frame.ndjson) {
+        pending_ += frame.isArray ? ']' : '}';
+      }
+      stack_.pop_back();
+      if (stack_.empty()) {
+        done_ = true;
+      }
+      continue;
+    }
+
+    Napi::Object container = frame.container.Value();
+
+    if (frame.isArray) {
+      uint32_t index = frame.index++;
+      if (index > 0) {
+        pending_ += frame.ndjson ? '\n' : ',';
+      }
+      // WriteValue may push a frame and invalidate the reference
+      WriteValue(container.Get(index));
+    } else {
+      Napi::Value key = frame.keys.Value().Get(frame.index++);
+      Napi::Value value = container.Get(key);
+
+      // Skip functions and undefined values like JSON.stringify
+      if (value.IsUndefined() || value.IsFunction()) {
+        continue;
+      }
+
+      if (frame.wroteAny) {
+        pending_ += ',';
+      }
+      frame.wroteAny = true;
+
+      owner_->StringifyString(key.ToString().Utf8Value(), pending_);
+      pending_ += ':';
+      WriteValue(value);
+    }
+  }
+}
+
+// Write a scalar, or open a container and push it on the walk stack
+void StringifyCursor::WriteValue(const Napi::Value& value) {
+  if (value.IsNull() || value.IsUndefined() || value.IsFunction()) {
+    pending_ += "null";
+  } else if (value.IsString()) {
+    owner_->StringifyString(value.As<Napi::String>().Utf8Value(), pending_);
+  } else if (value.IsNumber()) {
+    owner_->StringifyNumber(value.As<Napi::Number>().DoubleValue(), pending_);
+  } else if (value.IsBigInt()) {
+    owner_->StringifyBigInt(value, pending_);
+  } else if (value.IsBoolean()) {
+    owner_->StringifyBoolean(value.As<Napi::Boolean>().Value(), pending_);
+  } else if (value.IsBuffer()) {
+    owner_->StringifyValue(value, pending_);
+  } else if (value.IsArray()) {
+    OpenContainer(value.As<Napi::Object>(), true);
+  } else if (value.IsObject()) {
+    OpenContainer(value.As<Napi::Object>(), false);
+  } else {
+    pending_ += "null";
+  }
+}
+
+// Push an array or object frame, rejecting cycles
+void StringifyCursor::OpenContainer(Napi::Object container, bool isArray) {
+  if (stack_.size() >= maxDepth_) {
+    throw std::runtime_error("Maximum nesting depth exceeded");
+  }
+
+  for (const auto& frame : stack_) {
+    if (frame.container.Value().StrictEquals(container)) {
+      throw std::runtime_error("Converting circular structure to JSON");
+    }
+  }
+
+  Frame frame;
+  frame.isArray = isArray;
+  frame.ndjson = ndjson_ && isArray && stack_.empty();
+  frame.container = Napi::Persistent(container);
+
+  if (isArray) {
+    frame.length = container.As<Napi::Array>().Length();
+  } else {
+    Napi::Array keys = container.GetPropertyNames();
+    frame.length = keys.Length();
+    frame.keys = Napi::Persistent(Napi::Object(keys));
+  }
+
+  if (!frame.ndjson) {
+    pending_ += isArray ? '[' : '{';
+  }
+
+  stack_.push_back(std::move(frame));
+}
@@ -0,0 +1,69 @@
+#ifndef JSON_STRINGIFY_CURSOR_H
+#define JSON_STRINGIFY_CURSOR_H
+
+#include <napi.h>
+#include <string>
+#include <vector>
+
+namespace nexurejs {
+  // Forward declaration
+  void AddCleanupReference(Napi::FunctionReference* ref);
+}
+
+class JsonProcessor;
+
+/**
+ * Incremental stringify cursor
+ *
+ * Serializes a value graph into fixed-size Buffer chunks on demand. The walk
+ * state is kept on an explicit stack, so each next() call only produces
+ * enough output to fill one chunk and memory stays flat regardless of the
+ * total output size. Consumers pull chunks as the writable side drains.
+ */
+class StringifyCursor : public Napi::ObjectWrap<StringifyCursor> {
+public:
+  static void Init(Napi::Env env);
+  static Napi::Object NewInstance(Napi::Env env, Napi::Object owner, Napi::Value value,
+                                  Napi::Value options);
+  StringifyCursor(const Napi::CallbackInfo& info);
+
+private:
+  // One open array or object on the walk stack
+  struct Frame {
+    Napi::ObjectReference container;
+    Napi::ObjectReference keys;    // Property names (objects only)
+    uint32_t index = 0;
+    uint32_t length = 0;
+    bool isArray = false;
+    bool wroteAny = false;
+    bool ndjson = false;           // Top-level array written as newline-delimited JSON
+  };
+
+  Napi::Value Next(const Napi::CallbackInfo& info);
+  Napi::Value IsDone(const Napi::CallbackInfo& info);
+
+  // Advance the walk until at least one chunk of output is pending
+  void Fill(Napi::Env env);
+  void WriteValue(const Napi::Value& value);
+  void OpenContainer(Napi::Object container, bool isArray);
+
+  static Napi::FunctionReference* constructor_;
+
+  // Owning JsonProcessor, used for the scalar writers
+  Napi::ObjectReference ownerRef_;
+  JsonProcessor* owner_ = nullptr;
+
+  Napi::Reference<Napi::Value> root_;
+  std::vector<Frame> stack_;
+  std::string pending_;
+  size_t pendingOffset_ = 0;       // Start of the output not yet handed out
+  size_t chunkSize_ = 64 * 1024;
+  bool started_ = false;
+  bool done_ = false;
+  bool ndjson_ = false;
+
+  static constexpr size_t minChunkSize_ = 1024;
+  static constexpr size_t maxDepth_ = 1024;
+};
+
+#endif // JSON_STRINGIFY_CURSOR_H
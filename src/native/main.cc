@@ -2,6 +2,7 @@
 #include "json/simdjson_wrapper.h"
 #include "http/http_parser.h"
 #include "http/object_pool.h"
+#include "http/negotiator.h"
 #include "json/json_processor.h"
 #include "routing/radix_router.h"
 #include "url/url_parser.h"
@@ -87,6 +88,7 @@ Napi::Object Init(Napi::Env env, Napi::Object exports) {
   // Initialize all components
   HttpParser::Init(env, exports);
   ObjectPool::Init(env, exports);
+  Negotiator::Init(env, exports);
   RadixRouter::Init(env, exports);
   JsonProcessor::Init(env, exports);
   UrlParser::Init(env, exports);
@@ -97,6 +99,7 @@ Napi::Object Init(Napi::Env env, Napi::Object exports) {
   // Register component cleanup functions
   RegisterComponent("HttpParser", []() { /* Cleanup code if needed */ });
   RegisterComponent("ObjectPool", []() { /* Cleanup code if needed */ });
+  RegisterComponent("Negotiator", []() { /* Cleanup code if needed */ });
   RegisterComponent("RadixRouter", []() { /* Cleanup code if needed */ });
   RegisterComponent("JsonProcessor", []() { /* Cleanup code if needed */ });
   RegisterComponent("UrlParser", []() { /* Cleanup code if needed */ });
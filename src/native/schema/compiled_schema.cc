@@ -0,0 +1,111 @@
+#include "compiled_schema.h"
+
+namespace SchemaValidator {
+
+  Napi::FunctionReference* CompiledSchema::constructor_ = nullptr;
+
+  namespace {
+    // Tag on every CompiledSchema instance, so FromValue never unwraps a foreign object
+    const napi_type_tag kCompiledSchemaTag = {0x6e6578757265736aULL, 0x636f6d70696c6564ULL};
+  }
+
+  Napi::Object CompiledSchema::Init(Napi::Env env, Napi::Object exports) {
+    Napi::HandleScope scope(env);
+
+    Napi::Function func = DefineClass(env, "CompiledSchema", {
+      InstanceMethod("validate", &CompiledSchema::Validate),
+      InstanceMethod("validatePartial", &CompiledSchema::ValidatePartial),
+      InstanceAccessor("id", &CompiledSchema::GetId, nullptr),
+      InstanceAccessor("hash", &CompiledSchema::GetHash, nullptr),
+      InstanceAccessor("version", &CompiledSchema::GetVersion, nullptr)
+    });
+
+    constructor_ = new Napi::FunctionReference();
+    *constructor_ = Napi::Persistent(func);
+    exports.Set("CompiledSchema", func);
+
+    nexurejs::AddCleanupReference(constructor_);
+
+    return exports;
+  }
+
+  Napi::Object CompiledSchema::NewInstance(Napi::Env env, Napi::Object schema) {
+    Napi::EscapableHandleScope scope(env);
+
+    Napi::Object obj = constructor_->New({schema});
+    return scope.Escape(napi_value(obj)).ToObject();
+  }
+
+  // new CompiledSchema(schema): compiles once (or reuses the cached program) and keeps it
+  CompiledSchema::CompiledSchema(const Napi::CallbackInfo& info)
+    : Napi::ObjectWrap<CompiledSchema>(info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsObject()) {
+      Napi::TypeError::New(env, "Expected (schema)").ThrowAsJavaScriptException();
+      return;
+    }
+
+    validator_ = CompileSchemaInternal(info[0].As<Napi::Object>());
+    if (!validator_) {
+      return;
+    }
+    napi_type_tag_object(env, info.This(), &kCompiledSchemaTag);
+  }
+
+  CompiledSchema* CompiledSchema::FromValue(const Napi::Value& value) {
+    if (!value.IsObject()) {
+      return nullptr;
+    }
+    bool tagged = false;
+    if (napi_check_object_type_tag(value.Env(), value, &kCompiledSchemaTag, &tagged) != napi_ok || !tagged) {
+      return nullptr;
+    }
+    return Unwrap(value.As<Napi::Object>());
+  }
+
+  // validate(data): { valid, errors }
+  Napi::Value CompiledSchema::Validate(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (!validator_) {
+      Napi::Error::New(env, "Schema was not compiled").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    std::vector<ValidationError> errors;
+    bool valid = validator_->validate(info[0], errors);
+    return ValidationResult(env, valid, errors);
+  }
+
+  // validatePartial(data, updates): validates `updates` as if merged into `data`
+  Napi::Value CompiledSchema::ValidatePartial(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 2 || !info[0].IsObject() || !info[1].IsObject()) {
+      Napi::TypeError::New(env, "Expected (data, updates)").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    if (!validator_) {
+      Napi::Error::New(env, "Schema was not compiled").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    std::vector<ValidationError> errors;
+    bool valid = validator_->program->ValidateUpdate(info[0].As<Napi::Object>(), info[1].As<Napi::Object>(), errors);
+    return ValidationResult(env, valid, errors);
+  }
+
+  Napi::Value CompiledSchema::GetId(const Napi::CallbackInfo& info) {
+    return Napi::String::New(info.Env(), validator_ ? validator_->version.id : std::string());
+  }
+
+  Napi::Value CompiledSchema::GetHash(const Napi::CallbackInfo& info) {
+    return Napi::String::New(info.Env(), validator_ ? validator_->version.hash : std::string());
+  }
+
+  Napi::Value CompiledSchema::GetVersion(const Napi::CallbackInfo& info) {
+    return Napi::Number::New(info.Env(), validator_ ? static_cast<double>(validator_->version.version) : 0);
+  }
+
+} // namespace SchemaValidator
@@ -0,0 +1,50 @@
+#ifndef SCHEMA_COMPILED_SCHEMA_H
+#define SCHEMA_COMPILED_SCHEMA_H
+
+#include <napi.h>
+#include <memory>
+#include "schema_validator.h"
+
+namespace nexurejs {
+  // Forward declaration
+  void AddCleanupReference(Napi::FunctionReference* ref);
+}
+
+namespace SchemaValidator {
+
+  /**
+   * Handle to one compiled schema, returned by compileSchema()
+   *
+   * The handle owns its CompiledValidator, so validate() goes straight to the
+   * schema program: no hashing, no cache lookup and no locking per call.
+   * Meant for validators built once (per route, say) and reused.
+   */
+  class CompiledSchema : public Napi::ObjectWrap<CompiledSchema> {
+  public:
+    static Napi::Object Init(Napi::Env env, Napi::Object exports);
+
+    // New handle for a schema object, the same as `new CompiledSchema(schema)` in JS
+    static Napi::Object NewInstance(Napi::Env env, Napi::Object schema);
+
+    CompiledSchema(const Napi::CallbackInfo& info);
+
+    // The CompiledSchema behind a JS value, or nullptr if it is not one
+    static CompiledSchema* FromValue(const Napi::Value& value);
+
+    const std::shared_ptr<CompiledValidator>& Validator() const { return validator_; }
+
+  private:
+    Napi::Value Validate(const Napi::CallbackInfo& info);
+    Napi::Value ValidatePartial(const Napi::CallbackInfo& info);
+    Napi::Value GetId(const Napi::CallbackInfo& info);
+    Napi::Value GetHash(const Napi::CallbackInfo& info);
+    Napi::Value GetVersion(const Napi::CallbackInfo& info);
+
+    static Napi::FunctionReference* constructor_;
+
+    std::shared_ptr<CompiledValidator> validator_;
+  };
+
+} // namespace SchemaValidator
+
+#endif // SCHEMA_COMPILED_SCHEMA_H
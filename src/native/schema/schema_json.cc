@@ -0,0 +1,561 @@
+#include "schema_json.h"
+#include "schema_validator.h"
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+
+namespace SchemaValidator {
+
+  namespace {
+
+    using simdjson::ondemand::json_type;
+
+    inline bool isIntegral(double value) {
+      return std::isfinite(value) && std::floor(value) == value;
+    }
+
+    // Read a value to its end without keeping anything, so its syntax is still checked
+    template <typename V>
+    simdjson::error_code skipValue(V& value) {
+      json_type type;
+      simdjson::error_code error = value.type().get(type);
+      if (error) {
+        return error;
+      }
+
+      switch (type) {
+        case json_type::object: {
+          simdjson::ondemand::object object;
+          if ((error = value.get_object().get(object))) {
+            return error;
+          }
+          for (auto field : object) {
+            std::string_view key;
+            simdjson::ondemand::value item;
+            if ((error = field.unescaped_key().get(key)) || (error = field.value().get(item)) ||
+                (error = skipValue(item))) {
+              return error;
+            }
+          }
+          return simdjson::SUCCESS;
+        }
+        case json_type::array: {
+          simdjson::ondemand::array array;
+          if ((error = value.get_array().get(array))) {
+            return error;
+          }
+          for (auto element : array) {
+            simdjson::ondemand::value item;
+            if ((error = element.get(item)) || (error = skipValue(item))) {
+              return error;
+            }
+          }
+          return simdjson::SUCCESS;
+        }
+        case json_type::number: {
+          double number;
+          return value.get_double().get(number);
+        }
+        case json_type::string: {
+          std::string_view text;
+          return value.get_string().get(text);
+        }
+        case json_type::boolean: {
+          bool flag;
+          return value.get_bool().get(flag);
+        }
+        case json_type::null: {
+          bool isNull = false;
+          if ((error = value.is_null().get(isNull))) {
+            return error;
+          }
+          return isNull ? simdjson::SUCCESS : simdjson::N_ATOM_ERROR;
+        }
+        default:
+          return simdjson::INCORRECT_TYPE;
+      }
+    }
+
+    template <typename V>
+    simdjson::error_code toValue(Napi::Env env, V& value, Napi::Value& out) {
+      json_type type;
+      simdjson::error_code error = value.type().get(type);
+      if (error) {
+        return error;
+      }
+
+      switch (type) {
+        case json_type::object: {
+          simdjson::ondemand::object object;
+          if ((error = value.get_object().get(object))) {
+            return error;
+          }
+          Napi::Object result = Napi::Object::New(env);
+          for (auto field : object) {
+            std::string_view key;
+            simdjson::ondemand::value item;
+            Napi::Value converted;
+            if ((error = field.unescaped_key().get(key)) || (error = field.value().get(item)) ||
+                (error = toValue(env, item, converted))) {
+              return error;
+            }
+            SetOwnProperty(env, result, key, converted);
+          }
+          out = result;
+          return simdjson::SUCCESS;
+        }
+        case json_type::array: {
+          simdjson::ondemand::array array;
+          if ((error = value.get_array().get(array))) {
+            return error;
+          }
+          Napi::Array result = Napi::Array::New(env);
+          uint32_t index = 0;
+          for (auto element : array) {
+            simdjson::ondemand::value item;
+            Napi::Value converted;
+            if ((error = element.get(item)) || (error = toValue(env, item, converted))) {
+              return error;
+            }
+            result.Set(index++, converted);
+          }
+          out = result;
+          return simdjson::SUCCESS;
+        }
+        case json_type::number: {
+          double number;
+          if ((error = value.get_double().get(number))) {
+            return error;
+          }
+          out = Napi::Number::New(env, number);
+          return simdjson::SUCCESS;
+        }
+        case json_type::string: {
+          std::string_view text;
+          if ((error = value.get_string().get(text))) {
+            return error;
+          }
+          out = Napi::String::New(env, text.data(), text.size());
+          return simdjson::SUCCESS;
+        }
+        case json_type::boolean: {
+          bool flag;
+          if ((error = value.get_bool().get(flag))) {
+            return error;
+          }
+          out = Napi::Boolean::New(env, flag);
+          return simdjson::SUCCESS;
+        }
+        case json_type::null: {
+          bool isNull;
+          if ((error = value.is_null().get(isNull))) {
+            return error;
+          }
+          if (!isNull) {
+            return simdjson::N_ATOM_ERROR;
+          }
+          out = env.Null();
+          return simdjson::SUCCESS;
+        }
+        default:
+          return simdjson::INCORRECT_TYPE;
+      }
+    }
+
+  } // namespace
+
+  simdjson::error_code JsonValidator::Validate(simdjson::ondemand::document& document,
+                                               std::vector<ValidationError>& errors) {
+    error_ = simdjson::SUCCESS;
+    std::string path = "$";
+    Walk(0, document, path, errors);
+
+    // Every value is consumed by the walk, so anything left over is trailing content
+    if (!error_ && !document.at_end()) {
+      error_ = simdjson::TRAILING_CONTENT;
+    }
+    return error_;
+  }
+
+  // Validate one value against node `index`, consuming it
+  template <typename V>
+  bool JsonValidator::Walk(uint32_t index, V& value, std::string& path, std::vector<ValidationError>& errors) {
+    const SchemaProgram::Node& node = program_.NodeAt(index);
+    if (node.checks & (SchemaProgram::kCombinatorChecks | SchemaProgram::CHECK_UNIQUE_ITEMS)) {
+      std::string_view json;
+      if (Fail(value.raw_json().get(json))) {
+        return false;
+      }
+      return WalkCopy(index, json, path, errors);
+    }
+
+    uint8_t actual = 0;
+    return Check(index, value, path, errors, actual);
+  }
+
+  // The node's own keywords, without combinators or uniqueItems. `actual` is the value's
+  // type, or 0 when the walk stopped at it (null, or a type the node does not accept).
+  template <typename V>
+  bool JsonValidator::Check(uint32_t index, V& value, std::string& path, std::vector<ValidationError>& errors,
+                            uint8_t& actual) {
+    const SchemaProgram::Node& node = program_.NodeAt(index);
+    actual = 0;
+
+    json_type type;
+    if (Fail(value.type().get(type))) {
+      return false;
+    }
+
+    double number = 0;
+    bool flag = false;
+    std::string_view text;
+    uint8_t found = 0;
+    switch (type) {
+      case json_type::null: {
+        bool isNull = false;
+        if (Fail(value.is_null().get(isNull)) || (!isNull && Fail(simdjson::N_ATOM_ERROR))) {
+          return false;
+        }
+        // null passes unless the value is marked required
+        if (node.checks & SchemaProgram::CHECK_REQUIRED_VALUE) {
+          errors.push_back({path, "Value is required"});
+          return false;
+        }
+        return true;
+      }
+      case json_type::boolean:
+        if (Fail(value.get_bool().get(flag))) {
+          return false;
+        }
+        found = SchemaProgram::TYPE_BOOLEAN;
+        break;
+      case json_type::number:
+        if (Fail(value.get_double().get(number))) {
+          return false;
+        }
+        found = isIntegral(number) ? SchemaProgram::TYPE_NUMBER | SchemaProgram::TYPE_INTEGER
+                                   : SchemaProgram::TYPE_NUMBER;
+        break;
+      case json_type::string:
+        if (Fail(value.get_string().get(text))) {
+          return false;
+        }
+        found = SchemaProgram::TYPE_STRING;
+        break;
+      case json_type::array:
+        found = SchemaProgram::TYPE_ARRAY;
+        break;
+      case json_type::object:
+        found = SchemaProgram::TYPE_OBJECT;
+        break;
+      default:
+        Fail(simdjson::INCORRECT_TYPE);
+        return false;
+    }
+
+    if (node.types != 0 && (node.types & found) == 0) {
+      program_.TypeError(node, found, path, errors);
+      // Scalars were read above; containers still have to be stepped over
+      if (found & (SchemaProgram::TYPE_ARRAY | SchemaProgram::TYPE_OBJECT)) {
+        Skip(value);
+      }
+      return false;
+    }
+    actual = found;
+
+    size_t mark = errors.size();
+    switch (found) {
+      case SchemaProgram::TYPE_STRING:
+        if (node.checks & SchemaProgram::kStringChecks) {
+          program_.CheckString(node, text, path, errors);
+        }
+        break;
+      case SchemaProgram::TYPE_NUMBER:
+      case SchemaProgram::TYPE_NUMBER | SchemaProgram::TYPE_INTEGER:
+        if (node.checks & SchemaProgram::kNumberChecks) {
+          program_.CheckNumber(node, number, path, errors);
+        }
+        break;
+      case SchemaProgram::TYPE_ARRAY: {
+        simdjson::ondemand::array array;
+        if (!Fail(value.get_array().get(array))) {
+          CheckArray(node, array, path, errors);
+        }
+        break;
+      }
+      case SchemaProgram::TYPE_OBJECT: {
+        simdjson::ondemand::object object;
+        if (!Fail(value.get_object().get(object))) {
+          CheckObject(node, object, path, errors);
+        }
+        break;
+      }
+      default:
+        break;
+    }
+
+    return !error_ && errors.size() == mark;
+  }
+
+  bool JsonValidator::CheckObject(const SchemaProgram::Node& node, simdjson::ondemand::object object,
+                                  std::string& path, std::vector<ValidationError>& errors) {
+    size_t mark = errors.size();
+    size_t pathLength = path.size();
+
+    // Required properties are ticked off as they go by
+    std::vector<bool> seen(node.required.end - node.required.begin);
+
+    for (auto field : object) {
+      std::string_view key;
+      simdjson::ondemand::value item;
+      if (Fail(field.unescaped_key().get(key)) || Fail(field.value().get(item))) {
+        return false;
+      }
+
+      for (uint32_t i = node.required.begin; i < node.required.end; i++) {
+        if (program_.required_[i] == key) {
+          seen[i - node.required.begin] = true;
+        }
+      }
+
+      path += '.';
+      path += key;
+      const SchemaProgram::Property* property = program_.FindProperty(node, key);
+      if (property) {
+        Walk(property->node, item, path, errors);
+      } else if (node.checks & SchemaProgram::CHECK_NO_ADDITIONAL) {
+        errors.push_back({path, "Additional property not allowed"});
+        Skip(item);
+      } else if (node.checks & SchemaProgram::CHECK_ADDITIONAL_SCHEMA) {
+        Walk(node.additional, item, path, errors);
+      } else {
+        Skip(item);
+      }
+      path.resize(pathLength);
+
+      if (error_) {
+        return false;
+      }
+    }
+
+    // Reported ahead of the property errors, as for JS objects
+    std::vector<ValidationError> missing;
+    for (uint32_t i = node.required.begin; i < node.required.end; i++) {
+      if (!seen[i - node.required.begin]) {
+        missing.push_back({path + "." + program_.required_[i], "Required property missing"});
+      }
+    }
+    errors.insert(errors.begin() + mark, missing.begin(), missing.end());
+
+    return errors.size() == mark;
+  }
+
+  bool JsonValidator::CheckArray(const SchemaProgram::Node& node, simdjson::ondemand::array array,
+                                 std::string& path, std::vector<ValidationError>& errors) {
+    size_t mark = errors.size();
+    size_t pathLength = path.size();
+    size_t length = 0;
+
+    for (auto element : array) {
+      simdjson::ondemand::value item;
+      if (Fail(element.get(item))) {
+        return false;
+      }
+      if (node.checks & SchemaProgram::CHECK_ITEMS) {
+        path += '[';
+        path += std::to_string(length);
+        path += ']';
+        Walk(node.items, item, path, errors);
+        path.resize(pathLength);
+      } else {
+        Skip(item);
+      }
+      length++;
+
+      if (error_) {
+        return false;
+      }
+    }
+
+    // The length is only known at the end; its errors still come first
+    std::vector<ValidationError> lengthErrors;
+    program_.CheckArrayLength(node, length, path, lengthErrors);
+    errors.insert(errors.begin() + mark, lengthErrors.begin(), lengthErrors.end());
+
+    return errors.size() == mark;
+  }
+
+  // Primitive items are compared by type and value; objects and arrays are not compared
+  bool JsonValidator::CheckUnique(simdjson::ondemand::document& document, const std::string& path,
+                                  std::vector<ValidationError>& errors) {
+    simdjson::ondemand::array array;
+    if (Fail(document.get_array().get(array))) {
+      return false;
+    }
+
+    std::unordered_set<std::string> seen;
+    for (auto element : array) {
+      simdjson::ondemand::value item;
+      json_type type;
+      if (Fail(element.get(item)) || Fail(item.type().get(type))) {
+        return false;
+      }
+
+      std::string key;
+      if (type == json_type::string) {
+        std::string_view text;
+        if (Fail(item.get_string().get(text))) {
+          return false;
+        }
+        key = "s";
+        key += text;
+      } else if (type == json_type::number) {
+        double number;
+        if (Fail(item.get_double().get(number))) {
+          return false;
+        }
+        key = "n" + std::to_string(number);
+      } else if (type == json_type::boolean) {
+        bool flag;
+        if (Fail(item.get_bool().get(flag))) {
+          return false;
+        }
+        key = flag ? "t" : "f";
+      } else if (type == json_type::null) {
+        key = "z";
+      } else {
+        continue;
+      }
+
+      if (!seen.insert(std::move(key)).second) {
+        errors.push_back({path, "Array items must be unique"});
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool JsonValidator::CheckCombinators(const SchemaProgram::Node& node, simdjson::ondemand::document& document,
+                                       std::string& path, std::vector<ValidationError>& errors) {
+    size_t mark = errors.size();
+    std::vector<ValidationError> scratch;
+
+    // Each subschema reads the value from the start of the copy
+    auto walk = [&](uint32_t child, std::vector<ValidationError>& out) {
+      document.rewind();
+      return Walk(child, document, path, out) && !error_;
+    };
+
+    if (node.checks & SchemaProgram::CHECK_ANY_OF) {
+      bool matched = false;
+      for (uint32_t i = node.anyOf.begin; i < node.anyOf.end && !matched && !error_; i++) {
+        scratch.clear();
+        matched = walk(program_.children_[i], scratch);
+      }
+      if (!matched) {
+        errors.push_back({path, "Did not match any of the schemas"});
+      }
+    }
+
+    if (node.checks & SchemaProgram::CHECK_ALL_OF) {
+      for (uint32_t i = node.allOf.begin; i < node.allOf.end && !error_; i++) {
+        walk(program_.children_[i], errors);
+      }
+    }
+
+    if (node.checks & SchemaProgram::CHECK_ONE_OF) {
+      int matches = 0;
+      for (uint32_t i = node.oneOf.begin; i < node.oneOf.end && matches < 2 && !error_; i++) {
+        scratch.clear();
+        matches += walk(program_.children_[i], scratch) ? 1 : 0;
+      }
+      if (matches != 1) {
+        errors.push_back({path, "Should match exactly one schema"});
+      }
+    }
+
+    if (node.checks & SchemaProgram::CHECK_NOT) {
+      scratch.clear();
+      if (walk(node.not_, scratch)) {
+        errors.push_back({path, "Should not match schema"});
+      }
+    }
+
+    return !error_ && errors.size() == mark;
+  }
+
+  // Validate a node that reads its value more than once, from a private copy of the value's text
+  bool JsonValidator::WalkCopy(uint32_t index, std::string_view json, std::string& path,
+                               std::vector<ValidationError>& errors) {
+    const SchemaProgram::Node& node = program_.NodeAt(index);
+
+    // Nested copies are live at the same time, so each depth has its own parser
+    if (depth_ == parsers_.size()) {
+      parsers_.push_back(std::make_unique<simdjson::ondemand::parser>());
+    }
+    simdjson::ondemand::parser& parser = *parsers_[depth_];
+    simdjson::padded_string copy(json);
+    simdjson::ondemand::document document;
+    if (Fail(parser.iterate(copy).get(document))) {
+      return false;
+    }
+
+    depth_++;
+    size_t mark = errors.size();
+    uint8_t actual = 0;
+    Check(index, document, path, errors, actual);
+
+    // Like the JS walker: combinators are skipped for null and for a rejected type
+    if (actual != 0 && !error_) {
+      if ((node.checks & SchemaProgram::CHECK_UNIQUE_ITEMS) && actual == SchemaProgram::TYPE_ARRAY) {
+        document.rewind();
+        CheckUnique(document, path, errors);
+      }
+      if (node.checks & SchemaProgram::kCombinatorChecks) {
+        CheckCombinators(node, document, path, errors);
+      }
+    }
+    depth_--;
+
+    return !error_ && errors.size() == mark;
+  }
+
+  // Consume a value the schema does not look at, still checking that it is well-formed
+  template <typename V>
+  void JsonValidator::Skip(V& value) {
+    Fail(skipValue(value));
+  }
+
+  void SetOwnProperty(Napi::Env env, Napi::Object& object, std::string_view key, const Napi::Value& value) {
+    Napi::String name = Napi::String::New(env, key.data(), key.size());
+    if (key == "__proto__") {
+      napi_property_descriptor descriptor = {
+        nullptr, name, nullptr, nullptr, nullptr, value, napi_default_jsproperty, nullptr
+      };
+      napi_define_properties(env, object, 1, &descriptor);
+      return;
+    }
+    object.Set(name, value);
+  }
+
+  simdjson::error_code JsonToValue(Napi::Env env, simdjson::ondemand::document& document, Napi::Value& out) {
+    simdjson::error_code error = toValue(env, document, out);
+    if (!error && !document.at_end()) {
+      error = simdjson::TRAILING_CONTENT;
+    }
+    return error;
+  }
+
+  simdjson::error_code JsonToValue(Napi::Env env, simdjson::ondemand::value& value, Napi::Value& out) {
+    return toValue(env, value, out);
+  }
+
+  simdjson::error_code SkipJson(simdjson::ondemand::document& document) {
+    return skipValue(document);
+  }
+
+  simdjson::error_code SkipJson(simdjson::ondemand::value& value) {
+    return skipValue(value);
+  }
+
+} // namespace SchemaValidator
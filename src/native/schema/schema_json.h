@@ -0,0 +1,87 @@
+#ifndef SCHEMA_JSON_H
+#define SCHEMA_JSON_H
+
+#include <napi.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "json/simdjson_wrapper.h"
+#include "schema_program.h"
+
+namespace SchemaValidator {
+
+  struct ValidationError;
+
+  /**
+   * Validates raw JSON text against a SchemaProgram during a simdjson
+   * On-Demand walk, without creating any JS values
+   *
+   * The walk follows the schema: declared properties and items are checked as
+   * they are reached, and everything else is stepped over while still being
+   * checked for JSON syntax, so an invalid document is never half accepted.
+   * The errors are the ones SchemaProgram::Validate reports for the parsed value.
+   *
+   * On-Demand values are read once. Nodes that look at a value more than once
+   * (anyOf/allOf/oneOf/not, uniqueItems) copy that value's JSON text and
+   * rewind over the copy; everything else is a single forward pass.
+   */
+  class JsonValidator {
+  public:
+    explicit JsonValidator(const SchemaProgram& program) : program_(program) {}
+
+    // Validate a whole document. Anything but SUCCESS means the text is not valid
+    // JSON, in which case `errors` is incomplete and should be discarded.
+    simdjson::error_code Validate(simdjson::ondemand::document& document,
+                                  std::vector<ValidationError>& errors);
+
+  private:
+    template <typename V>
+    bool Walk(uint32_t index, V& value, std::string& path, std::vector<ValidationError>& errors);
+    template <typename V>
+    bool Check(uint32_t index, V& value, std::string& path, std::vector<ValidationError>& errors,
+               uint8_t& actual);
+    bool CheckObject(const SchemaProgram::Node& node, simdjson::ondemand::object object,
+                     std::string& path, std::vector<ValidationError>& errors);
+    bool CheckArray(const SchemaProgram::Node& node, simdjson::ondemand::array array,
+                    std::string& path, std::vector<ValidationError>& errors);
+    bool CheckUnique(simdjson::ondemand::document& document, const std::string& path,
+                     std::vector<ValidationError>& errors);
+    bool CheckCombinators(const SchemaProgram::Node& node, simdjson::ondemand::document& document,
+                          std::string& path, std::vector<ValidationError>& errors);
+    bool WalkCopy(uint32_t index, std::string_view json, std::string& path,
+                  std::vector<ValidationError>& errors);
+    template <typename V>
+    void Skip(V& value);
+
+    // Record a simdjson error; true if there was one
+    bool Fail(simdjson::error_code error) {
+      if (error && !error_) {
+        error_ = error;
+      }
+      return error != simdjson::SUCCESS;
+    }
+
+    const SchemaProgram& program_;
+    simdjson::error_code error_ = simdjson::SUCCESS;
+    std::vector<std::unique_ptr<simdjson::ondemand::parser>> parsers_;  // One per WalkCopy depth
+    size_t depth_ = 0;
+  };
+
+  // Build the JS value for a document or a value within one, as JSON.parse would
+  simdjson::error_code JsonToValue(Napi::Env env, simdjson::ondemand::document& document, Napi::Value& out);
+  simdjson::error_code JsonToValue(Napi::Env env, simdjson::ondemand::value& value, Napi::Value& out);
+
+  // Own-property set for a key read from input, as JSON.parse does: "__proto__"
+  // becomes a plain property instead of going through the prototype setter
+  void SetOwnProperty(Napi::Env env, Napi::Object& object, std::string_view key, const Napi::Value& value);
+
+  // Consume a document or value, checking its syntax without building anything
+  simdjson::error_code SkipJson(simdjson::ondemand::document& document);
+  simdjson::error_code SkipJson(simdjson::ondemand::value& value);
+
+} // namespace SchemaValidator
+
+#endif // SCHEMA_JSON_H
@@ -0,0 +1,486 @@
+#include "schema_parse.h"
+#include "schema_json.h"
+#include "schema_validator.h"
+#include "url/url_parser.h"
+#include "url/url_scan.h"
+#include <cmath>
+#include <cstdlib>
+#include <unordered_map>
+
+namespace SchemaValidator {
+
+  namespace {
+
+    using simdjson::ondemand::json_type;
+
+    // Parameters past this are ignored, as in parseQueryString()
+    constexpr uint32_t kQueryParameterLimit = 1000;
+
+    inline bool isIntegral(double value) {
+      return std::isfinite(value) && std::floor(value) == value;
+    }
+
+    // A decimal number spelled out in full ("42", "-1.5", "1e3"); no hex, Infinity or padding
+    bool parseNumber(std::string_view text, double& out) {
+      if (text.empty() || text.size() > 64) {
+        return false;
+      }
+      for (char c : text) {
+        if (!((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E')) {
+          return false;
+        }
+      }
+      std::string buffer(text);
+      char* end = nullptr;
+      out = std::strtod(buffer.c_str(), &end);
+      return end == buffer.c_str() + buffer.size() && std::isfinite(out);
+    }
+
+    inline uint8_t typeOf(uint8_t type, double number) {
+      if (type == SchemaProgram::TYPE_NUMBER && isIntegral(number)) {
+        return SchemaProgram::TYPE_NUMBER | SchemaProgram::TYPE_INTEGER;
+      }
+      return type;
+    }
+
+  } // namespace
+
+  simdjson::error_code SchemaParser::ParseJson(simdjson::ondemand::document& document, Napi::Value& out,
+                                               std::vector<ValidationError>& errors) {
+    error_ = simdjson::SUCCESS;
+    std::string path = "$";
+    Parse(0, document, path, errors, out);
+
+    if (!error_ && !document.at_end()) {
+      error_ = simdjson::TRAILING_CONTENT;
+    }
+    return error_;
+  }
+
+  template <typename V>
+  bool SchemaParser::Parse(uint32_t index, V& value, std::string& path, std::vector<ValidationError>& errors,
+                           Napi::Value& out) {
+    const SchemaProgram::Node& node = program_.NodeAt(index);
+
+    json_type type;
+    if (Fail(value.type().get(type))) {
+      return false;
+    }
+
+    Scalar scalar;
+    switch (type) {
+      case json_type::null: {
+        bool isNull = false;
+        if (Fail(value.is_null().get(isNull)) || (!isNull && Fail(simdjson::N_ATOM_ERROR))) {
+          return false;
+        }
+        return EmitScalar(index, scalar, path, errors, out);
+      }
+      case json_type::boolean:
+        scalar.type = SchemaProgram::TYPE_BOOLEAN;
+        return !Fail(value.get_bool().get(scalar.boolean)) && EmitScalar(index, scalar, path, errors, out);
+      case json_type::number:
+        scalar.type = SchemaProgram::TYPE_NUMBER;
+        return !Fail(value.get_double().get(scalar.number)) && EmitScalar(index, scalar, path, errors, out);
+      case json_type::string:
+        scalar.type = SchemaProgram::TYPE_STRING;
+        return !Fail(value.get_string().get(scalar.text)) && EmitScalar(index, scalar, path, errors, out);
+      case json_type::array:
+      case json_type::object:
+        break;
+      default:
+        Fail(simdjson::INCORRECT_TYPE);
+        return false;
+    }
+
+    uint8_t found = type == json_type::array ? SchemaProgram::TYPE_ARRAY : SchemaProgram::TYPE_OBJECT;
+    if (node.types != 0 && (node.types & found) == 0) {
+      // Containers are never coerced
+      program_.TypeError(node, found, path, errors);
+      Fail(SkipJson(value));
+      return false;
+    }
+
+    size_t mark = errors.size();
+    if (found == SchemaProgram::TYPE_ARRAY) {
+      simdjson::ondemand::array array;
+      if (!Fail(value.get_array().get(array))) {
+        ParseArray(node, array, path, errors, out);
+      }
+    } else {
+      simdjson::ondemand::object object;
+      if (!Fail(value.get_object().get(object))) {
+        ParseObject(node, object, path, errors, out);
+      }
+    }
+    if (error_) {
+      return false;
+    }
+
+    if (node.checks & SchemaProgram::kCombinatorChecks) {
+      program_.ValidateCombinators(node, out, path, errors);
+    }
+    return errors.size() == mark;
+  }
+
+  bool SchemaParser::ParseObject(const SchemaProgram::Node& node, simdjson::ondemand::object object,
+                                 std::string& path, std::vector<ValidationError>& errors, Napi::Value& out) {
+    Napi::Object result = Napi::Object::New(env_);
+    size_t mark = errors.size();
+    size_t pathLength = path.size();
+
+    for (auto field : object) {
+      std::string_view key;
+      simdjson::ondemand::value item;
+      if (Fail(field.unescaped_key().get(key)) || Fail(field.value().get(item))) {
+        return false;
+      }
+
+      const SchemaProgram::Property* property = program_.FindProperty(node, key);
+      if (!property && (node.checks & SchemaProgram::CHECK_NO_ADDITIONAL)) {
+        // Unknown properties are stripped
+        if (Fail(SkipJson(item))) {
+          return false;
+        }
+        continue;
+      }
+
+      path += '.';
+      path += key;
+      Napi::Value child;
+      if (property) {
+        Parse(property->node, item, path, errors, child);
+      } else if (node.checks & SchemaProgram::CHECK_ADDITIONAL_SCHEMA) {
+        Parse(node.additional, item, path, errors, child);
+      } else {
+        Fail(JsonToValue(env_, item, child));
+      }
+      path.resize(pathLength);
+
+      if (error_) {
+        return false;
+      }
+      // A rejected value still counts as present for `required`
+      SetOwnProperty(env_, result, key, child.IsEmpty() ? env_.Undefined() : child);
+    }
+
+    FinishObject(node, result, mark, path, errors);
+    out = result;
+    return errors.size() == mark;
+  }
+
+  bool SchemaParser::ParseArray(const SchemaProgram::Node& node, simdjson::ondemand::array array,
+                                std::string& path, std::vector<ValidationError>& errors, Napi::Value& out) {
+    Napi::Array result = Napi::Array::New(env_);
+    size_t mark = errors.size();
+    size_t pathLength = path.size();
+    uint32_t length = 0;
+
+    for (auto element : array) {
+      simdjson::ondemand::value item;
+      if (Fail(element.get(item))) {
+        return false;
+      }
+
+      Napi::Value child;
+      if (node.checks & SchemaProgram::CHECK_ITEMS) {
+        path += '[';
+        path += std::to_string(length);
+        path += ']';
+        Parse(node.items, item, path, errors, child);
+        path.resize(pathLength);
+      } else {
+        Fail(JsonToValue(env_, item, child));
+      }
+
+      if (error_) {
+        return false;
+      }
+      if (!child.IsEmpty()) {
+        result.Set(length, child);
+      }
+      length++;
+    }
+
+    FinishArray(node, result, length, mark, path, errors);
+    out = result;
+    return errors.size() == mark;
+  }
+
+  void SchemaParser::ParseQuery(const char* query, size_t length, Napi::Value& out,
+                                std::vector<ValidationError>& errors) {
+    const SchemaProgram::Node& root = program_.Root();
+    if (root.types != 0 && (root.types & SchemaProgram::TYPE_OBJECT) == 0) {
+      errors.push_back({"$", "Schema must be an object schema for query input"});
+      return;
+    }
+
+    // Decode every parameter and group the values by key, in first-seen order
+    struct Param {
+      std::string key;
+      std::vector<std::string> values;
+    };
+    std::vector<Param> params;
+    std::unordered_map<std::string, size_t> positions;
+    UrlParser::forEachQueryParam(query, length, kQueryParameterLimit,
+                                 [&](const char* keyData, size_t keyLength, const char* valueData, size_t valueLength) {
+      std::string key;
+      UrlScan::AppendDecoded(keyData, keyLength, true, key);
+      if (key.size() > 2 && key.compare(key.size() - 2, 2, "[]") == 0) {
+        key.resize(key.size() - 2);
+      }
+      auto position = positions.emplace(key, params.size());
+      if (position.second) {
+        params.push_back({std::move(key), {}});
+      }
+      std::string value;
+      UrlScan::AppendDecoded(valueData, valueLength, true, value);
+      params[position.first->second].values.push_back(std::move(value));
+    });
+
+    Napi::Object result = Napi::Object::New(env_);
+    size_t mark = errors.size();
+    std::string path;
+
+    for (const Param& param : params) {
+      const SchemaProgram::Property* property = program_.FindProperty(root, param.key);
+      if (!property && (root.checks & SchemaProgram::CHECK_NO_ADDITIONAL)) {
+        continue;
+      }
+
+      path = "$." + param.key;
+      Napi::Value child;
+      if (property) {
+        ParseQueryValue(property->node, param.values, path, errors, child);
+      } else if (root.checks & SchemaProgram::CHECK_ADDITIONAL_SCHEMA) {
+        ParseQueryValue(root.additional, param.values, path, errors, child);
+      } else {
+        child = Napi::String::New(env_, param.values.back());
+      }
+      SetOwnProperty(env_, result, param.key, child.IsEmpty() ? env_.Undefined() : child);
+    }
+
+    path = "$";
+    FinishObject(root, result, mark, path, errors);
+    if (root.checks & SchemaProgram::kCombinatorChecks) {
+      program_.ValidateCombinators(root, result, path, errors);
+    }
+    out = result;
+  }
+
+  // Every value of a query parameter is a string; array properties take all of them
+  bool SchemaParser::ParseQueryValue(uint32_t index, const std::vector<std::string>& values, std::string& path,
+                                     std::vector<ValidationError>& errors, Napi::Value& out) {
+    const SchemaProgram::Node& node = program_.NodeAt(index);
+    Scalar scalar;
+    scalar.type = SchemaProgram::TYPE_STRING;
+
+    if ((node.types & SchemaProgram::TYPE_ARRAY) == 0) {
+      scalar.text = values.back();
+      return EmitScalar(index, scalar, path, errors, out);
+    }
+
+    Napi::Array result = Napi::Array::New(env_);
+    size_t mark = errors.size();
+    size_t pathLength = path.size();
+    uint32_t count = static_cast<uint32_t>(values.size());
+    for (uint32_t i = 0; i < count; i++) {
+      Napi::Value child;
+      if (node.checks & SchemaProgram::CHECK_ITEMS) {
+        scalar.text = values[i];
+        path += '[';
+        path += std::to_string(i);
+        path += ']';
+        EmitScalar(node.items, scalar, path, errors, child);
+        path.resize(pathLength);
+      } else {
+        child = Napi::String::New(env_, values[i]);
+      }
+      if (!child.IsEmpty()) {
+        result.Set(i, child);
+      }
+    }
+
+    FinishArray(node, result, count, mark, path, errors);
+    if (node.checks & SchemaProgram::kCombinatorChecks) {
+      program_.ValidateCombinators(node, result, path, errors);
+    }
+    out = result;
+    return errors.size() == mark;
+  }
+
+  // Validate a scalar for node `index`, coercing it first if its type is not accepted
+  bool SchemaParser::EmitScalar(uint32_t index, Scalar value, std::string& path,
+                                std::vector<ValidationError>& errors, Napi::Value& out) {
+    const SchemaProgram::Node& node = program_.NodeAt(index);
+
+    // null passes unless the value is marked required, as in the validators
+    if (value.type == SchemaProgram::TYPE_NULL) {
+      out = env_.Null();
+      if (node.checks & SchemaProgram::CHECK_REQUIRED_VALUE) {
+        errors.push_back({path, "Value is required"});
+        return false;
+      }
+      return true;
+    }
+
+    std::string storage;
+    uint8_t found = typeOf(value.type, value.number);
+    if (node.types != 0 && (node.types & found) == 0 && !Coerce(node.types, value, storage)) {
+      program_.TypeError(node, found, path, errors);
+      return false;
+    }
+
+    size_t mark = errors.size();
+    switch (value.type) {
+      case SchemaProgram::TYPE_NULL:
+        out = env_.Null();
+        return true;
+      case SchemaProgram::TYPE_BOOLEAN:
+        out = Napi::Boolean::New(env_, value.boolean);
+        break;
+      case SchemaProgram::TYPE_NUMBER:
+        if (node.checks & SchemaProgram::kNumberChecks) {
+          program_.CheckNumber(node, value.number, path, errors);
+        }
+        out = Napi::Number::New(env_, value.number);
+        break;
+      default:
+        if (node.checks & SchemaProgram::kStringChecks) {
+          program_.CheckString(node, value.text, path, errors);
+        }
+        out = Napi::String::New(env_, value.text.data(), value.text.size());
+        break;
+    }
+
+    if (node.checks & SchemaProgram::kCombinatorChecks) {
+      program_.ValidateCombinators(node, out, path, errors);
+    }
+    return errors.size() == mark;
+  }
+
+  // Convert a scalar to a type in `types`, trying numbers, booleans, strings and null in that order
+  bool SchemaParser::Coerce(uint8_t types, Scalar& value, std::string& storage) {
+    bool toNumber = (types & (SchemaProgram::TYPE_NUMBER | SchemaProgram::TYPE_INTEGER)) != 0;
+    bool integerOnly = (types & SchemaProgram::TYPE_NUMBER) == 0;
+
+    switch (value.type) {
+      case SchemaProgram::TYPE_STRING: {
+        double number = 0;
+        if (toNumber && parseNumber(value.text, number) && (!integerOnly || isIntegral(number))) {
+          value.type = SchemaProgram::TYPE_NUMBER;
+          value.number = number;
+          return true;
+        }
+        if ((types & SchemaProgram::TYPE_BOOLEAN) && (value.text == "true" || value.text == "false")) {
+          value.type = SchemaProgram::TYPE_BOOLEAN;
+          value.boolean = value.text == "true";
+          return true;
+        }
+        if ((types & SchemaProgram::TYPE_NULL) && value.text.empty()) {
+          value.type = SchemaProgram::TYPE_NULL;
+          return true;
+        }
+        return false;
+      }
+      case SchemaProgram::TYPE_NUMBER:
+        if ((types & SchemaProgram::TYPE_BOOLEAN) && (value.number == 0 || value.number == 1)) {
+          value.type = SchemaProgram::TYPE_BOOLEAN;
+          value.boolean = value.number == 1;
+          return true;
+        }
+        if (types & SchemaProgram::TYPE_STRING) {
+          // Number-to-string follows JS formatting exactly
+          storage = Napi::Number::New(env_, value.number).ToString().Utf8Value();
+          value.type = SchemaProgram::TYPE_STRING;
+          value.text = storage;
+          return true;
+        }
+        if ((types & SchemaProgram::TYPE_NULL) && value.number == 0) {
+          value.type = SchemaProgram::TYPE_NULL;
+          return true;
+        }
+        return false;
+      case SchemaProgram::TYPE_BOOLEAN:
+        if (toNumber) {
+          value.type = SchemaProgram::TYPE_NUMBER;
+          value.number = value.boolean ? 1 : 0;
+          return true;
+        }
+        if (types & SchemaProgram::TYPE_STRING) {
+          value.type = SchemaProgram::TYPE_STRING;
+          value.text = value.boolean ? "true" : "false";
+          return true;
+        }
+        if ((types & SchemaProgram::TYPE_NULL) && !value.boolean) {
+          value.type = SchemaProgram::TYPE_NULL;
+          return true;
+        }
+        return false;
+      default:
+        return false;
+    }
+  }
+
+  // Fill in defaults for missing declared properties, then check `required` against the result
+  void SchemaParser::FinishObject(const SchemaProgram::Node& node, Napi::Object& object, size_t mark,
+                                  const std::string& path, std::vector<ValidationError>& errors) {
+    for (uint32_t i = node.properties.begin; i < node.properties.end; i++) {
+      const SchemaProgram::Property& property = program_.properties_[i];
+      uint32_t defaultValue = program_.nodes_[property.node].defaultValue;
+      if (defaultValue != SchemaProgram::kNone && !object.HasOwnProperty(property.name)) {
+        SetOwnProperty(env_, object, property.name, DefaultValue(program_.defaults_[defaultValue]));
+      }
+    }
+
+    // Reported ahead of the property errors, as for JS objects
+    std::vector<ValidationError> missing;
+    for (uint32_t i = node.required.begin; i < node.required.end; i++) {
+      const std::string& name = program_.required_[i];
+      if (!object.HasOwnProperty(name)) {
+        missing.push_back({path + "." + name, "Required property missing"});
+      }
+    }
+    errors.insert(errors.begin() + mark, missing.begin(), missing.end());
+  }
+
+  void SchemaParser::FinishArray(const SchemaProgram::Node& node, const Napi::Array& array, size_t length,
+                                 size_t mark, const std::string& path, std::vector<ValidationError>& errors) {
+    // The length is only known at the end; its errors still come first
+    std::vector<ValidationError> lengthErrors;
+    program_.CheckArrayLength(node, length, path, lengthErrors);
+    errors.insert(errors.begin() + mark, lengthErrors.begin(), lengthErrors.end());
+
+    if (node.checks & SchemaProgram::CHECK_UNIQUE_ITEMS) {
+      program_.CheckUniqueItems(array, path, errors);
+    }
+  }
+
+  // A fresh JS value for a `default`, so no two results share an object
+  Napi::Value SchemaParser::DefaultValue(const SchemaProgram::Default& value) {
+    switch (value.kind) {
+      case SchemaProgram::Default::Kind::BOOLEAN:
+        return Napi::Boolean::New(env_, value.boolean);
+      case SchemaProgram::Default::Kind::NUMBER:
+        return Napi::Number::New(env_, value.number);
+      case SchemaProgram::Default::Kind::STRING:
+        return Napi::String::New(env_, value.text);
+      case SchemaProgram::Default::Kind::JSON: {
+        if (!defaultParser_) {
+          defaultParser_ = std::make_unique<simdjson::ondemand::parser>();
+        }
+        simdjson::padded_string json(value.text);
+        simdjson::ondemand::document document;
+        Napi::Value result;
+        if (defaultParser_->iterate(json).get(document) == simdjson::SUCCESS &&
+            JsonToValue(env_, document, result) == simdjson::SUCCESS) {
+          return result;
+        }
+        return env_.Null();
+      }
+      default:
+        return env_.Null();
+    }
+  }
+
+} // namespace SchemaValidator
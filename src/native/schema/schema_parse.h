@@ -0,0 +1,87 @@
+#ifndef SCHEMA_PARSE_H
+#define SCHEMA_PARSE_H
+
+#include <napi.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "json/simdjson_wrapper.h"
+#include "schema_program.h"
+
+namespace SchemaValidator {
+
+  struct ValidationError;
+
+  /**
+   * Builds the JS value for a request body or query string in one pass,
+   * driven by a SchemaProgram
+   *
+   * Each input value is validated as it is read. Values of the wrong type
+   * are coerced where the schema allows it: strings to numbers, integers,
+   * booleans or null, and numbers and booleans to strings and each other.
+   * Declared properties that are missing get their `default`, and
+   * properties rejected by `additionalProperties: false` are dropped rather
+   * than reported. The result is only meaningful when no errors were added.
+   *
+   * Combinator subschemas (anyOf/allOf/oneOf/not) are checked against the
+   * value after it was coerced for its own node; they do not coerce again.
+   */
+  class SchemaParser {
+  public:
+    SchemaParser(Napi::Env env, const SchemaProgram& program) : env_(env), program_(program) {}
+
+    // Parse a JSON document. Anything but SUCCESS means the text is not valid JSON.
+    simdjson::error_code ParseJson(simdjson::ondemand::document& document, Napi::Value& out,
+                                   std::vector<ValidationError>& errors);
+
+    // Parse a query string ("a=1&b=x", leading '?' allowed) for an object schema.
+    // Repeated keys (or "key[]") collect into arrays for array properties; otherwise the last value wins.
+    void ParseQuery(const char* query, size_t length, Napi::Value& out, std::vector<ValidationError>& errors);
+
+  private:
+    // A scalar read from the input: TYPE_NULL, TYPE_BOOLEAN, TYPE_NUMBER or TYPE_STRING
+    struct Scalar {
+      uint8_t type = SchemaProgram::TYPE_NULL;
+      bool boolean = false;
+      double number = 0;
+      std::string_view text;
+    };
+
+    template <typename V>
+    bool Parse(uint32_t index, V& value, std::string& path, std::vector<ValidationError>& errors,
+               Napi::Value& out);
+    bool ParseObject(const SchemaProgram::Node& node, simdjson::ondemand::object object, std::string& path,
+                     std::vector<ValidationError>& errors, Napi::Value& out);
+    bool ParseArray(const SchemaProgram::Node& node, simdjson::ondemand::array array, std::string& path,
+                    std::vector<ValidationError>& errors, Napi::Value& out);
+    bool ParseQueryValue(uint32_t index, const std::vector<std::string>& values, std::string& path,
+                         std::vector<ValidationError>& errors, Napi::Value& out);
+    bool EmitScalar(uint32_t index, Scalar value, std::string& path, std::vector<ValidationError>& errors,
+                    Napi::Value& out);
+    bool Coerce(uint8_t types, Scalar& value, std::string& storage);
+    void FinishObject(const SchemaProgram::Node& node, Napi::Object& object, size_t mark,
+                      const std::string& path, std::vector<ValidationError>& errors);
+    void FinishArray(const SchemaProgram::Node& node, const Napi::Array& array, size_t length, size_t mark,
+                     const std::string& path, std::vector<ValidationError>& errors);
+    Napi::Value DefaultValue(const SchemaProgram::Default& value);
+
+    // Record a simdjson error; true if there was one
+    bool Fail(simdjson::error_code error) {
+      if (error && !error_) {
+        error_ = error;
+      }
+      return error != simdjson::SUCCESS;
+    }
+
+    Napi::Env env_;
+    const SchemaProgram& program_;
+    simdjson::error_code error_ = simdjson::SUCCESS;
+    std::unique_ptr<simdjson::ondemand::parser> defaultParser_;  // For object and array defaults
+  };
+
+} // namespace SchemaValidator
+
+#endif // SCHEMA_PARSE_H
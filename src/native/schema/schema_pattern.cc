@@ -0,0 +1,764 @@
+#include "schema_pattern.h"
+#include <algorithm>
+
+namespace SchemaValidator {
+
+  namespace {
+
+    constexpr uint32_t kMaxCodePoint = 0x10FFFF;
+    constexpr uint32_t kInfinite = UINT32_MAX;
+    constexpr size_t kMaxInstructions = 10000;
+    constexpr size_t kMaxRepeat = 1000;
+    constexpr int kMaxDepth = 128;
+    constexpr size_t kMaxTransitions = 1 << 18;
+
+    using CodeRanges = std::vector<std::pair<uint32_t, uint32_t>>;
+
+    // Decode one UTF-8 sequence at `pos`; malformed bytes decode as U+FFFD
+    inline uint32_t DecodeUtf8(std::string_view text, size_t& pos) {
+      unsigned char c = static_cast<unsigned char>(text[pos++]);
+      if (c < 0x80) {
+        return c;
+      }
+      int extra = c >= 0xf0 ? 3 : c >= 0xe0 ? 2 : c >= 0xc0 ? 1 : -1;
+      if (extra < 0 || pos + extra > text.size()) {
+        return 0xFFFD;
+      }
+      uint32_t cp = c & (0x3f >> extra);
+      for (int i = 0; i < extra; i++) {
+        unsigned char next = static_cast<unsigned char>(text[pos]);
+        if ((next & 0xc0) != 0x80) {
+          return 0xFFFD;
+        }
+        cp = (cp << 6) | (next & 0x3f);
+        pos++;
+      }
+      return cp > kMaxCodePoint ? 0xFFFD : cp;
+    }
+
+    inline int HexValue(char c) {
+      if (c >= '0' && c <= '9') return c - '0';
+      if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+      if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+      return -1;
+    }
+
+    void Normalize(CodeRanges& ranges) {
+      std::sort(ranges.begin(), ranges.end());
+      size_t out = 0;
+      for (size_t i = 0; i < ranges.size(); i++) {
+        if (out > 0 && ranges[i].first <= ranges[out - 1].second + 1) {
+          ranges[out - 1].second = std::max(ranges[out - 1].second, ranges[i].second);
+        } else {
+          ranges[out++] = ranges[i];
+        }
+      }
+      ranges.resize(out);
+    }
+
+    CodeRanges Complement(CodeRanges ranges) {
+      Normalize(ranges);
+      CodeRanges result;
+      uint32_t next = 0;
+      for (const auto& range : ranges) {
+        if (range.first > next) {
+          result.push_back({next, range.first - 1});
+        }
+        next = range.second + 1;
+      }
+      if (next <= kMaxCodePoint) {
+        result.push_back({next, kMaxCodePoint});
+      }
+      return result;
+    }
+
+    void AddClassEscape(char kind, CodeRanges& out) {
+      CodeRanges ranges;
+      switch (kind | 0x20) {
+        case 'd':
+          ranges = {{'0', '9'}};
+          break;
+        case 'w':
+          ranges = {{'0', '9'}, {'A', 'Z'}, {'_', '_'}, {'a', 'z'}};
+          break;
+        case 's':
+          ranges = {{0x09, 0x0D}, {0x20, 0x20}, {0xA0, 0xA0}, {0x1680, 0x1680}, {0x2000, 0x200A},
+                    {0x2028, 0x2029}, {0x202F, 0x202F}, {0x205F, 0x205F}, {0x3000, 0x3000}, {0xFEFF, 0xFEFF}};
+          break;
+      }
+      if (kind >= 'A' && kind <= 'Z') {
+        ranges = Complement(std::move(ranges));
+      }
+      out.insert(out.end(), ranges.begin(), ranges.end());
+    }
+
+  } // namespace
+
+  /**
+   * Recursive-descent parser for the ECMAScript pattern grammar, emitting
+   * Thompson NFA instructions directly into the matcher. Counted repetition
+   * is expanded by re-parsing the repeated atom, so the parser only ever
+   * holds the source position of an atom, never a syntax tree.
+   */
+  class PatternCompiler {
+  public:
+    PatternCompiler(std::string_view source, PatternMatcher& matcher)
+        : source_(source), matcher_(matcher) {}
+
+    PatternMatcher::Status Compile() {
+      if (!ParseAlternation(0) || status_ != PatternMatcher::Status::OK) {
+        return Fail(PatternMatcher::Status::INVALID);
+      }
+      if (pos_ != source_.size()) {
+        // Only an unbalanced ')' stops the top-level alternation early
+        return Fail(PatternMatcher::Status::INVALID);
+      }
+      Emit(PatternMatcher::OP_MATCH);
+      return matcher_.program_.size() > kMaxInstructions ? Fail(PatternMatcher::Status::UNSUPPORTED) : status_;
+    }
+
+  private:
+    using Status = PatternMatcher::Status;
+
+    bool AtEnd() const { return pos_ >= source_.size(); }
+    char Peek(size_t ahead = 0) const { return pos_ + ahead < source_.size() ? source_[pos_ + ahead] : '\0'; }
+
+    Status Fail(Status status) {
+      if (status_ == Status::OK || status == Status::UNSUPPORTED) {
+        status_ = status;
+      }
+      return status_;
+    }
+
+    bool Error(Status status) {
+      Fail(status);
+      return false;
+    }
+
+    uint32_t Emit(PatternMatcher::Op op, uint32_t x = 0, uint32_t y = 0) {
+      matcher_.program_.push_back({op, x, y});
+      return static_cast<uint32_t>(matcher_.program_.size() - 1);
+    }
+
+    uint32_t Here() const { return static_cast<uint32_t>(matcher_.program_.size()); }
+
+    bool TooLarge() {
+      return matcher_.program_.size() > kMaxInstructions && Error(Status::UNSUPPORTED);
+    }
+
+    void EmitSet(CodeRanges ranges) {
+      Normalize(ranges);
+      std::vector<PatternMatcher::CodeRange> set;
+      set.reserve(ranges.size());
+      for (const auto& range : ranges) {
+        set.push_back({range.first, range.second});
+      }
+      matcher_.sets_.push_back(std::move(set));
+      Emit(PatternMatcher::OP_CHAR, static_cast<uint32_t>(matcher_.sets_.size() - 1));
+    }
+
+    // alternation := concatenation ( '|' concatenation )*
+    bool ParseAlternation(int depth) {
+      if (depth > kMaxDepth) {
+        return Error(Status::UNSUPPORTED);
+      }
+      std::vector<uint32_t> exits;
+      uint32_t split = Emit(PatternMatcher::OP_SPLIT);
+      matcher_.program_[split].x = Here();
+      if (!ParseConcatenation(depth)) {
+        return false;
+      }
+      while (Peek() == '|' && !AtEnd()) {
+        pos_++;
+        exits.push_back(Emit(PatternMatcher::OP_JMP));
+        // Chain another split so every branch hangs off the one before it
+        matcher_.program_[split].y = Here();
+        split = Emit(PatternMatcher::OP_SPLIT);
+        matcher_.program_[split].x = Here();
+        if (!ParseConcatenation(depth) || TooLarge()) {
+          return false;
+        }
+      }
+      // The last split has no alternative left; make it a plain jump into its branch
+      matcher_.program_[split].op = PatternMatcher::OP_JMP;
+      for (uint32_t exit : exits) {
+        matcher_.program_[exit].x = Here();
+      }
+      return true;
+    }
+
+    bool ParseConcatenation(int depth) {
+      while (!AtEnd() && Peek() != '|' && Peek() != ')') {
+        if (!ParseQuantified(depth) || TooLarge()) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    // Read {n}, {n,} or {n,m}; returns false (consuming nothing) if the brace is a literal
+    bool ReadBraces(uint32_t& min, uint32_t& max) {
+      size_t start = pos_;
+      auto readNumber = [&](uint32_t& value) {
+        size_t digits = 0;
+        uint64_t number = 0;
+        while (Peek() >= '0' && Peek() <= '9') {
+          number = std::min<uint64_t>(number * 10 + (Peek() - '0'), kInfinite - 1);
+          pos_++;
+          digits++;
+        }
+        value = static_cast<uint32_t>(number);
+        return digits > 0;
+      };
+      pos_++;
+      if (!readNumber(min)) {
+        pos_ = start;
+        return false;
+      }
+      max = min;
+      if (Peek() == ',') {
+        pos_++;
+        max = kInfinite;
+        if (Peek() != '}' && !readNumber(max)) {
+          pos_ = start;
+          return false;
+        }
+      }
+      if (Peek() != '}') {
+        pos_ = start;
+        return false;
+      }
+      pos_++;
+      return true;
+    }
+
+    // quantified := atom ( ( '*' | '+' | '?' | '{' n [ ',' [ m ] ] '}' ) '?'? )?
+    bool ParseQuantified(int depth) {
+      size_t atomStart = pos_;
+      uint32_t codeStart = Here();
+      bool assertion = false;
+      if (!ParseAtom(depth, assertion)) {
+        return false;
+      }
+      size_t atomEnd = pos_;
+
+      uint32_t min = 1;
+      uint32_t max = 1;
+      char c = Peek();
+      if (c == '*') {
+        min = 0, max = kInfinite, pos_++;
+      } else if (c == '+') {
+        min = 1, max = kInfinite, pos_++;
+      } else if (c == '?') {
+        min = 0, max = 1, pos_++;
+      } else if (c != '{' || !ReadBraces(min, max)) {
+        return true;
+      }
+      if (Peek() == '?') {
+        pos_++;  // Laziness does not change whether a pattern matches
+      }
+      if (assertion || min > max) {
+        return Error(Status::INVALID);
+      }
+      if ((max != kInfinite && max > kMaxRepeat) || min > kMaxRepeat) {
+        return Error(Status::UNSUPPORTED);
+      }
+
+      // The atom was emitted once already; drop it and emit the repetition from source
+      size_t resume = pos_;
+      matcher_.program_.resize(codeStart);
+      auto emitAtom = [&]() {
+        pos_ = atomStart;
+        bool ignored = false;
+        bool ok = ParseAtom(depth, ignored) && !TooLarge();
+        pos_ = atomEnd;
+        return ok;
+      };
+
+      for (uint32_t i = 0; i < min; i++) {
+        if (!emitAtom()) {
+          return false;
+        }
+      }
+      if (max == kInfinite) {
+        uint32_t loop = Emit(PatternMatcher::OP_SPLIT);
+        matcher_.program_[loop].x = Here();
+        if (!emitAtom()) {
+          return false;
+        }
+        Emit(PatternMatcher::OP_JMP, loop);
+        matcher_.program_[loop].y = Here();
+      } else {
+        std::vector<uint32_t> skips;
+        for (uint32_t i = min; i < max; i++) {
+          uint32_t skip = Emit(PatternMatcher::OP_SPLIT);
+          matcher_.program_[skip].x = Here();
+          skips.push_back(skip);
+          if (!emitAtom()) {
+            return false;
+          }
+        }
+        for (uint32_t skip : skips) {
+          matcher_.program_[skip].y = Here();
+        }
+      }
+      pos_ = resume;
+      return true;
+    }
+
+    bool ParseAtom(int depth, bool& assertion) {
+      char c = Peek();
+      switch (c) {
+        case '(':
+          return ParseGroup(depth);
+        case '[':
+          return ParseClass();
+        case '.':
+          pos_++;
+          EmitSet(Complement({{0x0A, 0x0A}, {0x0D, 0x0D}, {0x2028, 0x2029}}));
+          return true;
+        case '^':
+          pos_++;
+          assertion = true;
+          Emit(PatternMatcher::OP_BEGIN, Here() + 1);
+          return true;
+        case '$':
+          pos_++;
+          assertion = true;
+          Emit(PatternMatcher::OP_END, Here() + 1);
+          return true;
+        case '\\': {
+          CodeRanges ranges;
+          uint32_t single = 0;
+          if (!ParseEscape(false, ranges, single)) {
+            return false;
+          }
+          EmitSet(std::move(ranges));
+          return true;
+        }
+        case '*':
+        case '+':
+        case '?':
+          return Error(Status::INVALID);  // Nothing to repeat
+        case '{': {
+          uint32_t min = 0;
+          uint32_t max = 0;
+          size_t start = pos_;
+          if (ReadBraces(min, max)) {
+            pos_ = start;
+            return Error(Status::INVALID);
+          }
+          break;
+        }
+        default:
+          break;
+      }
+      uint32_t cp = DecodeUtf8(source_, pos_);
+      EmitSet({{cp, cp}});
+      return true;
+    }
+
+    bool ParseGroup(int depth) {
+      pos_++;
+      if (Peek() == '?') {
+        if (Peek(1) == ':') {
+          pos_ += 2;
+        } else if (Peek(1) == '<' && Peek(2) != '=' && Peek(2) != '!') {
+          // Named group: the name does not matter without backreferences
+          size_t close = source_.find('>', pos_ + 2);
+          if (close == std::string_view::npos || close == pos_ + 2) {
+            return Error(Status::INVALID);
+          }
+          pos_ = close + 1;
+        } else {
+          return Error(Status::UNSUPPORTED);  // Lookahead or lookbehind
+        }
+      }
+      if (!ParseAlternation(depth + 1)) {
+        return false;
+      }
+      if (Peek() != ')' || AtEnd()) {
+        return Error(Status::INVALID);
+      }
+      pos_++;
+      return true;
+    }
+
+    // Escape after a backslash. Character escapes set `single` and a one-element range;
+    // class escapes (\d, \w, \s and their negations) leave `single` as kInfinite.
+    bool ParseEscape(bool inClass, CodeRanges& ranges, uint32_t& single) {
+      pos_++;
+      if (AtEnd()) {
+        return Error(Status::INVALID);
+      }
+      single = kInfinite;
+      char c = Peek();
+      switch (c) {
+        case 'd': case 'D': case 'w': case 'W': case 's': case 'S':
+          pos_++;
+          AddClassEscape(c, ranges);
+          return true;
+        case 'b':
+          if (!inClass) {
+            return Error(Status::UNSUPPORTED);  // Word boundary
+          }
+          pos_++;
+          single = 0x08;
+          break;
+        case 'B':
+        case 'k':
+        case 'p':
+        case 'P':
+          return Error(Status::UNSUPPORTED);
+        case 't': pos_++; single = 0x09; break;
+        case 'n': pos_++; single = 0x0A; break;
+        case 'v': pos_++; single = 0x0B; break;
+        case 'f': pos_++; single = 0x0C; break;
+        case 'r': pos_++; single = 0x0D; break;
+        case '0':
+          if (Peek(1) >= '0' && Peek(1) <= '9') {
+            return Error(Status::UNSUPPORTED);  // Legacy octal
+          }
+          pos_++;
+          single = 0;
+          break;
+        case 'c': {
+          char letter = Peek(1);
+          if (!((letter >= 'a' && letter <= 'z') || (letter >= 'A' && letter <= 'Z'))) {
+            return Error(Status::UNSUPPORTED);
+          }
+          pos_ += 2;
+          single = static_cast<uint32_t>(letter) % 32;
+          break;
+        }
+        case 'x': {
+          int hi = HexValue(Peek(1));
+          int lo = HexValue(Peek(2));
+          pos_++;
+          if (hi >= 0 && lo >= 0) {
+            pos_ += 2;
+            single = static_cast<uint32_t>(hi * 16 + lo);
+          } else {
+            single = 'x';
+          }
+          break;
+        }
+        case 'u':
+          pos_++;
+          single = ReadUnicodeEscape();
+          break;
+        default:
+          if (c >= '1' && c <= '9') {
+            return Error(Status::UNSUPPORTED);  // Backreference
+          }
+          single = DecodeUtf8(source_, pos_);
+          break;
+      }
+      ranges.push_back({single, single});
+      return true;
+    }
+
+    // After "\u": \uXXXX (joining surrogate pairs), \u{X...}, or a literal 'u'
+    uint32_t ReadUnicodeEscape() {
+      auto readHex4 = [&](size_t at, uint32_t& value) {
+        value = 0;
+        for (size_t i = 0; i < 4; i++) {
+          int digit = pos_ + at + i < source_.size() ? HexValue(source_[pos_ + at + i]) : -1;
+          if (digit < 0) {
+            return false;
+          }
+          value = value * 16 + static_cast<uint32_t>(digit);
+        }
+        return true;
+      };
+
+      if (Peek() == '{') {
+        size_t close = source_.find('}', pos_);
+        uint32_t value = 0;
+        bool ok = close != std::string_view::npos && close > pos_ + 1;
+        for (size_t i = pos_ + 1; ok && i < close; i++) {
+          int digit = HexValue(source_[i]);
+          ok = digit >= 0 && (value = value * 16 + static_cast<uint32_t>(digit)) <= kMaxCodePoint;
+        }
+        if (ok) {
+          pos_ = close + 1;
+          return value;
+        }
+        return 'u';
+      }
+
+      uint32_t unit = 0;
+      if (!readHex4(0, unit)) {
+        return 'u';
+      }
+      pos_ += 4;
+      uint32_t low = 0;
+      if (unit >= 0xD800 && unit <= 0xDBFF && Peek() == '\\' && Peek(1) == 'u' && readHex4(2, low) &&
+          low >= 0xDC00 && low <= 0xDFFF) {
+        pos_ += 6;
+        return 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00);
+      }
+      return unit;
+    }
+
+    bool ParseClassAtom(CodeRanges& ranges, uint32_t& single) {
+      if (Peek() == '\\') {
+        if (Peek(1) == '-') {
+          pos_ += 2;
+          single = '-';
+          ranges.push_back({single, single});
+          return true;
+        }
+        return ParseEscape(true, ranges, single);
+      }
+      single = DecodeUtf8(source_, pos_);
+      ranges.push_back({single, single});
+      return true;
+    }
+
+    bool ParseClass() {
+      pos_++;
+      bool negate = false;
+      if (Peek() == '^') {
+        negate = true;
+        pos_++;
+      }
+      CodeRanges ranges;
+      while (true) {
+        if (AtEnd()) {
+          return Error(Status::INVALID);
+        }
+        if (Peek() == ']') {
+          pos_++;
+          break;
+        }
+        CodeRanges first;
+        uint32_t lo = 0;
+        if (!ParseClassAtom(first, lo)) {
+          return false;
+        }
+        if (Peek() == '-' && Peek(1) != ']' && pos_ + 1 < source_.size()) {
+          pos_++;
+          CodeRanges second;
+          uint32_t hi = 0;
+          if (!ParseClassAtom(second, hi)) {
+            return false;
+          }
+          if (lo != kInfinite && hi != kInfinite) {
+            if (lo > hi) {
+              return Error(Status::INVALID);
+            }
+            ranges.push_back({lo, hi});
+            continue;
+          }
+          // A class escape on either side makes the dash literal
+          first.push_back({'-', '-'});
+          first.insert(first.end(), second.begin(), second.end());
+        }
+        ranges.insert(ranges.end(), first.begin(), first.end());
+      }
+      EmitSet(negate ? Complement(std::move(ranges)) : std::move(ranges));
+      return true;
+    }
+
+    std::string_view source_;
+    PatternMatcher& matcher_;
+    size_t pos_ = 0;
+    Status status_ = Status::OK;
+  };
+
+  PatternMatcher::Status PatternMatcher::Compile(std::string_view source) {
+    *this = PatternMatcher();
+    Status status = PatternCompiler(source, *this).Compile();
+    if (status != Status::OK) {
+      program_.clear();
+      sets_.clear();
+      return status;
+    }
+
+    // Equivalence classes: code points between two consecutive set boundaries behave alike
+    boundaries_.push_back(0);
+    for (const auto& set : sets_) {
+      for (const CodeRange& range : set) {
+        boundaries_.push_back(range.lo);
+        if (range.hi < kMaxCodePoint) {
+          boundaries_.push_back(range.hi + 1);
+        }
+      }
+    }
+    std::sort(boundaries_.begin(), boundaries_.end());
+    boundaries_.erase(std::unique(boundaries_.begin(), boundaries_.end()), boundaries_.end());
+    for (uint32_t cp = 0; cp < 128; cp++) {
+      asciiClass_[cp] = static_cast<uint32_t>(
+        std::upper_bound(boundaries_.begin(), boundaries_.end(), cp) - boundaries_.begin() - 1);
+    }
+
+    marks_.assign(program_.size(), 0);
+    NextStamp();
+    AddClosure(0, false, startKernel_);
+    std::sort(startKernel_.begin(), startKernel_.end());
+    return Status::OK;
+  }
+
+  uint32_t PatternMatcher::ClassOf(uint32_t cp) const {
+    if (cp < 128) {
+      return asciiClass_[cp];
+    }
+    return static_cast<uint32_t>(std::upper_bound(boundaries_.begin(), boundaries_.end(), cp) - boundaries_.begin() - 1);
+  }
+
+  bool PatternMatcher::SetContains(uint32_t set, uint32_t cp) const {
+    const std::vector<CodeRange>& ranges = sets_[set];
+    auto it = std::upper_bound(ranges.begin(), ranges.end(), cp,
+      [](uint32_t value, const CodeRange& range) { return value < range.lo; });
+    return it != ranges.begin() && cp <= (it - 1)->hi;
+  }
+
+  void PatternMatcher::NextStamp() const {
+    if (++stamp_ == 0) {
+      std::fill(marks_.begin(), marks_.end(), 0);
+      stamp_ = 1;
+    }
+  }
+
+  // Follow epsilon edges from `pc`, appending the positions that consume input or end the match.
+  // Positions already marked with the current stamp are skipped.
+  void PatternMatcher::AddClosure(uint32_t pc, bool atStart, std::vector<uint32_t>& kernel) const {
+    stack_.clear();
+    stack_.push_back(pc);
+    while (!stack_.empty()) {
+      pc = stack_.back();
+      stack_.pop_back();
+      if (marks_[pc] == stamp_) {
+        continue;
+      }
+      marks_[pc] = stamp_;
+      const Inst& inst = program_[pc];
+      switch (inst.op) {
+        case OP_JMP:
+          stack_.push_back(inst.x);
+          break;
+        case OP_SPLIT:
+          stack_.push_back(inst.y);
+          stack_.push_back(inst.x);
+          break;
+        case OP_BEGIN:
+          if (atStart) {
+            stack_.push_back(inst.x);
+          }
+          break;
+        case OP_CHAR:
+        case OP_END:
+        case OP_MATCH:
+          kernel.push_back(pc);
+          break;
+      }
+    }
+  }
+
+  uint32_t PatternMatcher::Intern(const std::vector<uint32_t>& kernel, bool& flushed) const {
+    std::string key(reinterpret_cast<const char*>(kernel.data()), kernel.size() * sizeof(uint32_t));
+    auto it = stateIndex_.find(key);
+    if (it != stateIndex_.end()) {
+      return it->second;
+    }
+
+    size_t classes = boundaries_.size();
+    if ((states_.size() + 1) * classes > kMaxTransitions) {
+      // Pathological patterns can need exponentially many states; start the cache over
+      states_.clear();
+      transitions_.clear();
+      stateIndex_.clear();
+      initial_ = -1;
+      flushed = true;
+    }
+
+    bool accept = false;
+    for (uint32_t pc : kernel) {
+      accept = accept || program_[pc].op == OP_MATCH;
+    }
+    uint32_t id = static_cast<uint32_t>(states_.size());
+    states_.push_back({kernel, accept});
+    transitions_.resize(transitions_.size() + classes, -1);
+    stateIndex_.emplace(std::move(key), id);
+    return id;
+  }
+
+  uint32_t PatternMatcher::InitialState() const {
+    if (initial_ < 0) {
+      scratch_.clear();
+      NextStamp();
+      AddClosure(0, true, scratch_);
+      std::sort(scratch_.begin(), scratch_.end());
+      bool flushed = false;
+      initial_ = static_cast<int32_t>(Intern(scratch_, flushed));
+    }
+    return static_cast<uint32_t>(initial_);
+  }
+
+  uint32_t PatternMatcher::Step(uint32_t state, uint32_t cls) const {
+    uint32_t rep = boundaries_[cls];
+    scratch_.clear();
+    NextStamp();
+    for (uint32_t pc : states_[state].kernel) {
+      const Inst& inst = program_[pc];
+      if (inst.op == OP_CHAR && SetContains(inst.x, rep)) {
+        AddClosure(pc + 1, false, scratch_);
+      }
+    }
+    // A match may also start at the next position
+    for (uint32_t pc : startKernel_) {
+      if (marks_[pc] != stamp_) {
+        marks_[pc] = stamp_;
+        scratch_.push_back(pc);
+      }
+    }
+    std::sort(scratch_.begin(), scratch_.end());
+
+    bool flushed = false;
+    uint32_t next = Intern(scratch_, flushed);
+    if (!flushed) {
+      transitions_[static_cast<size_t>(state) * boundaries_.size() + cls] = static_cast<int32_t>(next);
+    }
+    return next;
+  }
+
+  bool PatternMatcher::AcceptsAtEnd(uint32_t state, bool atStart) const {
+    scratch_.clear();
+    NextStamp();
+    for (uint32_t pc : states_[state].kernel) {
+      if (program_[pc].op == OP_END) {
+        AddClosure(program_[pc].x, atStart, scratch_);
+      }
+    }
+    for (size_t i = 0; i < scratch_.size(); i++) {
+      uint32_t pc = scratch_[i];
+      if (program_[pc].op == OP_MATCH) {
+        return true;
+      }
+      if (program_[pc].op == OP_END) {
+        // "$$": another end assertion is satisfied at the same position
+        AddClosure(program_[pc].x, atStart, scratch_);
+      }
+    }
+    return false;
+  }
+
+  bool PatternMatcher::Search(std::string_view text) const {
+    if (program_.empty()) {
+      return false;
+    }
+    std::lock_guard<std::mutex> lock(*dfaMutex_);
+    uint32_t state = InitialState();
+    size_t classes = boundaries_.size();
+    size_t pos = 0;
+    while (!states_[state].accept && pos < text.size()) {
+      uint32_t cp = DecodeUtf8(text, pos);
+      uint32_t cls = ClassOf(cp);
+      int32_t next = transitions_[static_cast<size_t>(state) * classes + cls];
+      state = next >= 0 ? static_cast<uint32_t>(next) : Step(state, cls);
+    }
+    return states_[state].accept || AcceptsAtEnd(state, text.empty());
+  }
+
+} // namespace SchemaValidator
@@ -0,0 +1,96 @@
+#ifndef SCHEMA_PATTERN_H
+#define SCHEMA_PATTERN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace SchemaValidator {
+
+  /**
+   * Linear-time matcher for JSON schema `pattern` keywords
+   *
+   * The ECMAScript pattern is parsed once into a Thompson NFA over code
+   * points. Matching runs a DFA whose states (sets of NFA positions) are
+   * built lazily on first use and memoized in a transition table, so a
+   * repeated validation costs one table lookup per input character. Code
+   * points are mapped to equivalence classes first, which keeps the table
+   * as narrow as the character sets in the pattern allow.
+   *
+   * Patterns are unanchored, as JSON schema defines them. Backreferences,
+   * lookaround and word boundaries have no DFA equivalent and are reported as
+   * UNSUPPORTED so the caller can fall back to a backtracking engine. Unicode
+   * property escapes (\p{L}, \P{...}) are UNSUPPORTED too, but std::regex cannot
+   * handle them either: schemas using them fail natively with an "Unsupported
+   * regex pattern" error and need the JavaScript validator.
+   *
+   * The DFA cache is mutated by Search under a per-matcher lock, since
+   * compiled schemas are shared by every thread that loads the addon.
+   */
+  class PatternMatcher {
+  public:
+    enum class Status { OK, UNSUPPORTED, INVALID };
+
+    Status Compile(std::string_view source);
+
+    // True if the pattern matches anywhere in the UTF-8 text
+    bool Search(std::string_view text) const;
+
+    size_t StateCount() const { return states_.size(); }
+
+  private:
+    enum Op : uint8_t { OP_CHAR, OP_SPLIT, OP_JMP, OP_BEGIN, OP_END, OP_MATCH };
+
+    struct Inst {
+      Op op;
+      uint32_t x;  // OP_CHAR: set index; OP_SPLIT/OP_JMP/OP_BEGIN/OP_END: next instruction
+      uint32_t y;  // OP_SPLIT: alternative instruction
+    };
+
+    struct CodeRange {
+      uint32_t lo;
+      uint32_t hi;
+    };
+
+    struct DfaState {
+      std::vector<uint32_t> kernel;  // Sorted OP_CHAR, OP_END and OP_MATCH positions
+      bool accept;
+    };
+
+    friend class PatternCompiler;
+
+    uint32_t ClassOf(uint32_t cp) const;
+    bool SetContains(uint32_t set, uint32_t cp) const;
+    void AddClosure(uint32_t pc, bool atStart, std::vector<uint32_t>& kernel) const;
+    void NextStamp() const;
+    uint32_t Intern(const std::vector<uint32_t>& kernel, bool& flushed) const;
+    uint32_t InitialState() const;
+    uint32_t Step(uint32_t state, uint32_t cls) const;
+    bool AcceptsAtEnd(uint32_t state, bool atStart) const;
+
+    std::vector<Inst> program_;
+    std::vector<std::vector<CodeRange>> sets_;   // Sorted, non-overlapping ranges
+    std::vector<uint32_t> boundaries_;           // First code point of each class
+    uint32_t asciiClass_[128] = {};
+    std::vector<uint32_t> startKernel_;          // Closure of the start away from position 0
+
+    // Lazily built DFA; flushed when it outgrows kMaxTransitions
+    mutable std::vector<DfaState> states_;
+    mutable std::vector<int32_t> transitions_;   // states_ x classes, -1 until computed
+    mutable std::unordered_map<std::string, uint32_t> stateIndex_;
+    mutable int32_t initial_ = -1;
+    mutable std::vector<uint32_t> marks_;
+    mutable std::vector<uint32_t> stack_;
+    mutable std::vector<uint32_t> scratch_;
+    mutable uint32_t stamp_ = 0;
+    std::unique_ptr<std::mutex> dfaMutex_ = std::make_unique<std::mutex>();  // Guards the mutable state above
+  };
+
+} // namespace SchemaValidator
+
+#endif // SCHEMA_PATTERN_H
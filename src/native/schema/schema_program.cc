@@ -0,0 +1,745 @@
+#include "schema_program.h"
+#include "schema_validator.h"
+#include "json/json_escape.h"
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+
+namespace SchemaValidator {
+
+  namespace {
+
+    struct TypeName {
+      const char* name;
+      uint8_t bit;
+    };
+
+    const TypeName kTypeNames[] = {
+      {"string", SchemaProgram::TYPE_STRING},
+      {"number", SchemaProgram::TYPE_NUMBER},
+      {"integer", SchemaProgram::TYPE_INTEGER},
+      {"boolean", SchemaProgram::TYPE_BOOLEAN},
+      {"object", SchemaProgram::TYPE_OBJECT},
+      {"array", SchemaProgram::TYPE_ARRAY},
+      {"null", SchemaProgram::TYPE_NULL}
+    };
+
+    uint8_t typeBit(const std::string& name) {
+      for (const TypeName& type : kTypeNames) {
+        if (name == type.name) {
+          return type.bit;
+        }
+      }
+      return 0;
+    }
+
+    inline bool isIntegral(double value) {
+      return std::isfinite(value) && std::floor(value) == value;
+    }
+
+    // Length in code points, as JSON Schema counts it
+    inline size_t codePointLength(std::string_view value) {
+      size_t length = 0;
+      for (char c : value) {
+        length += (static_cast<unsigned char>(c) & 0xc0) != 0x80;
+      }
+      return length;
+    }
+
+    bool readUint32(const Napi::Object& schema, const char* key, uint32_t& out) {
+      if (!schema.HasOwnProperty(key)) {
+        return false;
+      }
+      Napi::Value value = schema.Get(key);
+      if (!value.IsNumber()) {
+        return false;
+      }
+      double number = value.As<Napi::Number>().DoubleValue();
+      out = number <= 0 ? 0 : number >= 4294967295.0 ? 4294967295u : static_cast<uint32_t>(number);
+      return true;
+    }
+
+    // True if the pattern uses \p{...} or \P{...}. Neither the DFA nor std::regex has the
+    // Unicode property tables, and std::regex would misread them as literals or reject them.
+    bool hasPropertyEscape(const std::string& source) {
+      for (size_t i = 0; i + 1 < source.size(); i++) {
+        if (source[i] == '\\') {
+          if (source[i + 1] == 'p' || source[i + 1] == 'P') {
+            return true;
+          }
+          i++;
+        }
+      }
+      return false;
+    }
+
+    constexpr int kMaxDefaultDepth = 64;
+
+    // JSON text for a `default` value, with JSON.stringify's handling of undefined and non-finite numbers
+    void appendDefaultJson(const Napi::Value& value, std::string& out, int depth) {
+      switch (value.Type()) {
+        case napi_boolean:
+          out += value.As<Napi::Boolean>().Value() ? "true" : "false";
+          return;
+        case napi_number: {
+          double number = value.As<Napi::Number>().DoubleValue();
+          if (std::isfinite(number)) {
+            JsonEscape::AppendShortestDouble(number, out);
+          } else {
+            out += "null";
+          }
+          return;
+        }
+        case napi_string: {
+          std::string text = value.As<Napi::String>().Utf8Value();
+          JsonEscape::AppendEscapedString(text.data(), text.size(), out);
+          return;
+        }
+        case napi_object:
+          if (depth < kMaxDefaultDepth && value.IsArray()) {
+            Napi::Array array = value.As<Napi::Array>();
+            out += '[';
+            for (uint32_t i = 0; i < array.Length(); i++) {
+              if (i > 0) {
+                out += ',';
+              }
+              appendDefaultJson(array.Get(i), out, depth + 1);
+            }
+            out += ']';
+            return;
+          }
+          if (depth < kMaxDefaultDepth) {
+            Napi::Object object = value.As<Napi::Object>();
+            Napi::Array names = object.GetPropertyNames();
+            bool first = true;
+            out += '{';
+            for (uint32_t i = 0; i < names.Length(); i++) {
+              Napi::Value key = names.Get(i);
+              Napi::Value item = object.Get(key);
+              if (item.IsUndefined() || item.Type() == napi_function) {
+                continue;
+              }
+              std::string name = key.ToString().Utf8Value();
+              out += first ? "" : ",";
+              JsonEscape::AppendEscapedString(name.data(), name.size(), out);
+              out += ':';
+              appendDefaultJson(item, out, depth + 1);
+              first = false;
+            }
+            out += '}';
+            return;
+          }
+          out += "null";
+          return;
+        default:
+          out += "null";
+          return;
+      }
+    }
+
+  } // namespace
+
+  std::shared_ptr<SchemaProgram> SchemaProgram::Compile(const Napi::Object& schema) {
+    auto program = std::make_shared<SchemaProgram>();
+    program->CompileNode(schema);
+    if (!program->unknownType_.empty()) {
+      Napi::Error::New(schema.Env(), "Unknown schema type: " + program->unknownType_).ThrowAsJavaScriptException();
+      return nullptr;
+    }
+    return program;
+  }
+
+  // Compile one schema object. The node's slot is claimed first so subschemas land after it;
+  // side-table ranges are appended only once all subschemas are compiled, so they stay contiguous.
+  uint32_t SchemaProgram::CompileNode(const Napi::Object& schema) {
+    uint32_t index = static_cast<uint32_t>(nodes_.size());
+    nodes_.emplace_back();
+    Node node;
+
+    if (schema.HasOwnProperty("type")) {
+      // A type name outside the seven JSON Schema types would otherwise leave the mask empty,
+      // which accepts every value
+      auto addType = [&](const std::string& name) {
+        uint8_t bit = typeBit(name);
+        if (bit == 0 && unknownType_.empty()) {
+          unknownType_ = name;
+        }
+        node.types |= bit;
+      };
+      Napi::Value type = schema.Get("type");
+      if (type.IsString()) {
+        addType(type.As<Napi::String>().Utf8Value());
+      } else if (type.IsArray()) {
+        Napi::Array names = type.As<Napi::Array>();
+        for (uint32_t i = 0; i < names.Length(); i++) {
+          Napi::Value name = names.Get(i);
+          if (name.IsString()) {
+            addType(name.As<Napi::String>().Utf8Value());
+          }
+        }
+      }
+    }
+
+    if (schema.HasOwnProperty("required") && schema.Get("required").IsBoolean() &&
+        schema.Get("required").As<Napi::Boolean>().Value()) {
+      node.checks |= CHECK_REQUIRED_VALUE;
+    }
+
+    if (readUint32(schema, "minLength", node.minLength)) node.checks |= CHECK_MIN_LENGTH;
+    if (readUint32(schema, "maxLength", node.maxLength)) node.checks |= CHECK_MAX_LENGTH;
+    if (readUint32(schema, "minItems", node.minItems)) node.checks |= CHECK_MIN_ITEMS;
+    if (readUint32(schema, "maxItems", node.maxItems)) node.checks |= CHECK_MAX_ITEMS;
+
+    if (schema.HasOwnProperty("minimum") && schema.Get("minimum").IsNumber()) {
+      node.minimum = schema.Get("minimum").As<Napi::Number>().DoubleValue();
+      node.checks |= CHECK_MINIMUM;
+    }
+    if (schema.HasOwnProperty("maximum") && schema.Get("maximum").IsNumber()) {
+      node.maximum = schema.Get("maximum").As<Napi::Number>().DoubleValue();
+      node.checks |= CHECK_MAXIMUM;
+    }
+    // exclusiveMinimum/Maximum: a flag on minimum/maximum (draft 4) or a bound of its own (draft 6+)
+    if (schema.HasOwnProperty("exclusiveMinimum")) {
+      Napi::Value exclusive = schema.Get("exclusiveMinimum");
+      if (exclusive.IsBoolean() && exclusive.As<Napi::Boolean>().Value()) {
+        node.checks |= CHECK_EXCLUSIVE_MINIMUM;
+      } else if (exclusive.IsNumber()) {
+        double bound = exclusive.As<Napi::Number>().DoubleValue();
+        if (!(node.checks & CHECK_MINIMUM) || bound >= node.minimum) {
+          node.minimum = bound;
+          node.checks |= CHECK_MINIMUM | CHECK_EXCLUSIVE_MINIMUM;
+        }
+      }
+    }
+    if (schema.HasOwnProperty("exclusiveMaximum")) {
+      Napi::Value exclusive = schema.Get("exclusiveMaximum");
+      if (exclusive.IsBoolean() && exclusive.As<Napi::Boolean>().Value()) {
+        node.checks |= CHECK_EXCLUSIVE_MAXIMUM;
+      } else if (exclusive.IsNumber()) {
+        double bound = exclusive.As<Napi::Number>().DoubleValue();
+        if (!(node.checks & CHECK_MAXIMUM) || bound <= node.maximum) {
+          node.maximum = bound;
+          node.checks |= CHECK_MAXIMUM | CHECK_EXCLUSIVE_MAXIMUM;
+        }
+      }
+    }
+
+    if (schema.HasOwnProperty("pattern") && schema.Get("pattern").IsString()) {
+      Pattern pattern;
+      pattern.source = schema.Get("pattern").As<Napi::String>().Utf8Value();
+      PatternMatcher::Status status = pattern.matcher.Compile(pattern.source);
+      pattern.valid = status == PatternMatcher::Status::OK;
+      if (status == PatternMatcher::Status::UNSUPPORTED && hasPropertyEscape(pattern.source)) {
+        pattern.propertyEscape = true;
+      } else if (status == PatternMatcher::Status::UNSUPPORTED) {
+        try {
+          pattern.regex = std::regex(pattern.source, std::regex::ECMAScript);
+          pattern.valid = true;
+          pattern.backtracking = true;
+        } catch (const std::regex_error&) {
+          pattern.valid = false;
+        }
+      }
+      node.pattern = static_cast<uint32_t>(patterns_.size());
+      patterns_.push_back(std::move(pattern));
+      node.checks |= CHECK_PATTERN;
+    }
+
+    if (schema.HasOwnProperty("format") && schema.Get("format").IsString()) {
+      std::string format = schema.Get("format").As<Napi::String>().Utf8Value();
+      if (format == "email") {
+        node.format = Format::EMAIL;
+        node.checks |= CHECK_FORMAT;
+      }
+    }
+
+    if (schema.HasOwnProperty("default")) {
+      Napi::Value value = schema.Get("default");
+      Default compiled;
+      switch (value.Type()) {
+        case napi_boolean:
+          compiled.kind = Default::Kind::BOOLEAN;
+          compiled.boolean = value.As<Napi::Boolean>().Value();
+          break;
+        case napi_number:
+          compiled.kind = Default::Kind::NUMBER;
+          compiled.number = value.As<Napi::Number>().DoubleValue();
+          break;
+        case napi_string:
+          compiled.kind = Default::Kind::STRING;
+          compiled.text = value.As<Napi::String>().Utf8Value();
+          break;
+        case napi_object:
+          compiled.kind = Default::Kind::JSON;
+          appendDefaultJson(value, compiled.text, 0);
+          break;
+        default:
+          break;
+      }
+      if (!value.IsUndefined()) {
+        node.defaultValue = static_cast<uint32_t>(defaults_.size());
+        defaults_.push_back(std::move(compiled));
+      }
+    }
+
+    if (schema.HasOwnProperty("uniqueItems") && schema.Get("uniqueItems").IsBoolean() &&
+        schema.Get("uniqueItems").As<Napi::Boolean>().Value()) {
+      node.checks |= CHECK_UNIQUE_ITEMS;
+    }
+
+    if (schema.HasOwnProperty("items") && schema.Get("items").IsObject() && !schema.Get("items").IsArray()) {
+      node.items = CompileNode(schema.Get("items").As<Napi::Object>());
+      node.checks |= CHECK_ITEMS;
+    }
+
+    if (schema.HasOwnProperty("additionalProperties")) {
+      Napi::Value additional = schema.Get("additionalProperties");
+      if (additional.IsBoolean() && !additional.As<Napi::Boolean>().Value()) {
+        node.checks |= CHECK_NO_ADDITIONAL;
+      } else if (additional.IsObject() && !additional.IsArray()) {
+        node.additional = CompileNode(additional.As<Napi::Object>());
+        node.checks |= CHECK_ADDITIONAL_SCHEMA;
+      }
+    }
+
+    if (schema.HasOwnProperty("properties") && schema.Get("properties").IsObject()) {
+      Napi::Object props = schema.Get("properties").As<Napi::Object>();
+      Napi::Array names = props.GetPropertyNames();
+      std::vector<Property> compiled;
+      compiled.reserve(names.Length());
+      for (uint32_t i = 0; i < names.Length(); i++) {
+        Napi::Value key = names.Get(i);
+        Napi::Value propSchema = props.Get(key);
+        if (propSchema.IsObject() && !propSchema.IsArray()) {
+          compiled.push_back({key.ToString().Utf8Value(), 0});
+          compiled.back().node = CompileNode(propSchema.As<Napi::Object>());
+        }
+      }
+      std::sort(compiled.begin(), compiled.end(),
+        [](const Property& a, const Property& b) { return a.name < b.name; });
+      node.properties.begin = static_cast<uint32_t>(properties_.size());
+      for (Property& property : compiled) {
+        properties_.push_back(std::move(property));
+      }
+      node.properties.end = static_cast<uint32_t>(properties_.size());
+      if (!node.properties.empty()) {
+        node.checks |= CHECK_PROPERTIES;
+      }
+    }
+
+    if (schema.HasOwnProperty("required") && schema.Get("required").IsArray()) {
+      Napi::Array required = schema.Get("required").As<Napi::Array>();
+      node.required.begin = static_cast<uint32_t>(required_.size());
+      for (uint32_t i = 0; i < required.Length(); i++) {
+        if (required.Get(i).IsString()) {
+          required_.push_back(required.Get(i).As<Napi::String>().Utf8Value());
+        }
+      }
+      node.required.end = static_cast<uint32_t>(required_.size());
+      if (!node.required.empty()) {
+        node.checks |= CHECK_REQUIRED;
+      }
+    }
+
+    if (schema.HasOwnProperty("anyOf")) {
+      node.anyOf = CompileList(schema.Get("anyOf"));
+      if (!node.anyOf.empty()) node.checks |= CHECK_ANY_OF;
+    }
+    if (schema.HasOwnProperty("allOf")) {
+      node.allOf = CompileList(schema.Get("allOf"));
+      if (!node.allOf.empty()) node.checks |= CHECK_ALL_OF;
+    }
+    if (schema.HasOwnProperty("oneOf")) {
+      node.oneOf = CompileList(schema.Get("oneOf"));
+      if (!node.oneOf.empty()) node.checks |= CHECK_ONE_OF;
+    }
+    if (schema.HasOwnProperty("not") && schema.Get("not").IsObject() && !schema.Get("not").IsArray()) {
+      node.not_ = CompileNode(schema.Get("not").As<Napi::Object>());
+      node.checks |= CHECK_NOT;
+    }
+
+    nodes_[index] = node;
+    return index;
+  }
+
+  SchemaProgram::Range SchemaProgram::CompileList(const Napi::Value& list) {
+    std::vector<uint32_t> compiled;
+    if (list.IsArray()) {
+      Napi::Array schemas = list.As<Napi::Array>();
+      for (uint32_t i = 0; i < schemas.Length(); i++) {
+        Napi::Value schema = schemas.Get(i);
+        if (schema.IsObject() && !schema.IsArray()) {
+          compiled.push_back(CompileNode(schema.As<Napi::Object>()));
+        }
+      }
+    }
+    Range range;
+    range.begin = static_cast<uint32_t>(children_.size());
+    children_.insert(children_.end(), compiled.begin(), compiled.end());
+    range.end = static_cast<uint32_t>(children_.size());
+    return range;
+  }
+
+  const SchemaProgram::Property* SchemaProgram::FindProperty(const Node& node, std::string_view name) const {
+    auto begin = properties_.begin() + node.properties.begin;
+    auto end = properties_.begin() + node.properties.end;
+    auto it = std::lower_bound(begin, end, name,
+      [](const Property& property, std::string_view key) { return std::string_view(property.name) < key; });
+    return it != end && it->name == name ? &*it : nullptr;
+  }
+
+  void SchemaProgram::TypeError(const Node& node, uint8_t found, const std::string& path,
+                                std::vector<ValidationError>& errors) const {
+    if (found == TYPE_NUMBER && (node.types & TYPE_INTEGER)) {
+      errors.push_back({path, "Expected integer"});
+      return;
+    }
+
+    std::string message = "Invalid type, expected ";
+    bool first = true;
+    for (const TypeName& type : kTypeNames) {
+      if (node.types & type.bit) {
+        message += first ? "" : " or ";
+        message += type.name;
+        first = false;
+      }
+    }
+    errors.push_back({path, std::move(message)});
+  }
+
+  bool SchemaProgram::CheckString(const Node& node, std::string_view value, const std::string& path,
+                                  std::vector<ValidationError>& errors) const {
+    size_t mark = errors.size();
+
+    if (node.checks & (CHECK_MIN_LENGTH | CHECK_MAX_LENGTH)) {
+      size_t length = codePointLength(value);
+      if ((node.checks & CHECK_MIN_LENGTH) && length < node.minLength) {
+        errors.push_back({path, "String too short, minimum length: " + std::to_string(node.minLength)});
+      }
+      if ((node.checks & CHECK_MAX_LENGTH) && length > node.maxLength) {
+        errors.push_back({path, "String too long, maximum length: " + std::to_string(node.maxLength)});
+      }
+    }
+
+    if (node.checks & CHECK_PATTERN) {
+      const Pattern& pattern = patterns_[node.pattern];
+      if (pattern.propertyEscape) {
+        errors.push_back({path, "Unsupported regex pattern in schema (Unicode property escape): " + pattern.source});
+      } else if (!pattern.valid) {
+        errors.push_back({path, "Invalid regex pattern in schema: " + pattern.source});
+      } else if (pattern.backtracking ? !std::regex_search(value.begin(), value.end(), pattern.regex)
+                                      : !pattern.matcher.Search(value)) {
+        errors.push_back({path, "String does not match pattern: " + pattern.source});
+      }
+    }
+
+    if ((node.checks & CHECK_FORMAT) && node.format == Format::EMAIL &&
+        value.find('@') == std::string_view::npos) {
+      errors.push_back({path, "Invalid email format"});
+    }
+
+    return errors.size() == mark;
+  }
+
+  bool SchemaProgram::CheckNumber(const Node& node, double value, const std::string& path,
+                                  std::vector<ValidationError>& errors) const {
+    size_t mark = errors.size();
+
+    if (node.checks & CHECK_MINIMUM) {
+      if (node.checks & CHECK_EXCLUSIVE_MINIMUM) {
+        if (value <= node.minimum) {
+          errors.push_back({path, "Value must be greater than " + std::to_string(node.minimum)});
+        }
+      } else if (value < node.minimum) {
+        errors.push_back({path, "Value must be greater than or equal to " + std::to_string(node.minimum)});
+      }
+    }
+
+    if (node.checks & CHECK_MAXIMUM) {
+      if (node.checks & CHECK_EXCLUSIVE_MAXIMUM) {
+        if (value >= node.maximum) {
+          errors.push_back({path, "Value must be less than " + std::to_string(node.maximum)});
+        }
+      } else if (value > node.maximum) {
+        errors.push_back({path, "Value must be less than or equal to " + std::to_string(node.maximum)});
+      }
+    }
+
+    return errors.size() == mark;
+  }
+
+  bool SchemaProgram::CheckArrayLength(const Node& node, size_t length, const std::string& path,
+                                       std::vector<ValidationError>& errors) const {
+    size_t mark = errors.size();
+    if ((node.checks & CHECK_MIN_ITEMS) && length < node.minItems) {
+      errors.push_back({path, "Array too short, minimum items: " + std::to_string(node.minItems)});
+    }
+    if ((node.checks & CHECK_MAX_ITEMS) && length > node.maxItems) {
+      errors.push_back({path, "Array too long, maximum items: " + std::to_string(node.maxItems)});
+    }
+    return errors.size() == mark;
+  }
+
+  // Primitive items are compared by type and value; objects and arrays are not compared
+  bool SchemaProgram::CheckUniqueItems(const Napi::Array& array, const std::string& path,
+                                       std::vector<ValidationError>& errors) const {
+    std::unordered_set<std::string> seen;
+    uint32_t length = array.Length();
+    for (uint32_t i = 0; i < length; i++) {
+      Napi::Value item = array.Get(i);
+      std::string key;
+      if (item.IsString()) {
+        key = "s" + item.As<Napi::String>().Utf8Value();
+      } else if (item.IsNumber()) {
+        key = "n" + std::to_string(item.As<Napi::Number>().DoubleValue());
+      } else if (item.IsBoolean()) {
+        key = item.As<Napi::Boolean>().Value() ? "t" : "f";
+      } else if (item.IsNull()) {
+        key = "z";
+      } else {
+        continue;
+      }
+      if (!seen.insert(std::move(key)).second) {
+        errors.push_back({path, "Array items must be unique"});
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool SchemaProgram::Validate(const Napi::Value& value, std::vector<ValidationError>& errors) const {
+    std::string path = "$";
+    return ValidateNode(0, value, path, errors);
+  }
+
+  // `path` is extended in place while descending and restored on the way back up
+  bool SchemaProgram::ValidateNode(uint32_t index, const Napi::Value& value, std::string& path,
+                                   std::vector<ValidationError>& errors) const {
+    const Node& node = nodes_[index];
+    napi_valuetype valueType = value.Type();
+
+    // null and undefined pass unless the value is marked required
+    if (valueType == napi_undefined || valueType == napi_null) {
+      if (node.checks & CHECK_REQUIRED_VALUE) {
+        errors.push_back({path, "Value is required"});
+        return false;
+      }
+      return true;
+    }
+
+    uint8_t actual = 0;
+    double number = 0;
+    switch (valueType) {
+      case napi_boolean:
+        actual = TYPE_BOOLEAN;
+        break;
+      case napi_number:
+        number = value.As<Napi::Number>().DoubleValue();
+        actual = isIntegral(number) ? TYPE_NUMBER | TYPE_INTEGER : TYPE_NUMBER;
+        break;
+      case napi_string:
+        actual = TYPE_STRING;
+        break;
+      case napi_object:
+        actual = value.IsArray() ? TYPE_ARRAY : TYPE_OBJECT;
+        break;
+      default:
+        break;
+    }
+
+    if (node.types != 0 && (node.types & actual) == 0) {
+      TypeError(node, actual, path, errors);
+      return false;
+    }
+
+    size_t mark = errors.size();
+    switch (actual) {
+      case TYPE_STRING:
+        if (node.checks & kStringChecks) {
+          std::string text = value.As<Napi::String>().Utf8Value();
+          CheckString(node, text, path, errors);
+        }
+        break;
+      case TYPE_NUMBER:
+      case TYPE_NUMBER | TYPE_INTEGER:
+        if (node.checks & kNumberChecks) {
+          CheckNumber(node, number, path, errors);
+        }
+        break;
+      case TYPE_ARRAY:
+        ValidateArray(node, value.As<Napi::Array>(), path, errors);
+        break;
+      case TYPE_OBJECT:
+        ValidateObject(node, value.As<Napi::Object>(), path, errors);
+        break;
+      default:
+        break;
+    }
+
+    if (node.checks & kCombinatorChecks) {
+      ValidateCombinators(node, value, path, errors);
+    }
+
+    return errors.size() == mark;
+  }
+
+  bool SchemaProgram::ValidateObject(const Node& node, const Napi::Object& object, std::string& path,
+                                     std::vector<ValidationError>& errors) const {
+    size_t mark = errors.size();
+    size_t pathLength = path.size();
+
+    if (node.checks & CHECK_REQUIRED) {
+      for (uint32_t i = node.required.begin; i < node.required.end; i++) {
+        if (!object.HasOwnProperty(required_[i])) {
+          errors.push_back({path + "." + required_[i], "Required property missing"});
+        }
+      }
+    }
+
+    if (node.checks & (CHECK_NO_ADDITIONAL | CHECK_ADDITIONAL_SCHEMA)) {
+      // Every property has to be classified, so walk the object's keys
+      Napi::Array names = object.GetPropertyNames();
+      uint32_t count = names.Length();
+      for (uint32_t i = 0; i < count; i++) {
+        Napi::Value key = names.Get(i);
+        std::string name = key.ToString().Utf8Value();
+        path += '.';
+        path += name;
+        const Property* property = FindProperty(node, name);
+        if (property) {
+          ValidateNode(property->node, object.Get(key), path, errors);
+        } else if (node.checks & CHECK_NO_ADDITIONAL) {
+          errors.push_back({path, "Additional property not allowed"});
+        } else {
+          ValidateNode(node.additional, object.Get(key), path, errors);
+        }
+        path.resize(pathLength);
+      }
+    } else if (node.checks & CHECK_PROPERTIES) {
+      // Only declared properties matter: look each one up instead of listing the object
+      for (uint32_t i = node.properties.begin; i < node.properties.end; i++) {
+        const Property& property = properties_[i];
+        // Inherited members such as Object.prototype.constructor are not properties of the data
+        if (!object.HasOwnProperty(property.name)) {
+          continue;
+        }
+        Napi::Value propValue = object.Get(property.name);
+        if (propValue.IsUndefined()) {
+          continue;
+        }
+        path += '.';
+        path += property.name;
+        ValidateNode(property.node, propValue, path, errors);
+        path.resize(pathLength);
+      }
+    }
+
+    return errors.size() == mark;
+  }
+
+  bool SchemaProgram::ValidateArray(const Node& node, const Napi::Array& array, std::string& path,
+                                    std::vector<ValidationError>& errors) const {
+    size_t mark = errors.size();
+    uint32_t length = array.Length();
+    CheckArrayLength(node, length, path, errors);
+
+    if (node.checks & CHECK_UNIQUE_ITEMS) {
+      CheckUniqueItems(array, path, errors);
+    }
+
+    if (node.checks & CHECK_ITEMS) {
+      size_t pathLength = path.size();
+      for (uint32_t i = 0; i < length; i++) {
+        path += '[';
+        path += std::to_string(i);
+        path += ']';
+        ValidateNode(node.items, array.Get(i), path, errors);
+        path.resize(pathLength);
+      }
+    }
+
+    return errors.size() == mark;
+  }
+
+  bool SchemaProgram::ValidateCombinators(const Node& node, const Napi::Value& value, std::string& path,
+                                          std::vector<ValidationError>& errors) const {
+    size_t mark = errors.size();
+    std::vector<ValidationError> scratch;
+
+    if (node.checks & CHECK_ANY_OF) {
+      bool matched = false;
+      for (uint32_t i = node.anyOf.begin; i < node.anyOf.end && !matched; i++) {
+        scratch.clear();
+        matched = ValidateNode(children_[i], value, path, scratch);
+      }
+      if (!matched) {
+        errors.push_back({path, "Did not match any of the schemas"});
+      }
+    }
+
+    if (node.checks & CHECK_ALL_OF) {
+      for (uint32_t i = node.allOf.begin; i < node.allOf.end; i++) {
+        ValidateNode(children_[i], value, path, errors);
+      }
+    }
+
+    if (node.checks & CHECK_ONE_OF) {
+      int matches = 0;
+      for (uint32_t i = node.oneOf.begin; i < node.oneOf.end && matches < 2; i++) {
+        scratch.clear();
+        matches += ValidateNode(children_[i], value, path, scratch) ? 1 : 0;
+      }
+      if (matches != 1) {
+        errors.push_back({path, "Should match exactly one schema"});
+      }
+    }
+
+    if (node.checks & CHECK_NOT) {
+      scratch.clear();
+      if (ValidateNode(node.not_, value, path, scratch)) {
+        errors.push_back({path, "Should not match schema"});
+      }
+    }
+
+    return errors.size() == mark;
+  }
+
+  bool SchemaProgram::ValidateUpdate(const Napi::Object& data, const Napi::Object& updates,
+                                     std::vector<ValidationError>& errors) const {
+    const Node& root = Root();
+    if (root.types != 0 && (root.types & TYPE_OBJECT) == 0) {
+      errors.push_back({"$", "Schema must be an object schema for incremental validation"});
+      return false;
+    }
+
+    size_t mark = errors.size();
+    Napi::Array updateNames = updates.GetPropertyNames();
+    uint32_t count = updateNames.Length();
+    std::string path;
+
+    for (uint32_t i = 0; i < count; i++) {
+      Napi::Value key = updateNames.Get(i);
+      std::string name = key.ToString().Utf8Value();
+      path = "$." + name;
+      const Property* property = FindProperty(root, name);
+      if (property) {
+        ValidateNode(property->node, updates.Get(key), path, errors);
+      } else if (root.checks & CHECK_NO_ADDITIONAL) {
+        errors.push_back({path, "Additional property not allowed"});
+      } else if (root.checks & CHECK_ADDITIONAL_SCHEMA) {
+        ValidateNode(root.additional, updates.Get(key), path, errors);
+      }
+    }
+
+    // Required properties are checked against the merged object
+    for (uint32_t i = root.required.begin; i < root.required.end; i++) {
+      const std::string& name = required_[i];
+      if (!updates.HasOwnProperty(name) && !data.HasOwnProperty(name)) {
+        errors.push_back({"$." + name, "Required property missing after update"});
+      }
+    }
+
+    return errors.size() == mark;
+  }
+
+} // namespace SchemaValidator
@@ -0,0 +1,191 @@
+#ifndef SCHEMA_PROGRAM_H
+#define SCHEMA_PROGRAM_H
+
+#include <napi.h>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "schema_pattern.h"
+
+namespace SchemaValidator {
+
+  struct ValidationError;
+
+  /**
+   * A JSON schema compiled into a flat array of nodes
+   *
+   * Every keyword is resolved at compile time: `type` (a name or a list of
+   * names) becomes a bitmask, the keywords present on a node become bits in
+   * `checks`, and subschemas become indices into the node array. Validation
+   * dispatches on the value's type once per node and never compares schema
+   * strings; property names are only compared when an object has to be
+   * matched against its declared properties.
+   */
+  class SchemaProgram {
+  public:
+    // Type bits; a node with no bits accepts every type
+    enum TypeBit : uint8_t {
+      TYPE_NULL = 1 << 0,
+      TYPE_BOOLEAN = 1 << 1,
+      TYPE_OBJECT = 1 << 2,
+      TYPE_ARRAY = 1 << 3,
+      TYPE_NUMBER = 1 << 4,
+      TYPE_INTEGER = 1 << 5,
+      TYPE_STRING = 1 << 6
+    };
+
+    // Keywords present on a node
+    enum Check : uint32_t {
+      CHECK_REQUIRED_VALUE = 1u << 0,         // Legacy `required: true` on the value itself
+      CHECK_MIN_LENGTH = 1u << 1,
+      CHECK_MAX_LENGTH = 1u << 2,
+      CHECK_PATTERN = 1u << 3,
+      CHECK_FORMAT = 1u << 4,
+      CHECK_MINIMUM = 1u << 5,
+      CHECK_MAXIMUM = 1u << 6,
+      CHECK_EXCLUSIVE_MINIMUM = 1u << 7,
+      CHECK_EXCLUSIVE_MAXIMUM = 1u << 8,
+      CHECK_MIN_ITEMS = 1u << 9,
+      CHECK_MAX_ITEMS = 1u << 10,
+      CHECK_UNIQUE_ITEMS = 1u << 11,
+      CHECK_ITEMS = 1u << 12,
+      CHECK_PROPERTIES = 1u << 13,
+      CHECK_REQUIRED = 1u << 14,
+      CHECK_NO_ADDITIONAL = 1u << 15,         // additionalProperties: false
+      CHECK_ADDITIONAL_SCHEMA = 1u << 16,     // additionalProperties: {...}
+      CHECK_ANY_OF = 1u << 17,
+      CHECK_ALL_OF = 1u << 18,
+      CHECK_ONE_OF = 1u << 19,
+      CHECK_NOT = 1u << 20
+    };
+
+    static constexpr uint32_t kCombinatorChecks = CHECK_ANY_OF | CHECK_ALL_OF | CHECK_ONE_OF | CHECK_NOT;
+    static constexpr uint32_t kStringChecks = CHECK_MIN_LENGTH | CHECK_MAX_LENGTH | CHECK_PATTERN | CHECK_FORMAT;
+    static constexpr uint32_t kNumberChecks = CHECK_MINIMUM | CHECK_MAXIMUM;
+
+    enum class Format : uint8_t { NONE, EMAIL };
+
+    static constexpr uint32_t kNone = std::numeric_limits<uint32_t>::max();
+
+    // Index range into one of the program's side tables
+    struct Range {
+      uint32_t begin = 0;
+      uint32_t end = 0;
+      bool empty() const { return begin == end; }
+    };
+
+    struct Node {
+      uint8_t types = 0;
+      uint32_t checks = 0;
+      Format format = Format::NONE;
+      uint32_t minLength = 0;
+      uint32_t maxLength = 0;
+      uint32_t minItems = 0;
+      uint32_t maxItems = 0;
+      double minimum = 0;
+      double maximum = 0;
+      uint32_t pattern = kNone;      // Index into patterns_
+      uint32_t items = kNone;        // Node indices
+      uint32_t additional = kNone;
+      uint32_t not_ = kNone;
+      uint32_t defaultValue = kNone; // Index into defaults_
+      Range properties;              // Into properties_, sorted by name
+      Range required;                // Into required_
+      Range anyOf;                   // Into children_
+      Range allOf;
+      Range oneOf;
+    };
+
+    struct Property {
+      std::string name;
+      uint32_t node;
+    };
+
+    // `pattern` keyword: a linear-time matcher, or std::regex for the few
+    // ECMAScript features it cannot express (backreferences, lookaround, \b)
+    struct Pattern {
+      std::string source;
+      PatternMatcher matcher;
+      std::regex regex;
+      bool backtracking = false;
+      bool valid = false;
+      bool propertyEscape = false;  // \p{...}: not supported natively, see schema_pattern.h
+    };
+
+    // `default` keyword. Scalars are kept as values; objects and arrays as JSON
+    // text, so every use gets a fresh copy and the program stays free of JS handles.
+    struct Default {
+      enum class Kind : uint8_t { NULL_VALUE, BOOLEAN, NUMBER, STRING, JSON };
+      Kind kind = Kind::NULL_VALUE;
+      bool boolean = false;
+      double number = 0;
+      std::string text;  // STRING: the string; JSON: the serialized value
+    };
+
+    // Compile a schema object; subschemas that are not objects are ignored.
+    // Throws a JS error and returns nullptr for an unknown type name.
+    static std::shared_ptr<SchemaProgram> Compile(const Napi::Object& schema);
+
+    // Validate a JS value; errors get "$"-rooted paths
+    bool Validate(const Napi::Value& value, std::vector<ValidationError>& errors) const;
+
+    // Validate the properties in `updates` as if merged into `data` (root must be an object schema)
+    bool ValidateUpdate(const Napi::Object& data, const Napi::Object& updates,
+                        std::vector<ValidationError>& errors) const;
+
+    const Node& Root() const { return nodes_[0]; }
+    const Node& NodeAt(uint32_t index) const { return nodes_[index]; }
+
+    // Declared property of an object node, or nullptr
+    const Property* FindProperty(const Node& node, std::string_view name) const;
+
+    // Keyword checks shared by every value walker; each appends errors for `path`
+    bool CheckString(const Node& node, std::string_view value, const std::string& path,
+                     std::vector<ValidationError>& errors) const;
+    bool CheckNumber(const Node& node, double value, const std::string& path,
+                     std::vector<ValidationError>& errors) const;
+    bool CheckArrayLength(const Node& node, size_t length, const std::string& path,
+                          std::vector<ValidationError>& errors) const;
+
+    bool CheckUniqueItems(const Napi::Array& array, const std::string& path,
+                          std::vector<ValidationError>& errors) const;
+
+    // "Invalid type, expected ..." error for a node given the TYPE_* bits of the value found
+    // ("Expected integer" for a fractional number where an integer is expected)
+    void TypeError(const Node& node, uint8_t found, const std::string& path,
+                   std::vector<ValidationError>& errors) const;
+
+  private:
+    friend class JsonValidator;
+    friend class SchemaParser;
+
+    uint32_t CompileNode(const Napi::Object& schema);
+    Range CompileList(const Napi::Value& list);
+
+    bool ValidateNode(uint32_t index, const Napi::Value& value, std::string& path,
+                      std::vector<ValidationError>& errors) const;
+    bool ValidateObject(const Node& node, const Napi::Object& object, std::string& path,
+                        std::vector<ValidationError>& errors) const;
+    bool ValidateArray(const Node& node, const Napi::Array& array, std::string& path,
+                       std::vector<ValidationError>& errors) const;
+    bool ValidateCombinators(const Node& node, const Napi::Value& value, std::string& path,
+                             std::vector<ValidationError>& errors) const;
+
+    std::vector<Node> nodes_;
+    std::vector<Property> properties_;
+    std::vector<std::string> required_;
+    std::vector<uint32_t> children_;
+    std::vector<Pattern> patterns_;
+    std::vector<Default> defaults_;
+
+    // First type name CompileNode did not recognize
+    std::string unknownType_;
+  };
+
+} // namespace SchemaValidator
+
+#endif // SCHEMA_PROGRAM_H
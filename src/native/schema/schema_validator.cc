@@ -10,22 +10,28 @@
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
+#include <cstring>
 #include <list>
-#include <regex>
-#include <cmath>
 #include <iostream>
 #include <mutex>
 #include "schema_validator.h"
+#include "schema_program.h"
+#include "compiled_schema.h"
+#include "schema_json.h"
+#include "schema_parse.h"
 
 /**
  * Schema Validator implementation
- * Provides fast JSON schema validation with code generation for optimal performance
+ * Provides fast JSON schema validation with schemas compiled into flat node programs
  */
 namespace SchemaValidator {
 
   // Cache configuration
   constexpr size_t MAX_CACHE_SIZE = 100;
 
+  // validateJson()/parseJson() parsers larger than this are released after use
+  constexpr size_t MAX_RETAINED_PARSER_CAPACITY = 16 * 1024 * 1024;
+
   // Performance tracking
   uint64_t totalValidations = 0;
   uint64_t cacheHits = 0;
@@ -33,14 +39,10 @@ namespace SchemaValidator {
   uint64_t generationTime = 0;
   uint64_t validationTime = 0;
 
-  class Schema;
-  class CompiledValidator;
-  bool validateValue(const Napi::Value& value, const Schema& schema, const std::string& path, std::vector<ValidationError>& errors);
-  std::shared_ptr<Schema> ParseSchema(const Napi::Object& schemaObj, const std::string& path);
-
-  // LRU Cache for compiled schemas
+  // LRU Cache for compiled schemas, shared by every thread (and worker) that loads the addon
   class SchemaCache {
   private:
+    mutable std::mutex mutex;
     std::unordered_map<std::string, std::list<CacheEntry>::iterator> cacheMap;
     std::list<CacheEntry> cacheList;
     size_t maxSize;
@@ -54,6 +56,7 @@ namespace SchemaValidator {
     bool add(const std::string& key, const SchemaVersion& version, std::shared_ptr<CompiledValidator> validator) {
       auto now = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
           std::chrono::system_clock::now().time_since_epoch()).count());
+      std::lock_guard<std::mutex> lock(mutex);
 
       // Check if already in cache
       auto it = cacheMap.find(key);
@@ -75,7 +78,7 @@ namespace SchemaValidator {
         // Remove the least recently used item
         auto last = cacheList.end();
         --last;
-        cacheMap.erase(last->version.id + ":" + last->version.hash);
+        cacheMap.erase(last->version.hash);
         cacheList.pop_back();
         evictions++;
       }
@@ -93,6 +96,7 @@ namespace SchemaValidator {
     }
 
     std::shared_ptr<CompiledValidator> get(const std::string& key) {
+      std::lock_guard<std::mutex> lock(mutex);
       auto it = cacheMap.find(key);
       if (it == cacheMap.end()) {
         misses++;
@@ -115,18 +119,20 @@ namespace SchemaValidator {
     }
 
     void clear() {
+      std::lock_guard<std::mutex> lock(mutex);
       cacheMap.clear();
       cacheList.clear();
     }
 
     // Statistics
-    size_t size() const { return cacheList.size(); }
-    uint64_t getHits() const { return hits; }
-    uint64_t getMisses() const { return misses; }
-    uint64_t getEvictions() const { return evictions; }
+    size_t size() const { std::lock_guard<std::mutex> lock(mutex); return cacheList.size(); }
+    uint64_t getHits() const { std::lock_guard<std::mutex> lock(mutex); return hits; }
+    uint64_t getMisses() const { std::lock_guard<std::mutex> lock(mutex); return misses; }
+    uint64_t getEvictions() const { std::lock_guard<std::mutex> lock(mutex); return evictions; }
 
     // Get all entries for debugging
     std::vector<CacheEntry> getEntries() const {
+      std::lock_guard<std::mutex> lock(mutex);
       std::vector<CacheEntry> entries;
       entries.reserve(cacheList.size());
       for (const auto& entry : cacheList) {
@@ -139,505 +145,253 @@ namespace SchemaValidator {
   // Global cache instance
   SchemaCache schemaCache;
 
-  // Schema class with optimized memory layout
-  class Schema {
-  public:
-    std::string type;
-    bool required = false;
-    int minLength = -1;
-    int maxLength = -1;
-    double minimum = -std::numeric_limits<double>::infinity();
-    double maximum = std::numeric_limits<double>::infinity();
-    bool exclusiveMinimum = false;
-    bool exclusiveMaximum = false;
-    std::string pattern;
-    std::unordered_map<std::string, std::shared_ptr<Schema>> properties;
-    std::vector<std::string> requiredProperties;
-    std::shared_ptr<Schema> items;
-    std::vector<std::shared_ptr<Schema>> anyOf;
-    std::vector<std::shared_ptr<Schema>> allOf;
-    std::vector<std::shared_ptr<Schema>> oneOf;
-    std::shared_ptr<Schema> not_;
-    std::string format;
-    int minItems = -1;
-    int maxItems = -1;
-    bool uniqueItems = false;
-
-    // Schema path for error reporting
-    std::string path;
-
-    // New fields for incremental validation
-    bool additionalProperties = true;
-    std::shared_ptr<Schema> additionalPropertiesSchema;
-
-    // For schema version tracking
-    std::string id;
-    uint64_t version = 0;
-
-    // Validation method implementations
-    bool validateString(const std::string& value, const std::string& path, std::vector<ValidationError>& errors) const {
-      bool valid = true;
-
-      // Validate minLength
-      if (minLength >= 0 && static_cast<int>(value.length()) < minLength) {
-        errors.push_back({path, "String is too short (minimum length is " + std::to_string(minLength) + ")"});
-        valid = false;
-      }
-
-      // Validate maxLength
-      if (maxLength >= 0 && static_cast<int>(value.length()) > maxLength) {
-        errors.push_back({path, "String is too long (maximum length is " + std::to_string(maxLength) + ")"});
-        valid = false;
-      }
-
-      // Validate pattern (basic implementation for now)
-      if (!pattern.empty()) {
-        try {
-          std::regex patternRegex(pattern);
-          if (!std::regex_match(value, patternRegex)) {
-            errors.push_back({path, "String does not match pattern: " + pattern});
-            valid = false;
-          }
-        } catch (const std::regex_error&) {
-          errors.push_back({path, "Invalid regex pattern in schema: " + pattern});
-          valid = false;
-        }
-      }
-
-      return valid;
-    }
-
-    bool validateNumber(double value, const std::string& path, std::vector<ValidationError>& errors) const {
-      bool valid = true;
-
-      // Validate minimum
-      if (exclusiveMinimum && value <= minimum) {
-        errors.push_back({path, "Value must be greater than " + std::to_string(minimum)});
-        valid = false;
-      } else if (!exclusiveMinimum && value < minimum) {
-        errors.push_back({path, "Value must be greater than or equal to " + std::to_string(minimum)});
-        valid = false;
-      }
+  namespace {
 
-      // Validate maximum
-      if (exclusiveMaximum && value >= maximum) {
-        errors.push_back({path, "Value must be less than " + std::to_string(maximum)});
-        valid = false;
-      } else if (!exclusiveMaximum && value > maximum) {
-        errors.push_back({path, "Value must be less than or equal to " + std::to_string(maximum)});
-        valid = false;
-      }
+    // Tag marking schema objects that carry a SchemaMemo; guards napi_unwrap against
+    // objects wrapped by other addons
+    const napi_type_tag kSchemaMemoTag = {0x6e6578757265736aULL, 0x736368656d61686bULL};
 
-      // Validate integer type
-      if (type == "integer" && std::floor(value) != value) {
-        errors.push_back({path, "Value must be an integer"});
-        valid = false;
-      }
+    constexpr int kMaxHashDepth = 256;
 
-      return valid;
-    }
-
-    bool validateObject(const Napi::Object& obj, const std::string& path, std::vector<ValidationError>& errors) const {
-      bool valid = true;
+    // Hash memoized on a deeply frozen schema object, freed when the object is collected
+    struct SchemaMemo {
+      std::string hash;
+    };
 
-      // Check required properties
-      for (const auto& prop : requiredProperties) {
-        if (!obj.HasOwnProperty(prop.c_str())) {
-          errors.push_back({path, "Missing required property: " + prop});
-          valid = false;
+    // Two-lane 64-bit mixer producing a 128-bit digest
+    class SchemaHasher {
+    public:
+      void Word(uint64_t word) {
+        a_ = Mix(a_ ^ word) + 0x9e3779b97f4a7c15ULL;
+        b_ = Mix(b_ + word * 0x2545f4914f6cdd1dULL) ^ a_;
+      }
+
+      void Bytes(const std::string& bytes) {
+        Word(bytes.size());
+        size_t i = 0;
+        for (; i + 8 <= bytes.size(); i += 8) {
+          uint64_t word;
+          std::memcpy(&word, bytes.data() + i, 8);
+          Word(word);
+        }
+        if (i < bytes.size()) {
+          uint64_t word = 0;
+          std::memcpy(&word, bytes.data() + i, bytes.size() - i);
+          Word(word);
         }
       }
 
-      // Validate existing properties
-      Napi::Array propNames = obj.GetPropertyNames();
-      for (uint32_t i = 0; i < propNames.Length(); i++) {
-        std::string propName = propNames.Get(i).As<Napi::String>().Utf8Value();
-        Napi::Value propValue = obj.Get(propName);
-
-        // Check if property exists in schema
-        auto propIt = properties.find(propName);
-        if (propIt != properties.end()) {
-          // Validate against property schema
-          bool propValid = validateValue(propValue, *(propIt->second), path + "." + propName, errors);
-          if (!propValid) {
-            valid = false;
-          }
-        } else if (!additionalProperties && !additionalPropertiesSchema) {
-          // No additional properties allowed
-          errors.push_back({path, "Property not allowed: " + propName});
-          valid = false;
-        } else if (additionalPropertiesSchema) {
-          // Validate against additionalProperties schema
-          bool propValid = validateValue(propValue, *additionalPropertiesSchema, path + "." + propName, errors);
-          if (!propValid) {
-            valid = false;
-          }
-        }
+      std::string Hex() const {
+        std::stringstream ss;
+        ss << std::hex << std::setfill('0') << std::setw(16) << Mix(a_) << std::setw(16) << Mix(b_);
+        return ss.str();
       }
 
-      return valid;
-    }
+    private:
+      static uint64_t Mix(uint64_t x) {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ULL;
+        x ^= x >> 33;
+        return x;
+      }
 
-    bool validateArray(const Napi::Array& arr, const std::string& path, std::vector<ValidationError>& errors) const {
-      bool valid = true;
+      uint64_t a_ = 0x736368656d612d61ULL;
+      uint64_t b_ = 0x68617368696e672dULL;
+    };
 
-      // Validate minItems
-      if (minItems >= 0 && static_cast<int>(arr.Length()) < minItems) {
-        errors.push_back({path, "Array is too short (minimum items is " + std::to_string(minItems) + ")"});
-        valid = false;
-      }
+    // State of one hashing walk
+    struct SchemaHashWalk {
+      SchemaHasher hasher;
+      Napi::Function isFrozen;  // Object.isFrozen, only set while every object so far was frozen
+    };
 
-      // Validate maxItems
-      if (maxItems >= 0 && static_cast<int>(arr.Length()) > maxItems) {
-        errors.push_back({path, "Array is too long (maximum items is " + std::to_string(maxItems) + ")"});
-        valid = false;
+    // Canonical walk: object keys are visited in sorted order, so key order does not change the hash.
+    // False past kMaxHashDepth, where the hash would no longer cover the whole schema.
+    bool HashValue(SchemaHashWalk& walk, const Napi::Value& value, int depth) {
+      if (depth > kMaxHashDepth) {
+        return false;
       }
-
-      // Validate items
-      if (items) {
-        for (uint32_t i = 0; i < arr.Length(); i++) {
-          bool itemValid = validateValue(arr.Get(i), *items, path + "[" + std::to_string(i) + "]", errors);
-          if (!itemValid) {
-            valid = false;
+      SchemaHasher& hasher = walk.hasher;
+      switch (value.Type()) {
+        case napi_undefined:
+          hasher.Word('u');
+          break;
+        case napi_null:
+          hasher.Word('n');
+          break;
+        case napi_boolean:
+          hasher.Word(value.As<Napi::Boolean>().Value() ? 'T' : 'F');
+          break;
+        case napi_number: {
+          double number = value.As<Napi::Number>().DoubleValue();
+          if (number != number) {
+            hasher.Word('N');
+            break;
           }
+          number = number == 0 ? 0 : number;  // -0 and 0 are the same keyword value
+          uint64_t bits = 0;
+          std::memcpy(&bits, &number, sizeof(bits));
+          hasher.Word('d');
+          hasher.Word(bits);
+          break;
         }
-      }
-
-      // Validate uniqueItems
-      if (uniqueItems && arr.Length() > 1) {
-        // Basic uniqueness check (can be optimized)
-        std::unordered_set<std::string> seen;
-        for (uint32_t i = 0; i < arr.Length(); i++) {
-          Napi::Value item = arr.Get(i);
-          std::string itemStr;
-
-          // Convert to string representation for comparison (simplified)
-          if (item.IsString()) {
-            itemStr = item.As<Napi::String>().Utf8Value();
-          } else if (item.IsNumber()) {
-            itemStr = std::to_string(item.As<Napi::Number>().DoubleValue());
-          } else if (item.IsBoolean()) {
-            itemStr = item.As<Napi::Boolean>().Value() ? "true" : "false";
-          } else {
-            // Complex objects would need better serialization
-            continue;
+        case napi_string:
+          hasher.Word('s');
+          hasher.Bytes(value.As<Napi::String>().Utf8Value());
+          break;
+        case napi_object: {
+          if (!walk.isFrozen.IsEmpty() && !walk.isFrozen.Call({value}).ToBoolean().Value()) {
+            walk.isFrozen = Napi::Function();
           }
-
-          if (seen.find(itemStr) != seen.end()) {
-            errors.push_back({path, "Array items must be unique"});
-            valid = false;
+          if (value.IsArray()) {
+            Napi::Array array = value.As<Napi::Array>();
+            uint32_t length = array.Length();
+            hasher.Word('a');
+            hasher.Word(length);
+            for (uint32_t i = 0; i < length; i++) {
+              if (!HashValue(walk, array.Get(i), depth + 1)) {
+                return false;
+              }
+            }
             break;
           }
-          seen.insert(itemStr);
+          Napi::Object object = value.As<Napi::Object>();
+          Napi::Array names = object.GetPropertyNames();
+          uint32_t count = names.Length();
+          std::vector<std::string> keys;
+          keys.reserve(count);
+          for (uint32_t i = 0; i < count; i++) {
+            keys.push_back(names.Get(i).ToString().Utf8Value());
+          }
+          std::sort(keys.begin(), keys.end());
+          hasher.Word('o');
+          hasher.Word(count);
+          for (const std::string& key : keys) {
+            hasher.Bytes(key);
+            if (!HashValue(walk, object.Get(key), depth + 1)) {
+              return false;
+            }
+          }
+          break;
         }
+        default:
+          // Functions, symbols and bigints carry no keyword meaning
+          hasher.Word('x');
+          break;
       }
-
-      return valid;
-    }
-  };
-
-  // Compiled validator with generated validation code
-  class CompiledValidator {
-  public:
-    std::shared_ptr<Schema> schema;
-    ValidatorFunction validator;
-    SchemaVersion version;
-
-    CompiledValidator(std::shared_ptr<Schema> schema, ValidatorFunction validator, SchemaVersion version)
-        : schema(schema), validator(validator), version(version) {}
-
-    bool validate(const Napi::Value& value, std::vector<ValidationError>& errors, const std::string& path = "$") const {
-      if (!validator) {
-        // Fallback to generic validation if code generation failed
-        return validateValue(value, *schema, path, errors);
-      }
-      return validator(value, errors, path);
-    }
-  };
-
-  // Parse schema object from JavaScript
-  std::shared_ptr<Schema> ParseSchema(const Napi::Object& schemaObj, const std::string& path) {
-    auto schema = std::make_shared<Schema>();
-    schema->path = path;
-
-    // Check for schema ID for caching
-    if (schemaObj.HasOwnProperty("$id") && schemaObj.Get("$id").IsString()) {
-      schema->id = schemaObj.Get("$id").As<Napi::String>().Utf8Value();
-    }
-
-    // Parse basic properties
-    if (schemaObj.HasOwnProperty("type") && schemaObj.Get("type").IsString()) {
-      schema->type = schemaObj.Get("type").As<Napi::String>().Utf8Value();
-    }
-
-    if (schemaObj.HasOwnProperty("required") && schemaObj.Get("required").IsBoolean()) {
-      schema->required = schemaObj.Get("required").As<Napi::Boolean>().Value();
-    }
-
-    if (schemaObj.HasOwnProperty("minLength") && schemaObj.Get("minLength").IsNumber()) {
-      schema->minLength = schemaObj.Get("minLength").As<Napi::Number>().Int32Value();
-    }
-
-    if (schemaObj.HasOwnProperty("maxLength") && schemaObj.Get("maxLength").IsNumber()) {
-      schema->maxLength = schemaObj.Get("maxLength").As<Napi::Number>().Int32Value();
-    }
-
-    if (schemaObj.HasOwnProperty("minimum") && schemaObj.Get("minimum").IsNumber()) {
-      schema->minimum = schemaObj.Get("minimum").As<Napi::Number>().DoubleValue();
-    }
-
-    if (schemaObj.HasOwnProperty("maximum") && schemaObj.Get("maximum").IsNumber()) {
-      schema->maximum = schemaObj.Get("maximum").As<Napi::Number>().DoubleValue();
-    }
-
-    if (schemaObj.HasOwnProperty("exclusiveMinimum") && schemaObj.Get("exclusiveMinimum").IsBoolean()) {
-      schema->exclusiveMinimum = schemaObj.Get("exclusiveMinimum").As<Napi::Boolean>().Value();
-    }
-
-    if (schemaObj.HasOwnProperty("exclusiveMaximum") && schemaObj.Get("exclusiveMaximum").IsBoolean()) {
-      schema->exclusiveMaximum = schemaObj.Get("exclusiveMaximum").As<Napi::Boolean>().Value();
-    }
-
-    if (schemaObj.HasOwnProperty("pattern") && schemaObj.Get("pattern").IsString()) {
-      schema->pattern = schemaObj.Get("pattern").As<Napi::String>().Utf8Value();
-    }
-
-    if (schemaObj.HasOwnProperty("format") && schemaObj.Get("format").IsString()) {
-      schema->format = schemaObj.Get("format").As<Napi::String>().Utf8Value();
-    }
-
-    if (schemaObj.HasOwnProperty("minItems") && schemaObj.Get("minItems").IsNumber()) {
-      schema->minItems = schemaObj.Get("minItems").As<Napi::Number>().Int32Value();
-    }
-
-    if (schemaObj.HasOwnProperty("maxItems") && schemaObj.Get("maxItems").IsNumber()) {
-      schema->maxItems = schemaObj.Get("maxItems").As<Napi::Number>().Int32Value();
-    }
-
-    if (schemaObj.HasOwnProperty("uniqueItems") && schemaObj.Get("uniqueItems").IsBoolean()) {
-      schema->uniqueItems = schemaObj.Get("uniqueItems").As<Napi::Boolean>().Value();
-    }
-
-    // Handle additionalProperties for incremental validation
-    if (schemaObj.HasOwnProperty("additionalProperties")) {
-      auto additionalProps = schemaObj.Get("additionalProperties");
-      if (additionalProps.IsBoolean()) {
-        schema->additionalProperties = additionalProps.As<Napi::Boolean>().Value();
-      } else if (additionalProps.IsObject()) {
-        schema->additionalProperties = true;
-        schema->additionalPropertiesSchema = ParseSchema(
-          additionalProps.As<Napi::Object>(),
-          path + ".additionalProperties"
-        );
-      }
+      return true;
     }
 
-    // Parse properties for object schemas
-    if (schemaObj.HasOwnProperty("properties") && schemaObj.Get("properties").IsObject()) {
-      Napi::Object props = schemaObj.Get("properties").As<Napi::Object>();
-      Napi::Array propNames = props.GetPropertyNames();
-
-      // Pre-allocate space for properties
-      uint32_t propCount = propNames.Length();
-      schema->properties.reserve(propCount);
-
-      for (uint32_t i = 0; i < propCount; i++) {
-        std::string propName = propNames.Get(i).As<Napi::String>().Utf8Value();
-        if (props.Get(propName).IsObject()) {
-          schema->properties[propName] = ParseSchema(
-            props.Get(propName).As<Napi::Object>(),
-            path + ".properties." + propName
-          );
-        }
-      }
+    void FinalizeSchemaMemo(napi_env, void* data, void*) {
+      delete static_cast<SchemaMemo*>(data);
     }
 
-    // Parse required properties array
-    if (schemaObj.HasOwnProperty("required") && schemaObj.Get("required").IsArray()) {
-      Napi::Array required = schemaObj.Get("required").As<Napi::Array>();
-
-      // Pre-allocate space for required properties
-      uint32_t reqCount = required.Length();
-      schema->requiredProperties.reserve(reqCount);
-
-      for (uint32_t i = 0; i < reqCount; i++) {
-        if (required.Get(i).IsString()) {
-          schema->requiredProperties.push_back(required.Get(i).As<Napi::String>().Utf8Value());
+    // Structural hash of a schema, or "" if it is too deep to hash in full.
+    // Only deeply frozen schemas keep the hash on the object: any other schema may be
+    // mutated in place, so it is hashed again on every call.
+    std::string SchemaHashOf(const Napi::Object& schemaObj) {
+      napi_env env = schemaObj.Env();
+      bool tagged = false;
+      if (napi_check_object_type_tag(env, schemaObj, &kSchemaMemoTag, &tagged) == napi_ok && tagged) {
+        void* data = nullptr;
+        if (napi_unwrap(env, schemaObj, &data) == napi_ok && data != nullptr) {
+          return static_cast<SchemaMemo*>(data)->hash;
         }
       }
-    }
-
-    // Parse items for array schemas
-    if (schemaObj.HasOwnProperty("items") && schemaObj.Get("items").IsObject()) {
-      schema->items = ParseSchema(
-        schemaObj.Get("items").As<Napi::Object>(),
-        path + ".items"
-      );
-    }
 
-    // Parse compound schemas (anyOf, allOf, oneOf, not)
-    if (schemaObj.HasOwnProperty("anyOf") && schemaObj.Get("anyOf").IsArray()) {
-      Napi::Array anyOfArr = schemaObj.Get("anyOf").As<Napi::Array>();
-      uint32_t count = anyOfArr.Length();
-      schema->anyOf.reserve(count);
-
-      for (uint32_t i = 0; i < count; i++) {
-        if (anyOfArr.Get(i).IsObject()) {
-          schema->anyOf.push_back(ParseSchema(
-            anyOfArr.Get(i).As<Napi::Object>(),
-            path + ".anyOf[" + std::to_string(i) + "]"
-          ));
-        }
+      SchemaHashWalk walk;
+      Napi::Function isFrozen = schemaObj.Env().Global().Get("Object").As<Napi::Object>()
+        .Get("isFrozen").As<Napi::Function>();
+      if (isFrozen.Call({schemaObj}).ToBoolean().Value()) {
+        walk.isFrozen = isFrozen;
       }
-    }
-
-    if (schemaObj.HasOwnProperty("allOf") && schemaObj.Get("allOf").IsArray()) {
-      Napi::Array allOfArr = schemaObj.Get("allOf").As<Napi::Array>();
-      uint32_t count = allOfArr.Length();
-      schema->allOf.reserve(count);
-
-      for (uint32_t i = 0; i < count; i++) {
-        if (allOfArr.Get(i).IsObject()) {
-          schema->allOf.push_back(ParseSchema(
-            allOfArr.Get(i).As<Napi::Object>(),
-            path + ".allOf[" + std::to_string(i) + "]"
-          ));
-        }
+      if (!HashValue(walk, schemaObj, 0)) {
+        return std::string();
       }
-    }
 
-    if (schemaObj.HasOwnProperty("oneOf") && schemaObj.Get("oneOf").IsArray()) {
-      Napi::Array oneOfArr = schemaObj.Get("oneOf").As<Napi::Array>();
-      uint32_t count = oneOfArr.Length();
-      schema->oneOf.reserve(count);
-
-      for (uint32_t i = 0; i < count; i++) {
-        if (oneOfArr.Get(i).IsObject()) {
-          schema->oneOf.push_back(ParseSchema(
-            oneOfArr.Get(i).As<Napi::Object>(),
-            path + ".oneOf[" + std::to_string(i) + "]"
-          ));
+      std::string hash = walk.hasher.Hex();
+      if (!walk.isFrozen.IsEmpty()) {
+        SchemaMemo* memo = new SchemaMemo{hash};
+        if (napi_wrap(env, schemaObj, memo, FinalizeSchemaMemo, nullptr, nullptr) != napi_ok) {
+          // Already wrapped by someone else: hash on every call instead
+          delete memo;
+        } else {
+          napi_type_tag_object(env, schemaObj, &kSchemaMemoTag);
         }
       }
+      return hash;
     }
 
-    if (schemaObj.HasOwnProperty("not") && schemaObj.Get("not").IsObject()) {
-      schema->not_ = ParseSchema(
-        schemaObj.Get("not").As<Napi::Object>(),
-        path + ".not"
-      );
-    }
-
-    return schema;
-  }
-
-  // Helper functions for type checking
-  inline bool isType(const Napi::Value& value, const std::string& type) {
-    if (type == "string") return value.IsString();
-    if (type == "number") return value.IsNumber();
-    if (type == "integer") return value.IsNumber() && value.As<Napi::Number>().Int32Value() == value.As<Napi::Number>().DoubleValue();
-    if (type == "boolean") return value.IsBoolean();
-    if (type == "object") return value.IsObject() && !value.IsArray();
-    if (type == "array") return value.IsArray();
-    if (type == "null") return value.IsNull();
-    return false;
-  }
-
-  // Compute a hash for a schema to detect changes
-  std::string computeSchemaHash(const Napi::Object& schemaObj) {
-    std::stringstream ss;
-
-    // Serialize the schema to a canonical form
-    // This is a simple implementation - in production, you would use a more robust approach
-    Napi::Value json = schemaObj.Get("toString").As<Napi::Function>().Call(schemaObj, {});
-    std::string jsonStr = json.As<Napi::String>().Utf8Value();
-
-    // Compute a hash
-    std::hash<std::string> hasher;
-    size_t hash = hasher(jsonStr);
+  } // namespace
 
-    ss << std::hex << std::setw(16) << std::setfill('0') << hash;
-    return ss.str();
+  // Hash of the schema's structure; equal for schemas that differ only in key order.
+  // Empty for schemas nested deeper than the hash walk goes, which are never cached.
+  std::string ComputeSchemaHash(const Napi::Object& schema) {
+    SchemaHashWalk walk;
+    return HashValue(walk, schema, 0) ? walk.hasher.Hex() : std::string();
   }
 
-  // Compile a schema into an optimized validator
+  // Compiled validator for a schema, compiled on first use and cached by structural hash
   std::shared_ptr<CompiledValidator> CompileSchemaInternal(const Napi::Object& schemaObj) {
+    std::string hash = SchemaHashOf(schemaObj);
+    auto cachedValidator = hash.empty() ? nullptr : schemaCache.get(hash);
+    if (cachedValidator) {
+      cacheHits++;
+      return cachedValidator;
+    }
+    cacheMisses++;
+
     auto startTime = std::chrono::high_resolution_clock::now();
 
-    // Parse the schema into our internal representation
-    auto schema = ParseSchema(schemaObj, "$");
+    // Compile the schema into a flat node program; invalid schemas throw
+    auto program = SchemaProgram::Compile(schemaObj);
+    if (!program) {
+      return nullptr;
+    }
 
     // Create a schema version for caching
     SchemaVersion version;
-    version.id = schema->id;
-    version.hash = computeSchemaHash(schemaObj);
+    if (schemaObj.HasOwnProperty("$id") && schemaObj.Get("$id").IsString()) {
+      version.id = schemaObj.Get("$id").As<Napi::String>().Utf8Value();
+    }
+    version.hash = hash;
     version.version = std::chrono::duration_cast<std::chrono::milliseconds>(
         std::chrono::system_clock::now().time_since_epoch()).count();
 
-    // Generate optimized validation code
-    auto validator = GenerateValidator(schema);
-
     auto endTime = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count();
     generationTime += duration;
 
     // Create the compiled validator
-    auto compiledValidator = std::make_shared<CompiledValidator>(schema, validator, version);
-
-    // Add to cache if it has an ID
-    if (!schema->id.empty()) {
-      std::string cacheKey = schema->id + ":" + version.hash;
-      schemaCache.add(cacheKey, version, compiledValidator);
+    auto compiledValidator = std::make_shared<CompiledValidator>(program, version);
+    if (!hash.empty()) {
+      schemaCache.add(hash, version, compiledValidator);
     }
 
     return compiledValidator;
   }
 
-  // Forward declarations
-  bool validateValue(const Napi::Value& value, const Schema& schema, const std::string& path, std::vector<ValidationError>& errors);
-  std::shared_ptr<Schema> ParseSchema(const Napi::Object& schemaObj, const std::string& path);
-
-  // Validate a value against a schema - optimized version
-  bool validateValue(const Napi::Value& value, const Schema& schema, const std::string& path, std::vector<ValidationError>& errors) {
-    // Check if value is required but null or undefined
-    if (schema.required && (value.IsNull() || value.IsUndefined())) {
-      errors.push_back({path, "Value is required"});
-      return false;
-    }
-
-    // Skip validation for null or undefined values if not required
-    if (value.IsNull() || value.IsUndefined()) {
-      return true;
-    }
-
-    // Type validation
-    if (!schema.type.empty() && !isType(value, schema.type)) {
-      errors.push_back({path, "Invalid type"});
-      return false;
-    }
-
-    // Use optimized type-specific validation methods
-    if (schema.type == "string" && value.IsString()) {
-      return schema.validateString(value.As<Napi::String>().Utf8Value(), path, errors);
-    }
-
-    if ((schema.type == "number" || schema.type == "integer") && value.IsNumber()) {
-      return schema.validateNumber(value.As<Napi::Number>().DoubleValue(), path, errors);
-    }
+  // ========== JavaScript Interface Functions ==========
 
-    if (schema.type == "object" && value.IsObject() && !value.IsArray()) {
-      return schema.validateObject(value.As<Napi::Object>(), path, errors);
-    }
+  // { valid, errors: [{ path, message }] } as returned by every validate entry point
+  Napi::Object ValidationResult(Napi::Env env, bool valid, const std::vector<ValidationError>& errors) {
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("valid", Napi::Boolean::New(env, valid));
 
-    if (schema.type == "array" && value.IsArray()) {
-      return schema.validateArray(value.As<Napi::Array>(), path, errors);
+    Napi::Array errorsArray = Napi::Array::New(env, errors.size());
+    for (size_t i = 0; i < errors.size(); i++) {
+      Napi::Object error = Napi::Object::New(env);
+      error.Set("path", Napi::String::New(env, errors[i].path));
+      error.Set("message", Napi::String::New(env, errors[i].message));
+      errorsArray.Set(i, error);
     }
 
-    return errors.empty();
+    result.Set("errors", errorsArray);
+    return result;
   }
 
-  // ========== JavaScript Interface Functions ==========
-
   // Main validation function
   Napi::Value Validate(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
@@ -653,54 +407,11 @@ namespace SchemaValidator {
     auto startTime = std::chrono::high_resolution_clock::now();
     totalValidations++;
 
-    // Get schema ID and compute hash for caching
-    std::string schemaId = "";
-    std::string schemaHash = "";
-
-    if (schemaObj.HasOwnProperty("$id") && schemaObj.Get("$id").IsString()) {
-      schemaId = schemaObj.Get("$id").As<Napi::String>().Utf8Value();
-      schemaHash = computeSchemaHash(schemaObj);
-
-      // Try to get from cache
-      std::string cacheKey = schemaId + ":" + schemaHash;
-      auto cachedValidator = schemaCache.get(cacheKey);
-
-      if (cachedValidator) {
-        // Cache hit - use compiled validator
-        cacheHits++;
-
-        // Pre-allocate errors vector
-        std::vector<ValidationError> errors;
-        errors.reserve(16);
-
-        // Validate using the cached validator
-        cachedValidator->validate(data, errors);
-
-        auto endTime = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count();
-        validationTime += duration;
-
-        // Create result object
-        Napi::Object result = Napi::Object::New(env);
-        result.Set("valid", Napi::Boolean::New(env, errors.empty()));
-
-        // Create errors array
-        Napi::Array errorsArray = Napi::Array::New(env, errors.size());
-        for (size_t i = 0; i < errors.size(); i++) {
-          Napi::Object error = Napi::Object::New(env);
-          error.Set("path", Napi::String::New(env, errors[i].path));
-          error.Set("message", Napi::String::New(env, errors[i].message));
-          errorsArray.Set(i, error);
-        }
-
-        result.Set("errors", errorsArray);
-        return result;
-      }
-    }
-
-    // Cache miss or no ID - compile schema
-    cacheMisses++;
+    // Compiled on first use, then served from the cache by structural hash
     auto compiledValidator = CompileSchemaInternal(schemaObj);
+    if (!compiledValidator) {
+      return env.Null();
+    }
 
     // Pre-allocate errors vector
     std::vector<ValidationError> errors;
@@ -713,21 +424,7 @@ namespace SchemaValidator {
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count();
     validationTime += duration;
 
-    // Create result object
-    Napi::Object result = Napi::Object::New(env);
-    result.Set("valid", Napi::Boolean::New(env, errors.empty()));
-
-    // Create errors array
-    Napi::Array errorsArray = Napi::Array::New(env, errors.size());
-    for (size_t i = 0; i < errors.size(); i++) {
-      Napi::Object error = Napi::Object::New(env);
-      error.Set("path", Napi::String::New(env, errors[i].path));
-      error.Set("message", Napi::String::New(env, errors[i].message));
-      errorsArray.Set(i, error);
-    }
-
-    result.Set("errors", errorsArray);
-    return result;
+    return ValidationResult(env, errors.empty(), errors);
   }
 
   // Validate partial updates against a schema and existing data
@@ -746,113 +443,190 @@ namespace SchemaValidator {
     auto startTime = std::chrono::high_resolution_clock::now();
     totalValidations++;
 
-    // Get schema ID and compute hash for caching
-    std::string schemaId = "";
-    std::string schemaHash = "";
+    // Compiled on first use, then served from the cache by structural hash
+    auto compiledValidator = CompileSchemaInternal(schemaObj);
+    if (!compiledValidator) {
+      return env.Null();
+    }
 
-    if (schemaObj.HasOwnProperty("$id") && schemaObj.Get("$id").IsString()) {
-      schemaId = schemaObj.Get("$id").As<Napi::String>().Utf8Value();
-      schemaHash = computeSchemaHash(schemaObj);
-
-      // Try to get from cache
-      std::string cacheKey = schemaId + ":" + schemaHash;
-      auto cachedValidator = schemaCache.get(cacheKey);
-
-      if (cachedValidator) {
-        // Cache hit
-        cacheHits++;
-
-        // Pre-allocate errors vector
-        std::vector<ValidationError> errors;
-        errors.reserve(16);
-
-        // Validate incremental update
-        bool valid = ValidateIncrementalUpdate(data, updates, cachedValidator->schema, errors);
-
-        auto endTime = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count();
-        validationTime += duration;
-
-        // Create result object
-        Napi::Object result = Napi::Object::New(env);
-        result.Set("valid", Napi::Boolean::New(env, valid));
-
-        // Create errors array
-        Napi::Array errorsArray = Napi::Array::New(env, errors.size());
-        for (size_t i = 0; i < errors.size(); i++) {
-          Napi::Object error = Napi::Object::New(env);
-          error.Set("path", Napi::String::New(env, errors[i].path));
-          error.Set("message", Napi::String::New(env, errors[i].message));
-          errorsArray.Set(i, error);
-        }
+    // Pre-allocate errors vector
+    std::vector<ValidationError> errors;
+    errors.reserve(16);
+
+    // Validate incremental update
+    bool valid = ValidateIncrementalUpdate(data, updates, *compiledValidator->program, errors);
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count();
+    validationTime += duration;
+
+    return ValidationResult(env, valid, errors);
+  }
 
-        result.Set("errors", errorsArray);
-        return result;
+  // Compile a schema into a CompiledSchema handle with its own validate()
+  Napi::Value CompileSchema(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsObject()) {
+      Napi::TypeError::New(env, "Expected (schema)").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    Napi::Object handle = CompiledSchema::NewInstance(env, info[0].As<Napi::Object>());
+    if (env.IsExceptionPending()) {
+      return env.Null();
+    }
+    return handle;
+  }
+
+  namespace {
+
+    // One On-Demand parser per thread, shared by validateJson() and parseJson()
+    thread_local simdjson::ondemand::parser jsonParser;
+
+    // Do not keep a parser sized for one unusually large body
+    void ReleaseLargeParser() {
+      if (jsonParser.capacity() > MAX_RETAINED_PARSER_CAPACITY) {
+        jsonParser = simdjson::ondemand::parser();
       }
     }
 
-    // Cache miss or no ID - compile schema
-    cacheMisses++;
-    auto compiledValidator = CompileSchemaInternal(schemaObj);
+    // The bytes of a Buffer or string argument; strings are copied into `storage`
+    std::string_view InputBytes(const Napi::Value& value, std::string& storage) {
+      if (value.IsBuffer()) {
+        Napi::Buffer<char> buffer = value.As<Napi::Buffer<char>>();
+        return std::string_view(buffer.Data(), buffer.Length());
+      }
+      storage = value.As<Napi::String>().Utf8Value();
+      return storage;
+    }
 
-    // Pre-allocate errors vector
+    // { valid, errors, value }, with the value only when there were no errors
+    Napi::Object ParseResult(Napi::Env env, simdjson::error_code error, std::vector<ValidationError>& errors,
+                             const Napi::Value& value) {
+      if (error) {
+        errors.clear();
+        errors.push_back({"$", std::string("Invalid JSON: ") + simdjson::error_message(error)});
+      }
+
+      Napi::Object result = ValidationResult(env, errors.empty(), errors);
+      if (errors.empty()) {
+        result.Set("value", value);
+      }
+      return result;
+    }
+
+  } // namespace
+
+  // Validate JSON text (Buffer or string) against a CompiledSchema without building JS objects first.
+  // The parsed value is only materialized for valid documents, from the same simdjson index.
+  Napi::Value ValidateJson(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    CompiledSchema* compiled = info.Length() > 0 ? CompiledSchema::FromValue(info[0]) : nullptr;
+    if (!compiled || !compiled->Validator() || info.Length() < 2 ||
+        (!info[1].IsBuffer() && !info[1].IsString())) {
+      Napi::TypeError::New(env, "Expected (compiledSchema, Buffer or string)").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    std::string storage;
+    std::string_view input = InputBytes(info[1], storage);
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+    totalValidations++;
+
+    simdjson::padded_string padded(input);
+    simdjson::ondemand::document document;
     std::vector<ValidationError> errors;
-    errors.reserve(16);
+    Napi::Value value;
 
-    // Validate incremental update
-    bool valid = ValidateIncrementalUpdate(data, updates, compiledValidator->schema, errors);
+    simdjson::error_code error = jsonParser.iterate(padded).get(document);
+    if (!error) {
+      JsonValidator validator(*compiled->Validator()->program);
+      error = validator.Validate(document, errors);
+    }
+    if (!error && errors.empty()) {
+      document.rewind();
+      error = JsonToValue(env, document, value);
+    }
+    ReleaseLargeParser();
 
     auto endTime = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count();
     validationTime += duration;
 
-    // Create result object
-    Napi::Object result = Napi::Object::New(env);
-    result.Set("valid", Napi::Boolean::New(env, valid));
+    return ParseResult(env, error, errors, value);
+  }
 
-    // Create errors array
-    Napi::Array errorsArray = Napi::Array::New(env, errors.size());
-    for (size_t i = 0; i < errors.size(); i++) {
-      Napi::Object error = Napi::Object::New(env);
-      error.Set("path", Napi::String::New(env, errors[i].path));
-      error.Set("message", Napi::String::New(env, errors[i].message));
-      errorsArray.Set(i, error);
+  // Parse JSON text into the value a CompiledSchema describes: validated, coerced where the
+  // schema's types allow it, with defaults filled in and unknown properties stripped.
+  Napi::Value ParseJson(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    CompiledSchema* compiled = info.Length() > 0 ? CompiledSchema::FromValue(info[0]) : nullptr;
+    if (!compiled || !compiled->Validator() || info.Length() < 2 ||
+        (!info[1].IsBuffer() && !info[1].IsString())) {
+      Napi::TypeError::New(env, "Expected (compiledSchema, Buffer or string)").ThrowAsJavaScriptException();
+      return env.Null();
     }
 
-    result.Set("errors", errorsArray);
-    return result;
+    std::string storage;
+    std::string_view input = InputBytes(info[1], storage);
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+    totalValidations++;
+
+    simdjson::padded_string padded(input);
+    simdjson::ondemand::document document;
+    std::vector<ValidationError> errors;
+    Napi::Value value;
+
+    simdjson::error_code error = jsonParser.iterate(padded).get(document);
+    if (!error) {
+      SchemaParser parser(env, *compiled->Validator()->program);
+      error = parser.ParseJson(document, value, errors);
+    }
+    ReleaseLargeParser();
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count();
+    validationTime += duration;
+
+    return ParseResult(env, error, errors, value);
   }
 
-  // Compile a schema and return a reference
-  Napi::Value CompileSchema(const Napi::CallbackInfo& info) {
+  // Parse a query string ("a=1&tags=x&tags=y") against an object CompiledSchema, as parseJson() does for JSON
+  Napi::Value ParseQuery(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
 
-    if (info.Length() < 1 || !info[0].IsObject()) {
-      Napi::TypeError::New(env, "Expected (schema)").ThrowAsJavaScriptException();
+    CompiledSchema* compiled = info.Length() > 0 ? CompiledSchema::FromValue(info[0]) : nullptr;
+    if (!compiled || !compiled->Validator() || info.Length() < 2 || !info[1].IsString()) {
+      Napi::TypeError::New(env, "Expected (compiledSchema, string)").ThrowAsJavaScriptException();
       return env.Null();
     }
 
-    Napi::Object schemaObj = info[0].As<Napi::Object>();
+    std::string query = info[1].As<Napi::String>().Utf8Value();
 
-    // Compile the schema
-    auto compiledValidator = CompileSchemaInternal(schemaObj);
+    auto startTime = std::chrono::high_resolution_clock::now();
+    totalValidations++;
 
-    // Create a reference object to return
-    Napi::Object result = Napi::Object::New(env);
+    std::vector<ValidationError> errors;
+    Napi::Value value;
+    SchemaParser parser(env, *compiled->Validator()->program);
+    parser.ParseQuery(query.data(), query.size(), value, errors);
 
-    // Set schema ID and version
-    result.Set("id", Napi::String::New(env, compiledValidator->version.id));
-    result.Set("hash", Napi::String::New(env, compiledValidator->version.hash));
-    result.Set("version", Napi::Number::New(env, compiledValidator->version.version));
+    auto endTime = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count();
+    validationTime += duration;
 
-    return result;
+    return ParseResult(env, simdjson::SUCCESS, errors, value);
   }
 
   // Clear the schema cache
   Napi::Value ClearCache(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
 
-    // Clear the cache
     schemaCache.clear();
 
     Napi::Object result = Napi::Object::New(env);
@@ -886,8 +660,12 @@ namespace SchemaValidator {
     exports.Set("validate", Napi::Function::New(env, Validate));
     exports.Set("validatePartial", Napi::Function::New(env, ValidatePartial));
     exports.Set("compileSchema", Napi::Function::New(env, CompileSchema));
+    exports.Set("validateJson", Napi::Function::New(env, ValidateJson));
+    exports.Set("parseJson", Napi::Function::New(env, ParseJson));
+    exports.Set("parseQuery", Napi::Function::New(env, ParseQuery));
     exports.Set("clearCache", Napi::Function::New(env, ClearCache));
     exports.Set("getCacheStats", Napi::Function::New(env, GetCacheStats));
+    CompiledSchema::Init(env, exports);
 
     // Export the SchemaValidator namespace with static methods
     Napi::Object schemaValidator = Napi::Object::New(env);
@@ -901,298 +679,11 @@ namespace SchemaValidator {
     return exports;
   }
 
-  // Generate a specialized validator function for the schema
-  ValidatorFunction GenerateValidator(const std::shared_ptr<Schema>& schema) {
-    // This is where the code generation magic happens!
-    // Instead of using the generic validator, we build a specialized function
-    // that performs only the checks needed for this specific schema
-
-    return [schema](const Napi::Value& value, std::vector<ValidationError>& errors, const std::string& path) -> bool {
-      // Start with size of errors to track if we added any
-      const size_t initialErrorCount = errors.size();
-
-      // Handle required check
-      if (schema->required && (value.IsNull() || value.IsUndefined())) {
-        errors.push_back({path, "Value is required"});
-        return false;
-      }
-
-      // Skip validation for null or undefined values if not required
-      if (value.IsNull() || value.IsUndefined()) {
-        return true;
-      }
-
-      // Type validation - only if type is specified
-      if (!schema->type.empty()) {
-        if (!isType(value, schema->type)) {
-          errors.push_back({path, "Invalid type, expected " + schema->type});
-          return false;
-        }
-
-        // Type-specific validations
-        if (schema->type == "string" && value.IsString()) {
-          std::string strValue = value.As<Napi::String>().Utf8Value();
-          size_t length = strValue.length();
-
-          // Check minLength
-          if (schema->minLength >= 0 && length < static_cast<size_t>(schema->minLength)) {
-            errors.push_back({path, "String too short, minimum length: " + std::to_string(schema->minLength)});
-          }
-
-          // Check maxLength
-          if (schema->maxLength >= 0 && length > static_cast<size_t>(schema->maxLength)) {
-            errors.push_back({path, "String too long, maximum length: " + std::to_string(schema->maxLength)});
-          }
-
-          // Check pattern
-          if (!schema->pattern.empty()) {
-            // In production code, you would use regex here
-            if (strValue.find(schema->pattern) == std::string::npos) {
-              errors.push_back({path, "String does not match pattern: " + schema->pattern});
-            }
-          }
-
-          // Check format if specified
-          if (!schema->format.empty()) {
-            // Basic format validation - in production, implement more formats
-            if (schema->format == "email") {
-              if (strValue.find('@') == std::string::npos) {
-                errors.push_back({path, "Invalid email format"});
-              }
-            }
-          }
-        }
-        else if ((schema->type == "number" || schema->type == "integer") && value.IsNumber()) {
-          double numValue = value.As<Napi::Number>().DoubleValue();
-
-          // Integer validation
-          if (schema->type == "integer" && std::floor(numValue) != numValue) {
-            errors.push_back({path, "Expected integer"});
-          }
-
-          // Check minimum
-          if (schema->exclusiveMinimum && numValue <= schema->minimum) {
-            errors.push_back({path, "Value must be greater than " + std::to_string(schema->minimum)});
-          } else if (!schema->exclusiveMinimum && numValue < schema->minimum) {
-            errors.push_back({path, "Value must be greater than or equal to " + std::to_string(schema->minimum)});
-          }
-
-          // Check maximum
-          if (schema->exclusiveMaximum && numValue >= schema->maximum) {
-            errors.push_back({path, "Value must be less than " + std::to_string(schema->maximum)});
-          } else if (!schema->exclusiveMaximum && numValue > schema->maximum) {
-            errors.push_back({path, "Value must be less than or equal to " + std::to_string(schema->maximum)});
-          }
-        }
-        else if (schema->type == "array" && value.IsArray()) {
-          Napi::Array array = value.As<Napi::Array>();
-          uint32_t length = array.Length();
-
-          // Check minItems
-          if (schema->minItems >= 0 && length < static_cast<uint32_t>(schema->minItems)) {
-            errors.push_back({path, "Array too short, minimum items: " + std::to_string(schema->minItems)});
-          }
-
-          // Check maxItems
-          if (schema->maxItems >= 0 && length > static_cast<uint32_t>(schema->maxItems)) {
-            errors.push_back({path, "Array too long, maximum items: " + std::to_string(schema->maxItems)});
-          }
-
-          // Check uniqueItems
-          if (schema->uniqueItems && length > 0) {
-            // This is a simple implementation - in production, use a more efficient approach
-            std::unordered_set<std::string> uniqueValues;
-            for (uint32_t i = 0; i < length; i++) {
-              Napi::Value item = array.Get(i);
-              if (item.IsString()) {
-                std::string str = item.As<Napi::String>().Utf8Value();
-                if (uniqueValues.find(str) != uniqueValues.end()) {
-                  errors.push_back({path, "Array items must be unique"});
-                  break;
-                }
-                uniqueValues.insert(str);
-              }
-              else if (item.IsNumber()) {
-                std::string num = std::to_string(item.As<Napi::Number>().DoubleValue());
-                if (uniqueValues.find(num) != uniqueValues.end()) {
-                  errors.push_back({path, "Array items must be unique"});
-                  break;
-                }
-                uniqueValues.insert(num);
-              }
-              // For complex objects, this approach is simplified
-            }
-          }
-
-          // Validate items if schema has items defined
-          if (schema->items) {
-            std::string basePath = path + "[";
-            for (uint32_t i = 0; i < length; i++) {
-              std::string itemPath = basePath + std::to_string(i) + "]";
-              validateValue(array.Get(i), *schema->items, itemPath, errors);
-            }
-          }
-        }
-        else if (schema->type == "object" && value.IsObject() && !value.IsArray()) {
-          Napi::Object obj = value.As<Napi::Object>();
-
-          // Check required properties
-          for (const auto& prop : schema->requiredProperties) {
-            if (!obj.HasOwnProperty(prop)) {
-              errors.push_back({path + "." + prop, "Required property missing"});
-            }
-          }
-
-          // Validate properties
-          Napi::Array propNames = obj.GetPropertyNames();
-          uint32_t propCount = propNames.Length();
-
-          for (uint32_t i = 0; i < propCount; i++) {
-            std::string propName = propNames.Get(i).As<Napi::String>().Utf8Value();
-
-            // Check if property is defined in schema
-            auto propIt = schema->properties.find(propName);
-            if (propIt != schema->properties.end()) {
-              // Validate property against its schema
-              validateValue(obj.Get(propName), *propIt->second, path + "." + propName, errors);
-            } else if (!schema->additionalProperties) {
-              // If additionalProperties is false, disallow undefined properties
-              errors.push_back({path + "." + propName, "Additional property not allowed"});
-            } else if (schema->additionalPropertiesSchema) {
-              // If additionalProperties is a schema, validate against it
-              validateValue(obj.Get(propName), *schema->additionalPropertiesSchema, path + "." + propName, errors);
-            }
-          }
-        }
-      }
-
-      // Validate compound schemas
-
-      // anyOf validation
-      if (!schema->anyOf.empty()) {
-        bool anyValid = false;
-        std::vector<ValidationError> anyOfErrors;
-
-        for (const auto& subSchema : schema->anyOf) {
-          std::vector<ValidationError> subErrors;
-          if (validateValue(value, *subSchema, path, subErrors)) {
-            anyValid = true;
-            break;
-          }
-          anyOfErrors.insert(anyOfErrors.end(), subErrors.begin(), subErrors.end());
-        }
-
-        if (!anyValid) {
-          errors.push_back({path, "Did not match any of the schemas"});
-          // We could add all sub-errors here, but that gets verbose
-        }
-      }
-
-      // allOf validation
-      if (!schema->allOf.empty()) {
-        for (const auto& subSchema : schema->allOf) {
-          validateValue(value, *subSchema, path, errors);
-        }
-      }
-
-      // oneOf validation
-      if (!schema->oneOf.empty()) {
-        int validCount = 0;
-
-        for (const auto& subSchema : schema->oneOf) {
-          std::vector<ValidationError> subErrors;
-          if (validateValue(value, *subSchema, path, subErrors)) {
-            validCount++;
-          }
-        }
-
-        if (validCount != 1) {
-          errors.push_back({path, "Should match exactly one schema"});
-        }
-      }
-
-      // not validation
-      if (schema->not_) {
-        std::vector<ValidationError> notErrors;
-        if (validateValue(value, *schema->not_, path, notErrors)) {
-          errors.push_back({path, "Should not match schema"});
-        }
-      }
-
-      // Return true if we didn't add any errors
-      return errors.size() == initialErrorCount;
-    };
-  }
-
   // Incremental validation for partial updates
   bool ValidateIncrementalUpdate(const Napi::Object& data, const Napi::Object& updates,
-                                 const std::shared_ptr<Schema>& schema,
+                                 const SchemaProgram& program,
                                  std::vector<ValidationError>& errors) {
-    if (!schema || (!schema->type.empty() && schema->type != "object")) {
-      errors.push_back({"$", "Schema must be an object schema for incremental validation"});
-      return false;
-    }
-
-    // Get update properties
-    Napi::Array updateProps = updates.GetPropertyNames();
-    uint32_t propCount = updateProps.Length();
-
-    // Track if validation was successful
-    bool valid = true;
-
-    // Validate each property in updates
-    for (uint32_t i = 0; i < propCount; i++) {
-      std::string propName = updateProps.Get(i).As<Napi::String>().Utf8Value();
-      Napi::Value propValue = updates.Get(propName);
-
-      // Find property schema
-      auto propSchemaIt = schema->properties.find(propName);
-      if (propSchemaIt != schema->properties.end()) {
-        // Validate property against its schema
-        if (!validateValue(propValue, *propSchemaIt->second, "$." + propName, errors)) {
-          valid = false;
-        }
-      } else if (!schema->additionalProperties) {
-        // If additionalProperties is false, disallow undefined properties
-        errors.push_back({"$." + propName, "Additional property not allowed"});
-        valid = false;
-      } else if (schema->additionalPropertiesSchema) {
-        // If additionalProperties is a schema, validate against it
-        if (!validateValue(propValue, *schema->additionalPropertiesSchema, "$." + propName, errors)) {
-          valid = false;
-        }
-      }
-    }
-
-    // Create a virtual merged object to validate required properties
-    if (!schema->requiredProperties.empty()) {
-      std::unordered_set<std::string> existingProps;
-
-      // Get existing properties from data
-      if (data.IsObject() && !data.IsArray()) {
-        Napi::Array dataProps = data.GetPropertyNames();
-        uint32_t dataPropCount = dataProps.Length();
-
-        for (uint32_t i = 0; i < dataPropCount; i++) {
-          existingProps.insert(dataProps.Get(i).As<Napi::String>().Utf8Value());
-        }
-      }
-
-      // Add update properties
-      for (uint32_t i = 0; i < propCount; i++) {
-        existingProps.insert(updateProps.Get(i).As<Napi::String>().Utf8Value());
-      }
-
-      // Check required properties
-      for (const auto& requiredProp : schema->requiredProperties) {
-        if (existingProps.find(requiredProp) == existingProps.end()) {
-          errors.push_back({"$." + requiredProp, "Required property missing after update"});
-          valid = false;
-        }
-      }
-    }
-
-    return valid;
+    return program.ValidateUpdate(data, updates, errors);
   }
 
   // Cleanup method to clear caches and free resources
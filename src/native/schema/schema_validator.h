@@ -6,8 +6,8 @@
 #include <vector>
 #include <unordered_map>
 #include <memory>
-#include <functional>
 #include <mutex>
+#include "schema_program.h"
 
 namespace SchemaValidator {
 
@@ -23,9 +23,19 @@ namespace SchemaValidator {
     uint64_t version;
   };
 
-  // Forward declarations
-  class Schema;
-  class CompiledValidator;
+  // Compiled validator holding the schema program
+  class CompiledValidator {
+  public:
+    std::shared_ptr<SchemaProgram> program;
+    SchemaVersion version;
+
+    CompiledValidator(std::shared_ptr<SchemaProgram> program, SchemaVersion version)
+        : program(std::move(program)), version(std::move(version)) {}
+
+    bool validate(const Napi::Value& value, std::vector<ValidationError>& errors) const {
+      return program->Validate(value, errors);
+    }
+  };
 
   // Cache entry for compiled validators
   struct CacheEntry {
@@ -35,9 +45,6 @@ namespace SchemaValidator {
     uint64_t accessCount;
   };
 
-  // Generated validation function type
-  using ValidatorFunction = std::function<bool(const Napi::Value&, std::vector<ValidationError>&, const std::string&)>;
-
   // Main interface
   Napi::Object Init(Napi::Env env, Napi::Object exports);
 
@@ -45,19 +52,21 @@ namespace SchemaValidator {
   Napi::Value Validate(const Napi::CallbackInfo& info);
   Napi::Value ValidatePartial(const Napi::CallbackInfo& info);
   Napi::Value CompileSchema(const Napi::CallbackInfo& info);
+  Napi::Value ValidateJson(const Napi::CallbackInfo& info);
+  Napi::Value ParseJson(const Napi::CallbackInfo& info);
+  Napi::Value ParseQuery(const Napi::CallbackInfo& info);
   Napi::Value ClearCache(const Napi::CallbackInfo& info);
   Napi::Value GetCacheStats(const Napi::CallbackInfo& info);
 
-  // Schema compilation and code generation
+  // { valid, errors } result object
+  Napi::Object ValidationResult(Napi::Env env, bool valid, const std::vector<ValidationError>& errors);
+
+  // Schema compilation; nullptr with a pending JS exception for an invalid schema
   std::shared_ptr<CompiledValidator> CompileSchemaInternal(const Napi::Object& schemaObj);
-  std::shared_ptr<Schema> ParseSchema(const Napi::Object& schemaObj);
 
-  // Schema hashing for version checking
+  // Schema hashing for version checking ("" for schemas too deep to hash)
   std::string ComputeSchemaHash(const Napi::Object& schema);
 
-  // Validator code generation
-  ValidatorFunction GenerateValidator(const std::shared_ptr<Schema>& schema);
-
   // Cache management
   bool AddToCache(const std::string& id, const std::string& hash,
                  std::shared_ptr<CompiledValidator> validator);
@@ -66,7 +75,7 @@ namespace SchemaValidator {
 
   // Incremental validation
   bool ValidateIncrementalUpdate(const Napi::Object& data, const Napi::Object& updates,
-                                const std::shared_ptr<Schema>& schema,
+                                const SchemaProgram& program,
                                 std::vector<ValidationError>& errors);
 
   // Cleanup method
@@ -0,0 +1,204 @@
+#include <napi.h>
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "url_parser.h"
+
+/**
+ * Batch URL parsing for log and analytics pipelines
+ *
+ * Many URLs packed back to back in one Buffer are parsed in a single call and
+ * returned as columns: one Uint32Array of (offset, length) pairs per
+ * component, with offsets into the Buffer. Large batches are split across
+ * helper threads; each thread writes a disjoint range of the columns.
+ */
+namespace UrlParser {
+
+  namespace {
+
+    // Below this many URLs per thread, starting a thread costs more than it saves
+    constexpr size_t kUrlsPerThread = 8192;
+
+    // Raw query parameters of one slice: (keyOffset, keyLength, valueOffset, valueLength)
+    struct ParamSlice {
+      std::vector<uint32_t> params;
+      std::vector<uint32_t> counts;
+    };
+
+    struct BatchInput {
+      const char* data;
+      const uint32_t* offsets;
+      uint32_t* columns;   // COMPONENT_COUNT columns of 2 * count values
+      size_t count;
+      bool params;
+    };
+
+    void parseSlice(const BatchInput& input, size_t begin, size_t end, ParamSlice& slice) {
+      const size_t stride = input.count * 2;
+      for (size_t i = begin; i < end; i++) {
+        uint32_t start = input.offsets[i];
+        UrlSpans spans = parseUrl(input.data + start, input.offsets[i + 1] - start);
+
+        for (uint32_t c = 0; c < COMPONENT_COUNT; c++) {
+          uint32_t* column = input.columns + c * stride;
+          column[i * 2] = start + spans.parts[c].offset;
+          column[i * 2 + 1] = spans.parts[c].length;
+        }
+
+        if (input.params) {
+          const Span& search = spans.parts[SEARCH];
+          const char* query = input.data + start + search.offset;
+          uint32_t count = 0;
+          forEachQueryParam(query, search.length, UINT32_MAX,
+                            [&](const char* key, size_t keyLength, const char* value, size_t valueLength) {
+            slice.params.push_back(static_cast<uint32_t>(key - input.data));
+            slice.params.push_back(static_cast<uint32_t>(keyLength));
+            slice.params.push_back(static_cast<uint32_t>(value - input.data));
+            slice.params.push_back(static_cast<uint32_t>(valueLength));
+            count++;
+          });
+          slice.counts.push_back(count);
+        }
+      }
+    }
+
+  } // namespace
+
+  // parseBatch(buffer, offsets, options?)
+  //   offsets: Uint32Array of count + 1 boundaries; URL i is buffer[offsets[i], offsets[i + 1])
+  //   options: { hostnames?: boolean, params?: boolean, threads?: number }
+  // Returns { count, protocol, auth, hostname, port, pathname, search, hash } columns, plus
+  // hostIds/hostnames (ASCII case-insensitive dedupe) and paramIndex/params when requested.
+  Napi::Value ParseBatch(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 2 || !info[0].IsBuffer() || !info[1].IsTypedArray() ||
+        info[1].As<Napi::TypedArray>().TypedArrayType() != napi_uint32_array ||
+        info[1].As<Napi::TypedArray>().ElementLength() < 1) {
+      Napi::TypeError::New(env, "Buffer and Uint32Array of offsets expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    bool hostnames = false;
+    bool params = false;
+    size_t threads = std::max<unsigned int>(std::thread::hardware_concurrency(), 1);
+    if (info.Length() > 2 && info[2].IsObject()) {
+      Napi::Object options = info[2].As<Napi::Object>();
+      if (options.Has("hostnames") && options.Get("hostnames").IsBoolean()) {
+        hostnames = options.Get("hostnames").As<Napi::Boolean>().Value();
+      }
+      if (options.Has("params") && options.Get("params").IsBoolean()) {
+        params = options.Get("params").As<Napi::Boolean>().Value();
+      }
+      if (options.Has("threads") && options.Get("threads").IsNumber()) {
+        threads = std::max<uint32_t>(options.Get("threads").As<Napi::Number>().Uint32Value(), 1);
+      }
+    }
+
+    Napi::Buffer<char> buffer = info[0].As<Napi::Buffer<char>>();
+    Napi::Uint32Array offsetArray = info[1].As<Napi::Uint32Array>();
+    const uint32_t* offsets = offsetArray.Data();
+    const size_t count = offsetArray.ElementLength() - 1;
+
+    if (buffer.Length() > UINT32_MAX) {
+      Napi::RangeError::New(env, "Batch buffer too large").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    for (size_t i = 0; i < count; i++) {
+      if (offsets[i] > offsets[i + 1]) {
+        Napi::RangeError::New(env, "Offsets must be non-decreasing").ThrowAsJavaScriptException();
+        return env.Null();
+      }
+    }
+    if (offsets[count] > buffer.Length()) {
+      Napi::RangeError::New(env, "Offsets exceed buffer length").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    // All columns share one ArrayBuffer
+    const size_t stride = count * 2;
+    Napi::ArrayBuffer storage = Napi::ArrayBuffer::New(env, std::max<size_t>(stride * COMPONENT_COUNT, 1) * sizeof(uint32_t));
+    BatchInput input{buffer.Data(), offsets, static_cast<uint32_t*>(storage.Data()), count, params};
+
+    size_t sliceCount = std::max<size_t>(1, std::min(threads, count / kUrlsPerThread));
+    std::vector<ParamSlice> slices(sliceCount);
+    auto sliceBegin = [&](size_t index) { return count * index / sliceCount; };
+
+    // The first slice runs on this thread, the rest on helper threads
+    std::vector<std::thread> helpers;
+    helpers.reserve(sliceCount - 1);
+    for (size_t i = 1; i < sliceCount; i++) {
+      helpers.emplace_back([&, i]() { parseSlice(input, sliceBegin(i), sliceBegin(i + 1), slices[i]); });
+    }
+    parseSlice(input, sliceBegin(0), sliceBegin(1), slices[0]);
+    for (auto& helper : helpers) {
+      helper.join();
+    }
+
+    static const char* const names[COMPONENT_COUNT] = {
+      "protocol", "auth", "hostname", "port", "pathname", "search", "hash"
+    };
+
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("count", Napi::Number::New(env, static_cast<double>(count)));
+    for (uint32_t c = 0; c < COMPONENT_COUNT; c++) {
+      result.Set(names[c], Napi::Uint32Array::New(env, stride, storage, c * stride * sizeof(uint32_t), napi_uint32_array));
+    }
+
+    if (hostnames) {
+      const uint32_t* column = input.columns + HOSTNAME * stride;
+      Napi::Uint32Array hostIds = Napi::Uint32Array::New(env, count, napi_uint32_array);
+      Napi::Array hostList = Napi::Array::New(env);
+      std::unordered_map<std::string, uint32_t> ids;
+      std::string host;
+
+      for (size_t i = 0; i < count; i++) {
+        host.assign(input.data + column[i * 2], column[i * 2 + 1]);
+        for (char& ch : host) {
+          if (ch >= 'A' && ch <= 'Z') {
+            ch = static_cast<char>(ch | 0x20);
+          }
+        }
+        auto inserted = ids.emplace(host, static_cast<uint32_t>(ids.size()));
+        if (inserted.second) {
+          hostList.Set(inserted.first->second, Napi::String::New(env, host));
+        }
+        hostIds[i] = inserted.first->second;
+      }
+      result.Set("hostIds", hostIds);
+      result.Set("hostnames", hostList);
+    }
+
+    if (params) {
+      size_t total = 0;
+      for (const auto& slice : slices) {
+        total += slice.params.size();
+      }
+
+      // CSR layout: URL i owns params[paramIndex[i] * 4 .. paramIndex[i + 1] * 4)
+      Napi::Uint32Array paramIndex = Napi::Uint32Array::New(env, count + 1, napi_uint32_array);
+      Napi::Uint32Array paramSpans = Napi::Uint32Array::New(env, total, napi_uint32_array);
+      uint32_t* index = paramIndex.Data();
+      uint32_t* spans = paramSpans.Data();
+      size_t url = 0;
+      uint32_t running = 0;
+      for (const auto& slice : slices) {
+        for (uint32_t paramCount : slice.counts) {
+          index[url++] = running;
+          running += paramCount;
+        }
+        std::copy(slice.params.begin(), slice.params.end(), spans);
+        spans += slice.params.size();
+      }
+      index[count] = running;
+      result.Set("paramIndex", paramIndex);
+      result.Set("params", paramSpans);
+    }
+
+    return result;
+  }
+
+} // namespace UrlParser
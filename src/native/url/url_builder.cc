@@ -0,0 +1,154 @@
+#include <napi.h>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "url_parser.h"
+#include "url_scan.h"
+
+/**
+ * URL builder for redirect and signed URLs
+ *
+ * Takes a base URL and a set of query parameter overrides and writes the
+ * result straight into a caller-provided Buffer (normally a slab from a
+ * pool), so building a URL per request creates no intermediate JS strings.
+ * Everything outside the overridden parameters is copied byte for byte.
+ */
+namespace UrlParser {
+
+  namespace {
+
+    struct QueryOverride {
+      std::string key;
+      std::string value;
+      bool remove = false;    // null/undefined: drop the parameter
+      bool written = false;
+    };
+
+    void appendOverride(const QueryOverride& param, bool& first, std::string& out) {
+      out += first ? '?' : '&';
+      first = false;
+      UrlScan::AppendComponentEncoded(param.key.data(), param.key.size(), out);
+      out += '=';
+      UrlScan::AppendComponentEncoded(param.value.data(), param.value.size(), out);
+    }
+
+    // Copy base into out with overrides applied: an overridden parameter is written at
+    // the position of its first occurrence and its other occurrences are dropped; new
+    // parameters go after the existing ones, before the fragment.
+    void buildUrl(const char* base, size_t length, QueryOverride* overrides, size_t overrideCount, std::string& out) {
+      const char* hash = static_cast<const char*>(std::memchr(base, '#', length));
+      size_t hashPos = hash ? static_cast<size_t>(hash - base) : length;
+      const char* question = static_cast<const char*>(std::memchr(base, '?', hashPos));
+      size_t queryPos = question ? static_cast<size_t>(question - base) : hashPos;
+
+      out.append(base, queryPos);
+      bool first = true;
+
+      if (question) {
+        thread_local std::string key;
+        forEachQueryParam(base + queryPos + 1, hashPos - queryPos - 1, UINT32_MAX,
+                          [&](const char* keyData, size_t keyLength, const char* valueData, size_t valueLength) {
+          key.clear();
+          UrlScan::AppendDecoded(keyData, keyLength, true, key);
+          for (size_t i = 0; i < overrideCount; i++) {
+            QueryOverride& param = overrides[i];
+            if (param.key == key) {
+              if (!param.written && !param.remove) {
+                appendOverride(param, first, out);
+              }
+              param.written = true;
+              return;
+            }
+          }
+          out += first ? '?' : '&';
+          first = false;
+          out.append(keyData, static_cast<size_t>(valueData + valueLength - keyData));
+        });
+      }
+
+      for (size_t i = 0; i < overrideCount; i++) {
+        QueryOverride& param = overrides[i];
+        if (!param.written && !param.remove) {
+          appendOverride(param, first, out);
+          param.written = true;
+        }
+      }
+
+      out.append(base + hashPos, length - hashPos);
+    }
+
+  } // namespace
+
+  // buildUrl(base, overrides, out, offset, baseStart?, baseEnd?)
+  //   base: string or Buffer (optionally the span [baseStart, baseEnd) of a Buffer)
+  //   overrides: { key: value } with string/number/boolean values; null or undefined removes
+  // Writes the URL into out at offset and returns its byte length, or the negated length
+  // when it does not fit, so the caller can retry with a larger buffer.
+  Napi::Value BuildUrl(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 4 || (!info[0].IsString() && !info[0].IsBuffer()) ||
+        (!info[1].IsObject() && !info[1].IsUndefined() && !info[1].IsNull()) ||
+        !info[2].IsBuffer() || !info[3].IsNumber()) {
+      Napi::TypeError::New(env, "Expected (base, overrides, out: Buffer, offset: number)").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    std::string baseStr;
+    const char* base;
+    size_t length;
+    if (info[0].IsBuffer()) {
+      Napi::Buffer<char> buffer = info[0].As<Napi::Buffer<char>>();
+      size_t start = info.Length() > 4 && info[4].IsNumber() ? info[4].As<Napi::Number>().Uint32Value() : 0;
+      size_t end = info.Length() > 5 && info[5].IsNumber() ? info[5].As<Napi::Number>().Uint32Value() : buffer.Length();
+      if (start > end || end > buffer.Length()) {
+        Napi::RangeError::New(env, "Base span out of range").ThrowAsJavaScriptException();
+        return env.Null();
+      }
+      base = buffer.Data() + start;
+      length = end - start;
+    } else {
+      baseStr = info[0].As<Napi::String>().Utf8Value();
+      base = baseStr.data();
+      length = baseStr.size();
+    }
+
+    thread_local std::vector<QueryOverride> overrides;
+    size_t overrideCount = 0;
+    if (info[1].IsObject()) {
+      Napi::Object params = info[1].As<Napi::Object>();
+      Napi::Array keys = params.GetPropertyNames();
+      overrideCount = keys.Length();
+      if (overrides.size() < overrideCount) {
+        overrides.resize(overrideCount);
+      }
+      for (uint32_t i = 0; i < overrideCount; i++) {
+        Napi::Value key = keys.Get(i);
+        Napi::Value value = params.Get(key);
+        QueryOverride& param = overrides[i];
+        param.key = key.ToString().Utf8Value();
+        param.remove = value.IsNull() || value.IsUndefined();
+        param.value = param.remove ? std::string() : value.ToString().Utf8Value();
+        param.written = false;
+      }
+    }
+    // Override and output strings are per-thread and keep their capacity across calls
+    thread_local std::string output;
+    output.clear();
+    buildUrl(base, length, overrides.data(), overrideCount, output);
+
+    Napi::Buffer<char> out = info[2].As<Napi::Buffer<char>>();
+    double offsetValue = info[3].As<Napi::Number>().DoubleValue();
+    if (offsetValue < 0 || offsetValue > static_cast<double>(out.Length())) {
+      Napi::RangeError::New(env, "Offset out of range").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    size_t offset = static_cast<size_t>(offsetValue);
+    if (output.size() > out.Length() - offset) {
+      return Napi::Number::New(env, -static_cast<double>(output.size()));
+    }
+    std::memcpy(out.Data() + offset, output.data(), output.size());
+    return Napi::Number::New(env, static_cast<double>(output.size()));
+  }
+
+} // namespace UrlParser
@@ -0,0 +1,155 @@
+#ifndef URL_CACHE_H
+#define URL_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "url_parser.h"
+
+namespace UrlParser {
+
+  // Decoded query: keys and values back to back in `text`, (key, value) span pairs in `pairs`
+  struct DecodedQuery {
+    std::string text;
+    std::vector<Span> pairs;
+  };
+
+  // 64-bit hash of raw bytes, eight bytes per step
+  inline uint64_t hashBytes(const char* data, size_t length) {
+    uint64_t hash = 0x9e3779b97f4a7c15ULL ^ (length * 0xff51afd7ed558ccdULL);
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+      uint64_t word;
+      std::memcpy(&word, data + i, 8);
+      hash = (hash ^ word) * 0xff51afd7ed558ccdULL;
+      hash ^= hash >> 32;
+    }
+    uint64_t tail = 0;
+    std::memcpy(&tail, data + i, length - i);
+    // Final avalanche (MurmurHash3 fmix64) so the low bits used for set selection are well mixed
+    hash ^= tail;
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+  }
+
+  /**
+   * Bounded cache of parse results, keyed by the raw input bytes.
+   *
+   * Entries are content-addressed: the key is the exact input, so an entry can
+   * never go stale and nothing needs invalidating. The table is 4-way set
+   * associative with least-recently-used replacement inside each set, so its
+   * memory is fixed by the capacity and a lookup touches at most four entries.
+   */
+  class ParseCache {
+  public:
+    enum Kind : uint32_t {
+      EMPTY = 0,
+      SPANS_UTF8,    // parseUrl over bytes
+      SPANS_UTF16,   // parseUrl over JS string code units
+      QUERY          // decoded query pairs
+    };
+
+    struct Entry {
+      uint32_t kind = EMPTY;
+      uint64_t hash = 0;
+      uint64_t lastUsed = 0;
+      std::string key;
+      UrlSpans spans;
+      DecodedQuery query;
+    };
+
+    // Inputs longer than this are parsed without caching
+    static constexpr size_t kMaxKeyLength = 4096;
+
+    // Capacity is rounded up to a power of two; 0 disables the cache and frees its entries
+    void SetCapacity(size_t capacity) {
+      std::vector<Entry>().swap(slots_);
+      size_ = 0;
+      if (capacity == 0) {
+        return;
+      }
+      size_t slots = kWays;
+      while (slots < capacity) {
+        slots <<= 1;
+      }
+      slots_.resize(slots);
+      setMask_ = slots / kWays - 1;
+    }
+
+    bool Enabled() const { return !slots_.empty(); }
+    size_t Capacity() const { return slots_.size(); }
+    size_t Size() const { return size_; }
+    uint64_t Hits() const { return hits_; }
+    uint64_t Misses() const { return misses_; }
+    uint64_t Evictions() const { return evictions_; }
+
+    bool Cacheable(size_t length) const {
+      return !slots_.empty() && length <= kMaxKeyLength;
+    }
+
+    Entry* Find(uint32_t kind, const char* data, size_t length, uint64_t hash) {
+      Entry* set = &slots_[(hash & setMask_) * kWays];
+      for (size_t i = 0; i < kWays; i++) {
+        Entry& entry = set[i];
+        if (entry.kind == kind && entry.hash == hash && entry.key.size() == length &&
+            std::memcmp(entry.key.data(), data, length) == 0) {
+          entry.lastUsed = ++tick_;
+          hits_++;
+          return &entry;
+        }
+      }
+      misses_++;
+      return nullptr;
+    }
+
+    // Claim an entry for a new key, replacing the set's least recently used one.
+    // The caller fills in spans or query; string capacity is reused.
+    Entry& Insert(uint32_t kind, const char* data, size_t length, uint64_t hash) {
+      Entry* set = &slots_[(hash & setMask_) * kWays];
+      Entry* victim = &set[0];
+      for (size_t i = 0; i < kWays; i++) {
+        if (set[i].kind == EMPTY) {
+          victim = &set[i];
+          break;
+        }
+        if (set[i].lastUsed < victim->lastUsed) {
+          victim = &set[i];
+        }
+      }
+
+      if (victim->kind == EMPTY) {
+        size_++;
+      } else {
+        evictions_++;
+      }
+      victim->kind = kind;
+      victim->hash = hash;
+      victim->lastUsed = ++tick_;
+      victim->key.assign(data, length);
+      victim->spans = UrlSpans();
+      victim->query.text.clear();
+      victim->query.pairs.clear();
+      return *victim;
+    }
+
+  private:
+    static constexpr size_t kWays = 4;
+
+    std::vector<Entry> slots_;
+    size_t setMask_ = 0;
+    size_t size_ = 0;
+    uint64_t tick_ = 0;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+    uint64_t evictions_ = 0;
+  };
+
+} // namespace UrlParser
+
+#endif // URL_CACHE_H
@@ -1,9 +1,13 @@
 #include <napi.h>
 #include <string>
-#include <unordered_map>
+#include <vector>
 #include <string_view>
 #include <cstring>
+#include <cstdint>
 #include "url_parser.h"
+#include "url_cache.h"
+#include "whatwg_url.h"
+#include "url_scan.h"
 
 /**
  * URL Parser implementation
@@ -11,44 +15,47 @@
  */
 namespace UrlParser {
 
-  struct UrlParts {
-    std::string protocol;
-    std::string auth;
-    std::string hostname;
-    std::string port;
-    std::string pathname;
-    std::string search;
-    std::string hash;
-  };
+  Span makeSpan(size_t begin, size_t end) {
+    Span span;
+    span.offset = static_cast<uint32_t>(begin);
+    span.length = static_cast<uint32_t>(end - begin);
+    return span;
+  }
 
-  // Optimized URL parsing without regex - using string_view for zero-copy parsing
-  UrlParts parseUrl(const char* url, size_t length) {
-    UrlParts parts;
+  // Span-based URL parsing: components are located, never copied
+  template <typename CharT>
+  UrlSpans parseUrl(const CharT* url, size_t length) {
+    UrlSpans spans;
 
     // Fast path for empty URL
     if (length == 0) {
-      return parts;
+      return spans;
     }
 
     size_t pos = 0;
+    bool hasProtocol = false;
 
-    // Parse protocol
-    for (size_t i = 0; i < length - 2; i++) {
+    // Parse protocol; a scheme never contains '/', '?' or '#', so stop at the first one
+    for (size_t i = 0; i + 2 < length; i++) {
       if (url[i] == ':' && url[i+1] == '/' && url[i+2] == '/') {
-        parts.protocol = std::string(url, i);
+        spans.parts[PROTOCOL] = makeSpan(0, i);
+        hasProtocol = true;
         pos = i + 3; // Skip "://"
         break;
       }
+      if (url[i] == '/' || url[i] == '?' || url[i] == '#') {
+        break;
+      }
     }
 
     // Check if we have authority part (//...)
     bool hasAuthority = false;
-    if (pos == 0 && length >= 2 && url[0] == '/' && url[1] == '/') {
+    if (!hasProtocol && length >= 2 && url[0] == '/' && url[1] == '/') {
       hasAuthority = true;
       pos = 2; // Skip "//"
     }
 
-    if (hasAuthority || !parts.protocol.empty()) {
+    if (hasAuthority || hasProtocol) {
       // Find end of authority (next '/' or end of string)
       size_t authorityEnd = length;
       for (size_t i = pos; i < length; i++) {
@@ -58,24 +65,26 @@ namespace UrlParser {
         }
       }
 
-      // Extract authority
-      std::string_view authority(url + pos, authorityEnd - pos);
-
       // Parse auth (username:password@)
-      size_t authEnd = authority.find('@');
-      if (authEnd != std::string_view::npos) {
-        parts.auth = std::string(authority.substr(0, authEnd));
-        authority = authority.substr(authEnd + 1);
+      size_t hostStart = pos;
+      for (size_t i = pos; i < authorityEnd; i++) {
+        if (url[i] == '@') {
+          spans.parts[AUTH] = makeSpan(pos, i);
+          hostStart = i + 1;
+          break;
+        }
       }
 
       // Parse hostname and port
-      size_t portStart = authority.find(':');
-      if (portStart != std::string_view::npos) {
-        parts.hostname = std::string(authority.substr(0, portStart));
-        parts.port = std::string(authority.substr(portStart + 1));
-      } else {
-        parts.hostname = std::string(authority);
+      size_t hostEnd = authorityEnd;
+      for (size_t i = hostStart; i < authorityEnd; i++) {
+        if (url[i] == ':') {
+          hostEnd = i;
+          spans.parts[PORT] = makeSpan(i + 1, authorityEnd);
+          break;
+        }
       }
+      spans.parts[HOSTNAME] = makeSpan(hostStart, hostEnd);
 
       pos = authorityEnd;
     }
@@ -89,7 +98,7 @@ namespace UrlParser {
       }
     }
 
-    parts.pathname = std::string(url + pos, pathnameEnd - pos);
+    spans.parts[PATHNAME] = makeSpan(pos, pathnameEnd);
     pos = pathnameEnd;
 
     // Parse search
@@ -101,60 +110,118 @@ namespace UrlParser {
           break;
         }
       }
-      parts.search = std::string(url + pos + 1, searchEnd - pos - 1);
+      spans.parts[SEARCH] = makeSpan(pos + 1, searchEnd);
       pos = searchEnd;
     }
 
     // Parse hash
     if (pos < length && url[pos] == '#') {
-      parts.hash = std::string(url + pos + 1, length - pos - 1);
+      spans.parts[HASH] = makeSpan(pos + 1, length);
     }
 
-    return parts;
+    return spans;
   }
 
-  // Optimized query string parsing using string_view for zero-copy operations
-  std::unordered_map<std::string, std::string> parseQueryString(const char* queryString, size_t length) {
-    std::unordered_map<std::string, std::string> queryParams;
-    queryParams.reserve(16); // Pre-allocate for better performance
-
-    // Fast path for empty query string
-    if (length == 0) {
-      return queryParams;
-    }
-
-    size_t start = 0;
-
-    for (size_t i = 0; i < length; i++) {
-      if (queryString[i] == '&' || i == length - 1) {
-        // Handle the last parameter
-        size_t end = (i == length - 1) ? length : i;
-        size_t paramLength = end - start;
-
-        if (paramLength > 0) {
-          // Find the equals sign
-          size_t equals = start;
-          while (equals < end && queryString[equals] != '=') {
-            equals++;
-          }
-
-          if (equals < end) {
-            // We have a key-value pair
-            std::string key(queryString + start, equals - start);
-            std::string value(queryString + equals + 1, end - equals - 1);
-            queryParams[key] = value;
-          } else {
-            // We have a key with no value
-            std::string key(queryString + start, paramLength);
-            queryParams[key] = "";
-          }
-        }
+  template UrlSpans parseUrl<char>(const char* url, size_t length);
+  template UrlSpans parseUrl<char16_t>(const char16_t* url, size_t length);
+
+  // Split a decoded key like "a[b][]" into {"a", "b", ""}. At most `depth` bracket
+  // segments are split off; anything after them (or an unclosed bracket) is kept as
+  // one literal segment.
+  void splitQueryKey(std::string_view key, uint32_t depth, std::vector<std::string_view>& segments) {
+    segments.clear();
+    size_t open = key.find('[');
+    if (depth == 0 || open == std::string_view::npos || open == 0) {
+      segments.push_back(key);
+      return;
+    }
 
-        start = i + 1;
+    segments.push_back(key.substr(0, open));
+    size_t pos = open;
+    while (pos < key.size() && key[pos] == '[' && segments.size() <= depth) {
+      size_t close = key.find(']', pos + 1);
+      if (close == std::string_view::npos) {
+        break;
       }
+      segments.push_back(key.substr(pos + 1, close - pos - 1));
+      pos = close + 1;
     }
+    if (pos < key.size()) {
+      segments.push_back(key.substr(pos));
+    }
+  }
+  // Decode every parameter into one buffer; keys and values are span pairs into it
+  void decodeQuery(const char* query, size_t length, uint32_t limit, DecodedQuery& out) {
+    out.text.clear();
+    out.pairs.clear();
+    forEachQueryParam(query, length, limit,
+                      [&](const char* keyData, size_t keyLength, const char* valueData, size_t valueLength) {
+      size_t keyStart = out.text.size();
+      UrlScan::AppendDecoded(keyData, keyLength, true, out.text);
+      size_t valueStart = out.text.size();
+      UrlScan::AppendDecoded(valueData, valueLength, true, out.text);
+      out.pairs.push_back(makeSpan(keyStart, valueStart));
+      out.pairs.push_back(makeSpan(valueStart, out.text.size()));
+    });
+  }
 
-    return queryParams;
+  // Per-thread parse cache; disabled until configureParseCache sets a capacity
+  thread_local ParseCache parseCache;
+
+  template <typename CharT>
+  UrlSpans cachedParseUrl(const CharT* url, size_t length) {
+    const char* bytes = reinterpret_cast<const char*>(url);
+    size_t size = length * sizeof(CharT);
+    if (!parseCache.Cacheable(size)) {
+      return parseUrl(url, length);
+    }
+
+    uint32_t kind = sizeof(CharT) == 1 ? ParseCache::SPANS_UTF8 : ParseCache::SPANS_UTF16;
+    uint64_t hash = hashBytes(bytes, size);
+    if (ParseCache::Entry* hit = parseCache.Find(kind, bytes, size, hash)) {
+      return hit->spans;
+    }
+    UrlSpans spans = parseUrl(url, length);
+    parseCache.Insert(kind, bytes, size, hash).spans = spans;
+    return spans;
+  }
+
+
+  // Copy a JS string's UTF-16 code units into a per-thread buffer reused across calls.
+  // Spans over it are JS string indices, and no UTF-8 conversion is needed.
+  const char16_t* readUtf16(const Napi::Value& value, size_t& length) {
+    thread_local std::u16string buffer;
+    size_t needed = 0;
+    napi_get_value_string_utf16(value.Env(), value, nullptr, 0, &needed);
+    if (buffer.size() <= needed) {
+      buffer.resize(needed + 1);
+    }
+    napi_get_value_string_utf16(value.Env(), value, &buffer[0], buffer.size(), &length);
+    return buffer.data();
+  }
+
+  Napi::String newString(Napi::Env env, const char* data, size_t length) {
+    return Napi::String::New(env, data, length);
+  }
+
+  Napi::String newString(Napi::Env env, const char16_t* data, size_t length) {
+    return Napi::String::New(env, data, length);
+  }
+
+  // Materialize spans as the { protocol, auth, ... } object; empty parts share one string
+  template <typename CharT>
+  Napi::Object spansToObject(Napi::Env env, const CharT* url, const UrlSpans& spans) {
+    static const char* const names[COMPONENT_COUNT] = {
+      "protocol", "auth", "hostname", "port", "pathname", "search", "hash"
+    };
+
+    Napi::String empty = Napi::String::New(env, "");
+    Napi::Object result = Napi::Object::New(env);
+    for (uint32_t i = 0; i < COMPONENT_COUNT; i++) {
+      const Span& span = spans.parts[i];
+      result.Set(names[i], span.length == 0 ? empty : newString(env, url + span.offset, span.length));
+    }
+    return result;
   }
 
   Napi::Value Parse(const Napi::CallbackInfo& info) {
@@ -165,35 +232,245 @@ namespace UrlParser {
       return env.Null();
     }
 
-    const char* url;
+    // Avoid string conversion if possible
+    if (info[0].IsBuffer()) {
+      Napi::Buffer<char> buffer = info[0].As<Napi::Buffer<char>>();
+      if (buffer.Length() > UINT32_MAX) {
+        Napi::RangeError::New(env, "URL too long").ThrowAsJavaScriptException();
+        return env.Null();
+      }
+      return spansToObject(env, buffer.Data(), cachedParseUrl(buffer.Data(), buffer.Length()));
+    }
+
     size_t length;
-    std::string urlStr;
+    const char16_t* url = readUtf16(info[0], length);
+    return spansToObject(env, url, cachedParseUrl(url, length));
+  }
 
-    // Avoid string conversion if possible
+  // Parse into a packed Uint32Array of (offset, length) pairs, one per component.
+  // Offsets are string indices for string input and byte offsets for Buffer input.
+  // Passing a Uint32Array to reuse makes the call allocation-free.
+  Napi::Value ParseSpans(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || (!info[0].IsString() && !info[0].IsBuffer())) {
+      Napi::TypeError::New(env, "String or Buffer expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    Napi::Uint32Array out;
+    if (info.Length() > 1 && !info[1].IsUndefined()) {
+      if (!info[1].IsTypedArray() ||
+          info[1].As<Napi::TypedArray>().TypedArrayType() != napi_uint32_array ||
+          info[1].As<Napi::TypedArray>().ElementLength() < COMPONENT_COUNT * 2) {
+        Napi::TypeError::New(env, "Uint32Array of at least 14 elements expected").ThrowAsJavaScriptException();
+        return env.Null();
+      }
+      out = info[1].As<Napi::Uint32Array>();
+    } else {
+      out = Napi::Uint32Array::New(env, COMPONENT_COUNT * 2);
+    }
+
+    UrlSpans spans;
+    if (info[0].IsBuffer()) {
+      Napi::Buffer<char> buffer = info[0].As<Napi::Buffer<char>>();
+      if (buffer.Length() > UINT32_MAX) {
+        Napi::RangeError::New(env, "URL too long").ThrowAsJavaScriptException();
+        return env.Null();
+      }
+      spans = cachedParseUrl(buffer.Data(), buffer.Length());
+    } else {
+      size_t length;
+      const char16_t* url = readUtf16(info[0], length);
+      spans = cachedParseUrl(url, length);
+    }
+
+    uint32_t* data = out.Data();
+    for (uint32_t i = 0; i < COMPONENT_COUNT; i++) {
+      data[i * 2] = spans.parts[i].offset;
+      data[i * 2 + 1] = spans.parts[i].length;
+    }
+    return out;
+  }
+
+  // Copy a JS string's UTF-8 bytes into a per-thread buffer reused across calls
+  const char* readUtf8(const Napi::Value& value, size_t& length) {
+    thread_local std::string buffer;
+    size_t needed = 0;
+    napi_get_value_string_utf8(value.Env(), value, nullptr, 0, &needed);
+    if (buffer.size() <= needed) {
+      buffer.resize(needed + 1);
+    }
+    napi_get_value_string_utf8(value.Env(), value, &buffer[0], buffer.size(), &length);
+    return buffer.data();
+  }
+
+  // WHATWG URL parse: returns the serialized href and fills `out` with spans over it.
+  // Returns null when the input (or base) is not a valid URL, and undefined when the
+  // host needs IDNA processing, which the caller delegates to Node's URL.
+  Napi::Value ParseWhatwg(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 3 || (!info[0].IsString() && !info[0].IsBuffer()) ||
+        (!info[1].IsString() && !info[1].IsUndefined() && !info[1].IsNull())) {
+      Napi::TypeError::New(env, "String or Buffer input and optional string base expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    if (!info[2].IsTypedArray() ||
+        info[2].As<Napi::TypedArray>().TypedArrayType() != napi_uint32_array ||
+        info[2].As<Napi::TypedArray>().ElementLength() < COMPONENT_COUNT * 2) {
+      Napi::TypeError::New(env, "Uint32Array of at least 14 elements expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    // Most callers resolve many inputs against the same base; keep the last one parsed
+    thread_local std::string lastBase;
+    thread_local WhatwgUrl::Url baseUrl;
+    thread_local WhatwgUrl::Status baseStatus = WhatwgUrl::Status::FAILURE;
+
+    const WhatwgUrl::Url* base = nullptr;
+    if (info[1].IsString()) {
+      std::string baseInput = info[1].As<Napi::String>().Utf8Value();
+      if (baseInput != lastBase || lastBase.empty()) {
+        baseStatus = WhatwgUrl::Parse(baseInput.data(), baseInput.size(), nullptr, baseUrl);
+        lastBase.swap(baseInput);
+      }
+      if (baseStatus == WhatwgUrl::Status::FAILURE) {
+        return env.Null();
+      }
+      if (baseStatus == WhatwgUrl::Status::NEEDS_IDNA) {
+        return env.Undefined();
+      }
+      base = &baseUrl;
+    }
+
+    const char* input;
+    size_t length;
     if (info[0].IsBuffer()) {
       Napi::Buffer<char> buffer = info[0].As<Napi::Buffer<char>>();
-      url = buffer.Data();
+      input = buffer.Data();
       length = buffer.Length();
     } else {
-      urlStr = info[0].As<Napi::String>().Utf8Value();
-      url = urlStr.c_str();
-      length = urlStr.length();
+      input = readUtf8(info[0], length);
+    }
+    if (length > UINT32_MAX) {
+      Napi::RangeError::New(env, "URL too long").ThrowAsJavaScriptException();
+      return env.Null();
     }
 
-    UrlParts parts = parseUrl(url, length);
+    thread_local WhatwgUrl::Url url;
+    WhatwgUrl::Status status = WhatwgUrl::Parse(input, length, base, url);
+    if (status == WhatwgUrl::Status::FAILURE) {
+      return env.Null();
+    }
+    if (status == WhatwgUrl::Status::NEEDS_IDNA) {
+      return env.Undefined();
+    }
 
-    Napi::Object result = Napi::Object::New(env);
-    result.Set("protocol", Napi::String::New(env, parts.protocol));
-    result.Set("auth", Napi::String::New(env, parts.auth));
-    result.Set("hostname", Napi::String::New(env, parts.hostname));
-    result.Set("port", Napi::String::New(env, parts.port));
-    result.Set("pathname", Napi::String::New(env, parts.pathname));
-    result.Set("search", Napi::String::New(env, parts.search));
-    result.Set("hash", Napi::String::New(env, parts.hash));
+    // href is ASCII, so byte offsets are also string indices
+    uint32_t* data = info[2].As<Napi::Uint32Array>().Data();
+    for (uint32_t i = 0; i < COMPONENT_COUNT; i++) {
+      data[i * 2] = url.spans.parts[i].offset;
+      data[i * 2 + 1] = url.spans.parts[i].length;
+    }
+    return Napi::String::New(env, url.href);
+  }
 
-    return result;
+  struct QueryOptions {
+    bool nested = false;             // Repeated keys become arrays and "a[b][]" keys build objects and arrays
+    uint32_t depth = 5;              // Bracket segments honoured per key
+    uint32_t parameterLimit = 1000;  // Parameters past this are ignored
+    uint32_t arrayLimit = 20;        // Largest explicit index ("a[20]") treated as an array slot
+  };
+
+  bool parseArrayIndex(std::string_view segment, uint32_t limit, uint32_t& index) {
+    if (segment.empty() || segment.size() > 10 || (segment.size() > 1 && segment[0] == '0')) {
+      return false;
+    }
+    uint64_t value = 0;
+    for (char c : segment) {
+      if (c < '0' || c > '9') {
+        return false;
+      }
+      value = value * 10 + static_cast<uint64_t>(c - '0');
+    }
+    if (value > limit) {
+      return false;
+    }
+    index = static_cast<uint32_t>(value);
+    return true;
+  }
+
+  Napi::Object arrayToObject(Napi::Env env, Napi::Array array) {
+    Napi::Object object = Napi::Object::New(env);
+    for (uint32_t i = 0; i < array.Length(); i++) {
+      object.Set(i, array.Get(i));
+    }
+    return object;
+  }
+
+  // A repeated key: a single value becomes a two-element array, an array grows
+  Napi::Value combineQueryValue(Napi::Env env, Napi::Value existing, Napi::Value value) {
+    if (existing.IsArray()) {
+      Napi::Array array = existing.As<Napi::Array>();
+      array.Set(array.Length(), value);
+      return array;
+    }
+    Napi::Array array = Napi::Array::New(env, 2);
+    array.Set(0u, existing);
+    array.Set(1u, value);
+    return array;
   }
 
+  // Store value under container[segments[i]][segments[i + 1]]... Returns the container,
+  // which is replaced by an equivalent object when an array receives a non-index key.
+  Napi::Object assignQueryValue(Napi::Env env, Napi::Object container, const std::vector<std::string_view>& segments,
+                                size_t i, Napi::Value value, const QueryOptions& options) {
+    std::string_view segment = segments[i];
+    uint32_t index = 0;
+    bool isIndex = segment.empty() || parseArrayIndex(segment, options.arrayLimit, index);
+
+    Napi::Value key;
+    if (container.IsArray() && isIndex) {
+      // "a[]" appends; explicit indices past the end are compacted
+      uint32_t length = container.As<Napi::Array>().Length();
+      key = Napi::Number::New(env, (segment.empty() || index > length) ? length : index);
+    } else {
+      if (container.IsArray()) {
+        container = arrayToObject(env, container.As<Napi::Array>());
+      }
+      key = (segment.empty() && i > 0) ? Napi::Value(Napi::Number::New(env, container.GetPropertyNames().Length()))
+                            : Napi::Value(Napi::String::New(env, segment.data(), segment.size()));
+    }
+
+    bool exists = container.HasOwnProperty(key);
+    if (i + 1 == segments.size()) {
+      container.Set(key, exists ? combineQueryValue(env, container.Get(key), value) : value);
+      return container;
+    }
+
+    Napi::Object child;
+    Napi::Value existing = exists ? container.Get(key) : env.Undefined();
+    if (existing.IsObject()) {
+      child = existing.As<Napi::Object>();
+    } else if (exists) {
+      // A plain value already stored here keeps its place as element 0
+      Napi::Array array = Napi::Array::New(env, 1);
+      array.Set(0u, existing);
+      child = array;
+    } else {
+      std::string_view next = segments[i + 1];
+      uint32_t ignored;
+      bool nextIsIndex = next.empty() || parseArrayIndex(next, options.arrayLimit, ignored);
+      child = nextIsIndex ? Napi::Object(Napi::Array::New(env)) : Napi::Object::New(env);
+    }
+    container.Set(key, assignQueryValue(env, child, segments, i + 1, value, options));
+    return container;
+  }
+
+  // Parse a query string into an object, percent- and '+'-decoding keys and values.
+  // Keys keep their first-seen order. By default a repeated key keeps its last value;
+  // with { nested: true } repeated keys collect into arrays and bracket keys nest.
   Napi::Value ParseQueryString(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
 
@@ -202,26 +479,77 @@ namespace UrlParser {
       return env.Null();
     }
 
-    const char* queryString;
+    QueryOptions options;
+    if (info.Length() > 1 && info[1].IsObject()) {
+      Napi::Object opts = info[1].As<Napi::Object>();
+      if (opts.Has("nested") && opts.Get("nested").IsBoolean()) {
+        options.nested = opts.Get("nested").As<Napi::Boolean>().Value();
+      }
+      if (opts.Has("depth") && opts.Get("depth").IsNumber()) {
+        options.depth = opts.Get("depth").As<Napi::Number>().Uint32Value();
+      }
+      if (opts.Has("parameterLimit") && opts.Get("parameterLimit").IsNumber()) {
+        options.parameterLimit = opts.Get("parameterLimit").As<Napi::Number>().Uint32Value();
+      }
+      if (opts.Has("arrayLimit") && opts.Get("arrayLimit").IsNumber()) {
+        options.arrayLimit = opts.Get("arrayLimit").As<Napi::Number>().Uint32Value();
+      }
+    }
+
+    const char* query;
     size_t length;
-    std::string queryStr;
 
     // Avoid string conversion if possible
     if (info[0].IsBuffer()) {
       Napi::Buffer<char> buffer = info[0].As<Napi::Buffer<char>>();
-      queryString = buffer.Data();
+      query = buffer.Data();
       length = buffer.Length();
     } else {
-      queryStr = info[0].As<Napi::String>().Utf8Value();
-      queryString = queryStr.c_str();
-      length = queryStr.length();
+      query = readUtf8(info[0], length);
     }
 
-    auto queryParams = parseQueryString(queryString, length);
+    // Repeated query strings skip decoding: the cache holds their decoded pairs
+    thread_local DecodedQuery scratch;
+    const DecodedQuery* decoded = &scratch;
+    if (parseCache.Cacheable(length)) {
+      uint64_t hash = hashBytes(query, length) ^ (options.parameterLimit * 0x9e3779b97f4a7c15ULL);
+      if (ParseCache::Entry* hit = parseCache.Find(ParseCache::QUERY, query, length, hash)) {
+        decoded = &hit->query;
+      } else {
+        ParseCache::Entry& entry = parseCache.Insert(ParseCache::QUERY, query, length, hash);
+        decodeQuery(query, length, options.parameterLimit, entry.query);
+        decoded = &entry.query;
+      }
+    } else {
+      decodeQuery(query, length, options.parameterLimit, scratch);
+    }
 
+    thread_local std::vector<std::string_view> segments;
     Napi::Object result = Napi::Object::New(env);
-    for (const auto& pair : queryParams) {
-      result.Set(pair.first, Napi::String::New(env, pair.second));
+    Napi::String empty = Napi::String::New(env, "");
+
+    const std::string& text = decoded->text;
+    const std::vector<Span>& pairs = decoded->pairs;
+    for (size_t i = 0; i + 1 < pairs.size(); i += 2) {
+      std::string_view key(text.data() + pairs[i].offset, pairs[i].length);
+      const Span& value = pairs[i + 1];
+      Napi::String jsValue = value.length == 0 ? empty : Napi::String::New(env, text.data() + value.offset, value.length);
+
+      if (!options.nested) {
+        if (key != "__proto__") {
+          result.Set(Napi::String::New(env, key.data(), key.size()), jsValue);
+        }
+        continue;
+      }
+
+      splitQueryKey(key, options.depth, segments);
+      bool polluting = false;
+      for (std::string_view segment : segments) {
+        polluting = polluting || segment == "__proto__";
+      }
+      if (!polluting) {
+        assignQueryValue(env, result, segments, 0, jsValue, options);
+      }
     }
 
     return result;
@@ -338,26 +666,147 @@ namespace UrlParser {
         result += '&';
       }
 
-      result += key.As<Napi::String>().Utf8Value();
+      std::string keyStr = key.As<Napi::String>().Utf8Value();
+      UrlScan::AppendComponentEncoded(keyStr.data(), keyStr.size(), result);
       result += '=';
 
       if (value.IsString()) {
-        result += value.As<Napi::String>().Utf8Value();
+        std::string valueStr = value.As<Napi::String>().Utf8Value();
+        UrlScan::AppendComponentEncoded(valueStr.data(), valueStr.size(), result);
       } else if (!value.IsNull() && !value.IsUndefined()) {
         // Convert non-string values to string
-        Napi::String strValue = value.ToString();
-        result += strValue.Utf8Value();
+        std::string valueStr = value.ToString().Utf8Value();
+        UrlScan::AppendComponentEncoded(valueStr.data(), valueStr.size(), result);
       }
     }
 
     return Napi::String::New(env, result);
   }
 
+  // V8 turns lone surrogates into U+FFFD when producing UTF-8; only then is the
+  // UTF-16 needed to tell them apart from a real U+FFFD
+  bool hasLoneSurrogate(const Napi::Value& value, const char* utf8, size_t length) {
+    std::string_view bytes(utf8, length);
+    if (bytes.find("\xEF\xBF\xBD") == std::string_view::npos) {
+      return false;
+    }
+    size_t units;
+    const char16_t* data = readUtf16(value, units);
+    for (size_t i = 0; i < units; i++) {
+      if (data[i] >= 0xd800 && data[i] <= 0xdbff && i + 1 < units && data[i + 1] >= 0xdc00 && data[i + 1] <= 0xdfff) {
+        i++;
+      } else if (data[i] >= 0xd800 && data[i] <= 0xdfff) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // decodeURIComponent: returns undefined where the builtin would throw (malformed
+  // escapes) or where UTF-8 cannot represent the input (lone surrogates), so the
+  // caller can defer to the builtin for its exact result.
+  Napi::Value DecodeComponent(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || (!info[0].IsString() && !info[0].IsBuffer())) {
+      Napi::TypeError::New(env, "String or Buffer expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    const char* input;
+    size_t length;
+    if (info[0].IsBuffer()) {
+      Napi::Buffer<char> buffer = info[0].As<Napi::Buffer<char>>();
+      input = buffer.Data();
+      length = buffer.Length();
+    } else {
+      input = readUtf8(info[0], length);
+      // Nothing to decode: hand back the same string
+      if (UrlScan::FindEscape(input, 0, length, false) == length) {
+        return info[0];
+      }
+      if (hasLoneSurrogate(info[0], input, length)) {
+        return env.Undefined();
+      }
+    }
+
+    thread_local std::string decoded;
+    decoded.clear();
+    if (!UrlScan::AppendComponentDecoded(input, length, decoded)) {
+      return env.Undefined();
+    }
+    return Napi::String::New(env, decoded.data(), decoded.size());
+  }
+
+  // encodeURIComponent: returns undefined for lone surrogates, where the builtin throws
+  Napi::Value EncodeComponent(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || (!info[0].IsString() && !info[0].IsBuffer())) {
+      Napi::TypeError::New(env, "String or Buffer expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    const char* input;
+    size_t length;
+    if (info[0].IsBuffer()) {
+      Napi::Buffer<char> buffer = info[0].As<Napi::Buffer<char>>();
+      input = buffer.Data();
+      length = buffer.Length();
+    } else {
+      input = readUtf8(info[0], length);
+      if (UrlScan::FindComponentUnsafe(input, 0, length) == length) {
+        return info[0];
+      }
+      if (hasLoneSurrogate(info[0], input, length)) {
+        return env.Undefined();
+      }
+    }
+
+    thread_local std::string encoded;
+    encoded.clear();
+    encoded.reserve(length + length / 2);
+    UrlScan::AppendComponentEncoded(input, length, encoded);
+    return Napi::String::New(env, encoded.data(), encoded.size());
+  }
+
+  // Size the calling thread's parse cache (entries, rounded up to a power of two); 0 disables it
+  Napi::Value ConfigureParseCache(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsNumber() || info[0].As<Napi::Number>().DoubleValue() < 0) {
+      Napi::TypeError::New(env, "Non-negative capacity expected").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    parseCache.SetCapacity(info[0].As<Napi::Number>().Uint32Value());
+    return Napi::Number::New(env, static_cast<double>(parseCache.Capacity()));
+  }
+
+  Napi::Value GetParseCacheStats(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    Napi::Object stats = Napi::Object::New(env);
+    stats.Set("capacity", Napi::Number::New(env, static_cast<double>(parseCache.Capacity())));
+    stats.Set("size", Napi::Number::New(env, static_cast<double>(parseCache.Size())));
+    stats.Set("hits", Napi::Number::New(env, static_cast<double>(parseCache.Hits())));
+    stats.Set("misses", Napi::Number::New(env, static_cast<double>(parseCache.Misses())));
+    stats.Set("evictions", Napi::Number::New(env, static_cast<double>(parseCache.Evictions())));
+    return stats;
+  }
+
   Napi::Object Init(Napi::Env env, Napi::Object exports) {
     exports.Set("parse", Napi::Function::New(env, Parse));
+    exports.Set("parseSpans", Napi::Function::New(env, ParseSpans));
+    exports.Set("parseWhatwg", Napi::Function::New(env, ParseWhatwg));
+    exports.Set("parseBatch", Napi::Function::New(env, ParseBatch));
+    exports.Set("buildUrl", Napi::Function::New(env, BuildUrl));
     exports.Set("parseQueryString", Napi::Function::New(env, ParseQueryString));
     exports.Set("format", Napi::Function::New(env, Format));
     exports.Set("formatQueryString", Napi::Function::New(env, FormatQueryString));
+    exports.Set("decodeURIComponent", Napi::Function::New(env, DecodeComponent));
+    exports.Set("configureParseCache", Napi::Function::New(env, ConfigureParseCache));
+    exports.Set("getParseCacheStats", Napi::Function::New(env, GetParseCacheStats));
+    exports.Set("encodeURIComponent", Napi::Function::New(env, EncodeComponent));
     return exports;
   }
 
@@ -2,8 +2,65 @@
 #define URL_PARSER_H
 
 #include <napi.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 
 namespace UrlParser {
+
+  // URL components, in the order they appear in packed span arrays
+  enum Component : uint32_t {
+    PROTOCOL = 0,
+    AUTH,
+    HOSTNAME,
+    PORT,
+    PATHNAME,
+    SEARCH,
+    HASH,
+    COMPONENT_COUNT
+  };
+
+  // A component as (offset, length) into the input, counted in input code units
+  struct Span {
+    uint32_t offset = 0;
+    uint32_t length = 0;
+  };
+
+  struct UrlSpans {
+    Span parts[COMPONENT_COUNT];
+  };
+
+  // Locate the components of a URL without copying them.
+  // Instantiated for UTF-8 bytes (char) and JS string code units (char16_t).
+  template <typename CharT>
+  UrlSpans parseUrl(const CharT* url, size_t length);
+
+  // Split a query string into raw key/value ranges, stopping after `limit` parameters.
+  // A leading '?' is skipped and empty parameters ("a=1&&b=2") are ignored.
+  template <typename Callback>
+  void forEachQueryParam(const char* query, size_t length, uint32_t limit, Callback&& callback) {
+    size_t pos = (length > 0 && query[0] == '?') ? 1 : 0;
+    uint32_t count = 0;
+    while (pos < length && count < limit) {
+      const char* amp = static_cast<const char*>(std::memchr(query + pos, '&', length - pos));
+      size_t end = amp ? static_cast<size_t>(amp - query) : length;
+      if (end > pos) {
+        const char* eq = static_cast<const char*>(std::memchr(query + pos, '=', end - pos));
+        size_t keyEnd = eq ? static_cast<size_t>(eq - query) : end;
+        size_t valueStart = eq ? keyEnd + 1 : end;
+        callback(query + pos, keyEnd - pos, query + valueStart, end - valueStart);
+        count++;
+      }
+      pos = end + 1;
+    }
+  }
+
+  // parseBatch(buffer, offsets, options?): columnar spans for many packed URLs (url_batch.cc)
+  Napi::Value ParseBatch(const Napi::CallbackInfo& info);
+
+  // buildUrl(base, overrides, out, offset, ...): URL with query overrides into a Buffer (url_builder.cc)
+  Napi::Value BuildUrl(const Napi::CallbackInfo& info);
+
   Napi::Object Init(Napi::Env env, Napi::Object exports);
 }
 
@@ -0,0 +1,362 @@
+#ifndef URL_SCAN_H
+#define URL_SCAN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define URL_SCAN_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define URL_SCAN_NEON 1
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/**
+ * Byte scanning and percent-encoding helpers shared by the URL parsers
+ *
+ * URLs are overwhelmingly plain printable ASCII. The scanners skip such runs
+ * 16 bytes at a time and stop at anything a parser state has to look at:
+ * controls, space, DEL, non-ASCII bytes and a short list of delimiters.
+ */
+namespace UrlScan {
+
+  inline unsigned CountTrailingZeros(uint32_t mask) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+  }
+
+  // Stop set: controls, space, DEL, bytes >= 0x80 and up to 16 listed printable delimiters
+  class StopSet {
+  public:
+    constexpr explicit StopSet(const char* delimiters) : table_(), delimiters_(), count_(0) {
+      for (int c = 0; c < 256; c++) {
+        table_[c] = c <= 0x20 || c >= 0x7f;
+      }
+      for (const char* p = delimiters; *p != '\0' && count_ < 16; p++) {
+        table_[static_cast<unsigned char>(*p)] = true;
+        delimiters_[count_++] = *p;
+      }
+    }
+
+    bool Contains(unsigned char c) const { return table_[c]; }
+
+    // Index of the first byte in [pos, end) that is in the set, or end
+    size_t Find(const char* data, size_t pos, size_t end) const {
+#if defined(URL_SCAN_SSE2)
+      // Signed compare: bytes below 0x21 and bytes >= 0x80 (negative) both match
+      const __m128i limit = _mm_set1_epi8(0x21);
+      const __m128i del = _mm_set1_epi8(0x7f);
+      while (pos + 16 <= end) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+        __m128i hits = _mm_or_si128(_mm_cmplt_epi8(chunk, limit), _mm_cmpeq_epi8(chunk, del));
+        for (size_t i = 0; i < count_; i++) {
+          hits = _mm_or_si128(hits, _mm_cmpeq_epi8(chunk, _mm_set1_epi8(delimiters_[i])));
+        }
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(hits));
+        if (mask != 0) {
+          return pos + CountTrailingZeros(mask);
+        }
+        pos += 16;
+      }
+#elif defined(URL_SCAN_NEON)
+      const uint8x16_t limit = vdupq_n_u8(0x21);
+      const uint8x16_t del = vdupq_n_u8(0x7f);
+      while (pos + 16 <= end) {
+        uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(data + pos));
+        uint8x16_t hits = vorrq_u8(vcltq_u8(chunk, limit), vcgeq_u8(chunk, del));
+        for (size_t i = 0; i < count_; i++) {
+          hits = vorrq_u8(hits, vceqq_u8(chunk, vdupq_n_u8(static_cast<uint8_t>(delimiters_[i]))));
+        }
+        uint64x2_t halves = vreinterpretq_u64_u8(hits);
+        if ((vgetq_lane_u64(halves, 0) | vgetq_lane_u64(halves, 1)) != 0) {
+          break;  // The scalar loop pinpoints the byte
+        }
+        pos += 16;
+      }
+#endif
+      while (pos < end && !table_[static_cast<unsigned char>(data[pos])]) {
+        pos++;
+      }
+      return pos;
+    }
+
+  private:
+    bool table_[256];
+    char delimiters_[16];
+    size_t count_;
+  };
+
+  // Percent-encode set: bytes replaced by %XX when copied into a URL component
+  struct EncodeSet {
+    bool encode[256];
+    // Every encode set contains the C0 controls and all bytes above 0x7E
+    constexpr explicit EncodeSet(const char* extra) : encode() {
+      for (int c = 0; c < 256; c++) {
+        encode[c] = c < 0x20 || c > 0x7e;
+      }
+      for (const char* p = extra; *p != '\0'; p++) {
+        encode[static_cast<unsigned char>(*p)] = true;
+      }
+    }
+  };
+
+  // WHATWG URL percent-encode sets, as applied by Node's URL
+  constexpr EncodeSet kC0ControlSet("");
+  constexpr EncodeSet kFragmentSet(" \"<>`");
+  constexpr EncodeSet kQuerySet(" \"#<>");
+  constexpr EncodeSet kSpecialQuerySet(" \"#<>'");
+  constexpr EncodeSet kPathSet(" \"#<>?`{}");
+  constexpr EncodeSet kUserinfoSet(" \"#<>?`{}/:;=@[\\]^|");
+
+  constexpr char kHexUpper[] = "0123456789ABCDEF";
+
+  inline void AppendPercentEncodedByte(unsigned char c, std::string& out) {
+    char escape[3] = {'%', kHexUpper[c >> 4], kHexUpper[c & 0x0f]};
+    out.append(escape, 3);
+  }
+
+  // Append data, percent-encoding members of `set`; `stops` must include every printable member of `set`
+  inline void AppendEncoded(const char* data, size_t length, const StopSet& stops, const EncodeSet& set,
+                            std::string& out) {
+    size_t pos = 0;
+    while (pos < length) {
+      size_t next = stops.Find(data, pos, length);
+      out.append(data + pos, next - pos);
+      if (next == length) {
+        break;
+      }
+      unsigned char c = static_cast<unsigned char>(data[next]);
+      if (set.encode[c]) {
+        AppendPercentEncodedByte(c, out);
+      } else {
+        out += static_cast<char>(c);
+      }
+      pos = next + 1;
+    }
+  }
+
+  // Append data, percent-encoding members of `set` one byte at a time (for short components)
+  inline void AppendEncoded(const char* data, size_t length, const EncodeSet& set, std::string& out) {
+    size_t runStart = 0;
+    for (size_t i = 0; i < length; i++) {
+      unsigned char c = static_cast<unsigned char>(data[i]);
+      if (set.encode[c]) {
+        out.append(data + runStart, i - runStart);
+        AppendPercentEncodedByte(c, out);
+        runStart = i + 1;
+      }
+    }
+    out.append(data + runStart, length - runStart);
+  }
+
+  // Hex digit values, -1 for every other byte
+  struct HexTable {
+    int8_t value[256];
+    constexpr HexTable() : value() {
+      for (int c = 0; c < 256; c++) {
+        value[c] = (c >= '0' && c <= '9') ? static_cast<int8_t>(c - '0')
+                 : (c >= 'a' && c <= 'f') ? static_cast<int8_t>(c - 'a' + 10)
+                 : (c >= 'A' && c <= 'F') ? static_cast<int8_t>(c - 'A' + 10)
+                 : static_cast<int8_t>(-1);
+      }
+    }
+  };
+
+  constexpr HexTable kHexTable;
+
+  inline int HexValue(unsigned char c) {
+    return kHexTable.value[c];
+  }
+
+  // Index of the first '%' (or '+' when plusAsSpace) in [pos, end), or end
+  inline size_t FindEscape(const char* data, size_t pos, size_t end, bool plusAsSpace) {
+#if defined(URL_SCAN_SSE2)
+    const __m128i percent = _mm_set1_epi8('%');
+    // Without plusAsSpace, compare against '%' twice rather than branching per block
+    const __m128i plus = _mm_set1_epi8(plusAsSpace ? '+' : '%');
+    while (pos + 16 <= end) {
+      __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+      __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(chunk, percent), _mm_cmpeq_epi8(chunk, plus));
+      uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(hits));
+      if (mask != 0) {
+        return pos + CountTrailingZeros(mask);
+      }
+      pos += 16;
+    }
+#elif defined(URL_SCAN_NEON)
+    const uint8x16_t percent = vdupq_n_u8('%');
+    const uint8x16_t plus = vdupq_n_u8(plusAsSpace ? '+' : '%');
+    while (pos + 16 <= end) {
+      uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(data + pos));
+      uint8x16_t hits = vorrq_u8(vceqq_u8(chunk, percent), vceqq_u8(chunk, plus));
+      uint64x2_t halves = vreinterpretq_u64_u8(hits);
+      if ((vgetq_lane_u64(halves, 0) | vgetq_lane_u64(halves, 1)) != 0) {
+        break;
+      }
+      pos += 16;
+    }
+#endif
+    while (pos < end && data[pos] != '%' && !(plusAsSpace && data[pos] == '+')) {
+      pos++;
+    }
+    return pos;
+  }
+
+  // Value of the %XX escape at data[pos], or -1 if there is none
+  inline int DecodeEscape(const char* data, size_t pos, size_t length) {
+    if (pos + 2 >= length || data[pos] != '%') {
+      return -1;
+    }
+    int high = kHexTable.value[static_cast<unsigned char>(data[pos + 1])];
+    int low = kHexTable.value[static_cast<unsigned char>(data[pos + 2])];
+    return (high | low) < 0 ? -1 : high * 16 + low;
+  }
+
+  // Append data with %XX escapes decoded, and '+' as space when plusAsSpace.
+  // Malformed escapes are copied through unchanged, as URLSearchParams does.
+  inline void AppendDecoded(const char* data, size_t length, bool plusAsSpace, std::string& out) {
+    size_t pos = 0;
+    while (true) {
+      size_t next = FindEscape(data, pos, length, plusAsSpace);
+      out.append(data + pos, next - pos);
+      if (next == length) {
+        return;
+      }
+      int value = data[next] == '+' ? ' ' : DecodeEscape(data, next, length);
+      if (value < 0) {
+        out += '%';
+        pos = next + 1;
+      } else {
+        out += static_cast<char>(value);
+        pos = next + (data[next] == '+' ? 1 : 3);
+      }
+    }
+  }
+
+  // decodeURIComponent semantics: every escape must be well formed, and escaped bytes
+  // >= 0x80 must form complete, shortest-form UTF-8 sequences made only of escapes.
+  // Returns false where decodeURIComponent would throw URIError.
+  inline bool AppendComponentDecoded(const char* data, size_t length, std::string& out) {
+    static const uint32_t kMinimumCodePoint[4] = {0, 0x80, 0x800, 0x10000};
+    size_t pos = 0;
+    while (true) {
+      size_t next = FindEscape(data, pos, length, false);
+      out.append(data + pos, next - pos);
+      if (next == length) {
+        return true;
+      }
+
+      int lead = DecodeEscape(data, next, length);
+      if (lead < 0) {
+        return false;
+      }
+      pos = next + 3;
+      if (lead < 0x80) {
+        out += static_cast<char>(lead);
+        continue;
+      }
+
+      int extra = lead >= 0xf8 ? -1 : lead >= 0xf0 ? 3 : lead >= 0xe0 ? 2 : lead >= 0xc0 ? 1 : -1;
+      if (extra < 0) {
+        return false;
+      }
+      char sequence[4] = {static_cast<char>(lead), 0, 0, 0};
+      uint32_t codePoint = static_cast<uint32_t>(lead) & (0x3fu >> extra);
+      for (int i = 1; i <= extra; i++) {
+        int continuation = DecodeEscape(data, pos, length);
+        if (continuation < 0 || (continuation & 0xc0) != 0x80) {
+          return false;
+        }
+        codePoint = (codePoint << 6) | static_cast<uint32_t>(continuation & 0x3f);
+        sequence[i] = static_cast<char>(continuation);
+        pos += 3;
+      }
+      if (codePoint < kMinimumCodePoint[extra] || codePoint > 0x10ffff ||
+          (codePoint >= 0xd800 && codePoint <= 0xdfff)) {
+        return false;
+      }
+      out.append(sequence, static_cast<size_t>(extra) + 1);
+    }
+  }
+
+  // encodeURIComponent leaves only alphanumerics and -_.!~*'() unescaped
+  constexpr EncodeSet kComponentSet(" \"#$%&+,/:;<=>?@[\\]^`{|}");
+
+  // Index of the first byte in [pos, end) that encodeURIComponent escapes, or end
+  inline size_t FindComponentUnsafe(const char* data, size_t pos, size_t end) {
+#if defined(URL_SCAN_SSE2)
+    // Safe bytes are the ranges 0-9, A-Z, a-z, '\''..'*', '-'..'.' and the singles ! _ ~.
+    // Signed compares are fine: bytes >= 0x80 are negative and fall outside every range.
+    auto inRange = [](__m128i chunk, char low, char high) {
+      return _mm_and_si128(_mm_cmpgt_epi8(chunk, _mm_set1_epi8(static_cast<char>(low - 1))),
+                           _mm_cmplt_epi8(chunk, _mm_set1_epi8(static_cast<char>(high + 1))));
+    };
+    while (pos + 16 <= end) {
+      __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+      __m128i safe = _mm_or_si128(inRange(chunk, 'a', 'z'), inRange(chunk, 'A', 'Z'));
+      safe = _mm_or_si128(safe, inRange(chunk, '0', '9'));
+      safe = _mm_or_si128(safe, inRange(chunk, '\'', '*'));
+      safe = _mm_or_si128(safe, inRange(chunk, '-', '.'));
+      safe = _mm_or_si128(safe, _mm_cmpeq_epi8(chunk, _mm_set1_epi8('!')));
+      safe = _mm_or_si128(safe, _mm_cmpeq_epi8(chunk, _mm_set1_epi8('_')));
+      safe = _mm_or_si128(safe, _mm_cmpeq_epi8(chunk, _mm_set1_epi8('~')));
+      uint32_t mask = ~static_cast<uint32_t>(_mm_movemask_epi8(safe)) & 0xffff;
+      if (mask != 0) {
+        return pos + CountTrailingZeros(mask);
+      }
+      pos += 16;
+    }
+#elif defined(URL_SCAN_NEON)
+    auto inRange = [](uint8x16_t chunk, uint8_t low, uint8_t high) {
+      return vandq_u8(vcgeq_u8(chunk, vdupq_n_u8(low)), vcleq_u8(chunk, vdupq_n_u8(high)));
+    };
+    while (pos + 16 <= end) {
+      uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(data + pos));
+      uint8x16_t safe = vorrq_u8(inRange(chunk, 'a', 'z'), inRange(chunk, 'A', 'Z'));
+      safe = vorrq_u8(safe, inRange(chunk, '0', '9'));
+      safe = vorrq_u8(safe, inRange(chunk, '\'', '*'));
+      safe = vorrq_u8(safe, inRange(chunk, '-', '.'));
+      safe = vorrq_u8(safe, vceqq_u8(chunk, vdupq_n_u8('!')));
+      safe = vorrq_u8(safe, vceqq_u8(chunk, vdupq_n_u8('_')));
+      safe = vorrq_u8(safe, vceqq_u8(chunk, vdupq_n_u8('~')));
+      uint64x2_t halves = vreinterpretq_u64_u8(safe);
+      if ((vgetq_lane_u64(halves, 0) & vgetq_lane_u64(halves, 1)) != ~0ULL) {
+        break;
+      }
+      pos += 16;
+    }
+#endif
+    while (pos < end && !kComponentSet.encode[static_cast<unsigned char>(data[pos])]) {
+      pos++;
+    }
+    return pos;
+  }
+
+  // encodeURIComponent on UTF-8 input: each byte of a multi-byte character becomes %XX
+  inline void AppendComponentEncoded(const char* data, size_t length, std::string& out) {
+    size_t pos = 0;
+    while (true) {
+      size_t next = FindComponentUnsafe(data, pos, length);
+      out.append(data + pos, next - pos);
+      if (next == length) {
+        return;
+      }
+      AppendPercentEncodedByte(static_cast<unsigned char>(data[next]), out);
+      pos = next + 1;
+    }
+  }
+
+} // namespace UrlScan
+
+#endif // URL_SCAN_H
@@ -0,0 +1,808 @@
+#include "whatwg_url.h"
+#include "url_scan.h"
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace WhatwgUrl {
+
+namespace {
+
+  using UrlParser::Span;
+  using UrlScan::StopSet;
+
+  // Stop sets hold every printable member of the matching encode set plus the
+  // delimiters the parser splits on
+  constexpr StopSet kPathStops("/\\\"<>?`{}#");
+  constexpr StopSet kQueryStops("\"#<>'");
+  constexpr StopSet kFragmentStops("\"<>`");
+  constexpr StopSet kControlStops("");
+
+  // Default port of a special scheme; -1 for file and non-special schemes
+  int DefaultPort(const std::string& scheme) {
+    switch (scheme.size()) {
+      case 2: return scheme == "ws" ? 80 : -1;
+      case 3: return scheme == "wss" ? 443 : (scheme == "ftp" ? 21 : -1);
+      case 4: return scheme == "http" ? 80 : -1;
+      case 5: return scheme == "https" ? 443 : -1;
+      default: return -1;
+    }
+  }
+
+  bool IsAlpha(unsigned char c) {
+    return (c | 0x20) >= 'a' && (c | 0x20) <= 'z';
+  }
+
+  bool IsDigit(unsigned char c) {
+    return c >= '0' && c <= '9';
+  }
+
+  char ToLower(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c | 0x20) : c;
+  }
+
+  bool EqualsIgnoreCase(const char* data, size_t length, const char* literal) {
+    size_t i = 0;
+    for (; i < length && literal[i] != '\0'; i++) {
+      if (ToLower(data[i]) != literal[i]) return false;
+    }
+    return i == length && literal[i] == '\0';
+  }
+
+  bool IsSingleDot(const char* segment, size_t length) {
+    return (length == 1 && segment[0] == '.') || EqualsIgnoreCase(segment, length, "%2e");
+  }
+
+  bool IsDoubleDot(const char* segment, size_t length) {
+    switch (length) {
+      case 2: return segment[0] == '.' && segment[1] == '.';
+      case 4: return EqualsIgnoreCase(segment, length, ".%2e") || EqualsIgnoreCase(segment, length, "%2e.");
+      case 6: return EqualsIgnoreCase(segment, length, "%2e%2e");
+      default: return false;
+    }
+  }
+
+  // "C:" or "C|", optionally followed only by a path, query or fragment delimiter
+  bool StartsWithWindowsDriveLetter(const char* data, size_t length) {
+    return length >= 2 && IsAlpha(data[0]) && (data[1] == ':' || data[1] == '|') &&
+           (length == 2 || data[2] == '/' || data[2] == '\\' || data[2] == '?' || data[2] == '#');
+  }
+
+  bool IsForbiddenHostCodePoint(unsigned char c) {
+    switch (c) {
+      case 0x00: case '\t': case '\n': case '\r': case ' ': case '#': case '/': case ':':
+      case '<': case '>': case '?': case '@': case '[': case '\\': case ']': case '^': case '|':
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  bool IsForbiddenDomainCodePoint(unsigned char c) {
+    return IsForbiddenHostCodePoint(c) || c < 0x20 || c == '%' || c == 0x7f;
+  }
+
+  // --------------------------------------------------------------------
+  // Hosts
+  // --------------------------------------------------------------------
+
+  bool ParseIPv6(const char* data, size_t length, uint16_t (&address)[8]) {
+    std::memset(address, 0, sizeof(address));
+    int pieceIndex = 0;
+    int compress = -1;
+    size_t p = 0;
+
+    auto at = [&](size_t i) -> int {
+      return i < length ? static_cast<unsigned char>(data[i]) : -1;
+    };
+
+    if (at(p) == ':') {
+      if (at(p + 1) != ':') return false;
+      p += 2;
+      pieceIndex++;
+      compress = pieceIndex;
+    }
+
+    while (at(p) != -1) {
+      if (pieceIndex == 8) return false;
+
+      if (at(p) == ':') {
+        if (compress != -1) return false;
+        p++;
+        pieceIndex++;
+        compress = pieceIndex;
+        continue;
+      }
+
+      int value = 0;
+      int digits = 0;
+      while (digits < 4 && at(p) != -1 && UrlScan::HexValue(static_cast<unsigned char>(at(p))) >= 0) {
+        value = value * 16 + UrlScan::HexValue(static_cast<unsigned char>(at(p)));
+        p++;
+        digits++;
+      }
+
+      if (at(p) == '.') {
+        // Embedded IPv4 in the last 32 bits
+        if (digits == 0) return false;
+        p -= digits;
+        if (pieceIndex > 6) return false;
+        int numbersSeen = 0;
+        while (at(p) != -1) {
+          int piece = -1;
+          if (numbersSeen > 0) {
+            if (at(p) == '.' && numbersSeen < 4) {
+              p++;
+            } else {
+              return false;
+            }
+          }
+          if (at(p) == -1 || !IsDigit(static_cast<unsigned char>(at(p)))) return false;
+          while (at(p) != -1 && IsDigit(static_cast<unsigned char>(at(p)))) {
+            int number = at(p) - '0';
+            if (piece == -1) {
+              piece = number;
+            } else if (piece == 0) {
+              return false;
+            } else {
+              piece = piece * 10 + number;
+            }
+            if (piece > 255) return false;
+            p++;
+          }
+          address[pieceIndex] = static_cast<uint16_t>(address[pieceIndex] * 0x100 + piece);
+          numbersSeen++;
+          if (numbersSeen == 2 || numbersSeen == 4) pieceIndex++;
+        }
+        if (numbersSeen != 4) return false;
+        break;
+      } else if (at(p) == ':') {
+        p++;
+        if (at(p) == -1) return false;
+      } else if (at(p) != -1) {
+        return false;
+      }
+
+      address[pieceIndex] = static_cast<uint16_t>(value);
+      pieceIndex++;
+    }
+
+    if (compress != -1) {
+      int swaps = pieceIndex - compress;
+      pieceIndex = 7;
+      while (pieceIndex != 0 && swaps > 0) {
+        uint16_t tmp = address[pieceIndex];
+        address[pieceIndex] = address[compress + swaps - 1];
+        address[compress + swaps - 1] = tmp;
+        pieceIndex--;
+        swaps--;
+      }
+    } else if (pieceIndex != 8) {
+      return false;
+    }
+    return true;
+  }
+
+  void SerializeIPv6(const uint16_t (&address)[8], std::string& out) {
+    // Compress the first longest run of two or more zero pieces
+    int compress = -1;
+    int bestLength = 1;
+    for (int i = 0; i < 8;) {
+      if (address[i] != 0) {
+        i++;
+        continue;
+      }
+      int start = i;
+      while (i < 8 && address[i] == 0) i++;
+      if (i - start > bestLength) {
+        bestLength = i - start;
+        compress = start;
+      }
+    }
+
+    static const char hex[] = "0123456789abcdef";
+    out += '[';
+    for (int i = 0; i < 8; i++) {
+      if (i == compress) {
+        out += (i == 0) ? "::" : ":";
+        i += bestLength - 1;
+        continue;
+      }
+      uint16_t piece = address[i];
+      bool started = false;
+      for (int shift = 12; shift >= 0; shift -= 4) {
+        int nibble = (piece >> shift) & 0xf;
+        if (nibble != 0 || started || shift == 0) {
+          out += hex[nibble];
+          started = true;
+        }
+      }
+      if (i != 7) out += ':';
+    }
+    out += ']';
+  }
+
+  // One dotted part of an IPv4 host: decimal, octal (leading 0) or hex (0x)
+  bool ParseIPv4Number(const char* data, size_t length, uint64_t& value) {
+    if (length == 0) return false;
+    int radix = 10;
+    if (length >= 2 && data[0] == '0' && (data[1] == 'x' || data[1] == 'X')) {
+      radix = 16;
+      data += 2;
+      length -= 2;
+      if (length == 0) {
+        value = 0;
+        return true;
+      }
+    } else if (length >= 2 && data[0] == '0') {
+      radix = 8;
+      data += 1;
+      length -= 1;
+    }
+
+    value = 0;
+    for (size_t i = 0; i < length; i++) {
+      int digit = UrlScan::HexValue(static_cast<unsigned char>(data[i]));
+      if (digit < 0 || digit >= radix) return false;
+      // Saturate: anything past 2^32 is rejected by the caller anyway
+      if (value <= 0xffffffffULL) {
+        value = value * radix + digit;
+      }
+    }
+    return true;
+  }
+
+  // Whether the last (non-empty) label looks numeric, which makes the host an IPv4 address
+  bool EndsInNumber(const std::string& host) {
+    size_t end = host.size();
+    if (end > 0 && host[end - 1] == '.') {
+      end--;
+      if (end == 0) return false;
+    }
+    size_t start = host.rfind('.', end == 0 ? 0 : end - 1);
+    start = (start == std::string::npos) ? 0 : start + 1;
+    if (start >= end) return false;
+
+    bool allDigits = true;
+    for (size_t i = start; i < end; i++) {
+      if (!IsDigit(static_cast<unsigned char>(host[i]))) {
+        allDigits = false;
+        break;
+      }
+    }
+    uint64_t ignored;
+    return allDigits || ParseIPv4Number(host.data() + start, end - start, ignored);
+  }
+
+  bool ParseIPv4(const std::string& host, std::string& out) {
+    uint64_t numbers[4];
+    size_t count = 0;
+    size_t length = host.size();
+    if (length > 0 && host[length - 1] == '.') length--;
+
+    size_t start = 0;
+    while (true) {
+      size_t dot = host.find('.', start);
+      if (dot == std::string::npos || dot > length) dot = length;
+      if (count == 4 || !ParseIPv4Number(host.data() + start, dot - start, numbers[count])) return false;
+      count++;
+      if (dot >= length) break;
+      start = dot + 1;
+    }
+
+    for (size_t i = 0; i + 1 < count; i++) {
+      if (numbers[i] > 255) return false;
+    }
+    if (numbers[count - 1] >= (1ULL << (8 * (5 - count)))) return false;
+
+    uint64_t address = numbers[count - 1];
+    for (size_t i = 0; i + 1 < count; i++) {
+      address += numbers[i] << (8 * (3 - i));
+    }
+
+    out.clear();
+    for (int shift = 24; shift >= 0; shift -= 8) {
+      out += std::to_string((address >> shift) & 0xff);
+      if (shift != 0) out += '.';
+    }
+    return true;
+  }
+
+  Status ParseHost(const char* data, size_t length, bool opaque, std::string& out) {
+    out.clear();
+
+    if (length > 0 && data[0] == '[') {
+      uint16_t address[8];
+      if (length < 2 || data[length - 1] != ']' || !ParseIPv6(data + 1, length - 2, address)) {
+        return Status::FAILURE;
+      }
+      SerializeIPv6(address, out);
+      return Status::OK;
+    }
+
+    // Non-special schemes keep the host as written, minus controls
+    if (opaque) {
+      for (size_t i = 0; i < length; i++) {
+        unsigned char c = static_cast<unsigned char>(data[i]);
+        if (IsForbiddenHostCodePoint(c)) return Status::FAILURE;
+      }
+      UrlScan::AppendEncoded(data, length, UrlScan::kC0ControlSet, out);
+      return Status::OK;
+    }
+
+    // Percent-decode and case-fold the domain
+    out.reserve(length);
+    for (size_t i = 0; i < length; i++) {
+      unsigned char c = static_cast<unsigned char>(data[i]);
+      if (c == '%' && i + 2 < length &&
+          UrlScan::HexValue(static_cast<unsigned char>(data[i + 1])) >= 0 &&
+          UrlScan::HexValue(static_cast<unsigned char>(data[i + 2])) >= 0) {
+        c = static_cast<unsigned char>(UrlScan::HexValue(static_cast<unsigned char>(data[i + 1])) * 16 +
+                                       UrlScan::HexValue(static_cast<unsigned char>(data[i + 2])));
+        i += 2;
+      }
+      if (c >= 0x80) return Status::NEEDS_IDNA;
+      out += ToLower(static_cast<char>(c));
+    }
+
+    if (out.empty()) return Status::FAILURE;
+    for (char c : out) {
+      if (IsForbiddenDomainCodePoint(static_cast<unsigned char>(c))) return Status::FAILURE;
+    }
+
+    // Punycode labels must be validated by a full domain-to-ASCII implementation
+    for (size_t start = 0; start < out.size();) {
+      if (out.compare(start, 4, "xn--") == 0) return Status::NEEDS_IDNA;
+      size_t dot = out.find('.', start);
+      if (dot == std::string::npos) break;
+      start = dot + 1;
+    }
+
+    if (EndsInNumber(out)) {
+      std::string address;
+      if (!ParseIPv4(out, address)) return Status::FAILURE;
+      out.swap(address);
+    }
+    return Status::OK;
+  }
+
+  // --------------------------------------------------------------------
+  // Paths
+  // --------------------------------------------------------------------
+
+  // Remove the last path segment; a file URL's drive letter is never removed
+  void ShortenPath(Url& url) {
+    const std::string& path = url.path;
+    if (url.scheme == "file" && path.size() == 3 && path[0] == '/' &&
+        IsAlpha(static_cast<unsigned char>(path[1])) && path[2] == ':') {
+      return;
+    }
+    size_t slash = path.rfind('/');
+    if (slash != std::string::npos) {
+      url.path.resize(slash);
+    }
+  }
+
+  // Append the segments of data to url.path, resolving "." and ".." as they are seen
+  void ParseSegments(Url& url, const char* data, size_t length) {
+    bool special = url.IsSpecial();
+    bool file = url.scheme == "file";
+    size_t pos = 0;
+
+    while (true) {
+      size_t segmentStart = url.path.size();
+      url.path += '/';
+      bool last = true;
+
+      while (pos < length) {
+        size_t next = kPathStops.Find(data, pos, length);
+        url.path.append(data + pos, next - pos);
+        if (next == length) {
+          pos = length;
+          break;
+        }
+        unsigned char c = static_cast<unsigned char>(data[next]);
+        pos = next + 1;
+        if (c == '/' || (special && c == '\\')) {
+          last = false;
+          break;
+        }
+        if (UrlScan::kPathSet.encode[c]) {
+          UrlScan::AppendPercentEncodedByte(c, url.path);
+        } else {
+          url.path += static_cast<char>(c);
+        }
+      }
+
+      const char* segment = url.path.data() + segmentStart + 1;
+      size_t segmentLength = url.path.size() - segmentStart - 1;
+      if (IsDoubleDot(segment, segmentLength)) {
+        // A final ".." leaves an empty segment behind, except where a non-special
+        // path had nothing left to remove ("sc:/.." is "sc:", as Node's URL gives)
+        url.path.resize(segmentStart);
+        bool removed = !url.path.empty();
+        ShortenPath(url);
+        if (last && (special || removed)) url.path += '/';
+      } else if (IsSingleDot(segment, segmentLength)) {
+        url.path.resize(segmentStart);
+        if (last) url.path += '/';
+      } else if (file && segmentStart == 0 && segmentLength == 2 &&
+                 IsAlpha(static_cast<unsigned char>(segment[0])) && segment[1] == '|') {
+        url.path[segmentStart + 2] = ':';
+      }
+
+      if (last) break;
+    }
+  }
+
+  // --------------------------------------------------------------------
+  // Authority and scheme-specific states
+  // --------------------------------------------------------------------
+
+  // Userinfo, host and port, then the path that follows them
+  Status ParseAuthority(Url& url, const char* data, size_t length) {
+    bool special = url.IsSpecial();
+    size_t end = 0;
+    while (end < length && data[end] != '/' && !(special && data[end] == '\\')) {
+      end++;
+    }
+
+    // Credentials end at the last '@'
+    size_t hostStart = 0;
+    for (size_t i = end; i > 0; i--) {
+      if (data[i - 1] != '@') continue;
+      size_t at = i - 1;
+      const char* colon = static_cast<const char*>(std::memchr(data, ':', at));
+      size_t usernameEnd = colon ? static_cast<size_t>(colon - data) : at;
+      UrlScan::AppendEncoded(data, usernameEnd, UrlScan::kUserinfoSet, url.username);
+      if (colon) {
+        UrlScan::AppendEncoded(colon + 1, at - usernameEnd - 1, UrlScan::kUserinfoSet, url.password);
+      }
+      hostStart = at + 1;
+      if (hostStart == end) return Status::FAILURE;
+      break;
+    }
+
+    // Port separator: first ':' outside an IPv6 literal
+    size_t colon = std::string::npos;
+    bool inBrackets = false;
+    for (size_t i = hostStart; i < end; i++) {
+      if (data[i] == '[') {
+        inBrackets = true;
+      } else if (data[i] == ']') {
+        inBrackets = false;
+      } else if (data[i] == ':' && !inBrackets) {
+        colon = i;
+        break;
+      }
+    }
+
+    size_t hostEnd = colon == std::string::npos ? end : colon;
+    if (hostEnd == hostStart && (special || colon != std::string::npos)) {
+      return Status::FAILURE;
+    }
+
+    Status status = ParseHost(data + hostStart, hostEnd - hostStart, !special, url.host);
+    if (status != Status::OK) return status;
+    url.hasHost = true;
+
+    if (colon != std::string::npos && colon + 1 < end) {
+      uint32_t port = 0;
+      for (size_t i = colon + 1; i < end; i++) {
+        if (!IsDigit(static_cast<unsigned char>(data[i]))) return Status::FAILURE;
+        port = port * 10 + (data[i] - '0');
+        if (port > 65535) return Status::FAILURE;
+      }
+      url.port = static_cast<int>(port) == DefaultPort(url.scheme) ? -1 : static_cast<int>(port);
+    }
+
+    // Special URLs always have a path; the separator after the authority is consumed
+    if (special) {
+      size_t pathStart = end < length ? end + 1 : length;
+      ParseSegments(url, data + pathStart, length - pathStart);
+    } else if (end < length) {
+      ParseSegments(url, data + end + 1, length - end - 1);
+    }
+    return Status::OK;
+  }
+
+  Status ParseFile(Url& url, const char* data, size_t length, const Url* base, bool inputHasQuery) {
+    url.scheme = "file";
+    url.hasHost = true;
+    auto isSlash = [](char c) { return c == '/' || c == '\\'; };
+
+    if (length > 0 && isSlash(data[0])) {
+      if (length > 1 && isSlash(data[1])) {
+        size_t end = 2;
+        while (end < length && !isSlash(data[end])) end++;
+        const char* host = data + 2;
+        size_t hostLength = end - 2;
+
+        // "file://C:/x": the drive letter is the first path segment, not a host
+        if (StartsWithWindowsDriveLetter(host, length - 2) && hostLength == 2) {
+          ParseSegments(url, host, length - 2);
+          return Status::OK;
+        }
+        if (hostLength > 0) {
+          Status status = ParseHost(host, hostLength, false, url.host);
+          if (status != Status::OK) return status;
+          if (url.host == "localhost") url.host.clear();
+        }
+        size_t pathStart = end < length ? end + 1 : length;
+        ParseSegments(url, data + pathStart, length - pathStart);
+        return Status::OK;
+      }
+
+      if (base) {
+        url.host = base->host;
+        const std::string& basePath = base->path;
+        if (!StartsWithWindowsDriveLetter(data + 1, length - 1) && basePath.size() >= 3 &&
+            IsAlpha(static_cast<unsigned char>(basePath[1])) && basePath[2] == ':' &&
+            (basePath.size() == 3 || basePath[3] == '/')) {
+          url.path.assign(basePath, 0, 3);
+        }
+      }
+      ParseSegments(url, data + 1, length - 1);
+      return Status::OK;
+    }
+
+    if (base) {
+      url.host = base->host;
+      url.path = base->path;
+      if (length == 0) {
+        if (!inputHasQuery) {
+          url.query = base->query;
+          url.hasQuery = base->hasQuery;
+        }
+        return Status::OK;
+      }
+      if (StartsWithWindowsDriveLetter(data, length)) {
+        url.path.clear();
+      } else {
+        ShortenPath(url);
+      }
+    }
+    ParseSegments(url, data, length);
+    return Status::OK;
+  }
+
+  // Input without a scheme (or with the base's special scheme) resolved against base
+  Status ParseRelative(Url& url, const char* data, size_t length, const Url& base, bool inputHasQuery) {
+    url.scheme = base.scheme;
+    bool special = url.IsSpecial();
+    auto isSlash = [special](char c) { return c == '/' || (special && c == '\\'); };
+
+    if (length > 0 && isSlash(data[0])) {
+      // Scheme-relative: "//host/path"
+      if (length > 1 && isSlash(data[1])) {
+        size_t pos = 2;
+        while (special && pos < length && isSlash(data[pos])) pos++;
+        return ParseAuthority(url, data + pos, length - pos);
+      }
+      // Path-absolute: keep the base authority
+      url.username = base.username;
+      url.password = base.password;
+      url.host = base.host;
+      url.hasHost = base.hasHost;
+      url.port = base.port;
+      ParseSegments(url, data + 1, length - 1);
+      return Status::OK;
+    }
+
+    url.username = base.username;
+    url.password = base.password;
+    url.host = base.host;
+    url.hasHost = base.hasHost;
+    url.port = base.port;
+    url.path = base.path;
+
+    if (length == 0) {
+      if (!inputHasQuery) {
+        url.query = base.query;
+        url.hasQuery = base.hasQuery;
+      }
+      return Status::OK;
+    }
+
+    ShortenPath(url);
+    ParseSegments(url, data, length);
+    return Status::OK;
+  }
+
+  // Scheme: ASCII alpha followed by alphanumerics, '+', '-' or '.', terminated by ':'
+  bool FindScheme(const char* data, size_t length, size_t& schemeEnd) {
+    if (length == 0 || !IsAlpha(static_cast<unsigned char>(data[0]))) return false;
+    for (size_t i = 1; i < length; i++) {
+      unsigned char c = static_cast<unsigned char>(data[i]);
+      if (c == ':') {
+        schemeEnd = i;
+        return true;
+      }
+      if (!IsAlpha(c) && !IsDigit(c) && c != '+' && c != '-' && c != '.') return false;
+    }
+    return false;
+  }
+
+  Status ParseHead(Url& url, const char* data, size_t length, const Url* base, bool inputHasQuery,
+                   bool inputHasFragment) {
+    size_t schemeEnd;
+    if (FindScheme(data, length, schemeEnd)) {
+      url.scheme.assign(data, schemeEnd);
+      for (char& c : url.scheme) c = ToLower(c);
+      const char* rest = data + schemeEnd + 1;
+      size_t restLength = length - schemeEnd - 1;
+
+      if (url.scheme == "file") {
+        return ParseFile(url, rest, restLength, (base && base->scheme == "file") ? base : nullptr, inputHasQuery);
+      }
+
+      if (url.IsSpecial()) {
+        // "http:foo" against an http base is relative to it
+        if (base && base->scheme == url.scheme && !(restLength >= 2 && rest[0] == '/' && rest[1] == '/')) {
+          return ParseRelative(url, rest, restLength, *base, inputHasQuery);
+        }
+        size_t pos = 0;
+        while (pos < restLength && (rest[pos] == '/' || rest[pos] == '\\')) pos++;
+        return ParseAuthority(url, rest + pos, restLength - pos);
+      }
+
+      if (restLength >= 2 && rest[0] == '/' && rest[1] == '/') {
+        return ParseAuthority(url, rest + 2, restLength - 2);
+      }
+      if (restLength >= 1 && rest[0] == '/') {
+        ParseSegments(url, rest + 1, restLength - 1);
+        return Status::OK;
+      }
+
+      // Opaque path: "mailto:user@example.com"
+      url.opaquePath = true;
+      UrlScan::AppendEncoded(rest, restLength, kControlStops, UrlScan::kC0ControlSet, url.path);
+      return Status::OK;
+    }
+
+    if (!base) return Status::FAILURE;
+
+    if (base->opaquePath) {
+      // Only a fragment can be resolved against an opaque-path base
+      if (length != 0 || inputHasQuery || !inputHasFragment) return Status::FAILURE;
+      url.scheme = base->scheme;
+      url.path = base->path;
+      url.opaquePath = true;
+      url.query = base->query;
+      url.hasQuery = base->hasQuery;
+      return Status::OK;
+    }
+
+    if (base->scheme == "file") {
+      return ParseFile(url, data, length, base, inputHasQuery);
+    }
+    return ParseRelative(url, data, length, *base, inputHasQuery);
+  }
+
+  Span MakeSpan(size_t offset, size_t length) {
+    Span span;
+    span.offset = static_cast<uint32_t>(offset);
+    span.length = static_cast<uint32_t>(length);
+    return span;
+  }
+
+  void Serialize(Url& url) {
+    std::string& href = url.href;
+    UrlParser::Span* spans = url.spans.parts;
+    href.clear();
+    url.spans = UrlParser::UrlSpans();
+
+    spans[UrlParser::PROTOCOL] = MakeSpan(0, url.scheme.size());
+    href += url.scheme;
+    href += ':';
+
+    if (url.hasHost) {
+      href += "//";
+      if (!url.username.empty() || !url.password.empty()) {
+        size_t start = href.size();
+        href += url.username;
+        if (!url.password.empty()) {
+          href += ':';
+          href += url.password;
+        }
+        spans[UrlParser::AUTH] = MakeSpan(start, href.size() - start);
+        href += '@';
+      }
+      spans[UrlParser::HOSTNAME] = MakeSpan(href.size(), url.host.size());
+      href += url.host;
+      if (url.port >= 0) {
+        href += ':';
+        std::string port = std::to_string(url.port);
+        spans[UrlParser::PORT] = MakeSpan(href.size(), port.size());
+        href += port;
+      }
+    } else if (!url.opaquePath && url.path.size() > 1 && url.path[0] == '/' && url.path[1] == '/') {
+      // Keep a host-less "//..." path from reading back as an authority
+      href += "/.";
+    }
+
+    spans[UrlParser::PATHNAME] = MakeSpan(href.size(), url.path.size());
+    href += url.path;
+
+    if (url.hasQuery) {
+      href += '?';
+      spans[UrlParser::SEARCH] = MakeSpan(href.size(), url.query.size());
+      href += url.query;
+    }
+    if (url.hasFragment) {
+      href += '#';
+      spans[UrlParser::HASH] = MakeSpan(href.size(), url.fragment.size());
+      href += url.fragment;
+    }
+  }
+
+  // Clear every field but keep string capacity, so a reused Url parses without allocating
+  void Reset(Url& url) {
+    url.scheme.clear();
+    url.username.clear();
+    url.password.clear();
+    url.host.clear();
+    url.hasHost = false;
+    url.port = -1;
+    url.path.clear();
+    url.opaquePath = false;
+    url.query.clear();
+    url.hasQuery = false;
+    url.fragment.clear();
+    url.hasFragment = false;
+  }
+
+} // namespace
+
+bool Url::IsSpecial() const {
+  return DefaultPort(scheme) != -1 || scheme == "file";
+}
+
+Status Parse(const char* input, size_t length, const Url* base, Url& out) {
+  // Strip leading and trailing C0 controls and spaces
+  size_t begin = 0;
+  size_t end = length;
+  while (begin < end && static_cast<unsigned char>(input[begin]) <= 0x20) begin++;
+  while (end > begin && static_cast<unsigned char>(input[end - 1]) <= 0x20) end--;
+
+  const char* data = input + begin;
+  size_t size = end - begin;
+
+  // Tabs and newlines are ignored anywhere in the input
+  std::string cleaned;
+  if (std::memchr(data, '\t', size) || std::memchr(data, '\n', size) || std::memchr(data, '\r', size)) {
+    cleaned.reserve(size);
+    for (size_t i = 0; i < size; i++) {
+      if (data[i] != '\t' && data[i] != '\n' && data[i] != '\r') cleaned += data[i];
+    }
+    data = cleaned.data();
+    size = cleaned.size();
+  }
+
+  Reset(out);
+
+  // The fragment starts at the first '#', the query at the first '?' before it
+  const char* hash = static_cast<const char*>(std::memchr(data, '#', size));
+  size_t headEnd = hash ? static_cast<size_t>(hash - data) : size;
+  const char* question = static_cast<const char*>(std::memchr(data, '?', headEnd));
+  size_t pathEnd = question ? static_cast<size_t>(question - data) : headEnd;
+
+  Status status = ParseHead(out, data, pathEnd, base, question != nullptr, hash != nullptr);
+  if (status != Status::OK) return status;
+
+  if (question) {
+    out.hasQuery = true;
+    out.query.clear();
+    UrlScan::AppendEncoded(question + 1, headEnd - pathEnd - 1, kQueryStops,
+                           out.IsSpecial() ? UrlScan::kSpecialQuerySet : UrlScan::kQuerySet, out.query);
+  }
+  if (hash) {
+    out.hasFragment = true;
+    UrlScan::AppendEncoded(hash + 1, size - headEnd - 1, kFragmentStops, UrlScan::kFragmentSet, out.fragment);
+  }
+
+  Serialize(out);
+  return Status::OK;
+}
+
+} // namespace WhatwgUrl
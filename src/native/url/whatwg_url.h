@@ -0,0 +1,56 @@
+#ifndef WHATWG_URL_H
+#define WHATWG_URL_H
+
+#include <cstddef>
+#include <string>
+#include "url_parser.h"
+
+/**
+ * WHATWG URL Standard parser
+ *
+ * Produces the same serialization as Node's URL: scheme and host case
+ * folding, IPv4/IPv6 host normalization, default port removal, dot-segment
+ * removal, backslash handling for special schemes, per-component
+ * percent-encoding and relative resolution against a base URL. The result is
+ * the serialized href plus UrlParser spans over it, so callers read
+ * components the same way as from UrlParser::parseUrl.
+ *
+ * Hosts that need IDNA processing (non-ASCII or "xn--" labels) are reported
+ * as NEEDS_IDNA rather than approximated; callers hand those to a full
+ * UTS #46 implementation.
+ */
+namespace WhatwgUrl {
+
+  enum class Status {
+    OK = 0,
+    FAILURE = 1,     // Not a valid URL (new URL() would throw)
+    NEEDS_IDNA = 2   // Valid ASCII structure, but the host needs domain-to-ASCII
+  };
+
+  // Parsed URL record; serialized into href with spans whenever it is produced by Parse
+  struct Url {
+    std::string scheme;
+    std::string username;
+    std::string password;
+    std::string host;
+    bool hasHost = false;
+    int port = -1;
+    std::string path;          // Serialized path: "" or "/seg/seg", or the opaque path
+    bool opaquePath = false;
+    std::string query;
+    bool hasQuery = false;
+    std::string fragment;
+    bool hasFragment = false;
+
+    std::string href;
+    UrlParser::UrlSpans spans;
+
+    bool IsSpecial() const;
+  };
+
+  // Parse UTF-8 input, optionally against a base URL produced by an earlier Parse
+  Status Parse(const char* input, size_t length, const Url* base, Url& out);
+
+} // namespace WhatwgUrl
+
+#endif // WHATWG_URL_H
@@ -0,0 +1,399 @@
+/**
+ * MessagePack and CBOR codecs
+ *
+ * JavaScript implementation of the binary formats supported by the native
+ * JsonProcessor (encode/decode). Used as the fallback when the native module
+ * is unavailable; both produce the same encodings for the same values.
+ */
+
+export type BinaryFormat = 'msgpack' | 'cbor';
+
+const MAX_DEPTH = 512;
+const MSGPACK_TIMESTAMP_EXT = -1;
+
+/**
+ * Growable output buffer
+ */
+class ByteWriter {
+  private buffer = Buffer.allocUnsafe(1024);
+  private length = 0;
+
+  private ensure(extra: number): void {
+    if (this.length + extra > this.buffer.length) {
+      const next = Buffer.allocUnsafe(Math.max(this.buffer.length * 2, this.length + extra));
+      this.buffer.copy(next, 0, 0, this.length);
+      this.buffer = next;
+    }
+  }
+
+  byte(value: number): void {
+    this.ensure(1);
+    this.buffer[this.length++] = value & 0xff;
+  }
+
+  uint(value: number | bigint, bytes: number): void {
+    this.ensure(bytes);
+    if (bytes === 8) {
+      this.buffer.writeBigUInt64BE(BigInt.asUintN(64, BigInt(value)), this.length);
+    } else {
+      this.buffer.writeUIntBE(Number(value), this.length, bytes);
+    }
+    this.length += bytes;
+  }
+
+  float64(value: number): void {
+    this.ensure(8);
+    this.buffer.writeDoubleBE(value, this.length);
+    this.length += 8;
+  }
+
+  bytes(data: Uint8Array): void {
+    this.ensure(data.length);
+    this.buffer.set(data, this.length);
+    this.length += data.length;
+  }
+
+  result(): Buffer {
+    return Buffer.from(this.buffer.subarray(0, this.length));
+  }
+}
+
+/**
+ * Encode a value as MessagePack or CBOR
+ * @param value Value to encode
+ * @param format Output format (default msgpack)
+ */
+export function encodeBinary(value: any, format: BinaryFormat = 'msgpack'): Buffer {
+  const out = new ByteWriter();
+  const cbor = format === 'cbor';
+
+  const cborHead = (major: number, argument: number | bigint): void => {
+    const prefix = major << 5;
+    const n = BigInt(argument);
+    if (n < 24n) {
+      out.byte(prefix | Number(n));
+    } else if (n <= 0xffn) {
+      out.byte(prefix | 24);
+      out.uint(n, 1);
+    } else if (n <= 0xffffn) {
+      out.byte(prefix | 25);
+      out.uint(n, 2);
+    } else if (n <= 0xffffffffn) {
+      out.byte(prefix | 26);
+      out.uint(n, 4);
+    } else {
+      out.byte(prefix | 27);
+      out.uint(n, 8);
+    }
+  };
+
+  // Length header for strings (2), binaries (3), arrays (4) and maps (5)
+  const header = (kind: 'str' | 'bin' | 'array' | 'map', length: number): void => {
+    if (cbor) {
+      cborHead({ bin: 2, str: 3, array: 4, map: 5 }[kind], length);
+      return;
+    }
+    if (kind === 'str' && length < 32) return out.byte(0xa0 | length);
+    if ((kind === 'array' || kind === 'map') && length < 16) {
+      return out.byte((kind === 'array' ? 0x90 : 0x80) | length);
+    }
+    const codes = {
+      str: [0xd9, 0xda, 0xdb],
+      bin: [0xc4, 0xc5, 0xc6],
+      array: [-1, 0xdc, 0xdd],
+      map: [-1, 0xde, 0xdf]
+    }[kind];
+    if (length <= 0xff && codes[0] !== -1) {
+      out.byte(codes[0]);
+      out.uint(length, 1);
+    } else if (length <= 0xffff) {
+      out.byte(codes[1]);
+      out.uint(length, 2);
+    } else {
+      out.byte(codes[2]);
+      out.uint(length, 4);
+    }
+  };
+
+  const integer = (n: bigint): void => {
+    if (cbor) {
+      return n >= 0n ? cborHead(0, n) : cborHead(1, -1n - n);
+    }
+    if (n >= 0n) {
+      if (n <= 0x7fn) return out.byte(Number(n));
+      const size = n <= 0xffn ? 1 : n <= 0xffffn ? 2 : n <= 0xffffffffn ? 4 : 8;
+      out.byte(0xcc + Math.log2(size));
+      return out.uint(n, size);
+    }
+    if (n >= -32n) return out.byte(Number(n) & 0xff);
+    const size = n >= -0x80n ? 1 : n >= -0x8000n ? 2 : n >= -0x80000000n ? 4 : 8;
+    out.byte(0xd0 + Math.log2(size));
+    out.uint(BigInt.asUintN(size * 8, n), size);
+  };
+
+  const number = (n: number): void => {
+    if (Number.isSafeInteger(n)) {
+      integer(BigInt(n));
+    } else {
+      out.byte(cbor ? 0xfb : 0xcb);
+      out.float64(n);
+    }
+  };
+
+  const date = (ms: number): void => {
+    if (!Number.isFinite(ms)) {
+      return out.byte(cbor ? 0xf6 : 0xc0);
+    }
+    if (cbor) {
+      out.byte(0xc1);
+      return number(ms / 1000);
+    }
+    const seconds = Math.floor(ms / 1000);
+    const nanoseconds = Math.trunc((ms - seconds * 1000) * 1e6);
+    if (seconds >= 0 && seconds < 2 ** 34) {
+      out.byte(0xd7);
+      out.byte(MSGPACK_TIMESTAMP_EXT);
+      out.uint((BigInt(nanoseconds) << 34n) | BigInt(seconds), 8);
+    } else {
+      out.byte(0xc7);
+      out.byte(12);
+      out.byte(MSGPACK_TIMESTAMP_EXT);
+      out.uint(nanoseconds, 4);
+      out.uint(BigInt(seconds), 8);
+    }
+  };
+
+  const write = (v: any, depth: number): void => {
+    if (depth > MAX_DEPTH) {
+      throw new Error('Maximum nesting depth exceeded');
+    }
+
+    if (v === null || v === undefined || typeof v === 'function' || typeof v === 'symbol') {
+      out.byte(cbor ? 0xf6 : 0xc0);
+    } else if (typeof v === 'boolean') {
+      out.byte(cbor ? (v ? 0xf5 : 0xf4) : v ? 0xc3 : 0xc2);
+    } else if (typeof v === 'number') {
+      number(v);
+    } else if (typeof v === 'bigint') {
+      if (v < -(2n ** 63n) || v >= 2n ** 64n) {
+        throw new Error('BigInt value out of 64-bit range');
+      }
+      integer(v);
+    } else if (typeof v === 'string') {
+      const bytes = Buffer.from(v, 'utf8');
+      header('str', bytes.length);
+      out.bytes(bytes);
+    } else if (Buffer.isBuffer(v)) {
+      header('bin', v.length);
+      out.bytes(v);
+    } else if (v instanceof Date) {
+      date(v.getTime());
+    } else if (Array.isArray(v)) {
+      header('array', v.length);
+      for (const item of v) write(item, depth + 1);
+    } else {
+      const entries = Object.entries(v).filter(
+        ([, item]) => item !== undefined && typeof item !== 'function'
+      );
+      header('map', entries.length);
+      for (const [key, item] of entries) {
+        write(key, depth + 1);
+        write(item, depth + 1);
+      }
+    }
+  };
+
+  write(value, 0);
+  return out.result();
+}
+
+/**
+ * Decode a MessagePack or CBOR buffer
+ * @param input Encoded data
+ * @param format Input format (default msgpack)
+ */
+export function decodeBinary(input: Buffer, format: BinaryFormat = 'msgpack'): any {
+  let offset = 0;
+
+  const take = (count: number): Buffer => {
+    if (count > input.length - offset) {
+      throw new Error('Unexpected end of input');
+    }
+    const slice = input.subarray(offset, offset + count);
+    offset += count;
+    return slice;
+  };
+  const byte = (): number => take(1)[0];
+  const peek = (): number => {
+    if (offset >= input.length) throw new Error('Unexpected end of input');
+    return input[offset];
+  };
+  const uint = (bytes: number): number | bigint => {
+    const slice = take(bytes);
+    if (bytes < 8) return slice.readUIntBE(0, bytes);
+    const value = slice.readBigUInt64BE(0);
+    return value <= BigInt(Number.MAX_SAFE_INTEGER) ? Number(value) : value;
+  };
+  const int = (bytes: number): number | bigint => {
+    const slice = take(bytes);
+    if (bytes < 8) return slice.readIntBE(0, bytes);
+    const value = slice.readBigInt64BE(0);
+    return value >= BigInt(Number.MIN_SAFE_INTEGER) ? Number(value) : value;
+  };
+  const length = (bytes: number): number => Number(uint(bytes));
+  const text = (count: number): string => take(count).toString('utf8');
+
+  const object = (count: number | null, key: () => string, value: () => any): any => {
+    const result: Record<string, any> = {};
+    for (let i = 0; count === null ? peek() !== 0xff : i < count; i++) {
+      const k = key();
+      Object.defineProperty(result, k, { value: value(), enumerable: true, writable: true, configurable: true });
+    }
+    if (count === null) offset++;
+    return result;
+  };
+
+  const timestamp = (data: Buffer): Date => {
+    if (data.length === 4) return new Date(data.readUInt32BE(0) * 1000);
+    if (data.length === 8) {
+      const packed = data.readBigUInt64BE(0);
+      return new Date(Number(packed & 0x3ffffffffn) * 1000 + Number(packed >> 34n) / 1e6);
+    }
+    if (data.length === 12) {
+      return new Date(Number(data.readBigInt64BE(4)) * 1000 + data.readUInt32BE(0) / 1e6);
+    }
+    throw new Error('Invalid MessagePack timestamp');
+  };
+
+  const msgpack = (depth: number): any => {
+    if (depth > MAX_DEPTH) throw new Error('Maximum nesting depth exceeded');
+    const type = byte();
+
+    if (type <= 0x7f) return type;
+    if (type >= 0xe0) return type - 0x100;
+    if ((type & 0xf0) === 0x80) return object(type & 0x0f, () => String(msgpack(depth + 1)), () => msgpack(depth + 1));
+    if ((type & 0xf0) === 0x90) return Array.from({ length: type & 0x0f }, () => msgpack(depth + 1));
+    if ((type & 0xe0) === 0xa0) return text(type & 0x1f);
+
+    switch (type) {
+      case 0xc0: return null;
+      case 0xc2: return false;
+      case 0xc3: return true;
+      case 0xc4: case 0xc5: case 0xc6:
+        return Buffer.from(take(length(1 << (type - 0xc4))));
+      case 0xc7: case 0xc8: case 0xc9:
+      case 0xd4: case 0xd5: case 0xd6: case 0xd7: case 0xd8: {
+        const size = type >= 0xd4 ? 1 << (type - 0xd4) : length(1 << (type - 0xc7));
+        const ext = (byte() << 24) >> 24;
+        const data = take(size);
+        return ext === MSGPACK_TIMESTAMP_EXT ? timestamp(data) : Buffer.from(data);
+      }
+      case 0xca: return take(4).readFloatBE(0);
+      case 0xcb: return take(8).readDoubleBE(0);
+      case 0xcc: case 0xcd: case 0xce: case 0xcf: return uint(1 << (type - 0xcc));
+      case 0xd0: case 0xd1: case 0xd2: case 0xd3: return int(1 << (type - 0xd0));
+      case 0xd9: case 0xda: case 0xdb: return text(length(1 << (type - 0xd9)));
+      case 0xdc: case 0xdd: {
+        const count = length(type === 0xdc ? 2 : 4);
+        if (count > input.length - offset) throw new Error('Unexpected end of input');
+        return Array.from({ length: count }, () => msgpack(depth + 1));
+      }
+      case 0xde: case 0xdf:
+        return object(length(type === 0xde ? 2 : 4), () => String(msgpack(depth + 1)), () => msgpack(depth + 1));
+      default:
+        throw new Error('Invalid MessagePack type byte');
+    }
+  };
+
+  // CBOR argument; null for indefinite length
+  const argument = (info: number): number | bigint | null => {
+    if (info < 24) return info;
+    if (info <= 27) return uint(1 << (info - 24));
+    if (info === 31) return null;
+    throw new Error('Invalid CBOR additional information');
+  };
+
+  const chunks = (major: number, info: number): Buffer => {
+    const n = argument(info);
+    if (n !== null) return Buffer.from(take(Number(n)));
+    const parts: Buffer[] = [];
+    while (peek() !== 0xff) {
+      const chunk = byte();
+      const size = argument(chunk & 0x1f);
+      if (chunk >> 5 !== major || size === null) throw new Error('Invalid CBOR string chunk');
+      parts.push(take(Number(size)));
+    }
+    offset++;
+    return Buffer.concat(parts);
+  };
+
+  const half = (bits: number): number => {
+    const exponent = (bits >> 10) & 0x1f;
+    const mantissa = bits & 0x3ff;
+    const value = exponent === 0 ? mantissa * 2 ** -24
+      : exponent !== 31 ? (mantissa + 1024) * 2 ** (exponent - 25)
+        : mantissa === 0 ? Infinity : NaN;
+    return bits & 0x8000 ? -value : value;
+  };
+
+  const cbor = (depth: number): any => {
+    if (depth > MAX_DEPTH) throw new Error('Maximum nesting depth exceeded');
+    const initial = byte();
+    const major = initial >> 5;
+    const info = initial & 0x1f;
+
+    switch (major) {
+      case 0: return argument(info);
+      case 1: {
+        const n = argument(info)!;
+        return typeof n === 'bigint' || -1 - n < Number.MIN_SAFE_INTEGER ? -1n - BigInt(n) : -1 - n;
+      }
+      case 2: return chunks(major, info);
+      case 3: return chunks(major, info).toString('utf8');
+      case 4: {
+        const n = argument(info);
+        const result: any[] = [];
+        if (n === null) {
+          while (peek() !== 0xff) result.push(cbor(depth + 1));
+          offset++;
+        } else {
+          if (Number(n) > input.length - offset) throw new Error('Unexpected end of input');
+          for (let i = 0; i < Number(n); i++) result.push(cbor(depth + 1));
+        }
+        return result;
+      }
+      case 5: {
+        const n = argument(info);
+        return object(n === null ? null : Number(n), () => String(cbor(depth + 1)), () => cbor(depth + 1));
+      }
+      case 6: {
+        const tag = argument(info);
+        const content = cbor(depth + 1);
+        if (tag === 1 && typeof content === 'number') return new Date(content * 1000);
+        if ((tag === 2 || tag === 3) && Buffer.isBuffer(content) && content.length <= 8) {
+          const magnitude = content.length ? BigInt('0x' + content.toString('hex')) : 0n;
+          return tag === 2 ? magnitude : -1n - magnitude;
+        }
+        return content;
+      }
+      default:
+        switch (info) {
+          case 20: return false;
+          case 21: return true;
+          case 22: return null;
+          case 24: byte(); return undefined;
+          case 25: return half(take(2).readUInt16BE(0));
+          case 26: return take(4).readFloatBE(0);
+          case 27: return take(8).readDoubleBE(0);
+          case 31: throw new Error('Unexpected CBOR break');
+          default: return undefined;
+        }
+    }
+  };
+
+  const result = format === 'cbor' ? cbor(0) : msgpack(0);
+  if (offset !== input.length) {
+    throw new Error('Unexpected trailing data');
+  }
+  return result;
+}
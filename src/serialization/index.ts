@@ -1 +1,3 @@
 export * from './json-processor.js';
+export * from './binary-codec.js';
+export * from './json-patch.js';
@@ -0,0 +1,213 @@
+/**
+ * JSON Patch (RFC 6902) and JSON Merge Patch (RFC 7396)
+ *
+ * JavaScript implementation used when the native JsonProcessor.applyPatch
+ * is unavailable. Patches are applied to a copy, so a failing operation
+ * leaves the input untouched.
+ */
+
+export type PatchType = 'auto' | 'json-patch' | 'merge-patch';
+
+export interface JsonPatchOperation {
+  op: 'add' | 'remove' | 'replace' | 'move' | 'copy' | 'test';
+  path: string;
+  from?: string;
+  value?: any;
+}
+
+/**
+ * Split a JSON Pointer (RFC 6901) into unescaped reference tokens
+ */
+function parsePointer(pointer: string): string[] {
+  if (pointer === '') return [];
+  if (!pointer.startsWith('/')) {
+    throw new Error(`Invalid JSON Pointer: ${pointer}`);
+  }
+  return pointer
+    .slice(1)
+    .split('/')
+    .map(token => {
+      if (/~[^01]|~$/.test(token)) {
+        throw new Error(`Invalid JSON Pointer escape: ${pointer}`);
+      }
+      return token.replace(/~1/g, '/').replace(/~0/g, '~');
+    });
+}
+
+function parseIndex(token: string, length: number, allowEnd: boolean): number {
+  if (allowEnd && token === '-') return length;
+  if (!/^(0|[1-9]\d{0,9})$/.test(token)) {
+    throw new Error(`Invalid array index: ${token}`);
+  }
+  const index = Number(token);
+  if (index > length || (!allowEnd && index === length)) {
+    throw new Error(`Array index out of range: ${token}`);
+  }
+  return index;
+}
+
+function isObject(value: any): value is Record<string, any> {
+  return value !== null && typeof value === 'object' && !Array.isArray(value);
+}
+
+function resolve(root: any, tokens: string[]): any {
+  let node = root;
+  for (const token of tokens) {
+    if (Array.isArray(node)) {
+      node = node[parseIndex(token, node.length, false)];
+    } else if (isObject(node) && Object.prototype.hasOwnProperty.call(node, token)) {
+      node = node[token];
+    } else {
+      throw new Error(`Path not found: /${token}`);
+    }
+  }
+  return node;
+}
+
+function deepEqual(a: any, b: any): boolean {
+  if (a === b) return true;
+  if (Array.isArray(a)) {
+    return Array.isArray(b) && a.length === b.length && a.every((item, i) => deepEqual(item, b[i]));
+  }
+  if (isObject(a) && isObject(b)) {
+    const keys = Object.keys(a);
+    return keys.length === Object.keys(b).length &&
+      keys.every(key => Object.prototype.hasOwnProperty.call(b, key) && deepEqual(a[key], b[key]));
+  }
+  return false;
+}
+
+/**
+ * Apply RFC 6902 operations; returns the patched document
+ */
+export function applyJsonPatch(document: any, operations: JsonPatchOperation[]): any {
+  if (!Array.isArray(operations)) {
+    throw new Error('JSON Patch must be an array of operations');
+  }
+
+  let root = structuredClone(document);
+
+  const add = (tokens: string[], value: any): void => {
+    if (tokens.length === 0) {
+      root = value;
+      return;
+    }
+    const parent = resolve(root, tokens.slice(0, -1));
+    const last = tokens[tokens.length - 1];
+    if (Array.isArray(parent)) {
+      parent.splice(parseIndex(last, parent.length, true), 0, value);
+    } else if (isObject(parent)) {
+      Object.defineProperty(parent, last, { value, enumerable: true, writable: true, configurable: true });
+    } else {
+      throw new Error('Cannot add to a scalar value');
+    }
+  };
+
+  const remove = (tokens: string[]): any => {
+    if (tokens.length === 0) {
+      throw new Error('Cannot remove the document root');
+    }
+    const parent = resolve(root, tokens.slice(0, -1));
+    const last = tokens[tokens.length - 1];
+    if (Array.isArray(parent)) {
+      return parent.splice(parseIndex(last, parent.length, false), 1)[0];
+    }
+    if (isObject(parent) && Object.prototype.hasOwnProperty.call(parent, last)) {
+      const value = parent[last];
+      delete parent[last];
+      return value;
+    }
+    throw new Error(`Path not found: /${last}`);
+  };
+
+  for (const operation of operations) {
+    if (!isObject(operation) || typeof operation.path !== 'string') {
+      throw new Error('Patch operation is missing "path"');
+    }
+    const path = parsePointer(operation.path);
+    const needsValue = operation.op === 'add' || operation.op === 'replace' || operation.op === 'test';
+    if (needsValue && !('value' in operation)) {
+      throw new Error('Patch operation is missing "value"');
+    }
+    if ((operation.op === 'move' || operation.op === 'copy') && typeof operation.from !== 'string') {
+      throw new Error('Patch operation is missing "from"');
+    }
+
+    switch (operation.op) {
+      case 'add':
+        add(path, structuredClone(operation.value));
+        break;
+      case 'remove':
+        remove(path);
+        break;
+      case 'replace': {
+        resolve(root, path);
+        const value = structuredClone(operation.value);
+        if (path.length === 0) {
+          root = value;
+          break;
+        }
+        const parent = resolve(root, path.slice(0, -1));
+        const last = path[path.length - 1];
+        if (Array.isArray(parent)) {
+          parent[parseIndex(last, parent.length, false)] = value;
+        } else {
+          parent[last] = value;
+        }
+        break;
+      }
+      case 'move':
+        if (operation.path.startsWith(`${operation.from}/`)) {
+          throw new Error('Cannot move a value into one of its children');
+        }
+        if (operation.from !== operation.path) {
+          add(path, remove(parsePointer(operation.from!)));
+        }
+        break;
+      case 'copy':
+        add(path, structuredClone(resolve(root, parsePointer(operation.from!))));
+        break;
+      case 'test':
+        if (!deepEqual(resolve(root, path), operation.value)) {
+          throw new Error(`Test operation failed at ${operation.path}`);
+        }
+        break;
+      default:
+        throw new Error(`Unknown patch operation: ${(operation as any).op}`);
+    }
+  }
+
+  return root;
+}
+
+/**
+ * Apply an RFC 7396 merge patch; returns the patched document
+ */
+export function applyMergePatch(target: any, patch: any): any {
+  if (!isObject(patch)) {
+    return structuredClone(patch);
+  }
+
+  const result: Record<string, any> = isObject(target) ? { ...target } : {};
+  for (const [key, value] of Object.entries(patch)) {
+    if (value === null) {
+      delete result[key];
+    } else {
+      Object.defineProperty(result, key, {
+        value: applyMergePatch(result[key], value),
+        enumerable: true,
+        writable: true,
+        configurable: true
+      });
+    }
+  }
+  return result;
+}
+
+/**
+ * Apply a patch by type; 'auto' treats arrays as JSON Patch and anything else as Merge Patch
+ */
+export function applyPatch(document: any, patch: any, type: PatchType = 'auto'): any {
+  const resolved = type === 'auto' ? (Array.isArray(patch) ? 'json-patch' : 'merge-patch') : type;
+  return resolved === 'json-patch' ? applyJsonPatch(document, patch) : applyMergePatch(document, patch);
+}
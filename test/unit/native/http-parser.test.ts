@@ -3,7 +3,7 @@
  */
 
 import { describe, test, expect, beforeAll } from '@jest/globals';
-import { HttpParser, getNativeModuleStatus } from '../../../src/native/index.js';
+import { HttpParser, ContentNegotiator, configureNativeModules, getNativeModuleStatus } from '../../../src/native/index.js';
 
 describe('Native HttpParser', () => {
   let httpParser: HttpParser;
@@ -137,6 +137,112 @@ describe('Native HttpParser', () => {
     expect(() => httpParser.reset()).not.toThrow();
   });
 
+  test('should read cookies of the last parsed request', () => {
+    httpParser.parse(Buffer.from(
+      'GET / HTTP/1.1\r\n' +
+      'Host: example.com\r\n' +
+      'Cookie: sid=abc123; theme = "dark" ;flag; name=J%C3%BCrgen; sid=second; bad=%zz\r\n' +
+      '\r\n'
+    ));
+
+    expect(httpParser.getCookie('sid')).toBe('abc123');
+    expect(httpParser.getCookie('theme')).toBe('dark');
+    expect(httpParser.getCookie('name')).toBe('Jürgen');
+    expect(httpParser.getCookie('bad')).toBe('%zz');
+    expect(httpParser.getCookie('flag')).toBeUndefined();
+    expect(httpParser.getCookies()).toEqual({ sid: 'abc123', theme: 'dark', name: 'Jürgen', bad: '%zz' });
+
+    // A request without a Cookie header does not see the previous one's cookies
+    httpParser.parse(Buffer.from('GET / HTTP/1.1\r\nHost: example.com\r\n\r\n'));
+    expect(httpParser.getCookie('sid')).toBeUndefined();
+    expect(httpParser.getCookies()).toEqual({});
+  });
+
+  test('should serialize Set-Cookie values with validated attributes', () => {
+    expect(HttpParser.serializeCookie('sid', 'a b;c', {
+      maxAge: 3600.5,
+      domain: '.example.com',
+      path: '/',
+      expires: new Date(Date.UTC(2015, 9, 21, 7, 28)),
+      httpOnly: true,
+      secure: true,
+      partitioned: true,
+      priority: 'high',
+      sameSite: 'lax'
+    })).toBe(
+      'sid=a%20b%3Bc; Max-Age=3600; Domain=.example.com; Path=/; Expires=Wed, 21 Oct 2015 07:28:00 GMT; ' +
+      'HttpOnly; Secure; Partitioned; Priority=High; SameSite=Lax'
+    );
+    expect(HttpParser.serializeCookie('token', 'x', { sameSite: true })).toBe('token=x; SameSite=Strict');
+
+    expect(() => HttpParser.serializeCookie('bad name', 'x')).toThrow(TypeError);
+    expect(() => HttpParser.serializeCookie('n', 'a b', { encode: false })).toThrow('argument val is invalid');
+    expect(() => HttpParser.serializeCookie('n', 'v', { domain: 'ex ample.com' })).toThrow('option domain is invalid');
+    expect(() => HttpParser.serializeCookie('n', 'v', { path: '/a;b' })).toThrow('option path is invalid');
+    expect(() => HttpParser.serializeCookie('n', 'v', { maxAge: Infinity })).toThrow('option maxAge is invalid');
+    expect(() => HttpParser.serializeCookie('n', 'v', { sameSite: 'loose' as any })).toThrow('option sameSite is invalid');
+  });
+
+  test('should negotiate Accept headers by q-value and specificity', () => {
+    const types = new ContentNegotiator('type', ['application/json', 'text/html', 'text/plain']);
+    const browser = 'text/html,application/xhtml+xml,application/xml;q=0.9,image/webp,*/*;q=0.8';
+    expect(types.select(browser)).toBe('text/html');
+    expect(types.select(Buffer.from(browser))).toBe('text/html');
+    expect(types.select('application/*;q=0.2, text/plain;q=0.5')).toBe('text/plain');
+    expect(types.select('*/*, text/html;q=0')).toBe('application/json');
+    expect(types.select('image/png')).toBeUndefined();
+    expect(types.select(undefined)).toBe('application/json');
+
+    const encodings = new ContentNegotiator('encoding', ['br', 'gzip', 'identity']);
+    expect(encodings.select('gzip, deflate, br')).toBe('gzip');
+    expect(encodings.select('br;q=1.0, gzip;q=0.8')).toBe('br');
+    expect(encodings.select(undefined)).toBe('identity');
+    expect(encodings.select('gzip;q=0, br;q=0, *;q=0')).toBeUndefined();
+
+    const languages = new ContentNegotiator('language', ['en', 'fr', 'de-DE']);
+    expect(languages.select('fr-CH, fr;q=0.9, en;q=0.8')).toBe('fr');
+    expect(languages.select('de')).toBe('de-DE');
+    expect(languages.select('ja')).toBeUndefined();
+
+    // Repeated header values are answered from the decision cache
+    for (let i = 0; i < 5; i++) {
+      expect(types.select(browser)).toBe('text/html');
+    }
+    if (isNativeAvailable) {
+      expect(types.getStats().hits).toBeGreaterThanOrEqual(5);
+    }
+
+    // The parser hands its stored header straight to the negotiator
+    httpParser.parse(Buffer.from(
+      'GET / HTTP/1.1\r\nHost: example.com\r\nAccept-Encoding: gzip;q=0.5, br\r\n\r\n'
+    ));
+    expect(httpParser.negotiate(encodings)).toBe('br');
+    expect(httpParser.negotiate(types)).toBe('application/json');
+  });
+
+  test('should apply the implicit identity coding like negotiator', () => {
+    const cases = (encodings: (offers: string[]) => ContentNegotiator) => {
+      // Refusing other codings leaves identity acceptable
+      expect(encodings(['identity']).select('gzip;q=0')).toBe('identity');
+      // "*" covers identity, so it gets no implicit q=1 entry of its own
+      expect(encodings(['br', 'deflate', 'identity']).select('*')).toBe('br');
+      expect(encodings(['br', 'identity']).select('gzip;q=1.0, *')).toBe('br');
+      // Only an explicit q=0 refuses it
+      expect(encodings(['identity']).select('*;q=0')).toBeUndefined();
+      expect(encodings(['identity']).select('identity;q=0')).toBeUndefined();
+    };
+
+    cases(offers => new ContentNegotiator('encoding', offers));
+
+    const initialOptions = configureNativeModules({});
+    try {
+      configureNativeModules({ enabled: false });
+      cases(offers => new ContentNegotiator('encoding', offers));
+    } finally {
+      configureNativeModules(initialOptions);
+    }
+  });
+
   // Add tests for POST requests with body, chunked encoding, responses etc.
   // if the parser supports them and the interface allows testing them.
 });
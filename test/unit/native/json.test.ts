@@ -82,6 +82,198 @@ describe('Native JsonProcessor', () => {
     expect(() => jsonProcessor.stringify(circularObj)).toThrow();
   });
 
+  test('should stringify with a compiled serializer', () => {
+    const serializer = jsonProcessor.compileSerializer({
+      type: 'object',
+      properties: {
+        id: { type: 'integer' },
+        name: { type: 'string' },
+        tags: { type: 'array', items: { type: 'string' } },
+        note: { type: ['string', 'null'] }
+      },
+      required: ['id']
+    });
+
+    const result = serializer.stringify({ id: 7.9, name: 'a"b', tags: ['x'], note: null, extra: 1 });
+    expect(result).toBe('{"id":7,"name":"a\\"b","tags":["x"],"note":null}');
+    expect(serializer.stringify({ id: null, name: null, tags: [null], note: null })).toBe(
+      '{"id":0,"name":"","tags":[""],"note":null}'
+    );
+    expect(serializer.stringifyToBuffer({ id: 1 }).toString()).toBe('{"id":1}');
+    expect(() => serializer.stringify({ name: 'missing id' })).toThrow();
+  });
+
+  test('should stringify into fixed-size chunks', () => {
+    const items = Array.from({ length: 500 }, (_, i) => ({ id: i, name: `item-${i}` }));
+    const chunks = [...jsonProcessor.stringifyChunks(items, { chunkSize: 1024 })];
+
+    expect(chunks.length).toBeGreaterThan(1);
+    expect(chunks.slice(0, -1).every(chunk => chunk.length === 1024)).toBe(true);
+    expect(Buffer.concat(chunks).toString()).toBe(JSON.stringify(items));
+
+    // Smaller chunk sizes are raised to the 1 KB minimum
+    const clamped = [...jsonProcessor.stringifyChunks(items, { chunkSize: 10 })];
+    expect(clamped.slice(0, -1).every(chunk => chunk.length === 1024)).toBe(true);
+  });
+
+  test('should not carry output across stringify calls', () => {
+    const large = Array.from({ length: 200 }, (_, i) => i);
+    expect(jsonProcessor.stringify(large)).toBe(JSON.stringify(large));
+    expect(jsonProcessor.stringify(large)).toBe(JSON.stringify(large));
+    expect(jsonProcessor.stringifyStream([{ a: 1 }, 2])).toBe('{"a":1}\n2');
+    expect(jsonProcessor.stringifyStream([3])).toBe('3');
+
+    const capped = new JsonProcessor({ maxBufferSize: 64 * 1024 });
+    const huge = Array.from({ length: 50000 }, (_, i) => i);
+    expect(capped.stringify(huge)).toBe(JSON.stringify(huge));
+    if (isNativeAvailable) {
+      const stats = capped.getBufferStats();
+      expect(stats.maxRetainedSize).toBe(64 * 1024);
+      expect(stats.outputCapacity).toBeLessThanOrEqual(64 * 1024);
+    }
+  });
+
+  test('should parse asynchronously, including NDJSON', async () => {
+    await expect(jsonProcessor.parseAsync(Buffer.from('{"a":[1,2]}'))).resolves.toEqual({ a: [1, 2] });
+    await expect(jsonProcessor.parseAsync('["small",1]')).resolves.toEqual(['small', 1]);
+    await expect(jsonProcessor.parseAsync('{"a":1}\n\n{"b":2}\n', { ndjson: true })).resolves.toEqual([
+      { a: 1 },
+      { b: 2 }
+    ]);
+    await expect(jsonProcessor.parseAsync('{invalid')).rejects.toThrow();
+
+    // A line holding more than one value is not valid NDJSON
+    await expect(jsonProcessor.parseAsync('{"a":1}\n1,2\n', { ndjson: true })).rejects.toThrow();
+    await expect(jsonProcessor.parseAsync('"a","b"', { ndjson: true })).rejects.toThrow();
+  });
+
+  test('should parse documents off-thread above the async threshold', async () => {
+    const offThread = new JsonProcessor({ asyncThreshold: 0 });
+    const json = JSON.stringify({ items: Array.from({ length: 100 }, (_, i) => ({ i })) });
+    await expect(offThread.parseAsync(json)).resolves.toEqual(JSON.parse(json));
+    await expect(offThread.parseAsync(Buffer.from(json))).resolves.toEqual(JSON.parse(json));
+    await expect(offThread.parseAsync('{invalid')).rejects.toThrow();
+
+    if (isNativeAvailable) {
+      expect(offThread.setAsyncThreshold(64)).toBe(64);
+      await expect(offThread.parseAsync('[1]')).resolves.toEqual([1]);
+    }
+  });
+
+  test('should round-trip MessagePack and CBOR', () => {
+    const value = { id: 7, neg: -300, ratio: 0.5, name: 'café', tags: ['a', 'b'], ok: true, none: null };
+
+    expect(jsonProcessor.encode({ a: 1 }).toString('hex')).toBe('81a16101');
+    expect(jsonProcessor.encode({ a: 1 }, 'cbor').toString('hex')).toBe('a1616101');
+    expect(jsonProcessor.decode(jsonProcessor.encode(value))).toEqual(value);
+    expect(jsonProcessor.decode(jsonProcessor.encode(value, 'cbor'), 'cbor')).toEqual(value);
+    expect(jsonProcessor.decode(jsonProcessor.encode(2n ** 60n))).toBe(2n ** 60n);
+    expect(() => jsonProcessor.decode(Buffer.from([0x92, 0x01]))).toThrow();
+  });
+
+  test('should transcode between JSON and binary formats', () => {
+    const json = '{"id":12,"name":"a\\"b","items":[1,-2,0.5,null,true]}';
+
+    const msgpack = jsonProcessor.jsonToMsgpack(json);
+    expect(msgpack).toEqual(jsonProcessor.encode(JSON.parse(json)));
+    expect(jsonProcessor.msgpackToJson(msgpack).toString()).toBe(json);
+
+    const cbor = jsonProcessor.jsonToBinary(Buffer.from(json), 'cbor');
+    expect(jsonProcessor.binaryToJson(cbor, 'cbor').toString()).toBe(json);
+    expect(() => jsonProcessor.jsonToMsgpack('{invalid')).toThrow();
+
+    // Same text as JSON.stringify(decode(x))
+    const samples: [string, 'msgpack' | 'cbor'][] = [
+      ['cb3fd3333333333334', 'msgpack'], // 0.1 + 0.2
+      ['cb444b1ae4d6e2ef50', 'msgpack'], // 1e21
+      ['cb3eb0c6f7a0b5ed8d', 'msgpack'], // 1e-6
+      ['82f701', 'cbor'], // [undefined, 1]
+      ['a26161f7616202', 'cbor'] // { a: undefined, b: 2 }
+    ];
+    for (const [hex, format] of samples) {
+      const buffer = Buffer.from(hex, 'hex');
+      expect(jsonProcessor.binaryToJson(buffer, format).toString())
+        .toBe(JSON.stringify(jsonProcessor.decode(buffer, format)));
+    }
+
+    // Integers past 2^53 are written as exact decimals
+    expect(jsonProcessor.binaryToJson(Buffer.from('cf1000000000000000', 'hex')).toString())
+      .toBe('1152921504606846976');
+    expect(jsonProcessor.binaryToJson(Buffer.from('3bffffffffffffffff', 'hex'), 'cbor').toString())
+      .toBe('-18446744073709551616');
+  });
+
+  test('should round-trip 64-bit integers through binary formats', () => {
+    const json = '[9223372036854775807,-9223372036854775808,18446744073709551615]';
+    expect(jsonProcessor.binaryToJson(jsonProcessor.encode([2n ** 63n - 1n, -(2n ** 63n)])).toString())
+      .toBe('[9223372036854775807,-9223372036854775808]');
+
+    // The JS fallback needs JSON.parse source text to read them exactly
+    if (isNativeAvailable) {
+      expect(jsonProcessor.msgpackToJson(jsonProcessor.jsonToMsgpack(json)).toString()).toBe(json);
+      expect(jsonProcessor.binaryToJson(jsonProcessor.jsonToBinary(json, 'cbor'), 'cbor').toString()).toBe(json);
+    }
+  });
+
+  test('should keep 64-bit integers exact', () => {
+    const json = '{"id":9007199254740993,"small":42,"neg":-9223372036854775808}';
+    // Lossy by default, like JSON.parse
+    expect(jsonProcessor.parse(json)).toEqual(JSON.parse(json));
+    expect(jsonProcessor.parse(json).small).toBe(42);
+
+    if (isNativeAvailable) {
+      const exact = new JsonProcessor({ bigIntMode: 'bigint' });
+      expect(exact.parse(json)).toEqual({ id: 9007199254740993n, small: 42, neg: -9223372036854775808n });
+      expect(exact.stringify(exact.parse(json))).toBe(json);
+
+      const asString = new JsonProcessor({ bigIntMode: 'string' });
+      expect(asString.parse(json).id).toBe('9007199254740993');
+    }
+  });
+
+  test('should apply JSON Patch and Merge Patch', () => {
+    const doc = '{"title":"Goodbye!","author":{"givenName":"John","familyName":"Doe"},"tags":["a","b"]}';
+
+    const patched = jsonProcessor.applyPatch(doc, JSON.stringify([
+      { op: 'replace', path: '/title', value: 'Hello!' },
+      { op: 'add', path: '/tags/-', value: 'c' },
+      { op: 'move', from: '/author/givenName', path: '/author/name' },
+      { op: 'test', path: '/tags/0', value: 'a' }
+    ]));
+    expect(JSON.parse(patched.toString())).toEqual({
+      title: 'Hello!',
+      author: { familyName: 'Doe', name: 'John' },
+      tags: ['a', 'b', 'c']
+    });
+
+    const merged = jsonProcessor.applyPatch(doc, '{"author":{"familyName":null},"tags":["x"]}');
+    expect(merged.toString()).toBe('{"title":"Goodbye!","author":{"givenName":"John"},"tags":["x"]}');
+
+    expect(() => jsonProcessor.applyPatch(doc, '[{"op":"test","path":"/title","value":"nope"}]')).toThrow();
+    expect(() => jsonProcessor.applyPatch(doc, '[{"op":"remove","path":"/missing"}]')).toThrow();
+  });
+
+  test('should pool parsers by document size and drop oversized ones', () => {
+    const processor = new JsonProcessor({ maxParserCapacity: 1024 * 1024, parserIdleCalls: 4 });
+    const medium = JSON.stringify(Array.from({ length: 20000 }, (_, i) => ({ i })));
+    const large = JSON.stringify(Array.from({ length: 100000 }, (_, i) => ({ i })));
+
+    expect(processor.parse(medium)).toHaveLength(20000);
+    expect(processor.parse(large)).toHaveLength(100000);
+    expect(processor.parse('{"a":1}')).toEqual({ a: 1 });
+
+    const stats = processor.getBufferStats();
+    expect(stats.parserInUse).toBe(0);
+    if (isNativeAvailable) {
+      expect(stats.maxParserCapacity).toBe(1024 * 1024);
+      expect(stats.parserCapacity).toBeLessThanOrEqual(2 * 1024 * 1024);
+      expect(stats.parserTrimCount).toBeGreaterThan(0);
+
+      processor.releaseBuffers();
+      expect(processor.getBufferStats().parserCount).toBe(0);
+    }
+  });
+
   // Add more tests for JSON stream handling if supported by the interface
   // test('should parse a JSON stream', () => {...});
   // test('should stringify to a stream', () => {...});
@@ -0,0 +1,212 @@
+/**
+ * Unit tests for the native SchemaValidator
+ */
+
+import { describe, test, expect, beforeAll } from '@jest/globals';
+import { SchemaValidator, getNativeModuleStatus } from '../../../src/native/index.js';
+
+describe('Native SchemaValidator', () => {
+  let validator: SchemaValidator;
+  let isNativeAvailable: boolean;
+
+  const userSchema = {
+    type: 'object',
+    required: ['id', 'tags'],
+    properties: {
+      id: { type: 'integer' },
+      name: { type: ['string', 'null'], maxLength: 5 },
+      tags: { type: 'array', items: { type: 'string' } }
+    },
+    additionalProperties: false
+  };
+
+  beforeAll(() => {
+    validator = new SchemaValidator();
+    isNativeAvailable = getNativeModuleStatus().schemaValidator;
+    console.log(`SchemaValidator Native Implementation Available: ${isNativeAvailable}`);
+
+    if (!isNativeAvailable) {
+      console.warn('Native SchemaValidator not available, tests might only cover JS fallback.');
+    }
+  });
+
+  test('should accept type lists and integers', () => {
+    expect(validator.validate(userSchema, { id: 1, name: null, tags: ['a'] }).valid).toBe(true);
+    expect(validator.validate(userSchema, { id: 2, name: 'ada', tags: [] }).valid).toBe(true);
+  });
+
+  test('should report every failing path', () => {
+    const result = validator.validate(userSchema, { id: 1.5, name: 'toolong', tags: ['a', 2], extra: true });
+    expect(result.valid).toBe(false);
+    expect(result.errors.map(error => error.path).sort()).toEqual(['$.extra', '$.id', '$.name', '$.tags[1]']);
+
+    const missing = validator.validate(userSchema, { tags: [] });
+    expect(missing.valid).toBe(false);
+    expect(missing.errors.map(error => error.path)).toEqual(['$.id']);
+  });
+
+  test('should only validate own properties of the data', () => {
+    const schema = { type: 'object', properties: { constructor: { type: 'string' }, toString: { type: 'string' } } };
+    expect(validator.validate(schema, {}).valid).toBe(true);
+    expect(validator.validate(schema, { constructor: 1 }).valid).toBe(false);
+  });
+
+  test('should reject unknown type names', () => {
+    const integer = validator.validate({ type: 'object', properties: { id: { type: 'integer' } } }, { id: 1.5 });
+    expect(integer.errors).toEqual([{ path: '$.id', message: 'Expected integer' }]);
+
+    if (isNativeAvailable) {
+      expect(() => validator.compileSchema({ type: 'strnig' })).toThrow('Unknown schema type: strnig');
+      expect(() => validator.validate({ type: 'object', properties: { a: { type: ['string', 'int'] } } }, {}))
+        .toThrow('Unknown schema type: int');
+    }
+  });
+
+  test('should match patterns anywhere in the string', () => {
+    const schema = {
+      type: 'object',
+      properties: {
+        slug: { type: 'string', pattern: '^[a-z0-9]+(?:-[a-z0-9]+)*$' },
+        code: { type: 'string', pattern: '\\d{3}' },
+        word: { type: 'string', pattern: '\\bcat\\b' }
+      }
+    };
+    expect(validator.validate(schema, { slug: 'hello-world-2', code: 'ab123cd', word: 'a cat sat' }).valid).toBe(true);
+
+    const result = validator.validate(schema, { slug: 'Hello--world', code: '12a', word: 'concatenate' });
+    expect(result.errors.map(error => error.path).sort()).toEqual(['$.code', '$.slug', '$.word']);
+
+    // Patterns match by code point, so '.' covers a whole astral character
+    const single = { type: 'object', properties: { s: { type: 'string', pattern: '^.$' } } };
+    expect(validator.validate(single, { s: '😀' }).valid).toBe(true);
+
+    if (isNativeAvailable) {
+      // Nested quantifiers do not backtrack in the native matcher
+      const nested = { type: 'object', properties: { s: { type: 'string', pattern: '^(a+)+$' } } };
+      expect(validator.validate(nested, { s: 'a'.repeat(10000) + '!' }).valid).toBe(false);
+    }
+  });
+
+  test('should report Unicode property escapes as unsupported natively', () => {
+    const letters = { type: 'object', properties: { s: { type: 'string', pattern: '^\\p{L}+$' } } };
+    if (isNativeAvailable) {
+      expect(validator.validate(letters, { s: 'héllo' }).errors).toEqual([
+        { path: '$.s', message: 'Unsupported regex pattern in schema (Unicode property escape): ^\\p{L}+$' }
+      ]);
+    } else {
+      expect(validator.validate(letters, { s: 'héllo' }).valid).toBe(true);
+      expect(validator.validate(letters, { s: '123' }).valid).toBe(false);
+    }
+  });
+
+  test('should cache compiled schemas by structure rather than $id', () => {
+    validator.clearCache();
+    const first = { $id: 'shared', type: 'object', properties: { n: { type: 'number' } } };
+    const second = { $id: 'shared', type: 'object', properties: { n: { type: 'string' } } };
+    expect(validator.validate(first, { n: 1 }).valid).toBe(true);
+    expect(validator.validate(second, { n: 1 }).valid).toBe(false);
+
+    // Key order does not matter, and repeats hit the cache
+    const reordered = { properties: { n: { type: 'number' } }, type: 'object', $id: 'shared' };
+    for (let i = 0; i < 3; i++) {
+      expect(validator.validate(first, { n: 2 }).valid).toBe(true);
+      expect(validator.validate(reordered, { n: 'x' }).valid).toBe(false);
+    }
+    if (isNativeAvailable) {
+      const stats = validator.getCacheStats();
+      expect(stats.cacheSize).toBe(2);
+      expect(stats.cacheHits).toBeGreaterThanOrEqual(6);
+    }
+  });
+
+  test('should never serve a stale compiled schema', () => {
+    // In-place mutation is picked up without clearCache()
+    const schema: any = { type: 'object', properties: { n: { type: 'number' } } };
+    expect(validator.validate(schema, { n: 1 }).valid).toBe(true);
+    schema.properties.n.type = 'string';
+    expect(validator.validate(schema, { n: 1 }).valid).toBe(false);
+
+    // NaN is its own keyword value, not 0
+    const zero = { type: 'object', properties: { n: { maximum: 0 } } };
+    const nan = { type: 'object', properties: { n: { maximum: NaN } } };
+    expect(validator.validate(zero, { n: 1 }).valid).toBe(false);
+    expect(validator.validate(nan, { n: 1 }).valid).toBe(true);
+  });
+
+  test('should validate through a compiled schema handle', () => {
+    const compiled = validator.compileSchema(userSchema);
+    expect(compiled.validate({ id: 3, tags: ['x'] })).toEqual({ valid: true, errors: [] });
+    expect(compiled.validate({ id: 'x', tags: [] }).errors.map(error => error.path)).toEqual(['$.id']);
+    expect(compiled.validatePartial({ id: 1, tags: [] }, { name: 'bob' }).valid).toBe(true);
+    expect(compiled.validatePartial({ id: 1, tags: [] }, { extra: 1 }).valid).toBe(false);
+
+    if (isNativeAvailable) {
+      expect(compiled.hash).toMatch(/^[0-9a-f]{32}$/);
+    }
+  });
+
+  test('should validate raw JSON against a compiled schema', () => {
+    const compiled = validator.compileSchema(userSchema);
+    const body = '{"id":7,"name":"ada","tags":["x","y"]}';
+
+    const result = validator.validateJson(compiled, Buffer.from(body));
+    expect(result.valid).toBe(true);
+    expect(result.value).toEqual(JSON.parse(body));
+
+    const invalid = validator.validateJson(compiled, '{"id":1.5,"tags":["a",2],"extra":{"deep":[1]}}');
+    expect(invalid.valid).toBe(false);
+    expect(invalid.value).toBeUndefined();
+    expect(invalid.errors.map(error => error.path).sort()).toEqual(['$.extra', '$.id', '$.tags[1]']);
+
+    const malformed = validator.validateJson(compiled, '{"id":1,"tags":[],"junk":tru}');
+    expect(malformed.valid).toBe(false);
+    expect(malformed.errors[0].message).toMatch(/^Invalid JSON/);
+  });
+
+  test('should keep __proto__ keys as own properties', () => {
+    const compiled = validator.compileSchema({ type: 'object' });
+    const { value } = validator.validateJson(compiled, '{"__proto__":{"x":1}}');
+    expect(Object.getPrototypeOf(value)).toBe(Object.prototype);
+    expect(Object.hasOwn(value, '__proto__')).toBe(true);
+    expect(value.x).toBeUndefined();
+  });
+
+  test('should parse bodies and queries with coercion, defaults and stripping', () => {
+    const compiled = validator.compileSchema({
+      type: 'object',
+      required: ['id'],
+      properties: {
+        id: { type: 'integer' },
+        active: { type: 'boolean' },
+        limit: { type: 'integer', default: 20, maximum: 100 },
+        tags: { type: 'array', items: { type: 'string' } }
+      },
+      additionalProperties: false
+    });
+
+    const body = validator.parseJson(compiled, '{"id":"42","active":"true","extra":{"deep":[1]}}');
+    expect(body.valid).toBe(true);
+    expect(body.value).toEqual({ id: 42, active: true, limit: 20 });
+
+    const query = validator.parseQuery(compiled, '?id=7&tags=a&tags=b&limit=5&junk=1');
+    expect(query.value).toEqual({ id: 7, tags: ['a', 'b'], limit: 5 });
+
+    const invalid = validator.parseQuery(compiled, 'id=1.5&limit=500');
+    expect(invalid.valid).toBe(false);
+    expect(invalid.value).toBeUndefined();
+    expect(invalid.errors.map(error => error.path).sort()).toEqual(['$.id', '$.limit']);
+  });
+
+  test('should keep __proto__ keys as own properties when parsing', () => {
+    const compiled = validator.compileSchema({ type: 'object' });
+
+    const body = validator.parseJson(compiled, '{"__proto__":{"x":1}}').value;
+    expect(Object.getPrototypeOf(body)).toBe(Object.prototype);
+    expect(Object.hasOwn(body, '__proto__')).toBe(true);
+    expect(body.x).toBeUndefined();
+
+    const query = validator.parseQuery(compiled, '__proto__=x').value;
+    expect(Object.getPrototypeOf(query)).toBe(Object.prototype);
+    expect(Object.hasOwn(query, '__proto__')).toBe(true);
+  });
+});
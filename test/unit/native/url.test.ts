@@ -0,0 +1,235 @@
+/**
+ * Unit tests for the native UrlParser
+ */
+
+import { describe, test, expect, beforeAll, beforeEach } from '@jest/globals';
+import { UrlParser, URL_COMPONENTS, getNativeModuleStatus } from '../../../src/native/index.js';
+
+describe('Native UrlParser', () => {
+  let parser: UrlParser;
+  let isNativeAvailable: boolean;
+
+  beforeAll(() => {
+    isNativeAvailable = getNativeModuleStatus().urlParser;
+    console.log(`UrlParser Native Implementation Available: ${isNativeAvailable}`);
+
+    if (!isNativeAvailable) {
+      console.warn('Native UrlParser not available, tests might only cover JS fallback.');
+    }
+  });
+
+  beforeEach(() => {
+    parser = new UrlParser();
+  });
+
+  test('should return component spans over the input', () => {
+    const url = 'https://user:pw@example.com:8080/a/b?x=1&y=2#frag';
+    const spans = parser.parseSpans(url);
+    expect(spans).toBeInstanceOf(Uint32Array);
+    expect(spans).toHaveLength(URL_COMPONENTS.length * 2);
+
+    const parts = URL_COMPONENTS.map((_, i) => url.slice(spans[i * 2], spans[i * 2] + spans[i * 2 + 1]));
+    expect(parts).toEqual(['https', 'user:pw', 'example.com', '8080', '/a/b', 'x=1&y=2', 'frag']);
+  });
+
+  test('should fill a caller-provided span array', () => {
+    const out = new Uint32Array(14);
+    expect(parser.parseSpans('/items?page=2', out)).toBe(out);
+    expect(Array.from(out.subarray(8, 12))).toEqual([0, 6, 7, 6]);
+
+    // Buffer input reports byte offsets
+    const spans = parser.parseSpans(Buffer.from('/café?q'));
+    expect(Array.from(spans.subarray(8, 12))).toEqual([0, 6, 7, 1]);
+  });
+
+  test('should expose components lazily', () => {
+    const view = parser.parseLazy('//cdn.example.com/img.png?v=3');
+    expect(view.hostname).toBe('cdn.example.com');
+    expect(view.pathname).toBe('/img.png');
+    expect(view.search).toBe('v=3');
+    expect(view.protocol).toBe('');
+    expect(view.toJSON()).toEqual({
+      protocol: '', auth: '', hostname: 'cdn.example.com', port: '', pathname: '/img.png', search: 'v=3', hash: ''
+    });
+  });
+
+  test('should not take a scheme from the query string', () => {
+    const view = parser.parseLazy('/redirect?to=http://other.example/');
+    expect(view.protocol).toBe('');
+    expect(view.pathname).toBe('/redirect');
+    expect(view.search).toBe('to=http://other.example/');
+  });
+
+  test('should normalize URLs like the WHATWG URL parser', () => {
+    const cases: Array<[string, string | undefined]> = [
+      ['HTTP://EXAMPLE.com:80/a/./b/../c', undefined],
+      ['http://0x7f.1/', undefined],
+      ['http:\\\\x\\y', undefined],
+      ['file:///C:/a/../../b', undefined],
+      ['file://localhost/etc', undefined],
+      ['http://user:p@ss@host/%2e%2E/x', undefined],
+      ['http://[1:0:0:2::3:0]/', undefined],
+      ['https://example.com:443/?q=\'a b\'#"x"', undefined],
+      ['  http://ex\tample.com/a b  ', undefined],
+      ['sc://a/..//b', undefined],
+      ['sc:/..', undefined],
+      ['sc://h/..', undefined],
+      ['..', 'sc:/a'],
+      ['../../../g?y#s', 'http://a/b/c/d;p?q'],
+      ['//other/x', 'https://a/b']
+    ];
+
+    for (const [input, base] of cases) {
+      const expected = new URL(input, base);
+      const view = parser.parseWhatwg(input, base);
+      expect(view).not.toBeNull();
+      expect(view!.href).toBe(expected.href);
+      expect(view!.protocol).toBe(expected.protocol.slice(0, -1));
+      expect(view!.hostname).toBe(expected.hostname);
+      expect(view!.port).toBe(expected.port);
+      expect(view!.pathname).toBe(expected.pathname);
+      expect(view!.search).toBe(expected.search.slice(1));
+      expect(view!.hash).toBe(expected.hash.slice(1));
+    }
+  });
+
+  test('should reject invalid URLs and hand IDNA hosts to URL', () => {
+    expect(parser.parseWhatwg('http://1.2.3.4.5/')).toBeNull();
+    expect(parser.parseWhatwg('http://x:65536/')).toBeNull();
+    expect(parser.parseWhatwg('relative/path')).toBeNull();
+    expect(parser.parseWhatwg('g', 'not a url')).toBeNull();
+
+    expect(parser.parseWhatwg('http://münchen.de/')!.hostname).toBe('xn--mnchen-3ya.de');
+  });
+
+  test('should decode query strings and keep key order', () => {
+    const result = parser.parseQueryString('?b=%41+b&a=1&&c&b=2&d=%E2%82%AC%zz');
+    expect(result).toEqual({ b: '2', a: '1', c: '', d: '€%zz' });
+    expect(Object.keys(result)).toEqual(['b', 'a', 'c', 'd']);
+  });
+
+  test('should collect repeated and bracketed query keys', () => {
+    expect(parser.parseQuery('a=1&a=2&a=3&tags[]=x&tags[]=y&user[name]=ann&user[roles][]=admin')).toEqual({
+      a: ['1', '2', '3'],
+      tags: ['x', 'y'],
+      user: { name: 'ann', roles: ['admin'] }
+    });
+    expect(parser.parseQuery('a[1]=x&a[5]=y&b[21]=z')).toEqual({ a: ['x', 'y'], b: { 21: 'z' } });
+    expect(parser.parseQuery(Buffer.from('k%5Bv%5D=1'))).toEqual({ k: { v: '1' } });
+
+    // Depth and parameter limits
+    expect(parser.parseQuery('x[a][b][c]=1', { depth: 1 })).toEqual({ x: { a: { '[b][c]': '1' } } });
+    expect(parser.parseQuery('a&b&c', { parameterLimit: 2 })).toEqual({ a: '', b: '' });
+
+    const polluted = parser.parseQuery('__proto__[admin]=1&constructor[x]=2');
+    expect(({} as any).admin).toBeUndefined();
+    expect(Object.keys(polluted)).toEqual(['constructor']);
+  });
+
+  test('should percent-decode and encode like the URI component builtins', () => {
+    const samples = [
+      '',
+      'plain-ascii_value.~*()',
+      'a b&c=d/e?f#g+h',
+      'caf\u00e9 \u20ac \ud83d\ude00 '.repeat(8),
+      'x'.repeat(100) + ' ' + 'y'.repeat(100)
+    ];
+    for (const sample of samples) {
+      const encoded = parser.encodeURIComponent(sample);
+      expect(encoded).toBe(encodeURIComponent(sample));
+      expect(parser.decodeURIComponent(encoded)).toBe(sample);
+    }
+
+    expect(parser.decodeURIComponent('%41%62%2B+%e2%82%ac')).toBe('Ab++\u20ac');
+    for (const malformed of ['%', '%zz', '%E2%82', '%C0%80', '%ED%A0%80', '%F4%90%80%80']) {
+      expect(() => parser.decodeURIComponent(malformed)).toThrow(URIError);
+    }
+    expect(() => parser.encodeURIComponent('\ud800')).toThrow(URIError);
+  });
+
+  test('should serve repeated URLs from the parse cache', () => {
+    const capacity = UrlParser.configureCache(64);
+    try {
+      const url = '/health?check=deep&region=eu';
+      const first = parser.parseSpans(url);
+      const firstQuery = parser.parseQueryString('check=deep&region=eu');
+      for (let i = 0; i < 10; i++) {
+        expect(parser.parseSpans(url)).toEqual(first);
+        expect(parser.parseQueryString('check=deep&region=eu')).toEqual(firstQuery);
+      }
+      // Same bytes, different options: a separate entry
+      expect(parser.parseQuery('a=1&a=2', { parameterLimit: 1 })).toEqual({ a: '1' });
+      expect(parser.parseQuery('a=1&a=2')).toEqual({ a: ['1', '2'] });
+
+      const stats = UrlParser.getCacheStats();
+      if (isNativeAvailable) {
+        expect(capacity).toBe(64);
+        expect(stats.hits).toBeGreaterThanOrEqual(20);
+        expect(stats.size).toBeLessThanOrEqual(stats.capacity);
+      } else {
+        expect(stats.capacity).toBe(0);
+      }
+    } finally {
+      UrlParser.configureCache(0);
+    }
+  });
+
+  test('should parse packed URL batches into columns', () => {
+    const urls = ['https://Example.com/a?x=1&y=2#h', '/health?check', '', '//CDN/x?a&b=&=c', 'https://example.COM/z'];
+    const { buffer, offsets } = UrlParser.packUrls(urls);
+    const batch = parser.parseBatch(buffer, offsets, { hostnames: true, params: true });
+    const read = (column: Uint32Array, i: number) =>
+      buffer.toString('utf8', column[i * 2], column[i * 2] + column[i * 2 + 1]);
+
+    expect(batch.count).toBe(urls.length);
+    expect(urls.map((_, i) => read(batch.hostname, i))).toEqual(['Example.com', '', '', 'CDN', 'example.COM']);
+    expect(urls.map((_, i) => read(batch.pathname, i))).toEqual(['/a', '/health', '', '/x', '/z']);
+    expect(read(batch.hash, 0)).toBe('h');
+
+    expect(batch.hostnames).toEqual(['example.com', '', 'cdn']);
+    expect(Array.from(batch.hostIds!)).toEqual([0, 1, 1, 2, 0]);
+
+    expect(Array.from(batch.paramIndex!)).toEqual([0, 2, 3, 3, 6, 6]);
+    const params = batch.params!;
+    const pairs: string[] = [];
+    for (let k = 0; k < params.length; k += 4) {
+      pairs.push(`${buffer.toString('utf8', params[k], params[k] + params[k + 1])}=` +
+        buffer.toString('utf8', params[k + 2], params[k + 2] + params[k + 3]));
+    }
+    expect(pairs).toEqual(['x=1', 'y=2', 'check=', 'a=', 'b=', '=c']);
+
+    // Thread-split batches give the same columns
+    const many = UrlParser.packUrls(Array.from({ length: 40000 }, (_, i) => `/item/${i}?page=${i % 7}`));
+    const single = parser.parseBatch(many.buffer, many.offsets, { threads: 1 });
+    const split = parser.parseBatch(many.buffer, many.offsets, { threads: 4 });
+    expect(split.pathname).toEqual(single.pathname);
+    expect(split.search).toEqual(single.search);
+  });
+
+  test('should build URLs with query overrides into pooled buffers', () => {
+    const redirect = parser.buildUrl('https://x.com/p?a=1&b=2&a=3#frag', { a: 'new value', c: '&=' });
+    expect(Buffer.isBuffer(redirect)).toBe(true);
+    expect(redirect.toString()).toBe('https://x.com/p?a=new%20value&b=2&c=%26%3D#frag');
+
+    expect(parser.buildUrl('https://x.com/p?a=1&b=2', { a: null, b: undefined }).toString()).toBe('https://x.com/p');
+    expect(parser.buildUrl('/login', { next: '/app?x=1', page: 2 }).toString()).toBe('/login?next=%2Fapp%3Fx%3D1&page=2');
+
+    // Signing: build, sign the bytes, then append the signature to the built Buffer
+    const unsigned = parser.buildUrl('/download?file=a.txt', { expires: 1700000000 });
+    const signed = parser.buildUrl(unsigned, { sig: 'ab+/=' });
+    expect(signed.toString()).toBe('/download?file=a.txt&expires=1700000000&sig=ab%2B%2F%3D');
+
+    // Base spans select part of a larger buffer
+    const log = Buffer.from('GET /s?k%20ey=1 HTTP/1.1');
+    expect(parser.buildUrl(log, { 'k ey': 2 }, [4, 15]).toString()).toBe('/s?k%20ey=2');
+
+    // Results are views into a shared slab and do not overlap
+    const first = parser.buildUrl('/a', { x: 1 });
+    const second = parser.buildUrl('/b', { y: 2 });
+    expect(first.toString()).toBe('/a?x=1');
+    expect(second.toString()).toBe('/b?y=2');
+
+    const long = 'v'.repeat(100 * 1024);
+    expect(parser.buildUrl('/big', { q: long }).length).toBe('/big?q='.length + long.length);
+  });
+});